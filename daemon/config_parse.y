@@ -605,6 +605,26 @@ ParamStruct	:	DEBUGFLAGS EQUALS OPENBRACE AlarmBitComp CLOSEBRACE
 			{
 			    Conf_set_lookup_timeout($3.number);
 			}
+		|	STRING EQUALS SP_BOOL
+			{
+			    if (!Conf_set_named_param($1.string, $3.boolean))
+			        yyerror("Unknown configuration parameter");
+			}
+		|	STRING EQUALS SP_TRIVAL
+			{
+			    if (!Conf_set_named_param($1.string, $3.number))
+			        yyerror("Unknown configuration parameter");
+			}
+		|	STRING EQUALS NUMBER
+			{
+			    if (!Conf_set_named_param($1.string, $3.number))
+			        yyerror("Unknown configuration parameter");
+			}
+		|	STRING EQUALS STRING
+			{
+			    if (!Conf_set_named_string_param($1.string, $3.string))
+			        yyerror("Unknown configuration parameter");
+			}
 
 SegmentStruct	:    SEGMENT IPADDR OPENBRACE Segmentparams CLOSEBRACE
                         { int i;
@@ -73,6 +73,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h> 
+#include <limits.h>
 #include <assert.h>
 
 #include "configuration.h"
@@ -103,6 +104,10 @@ static	char	*User = NULL;
 static	char	*Group = NULL;
 
 static  int     MaxSessionMessages = DEFAULT_MAX_SESSION_MESSAGES;
+static  int     MaxSessionBytes = DEFAULT_MAX_SESSION_BYTES;
+static  bool    SessionSpill = FALSE;
+static  int     MaxSessionSpillBytes = DEFAULT_MAX_SESSION_SPILL_BYTES;
+static  char    *SessionSpillDir = NULL;
 
 static  int     Window = DEFAULT_WINDOW;
 static  int     PersonalWindow = DEFAULT_PERSONAL_WINDOW;
@@ -111,6 +116,49 @@ static  bool    AcceleratedRingFlag = FALSE;
 static  bool    AcceleratedRing     = FALSE;
 static  int     AcceleratedWindow   = DEFAULT_ACCELERATED_WINDOW;
 
+static  bool    LinkOffload = FALSE;
+static  bool    AdaptiveWindow = FALSE;
+static  int     MaxSeqGap = DEFAULT_MAX_SEQ_GAP;
+static  bool    SelectiveDelivery = FALSE;
+static  bool    FastFailureDetection = FALSE;
+static  int     TokenLossMinTimeout = 0;        /* 0: the membership profile's */
+static  bool    IncrementalGroupState = FALSE;
+static  bool    CompactGroupState = FALSE;
+
+/* Parameters without a keyword of their own in config_gram.l are written
+ * "Name = value" in spread.conf and set through this table.
+ */
+static  struct {
+        const char      *name;
+        void            (*set)(int value);
+} Conf_named_params[] = {
+        { "DataLinkOffload",    Conf_set_link_offload },
+        { "AdaptiveWindow",     Conf_set_adaptive_window },
+        { "MaxSeqGap",          Conf_set_max_seq_gap },
+        { "SelectiveDelivery",  Conf_set_selective_delivery },
+        { "FastFailureDetection", Conf_set_fast_failure_detection },
+        { "TokenLossMinTimeout", Conf_set_token_loss_min_timeout },
+        { "IncrementalGroupState", Conf_set_incremental_group_state },
+        { "CompactGroupState",  Conf_set_compact_group_state },
+        { "MaxSessionBytes",    Conf_set_max_session_bytes },
+        { "SessionSpill",       Conf_set_session_spill },
+        { "MaxSessionSpillBytes", Conf_set_max_session_spill_bytes },
+};
+
+static  void    Conf_set_max_session_bytes_string(char *value);
+static  void    Conf_set_max_session_spill_bytes_string(char *value);
+
+/* and the ones taking a string. A number longer than config_gram.l takes
+ * as a NUMBER is a string too, so byte sizes are parsed from either. */
+static  struct {
+        const char      *name;
+        void            (*set)(char *value);
+} Conf_named_string_params[] = {
+        { "SessionSpillDir",    Conf_set_session_spill_dir },
+        { "MaxSessionBytes",    Conf_set_max_session_bytes_string },
+        { "MaxSessionSpillBytes", Conf_set_max_session_spill_bytes_string },
+};
+
 enum 
 {
   TOKEN_TIMEOUT_CONF  = (0x1 << 0),
@@ -409,6 +457,8 @@ void	Conf_load_conf_file( char *file_name, char *my_name )
 
         fclose(yyin);
 
+        Conf_build_ip_hash( Config );
+
         /* Test for localhost segemnt defined with other non-localhost segments.
          * That is an invalid configuration 
          */
@@ -444,6 +494,31 @@ void	Conf_load_conf_file( char *file_name, char *my_name )
 	}
 
 	ConfStringRep[ConfStringLen++] = '0' + AcceleratedRing;
+
+	/* every daemon in a ring must apply the same seq gap limit */
+	if (MaxSeqGap != DEFAULT_MAX_SEQ_GAP) {
+	  added_len = snprintf(&ConfStringRep[ConfStringLen], MAX_CONF_STRING - ConfStringLen, "G%d", MaxSeqGap);
+	  if (added_len < 0 || ConfStringLen + added_len >= MAX_CONF_STRING) {
+	    Alarmp( SPLOG_FATAL, CONF_SYS, "Failed to update string with seq gap limit!\n");
+	  }
+	  ConfStringLen += added_len;
+	}
+
+	/* placeholder packets are only understood by daemons that send them */
+	if (SelectiveDelivery) {
+	  if (ConfStringLen >= MAX_CONF_STRING) {
+	    Alarmp( SPLOG_FATAL, CONF_SYS, "Failed to update string with selective delivery!\n");
+	  }
+	  ConfStringRep[ConfStringLen++] = 'S';
+	}
+
+	/* so is the digest round of the incremental group state exchange */
+	if (IncrementalGroupState) {
+	  if (ConfStringLen >= MAX_CONF_STRING) {
+	    Alarmp( SPLOG_FATAL, CONF_SYS, "Failed to update string with incremental group state!\n");
+	  }
+	  ConfStringRep[ConfStringLen++] = 'I';
+	}
 	
         /* calculate hash value of configuration. 
          * This daemon will only work with other daemons who have an identical hash value.
@@ -556,20 +631,78 @@ int 	Conf_proc_by_name( char *name, proc *p )
 
 int	Conf_proc_by_id_in_conf( configuration *config, int32u id, proc *p )
 {
-	int	i,j;
+        proc    *ref;
+	int	i;
+
+        i = Conf_proc_ref_by_id_in_conf( config, id, &ref );
+        if ( i >= 0 )
+                *p = *ref;
+	return( i );
+}
+
+int	Conf_proc_ref_by_id( int32u id, proc **p )
+{
+        return( Conf_proc_ref_by_id_in_conf( Config, id, p ) );
+}
+
+static LOC_INLINE int32u conf_hash_ip( int32u ip )
+{
+        return( ( ip * 2654435761u ) >> 21 ) & ( CONF_IP_HASH_SIZE - 1 );
+}
+
+/* Looks id up among the interfaces of every proc in config and points *p
+ * at the proc in config->allprocs. Returns its index there, or -1. */
+int	Conf_proc_ref_by_id_in_conf( configuration *config, int32u id, proc **p )
+{
+        conf_ip_slot    *slot;
+        int32u          h;
+        int             n;
+
+        for ( h = conf_hash_ip( id ), n = 0; n < CONF_IP_HASH_SIZE; h = ( h + 1 ) & ( CONF_IP_HASH_SIZE - 1 ), n++ )
+        {
+                slot = &config->ip_hash[h];
+                if ( slot->proc_index < 0 )
+                        break;
+                if ( slot->ip == id )
+                {
+                        *p = &config->allprocs[slot->proc_index];
+                        return( slot->proc_index );
+                }
+        }
+        return( -1 );
+}
+
+/* Indexes every interface of config->allprocs. An address listed twice
+ * keeps the first proc, as a scan in allprocs order would find. Must be
+ * called whenever allprocs changes. */
+void	Conf_build_ip_hash( configuration *config )
+{
+        conf_ip_slot    *slot;
+        int32u          ip, h;
+	int	        i,j;
+
+        for ( h = 0; h < CONF_IP_HASH_SIZE; h++ )
+                config->ip_hash[h].proc_index = -1;
 
 	for ( i=0; i < config->num_total_procs; i++ )
 	{
                 for ( j=0; j < config->allprocs[i].num_if; j++)
                 {
-                        if ( config->allprocs[i].ifc[j].ip == id )
+                        ip = config->allprocs[i].ifc[j].ip;
+                        for ( h = conf_hash_ip( ip ); ; h = ( h + 1 ) & ( CONF_IP_HASH_SIZE - 1 ) )
                         {
-                                *p =  config->allprocs[i] ;
-                                return( i );
+                                slot = &config->ip_hash[h];
+                                if ( slot->proc_index < 0 )
+                                {
+                                        slot->ip         = ip;
+                                        slot->proc_index = i;
+                                        break;
+                                }
+                                if ( slot->ip == ip )
+                                        break;
                         }
                 }
 	}
-	return( -1 );
 }
 
 int 	Conf_proc_by_name_in_conf( configuration *config, char *name, proc *p )
@@ -616,6 +749,7 @@ void    Conf_config_copy( configuration *src_conf, configuration *dst_conf)
     {
         memcpy( &dst_conf->allprocs[i], &src_conf->allprocs[i], sizeof( proc ) );
     }
+    memcpy( dst_conf->ip_hash, src_conf->ip_hash, sizeof( src_conf->ip_hash ) );
 
     for (i=0; i < src_conf->num_segments; i++ )
     {
@@ -642,24 +776,6 @@ void    Conf_config_copy( configuration *src_conf, configuration *dst_conf)
 #endif
 }
 
-static  int     Conf_proc_ref_by_id( int32u id, proc **p )
-{
-	int	i,j;
-
-	for ( i=0; i < Config->num_total_procs; i++ )
-	{
-                for ( j=0; j < Config->allprocs[i].num_if; j++)
-                {
-                        if ( Config->allprocs[i].ifc[j].ip == id )
-                        {
-                                *p = &Config->allprocs[i];
-                                return( i );
-                        }
-                }
-	}
-	return( -1 );
-}
-
 int     Conf_append_id_to_seg( segment *seg, int32u id)
 {
         proc *p;
@@ -944,6 +1060,86 @@ int     Conf_get_max_session_messages(void)
         return (MaxSessionMessages);
 }
 
+void    Conf_set_max_session_bytes(int max_bytes)
+{
+        if (max_bytes < 0) {
+            Alarmp(SPLOG_ERROR, CONF_SYS, "Conf_set_max_session_bytes: Attempt to set max_bytes to less then zero. Resetting to default value of %d\n", DEFAULT_MAX_SESSION_BYTES);
+            max_bytes = DEFAULT_MAX_SESSION_BYTES;
+        }
+        Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_max_session_bytes: Set Max Session Bytes to %d\n", max_bytes);
+        MaxSessionBytes = max_bytes;
+}
+
+int     Conf_get_max_session_bytes(void)
+{
+        return (MaxSessionBytes);
+}
+
+void    Conf_set_session_spill(int state)
+{
+        SessionSpill = ( state != 0 );
+        Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_session_spill: Set SessionSpill to %d\n", SessionSpill);
+}
+
+bool    Conf_get_session_spill(void)
+{
+        return (SessionSpill);
+}
+
+void    Conf_set_max_session_spill_bytes(int max_bytes)
+{
+        if (max_bytes <= 0) {
+            Alarmp(SPLOG_ERROR, CONF_SYS, "Conf_set_max_session_spill_bytes: Attempt to set max_bytes to %d. Resetting to default value of %d\n", max_bytes, DEFAULT_MAX_SESSION_SPILL_BYTES);
+            max_bytes = DEFAULT_MAX_SESSION_SPILL_BYTES;
+        }
+        Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_max_session_spill_bytes: Set Max Session Spill Bytes to %d\n", max_bytes);
+        MaxSessionSpillBytes = max_bytes;
+}
+
+int     Conf_get_max_session_spill_bytes(void)
+{
+        return (MaxSessionSpillBytes);
+}
+
+/* A byte count, optionally with a K, M or G suffix */
+static  int     conf_parse_bytes(const char *name, char *value)
+{
+        char    *end;
+        long    bytes, unit;
+
+        bytes = strtol(value, &end, 10);
+        switch (*end) {
+        case 'k': case 'K': unit = 1024; end++; break;
+        case 'm': case 'M': unit = 1024 * 1024; end++; break;
+        case 'g': case 'G': unit = 1024 * 1024 * 1024; end++; break;
+        default:            unit = 1; break;
+        }
+        if (end == value || *end != '\0' || bytes < 0 || bytes > INT_MAX / unit) {
+            Alarmp(SPLOG_FATAL, CONF_SYS, "conf_parse_bytes: %s = %s is not a size in bytes up to %d\n", name, value, INT_MAX);
+        }
+        return ((int) (bytes * unit));
+}
+
+static  void    Conf_set_max_session_bytes_string(char *value)
+{
+        Conf_set_max_session_bytes(conf_parse_bytes("MaxSessionBytes", value));
+}
+
+static  void    Conf_set_max_session_spill_bytes_string(char *value)
+{
+        Conf_set_max_session_spill_bytes(conf_parse_bytes("MaxSessionSpillBytes", value));
+}
+
+char    *Conf_get_session_spill_dir(void)
+{
+        return (SessionSpillDir != NULL ? SessionSpillDir : Conf_get_runtime_dir());
+}
+
+void    Conf_set_session_spill_dir(char *dir)
+{
+        set_param_if_valid(&SessionSpillDir, dir, "session spill directory", MAXPATHLEN);
+}
+
 char    *Conf_get_runtime_dir(void)
 {
         return (RuntimeDir != NULL ? RuntimeDir : SP_RUNTIME_DIR);
@@ -1189,3 +1385,123 @@ int Conf_get_lookup_timeout(void)
 { 
   return LookupTimeout; 
 }
+
+void Conf_set_link_offload(int state)
+{
+  LinkOffload = ( state != 0 );
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_link_offload: Set DataLinkOffload to %d\n", LinkOffload);
+}
+
+bool Conf_get_link_offload(void)
+{
+  return LinkOffload;
+}
+
+void Conf_set_adaptive_window(int state)
+{
+  AdaptiveWindow = ( state != 0 );
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_adaptive_window: Set AdaptiveWindow to %d\n", AdaptiveWindow);
+}
+
+bool Conf_get_adaptive_window(void)
+{
+  return AdaptiveWindow;
+}
+
+void Conf_set_max_seq_gap(int gap)
+{
+  if (gap < MIN_MAX_SEQ_GAP || gap > MAX_MAX_SEQ_GAP) {
+    Alarmp(SPLOG_FATAL, CONF_SYS, "Conf_set_max_seq_gap: MaxSeqGap (%d) must be between %d and %d!\n", gap, MIN_MAX_SEQ_GAP, MAX_MAX_SEQ_GAP);
+  }
+  MaxSeqGap = gap;
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_max_seq_gap: Set MaxSeqGap to %d\n", MaxSeqGap);
+}
+
+int Conf_get_max_seq_gap(void)
+{
+  return MaxSeqGap;
+}
+
+void Conf_set_selective_delivery(int state)
+{
+  SelectiveDelivery = ( state != 0 );
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_selective_delivery: Set SelectiveDelivery to %d\n", SelectiveDelivery);
+}
+
+bool Conf_get_selective_delivery(void)
+{
+  return SelectiveDelivery;
+}
+
+void Conf_set_fast_failure_detection(int state)
+{
+  FastFailureDetection = ( state != 0 );
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_fast_failure_detection: Set FastFailureDetection to %d\n", FastFailureDetection);
+}
+
+bool Conf_get_fast_failure_detection(void)
+{
+  return FastFailureDetection;
+}
+
+void Conf_set_token_loss_min_timeout(int timeout)
+{
+  if (timeout <= 0) {
+    Alarmp(SPLOG_FATAL, CONF_SYS, "Conf_set_token_loss_min_timeout: Non-positive timeout (%d) specified!\n", timeout);
+  }
+  TokenLossMinTimeout = timeout;
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_token_loss_min_timeout: Set TokenLossMinTimeout to %d\n", TokenLossMinTimeout);
+}
+
+int Conf_get_token_loss_min_timeout(void)
+{
+  return TokenLossMinTimeout;
+}
+
+void Conf_set_incremental_group_state(int state)
+{
+  IncrementalGroupState = ( state != 0 );
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_incremental_group_state: Set IncrementalGroupState to %d\n", IncrementalGroupState);
+}
+
+bool Conf_get_incremental_group_state(void)
+{
+  return IncrementalGroupState;
+}
+
+void Conf_set_compact_group_state(int state)
+{
+  CompactGroupState = ( state != 0 );
+  Alarmp(SPLOG_DEBUG, CONF_SYS, "Conf_set_compact_group_state: Set CompactGroupState to %d\n", CompactGroupState);
+}
+
+bool Conf_get_compact_group_state(void)
+{
+  return CompactGroupState;
+}
+
+bool Conf_set_named_param(char *name, int value)
+{
+  int i;
+
+  for (i = 0; i < (int) (sizeof(Conf_named_params) / sizeof(Conf_named_params[0])); i++) {
+    if (strcmp(name, Conf_named_params[i].name) == 0) {
+      Conf_named_params[i].set(value);
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+bool Conf_set_named_string_param(char *name, char *value)
+{
+  int i;
+
+  for (i = 0; i < (int) (sizeof(Conf_named_string_params) / sizeof(Conf_named_string_params[0])); i++) {
+    if (strcmp(name, Conf_named_string_params[i].name) == 0) {
+      Conf_named_string_params[i].set(value);
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
@@ -78,12 +78,23 @@ typedef struct dummy_segment{
 	proc    *procs[MAX_PROCS_SEGMENT];
 } segment;
 
+/* Open addressing table from interface address to index in allprocs.
+ * Its size is a power of 2 that keeps every interface of a full ring
+ * at most 5/8 loaded. */
+#define         CONF_IP_HASH_SIZE       2048
+
+typedef struct dummy_conf_ip_slot{
+        int32u  ip;
+        int16   proc_index;     /* -1 if the slot is free */
+} conf_ip_slot;
+
 typedef struct dummy_configuration{
         int32u  hash_code;
 	int	num_segments;
         int     num_total_procs;
         proc    *allprocs;
 	segment	segments[MAX_SEGMENTS];
+        conf_ip_slot ip_hash[CONF_IP_HASH_SIZE];  /* built from allprocs by Conf_build_ip_hash */
 } configuration;
 
 typedef enum dummy_port_reuse {
@@ -101,6 +112,9 @@ proc		Conf_my(void);
 int		Conf_proc_by_id( int32u id, proc *p );
 int		Conf_proc_by_name( char *name, proc *p );
 int		Conf_proc_by_id_in_conf( configuration *config, int32u id, proc *p );
+int		Conf_proc_ref_by_id( int32u id, proc **p );
+int		Conf_proc_ref_by_id_in_conf( configuration *config, int32u id, proc **p );
+void		Conf_build_ip_hash( configuration *config );
 int		Conf_proc_by_name_in_conf( configuration *config, char *name, proc *p );
 int		Conf_id_in_seg( segment *seg, int32u id );	
 int		Conf_id_in_conf( configuration *config, int32u id );	
@@ -142,6 +156,14 @@ int             Conf_get_link_protocol(void);
 void            Conf_set_link_protocol(int protocol);
 void            Conf_set_max_session_messages(int max_messages);
 int             Conf_get_max_session_messages(void);
+void            Conf_set_max_session_bytes(int max_bytes);
+int             Conf_get_max_session_bytes(void);
+void            Conf_set_session_spill(int state);
+bool            Conf_get_session_spill(void);
+void            Conf_set_max_session_spill_bytes(int max_bytes);
+int             Conf_get_max_session_spill_bytes(void);
+char            *Conf_get_session_spill_dir(void);
+void            Conf_set_session_spill_dir(char *dir);
 void		Conf_set_window(int window);
 int		Conf_get_window(void);
 void		Conf_set_personal_window(int pwindow);
@@ -172,5 +194,23 @@ void		Conf_set_form_timeout(int timeout);
 int		Conf_get_form_timeout(void);
 void		Conf_set_lookup_timeout(int timeout);
 int		Conf_get_lookup_timeout(void);
+void		Conf_set_link_offload(int state);
+bool		Conf_get_link_offload(void);
+void		Conf_set_adaptive_window(int state);
+bool		Conf_get_adaptive_window(void);
+void		Conf_set_max_seq_gap(int gap);
+int		Conf_get_max_seq_gap(void);
+void		Conf_set_selective_delivery(int state);
+bool		Conf_get_selective_delivery(void);
+void		Conf_set_fast_failure_detection(int state);
+bool		Conf_get_fast_failure_detection(void);
+void		Conf_set_token_loss_min_timeout(int timeout);
+int		Conf_get_token_loss_min_timeout(void);
+void		Conf_set_incremental_group_state(int state);
+bool		Conf_get_incremental_group_state(void);
+void		Conf_set_compact_group_state(int state);
+bool		Conf_get_compact_group_state(void);
+bool		Conf_set_named_param(char *name, int value);
+bool		Conf_set_named_string_param(char *name, char *value);
 
 #endif /* INC_CONFIGURATION */
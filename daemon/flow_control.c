@@ -40,45 +40,159 @@
 #include "prot_body.h"
 #include "status.h"
 #include "spu_alarm.h"
+#include "spu_events.h"
+
+/* Adaptive window control (AdaptiveWindow = on).
+ * The configured (or monitor set) windows are the starting point. Every
+ * token round in which this daemon used all it was allowed to send and the
+ * ring showed no loss, the global window grows by one packet; a round with
+ * retransmissions, or with Highest_seq running far ahead of Aru, cuts it by
+ * a quarter and then holds it for a few rounds so a single loss burst costs
+ * one cut. Growth also stops while the token round trip per packet carried
+ * is well above the best seen in this configuration, since a larger window
+ * then only adds queueing. The personal window keeps its
+ * configured ratio to the global one.
+ */
+#define	FC_ADAPT_MAX_SCALE	4	/* grow to at most 4x configured window */
+#define	FC_ADAPT_MIN_DIVISOR	8	/* shrink to at least 1/8 of it */
+#define	FC_ADAPT_HOLD_ROUNDS	8	/* rounds without growth after a cut */
+#define	FC_ADAPT_RTT_FACTOR	2	/* round time per packet this much above best holds growth */
 
 static	int16	Window;
 static	int16	Personal_window;
 static  int16   Accelerated_window;
 static  bool    Accelerated_ring;
 
+static	bool	Adaptive;
+static	int	Cur_window;
+static	int	Cur_personal_window;
+static	int	Hold_rounds;
+static	sp_time	Last_round_time;
+static	int	Last_flow_control;
+static	long	Min_pkt_nsec;
+static	long	Avg_pkt_nsec;
+
+static	void	FC_adapt_reset( void );
+static	void	FC_adapt_set( int window );
+
 void	FC_init( )
 {
 	Window = Conf_get_window();
 	Personal_window = Conf_get_personal_window();
 	Accelerated_ring = Conf_get_accelerated_ring();
 	Accelerated_window = Conf_get_accelerated_window();
+	Adaptive = Conf_get_adaptive_window();
 
-	GlobalStatus.window = Window;
-	GlobalStatus.personal_window = Personal_window;
 	GlobalStatus.accelerated_ring = Accelerated_ring;
 	GlobalStatus.accelerated_window = Accelerated_window;
+	GlobalStatus.adaptive_window = Adaptive;
+	FC_adapt_reset();
 }
 
 void	FC_new_configuration( )
 {
 	Last_num_retrans = 0;
 	Last_num_sent    = 0;
+	FC_adapt_reset();
+}
+
+static	void	FC_adapt_reset( void )
+{
+	Hold_rounds = 0;
+	Last_round_time.sec  = 0;
+	Last_round_time.usec = 0;
+	Last_flow_control = 0;
+	Min_pkt_nsec = 0;
+	Avg_pkt_nsec = 0;
+	FC_adapt_set( Window );
+}
+
+static	void	FC_adapt_set( int window )
+{
+	Cur_window = window;
+	if( window == Window ) {
+		Cur_personal_window = Personal_window;
+	} else {
+		Cur_personal_window = (int) ( (long) Personal_window * window / Window );
+		if( Cur_personal_window < 1 ) Cur_personal_window = 1;
+		if( Cur_personal_window > Cur_window ) Cur_personal_window = Cur_window;
+	}
+
+	GlobalStatus.window = Cur_window;
+	GlobalStatus.personal_window = Cur_personal_window;
 }
 
 int	FC_allowed( int flow_control, int num_retrans )
 {
 	int	allowed;
 
+	Last_flow_control = flow_control;
 	if( Memb_state() == EVS ) return( 0 );
-	if( Highest_seq > (Aru + MAX_SEQ_GAP) ) return( 0 );
-	allowed = Window + Personal_window - flow_control;
+	if( Highest_seq > (Aru + Conf_get_max_seq_gap()) ) return( 0 );
+	allowed = Cur_window + Cur_personal_window - flow_control;
 	if (allowed < 0) allowed = 0;
-	if (allowed > Window) allowed = Window;
-	if (allowed > Personal_window) allowed = Personal_window;
+	if (allowed > Cur_window) allowed = Cur_window;
+	if (allowed > Cur_personal_window) allowed = Cur_personal_window;
 
 	return(allowed);
 }
 
+void	FC_token_round( int rtr_len, int num_retrans, int num_allowed, int num_sent )
+{
+	sp_time	now;
+	long	round_usec, pkt_nsec;
+	int	min_window, max_window;
+	int	max_gap;
+	int	new_window;
+	bool	loss;
+
+	if( !Adaptive || Memb_state() == EVS ) return;
+
+	now = E_get_time();
+	if( ( Last_round_time.sec != 0 || Last_round_time.usec != 0 ) && Last_flow_control > 0 )
+	{
+		round_usec = ( now.sec - Last_round_time.sec ) * 1000000L + ( now.usec - Last_round_time.usec );
+		pkt_nsec = round_usec * 1000 / Last_flow_control;
+		if( Avg_pkt_nsec == 0 ) Avg_pkt_nsec = pkt_nsec;
+		else Avg_pkt_nsec = ( 7 * Avg_pkt_nsec + pkt_nsec ) / 8;
+		if( Min_pkt_nsec == 0 || Avg_pkt_nsec < Min_pkt_nsec ) Min_pkt_nsec = Avg_pkt_nsec;
+	}
+	Last_round_time = now;
+
+	max_gap = Conf_get_max_seq_gap();
+	max_window = Window * FC_ADAPT_MAX_SCALE;
+	if( max_window > max_gap ) max_window = max_gap;
+	min_window = Window / FC_ADAPT_MIN_DIVISOR;
+	if( min_window < 1 ) min_window = 1;
+
+	loss = ( rtr_len > 0 || num_retrans > 0 || Highest_seq > Aru + max_gap / 2 );
+	new_window = Cur_window;
+
+	if( loss )
+	{
+		GlobalStatus.fc_loss_rounds++;
+		if( Hold_rounds == 0 )
+		{
+			new_window = Cur_window - Cur_window / 4;
+			if( new_window < min_window ) new_window = min_window;
+			Hold_rounds = FC_ADAPT_HOLD_ROUNDS;
+		}
+	} else if( Hold_rounds > 0 ) {
+		Hold_rounds--;
+	} else if( num_allowed > 0 && num_sent >= num_allowed && Cur_window < max_window &&
+		   Avg_pkt_nsec <= FC_ADAPT_RTT_FACTOR * Min_pkt_nsec ) {
+		new_window = Cur_window + 1;
+	}
+
+	if( new_window != Cur_window )
+	{
+		GlobalStatus.fc_adjustments++;
+		Alarmp( SPLOG_DEBUG, FLOW_CONTROL, "FC_token_round: window %d -> %d (loss %d, %ld nsec/packet, best %ld)\n",
+			Cur_window, new_window, loss, Avg_pkt_nsec, Min_pkt_nsec );
+		FC_adapt_set( new_window );
+	}
+}
+
 bool    FC_accelerated_ring(void)
 {
 	return Accelerated_ring;
@@ -86,6 +200,7 @@ bool    FC_accelerated_ring(void)
 
 int     FC_accelerated_window(void)
 {
+        if( Accelerated_window > Cur_personal_window ) return Cur_personal_window;
         return Accelerated_window;
 }
 
@@ -94,7 +209,7 @@ void	FC_handle_message( sys_scatter *scat )
 
         int16		(*cur_fc_buf)[2];
 	packet_header	*pack_ptr;
-	proc		dummy_proc;
+	proc		*dummy_proc;
 	int		my_index;
 	int16		temp_window,temp_personal_window, temp_accelerated_window;
         configuration   *Cn;
@@ -115,7 +230,7 @@ void	FC_handle_message( sys_scatter *scat )
 	}
 	cur_fc_buf = (int16 (*)[2])scat->elements[1].buf;
 
-	my_index = Conf_proc_by_id( Conf_my().id, &dummy_proc );
+	my_index = Conf_proc_ref_by_id( Conf_my().id, &dummy_proc );
 
 	if( Same_endian( pack_ptr->type ) ) {
 		temp_window = cur_fc_buf[Conf_num_procs( Cn )][0];
@@ -130,9 +245,8 @@ void	FC_handle_message( sys_scatter *scat )
 	if( temp_personal_window != -1 ) Personal_window = temp_personal_window;
 	if( temp_accelerated_window != -1) Accelerated_window = temp_accelerated_window;
 
-	GlobalStatus.window = Window;
-	GlobalStatus.personal_window = Personal_window;
 	GlobalStatus.accelerated_window = Accelerated_window;
+	FC_adapt_reset();
 	Alarm( FLOW_CONTROL, 
 		"FC_handle_message: Got monitor mess, Window %d Personal %d Accelerated %d\n", 
 	        Window, Personal_window, Accelerated_window );
@@ -42,6 +42,7 @@
 void	FC_init( );
 void	FC_new_configuration( );
 int	FC_allowed( int flow_control, int num_retrans );
+void	FC_token_round( int rtr_len, int num_retrans, int num_allowed, int num_sent );
 bool    FC_accelerated_ring(void);
 int     FC_accelerated_window(void);
 void	FC_handle_message( sys_scatter *scat );
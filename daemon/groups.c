@@ -36,6 +36,7 @@
 #include "arch.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <assert.h>
 
 #include "spread_params.h"
@@ -54,6 +55,8 @@
 #include "queues.h"
 #endif
 #include "message.h"
+#include "stdutil/stdutil.h"
+#include "stdutil/stdhash.h"
 
 #ifndef NULL
 #define		NULL 	0
@@ -71,8 +74,12 @@
 /* Flag values - working with a pointer to char, set it 0x01 or test if its 0x01 */
 #define         Set_first_message( cp ) ( (*cp) = 0x01  )
 #define         Set_later_message( cp ) ( (*cp) = 0x00  )
-#define         Is_first_message( cp )  ( (*cp) == 0x01 )
-#define         Is_later_message( cp )  ( (*cp) == 0x00 )
+#define         Is_first_message( cp )  ( ( (*cp) & 0x0f ) == 0x01 )
+#define         Is_later_message( cp )  ( ( (*cp) & 0x0f ) == 0x00 )
+#define         Set_compact_message( cp ) ( (*cp) |= 0x10 )
+#define         Is_compact_message( cp )  ( (*cp) & 0x10 )
+#define         Set_digest_message( cp ) ( (*cp) = 0x02 )
+#define         Is_digest_message( cp )  ( (*cp) == 0x02 )
 
 /* IP should be a 32-bit integer, and
  * STR should be a character array of size at least 16. */
@@ -103,6 +110,23 @@ typedef struct dummy_groups_message_link {
         struct dummy_groups_message_link  *next;
 } groups_message_link;
 
+/* What the GroupsList holds for one daemon: for each of its groups, in
+ * GroupsList order, the group name, the group id as three 4 byte big endian
+ * integers, a 2 byte big endian member count and the member names.  Daemons
+ * compare these by length and two hashes, each the sum of the hashes of the
+ * daemon's part of every group (G_hash_daemon). */
+typedef struct dummy_contribution {
+        int32   proc_id;
+        int32u  bytes;
+        int32u  hash_oaat;
+        int32u  hash_sfh;
+        int     matches;        /* digests from outside my synced set holding this copy */
+        int     size;
+        char   *buf;
+} contribution;
+
+#define CONTRIBUTION_DIGEST_SIZE ( sizeof(int32) + 3 * sizeof(int32u) )
+
 char *printgroup(void *vgrp) {
   group *grp = (group *)vgrp;
   return grp->name;
@@ -119,6 +143,7 @@ static	char		Mess_buf[MAX_MESSAGE_BODY_LEN];
 
 static  groups_buf_link        *Groups_bufs;
 static  int                     Groups_bufs_fresh;
+static  int                     Groups_bufs_compact;
 static  int                     Num_mess_gathered;
 static  int                     Num_daemons_gathered;
 static  groups_message_link     Gathered; /* Groups messages */
@@ -126,11 +151,29 @@ static  groups_message_link     Gathered; /* Groups messages */
 static  int             Groups_control_down_queue;
 
 static  stdskl          GroupsList;   /* (group*) -> nil */
+static  stdhash         GroupsIndex;  /* (group*) -> nil: the GroupsList hashed by name, for G_get_group */
 /* TODO: might want to add a "secondary" index of daemon IDs -> groups for potentially faster performance */
 /* TODO: might want to add a "secondary" index of member IDs -> groups for potentially faster performance */
 static  synced_set      MySyncedSet;
 static  membership_id   unknown_memb_id = { -1, -1 }; /* See explanation above. */
 
+/* IncrementalGroupState: the last state held for daemons since partitioned
+ * away, and the digest round that lets a synced set skip sending what every
+ * other daemon already holds. */
+static  contribution    Departed[MAX_PROCS_RING];
+static  int             Num_departed;
+static  contribution    Set_contribs[MAX_PROCS_RING];  /* my synced set, hashes only */
+static  int             Num_set_contribs;
+static  int             Num_digests_gathered;
+static  int32           Cached_ids[MAX_PROCS_RING];    /* my synced set's daemons sent as digests */
+static  int             Num_cached;
+static  contribution    Chunk;                         /* scratch for G_hash_daemon */
+
+/* CompactGroupState: the string table of the GROUPS message being built */
+static  stdhash         Compact_names;  /* (char*) -> (int32u) index in Compact_table */
+static  char            Compact_table[GROUPS_BUF_SIZE];
+static  int32u          Compact_offsets[GROUPS_BUF_SIZE / 2];
+
 /* Unused function
  *static	int		G_id_is_equal( group_id g1, group_id g2 );
  */
@@ -185,11 +228,42 @@ static  int             G_compare_memb_ids( const membership_id *mid1,
 
 static  void            G_shift_to_GOP( void );
 
+static  group          *G_new_group( char *group_name, group_id *grp_id );
+static  bool            G_is_departing_daemon( daemon_members *dmn );
+static  contribution   *G_find_contribution( contribution *contribs, int num_contribs, int32 proc_id );
+static  void            G_contribution_append( contribution *c, char *data, int len );
+static  void            G_free_contribution( contribution *c );
+static  void            G_serialize_daemon( contribution *c, group *grp, daemon_members *dmn );
+static  void            G_hash_daemon( group *grp, daemon_members *dmn );
+static  void            G_collect_contributions( contribution *contribs, int *num_contribs, bool departing );
+static  void            G_cache_departed_daemons( void );
+static  void            G_forget_departed( synced_set *sset );
+static  void            G_restore_departed( int32 proc_id );
+static  bool            G_is_cached_daemon( int32 proc_id );
+static  bool            G_has_sent_daemon( group *grp, stdit *dit );
+static  int             G_queue_groups_buf( char buf[], int bytes, int32 type );
+static  void            G_send_digest( void );
+static  void            G_handle_digest( message_link *mess_link, int32 sender_id );
+static  void            G_digests_complete( void );
+
+static  int             G_put_varint( char *buf, int32u value );
+static  int             G_get_varint( char *buf, int32u *value );
+static  int             G_build_compact_groups_buf( char buf[], int num_bytes, stdit *git, stdit *dit, int first_time );
+static  int             G_compact_mess_to_groups( message_header *head_ptr, int num_bytes, int total_bytes, synced_set *sset );
+
 static int G_compare_nameptr(const void *a, const void *b)
 {
   return strncmp(*(const char**) a, *(const char**) b, MAX_GROUP_NAME);
 }
 
+static stdhcode G_hash_nameptr(const void *a)
+{
+  const char *name = *(const char**) a;
+  const char *end  = memchr(name, 0, MAX_GROUP_NAME);
+
+  return stdhcode_sfh(name, (end != NULL ? end - name : MAX_GROUP_NAME));
+}
+
 static int G_compare_proc_ids_by_conf(const void *a, const void *b)
 {
     return G_compare_proc_ids_by_conf_internal( &Cn_active, a, b);
@@ -207,12 +281,12 @@ static int G_compare_proc_ids_by_conf_interim(const void *a, const void *b)
  */
 static int G_compare_proc_ids_by_conf_internal( configuration *config, const void *a, const void *b)
 {
-  proc dummy_proc;
+  proc *dummy_proc;
   const int32u aip = **(const int32u**)a;
   const int32u bip = **(const int32u**)b;
 
-  int  ia = Conf_proc_by_id_in_conf( config, aip, &dummy_proc );
-  int  ib = Conf_proc_by_id_in_conf( config, bip, &dummy_proc );
+  int  ia = Conf_proc_ref_by_id_in_conf( config, aip, &dummy_proc );
+  int  ib = Conf_proc_ref_by_id_in_conf( config, bip, &dummy_proc );
 
   /* common case */
   if (ia > -1 && ib > -1) {
@@ -309,6 +383,10 @@ void	G_init()
 	if (ret != 0) {
                 Alarmp( SPLOG_FATAL, GROUPS, "G_init: Failure to Initialize GroupsList\n");
 	}
+	ret = stdhash_construct(&GroupsIndex, sizeof(group*), 0, G_compare_nameptr, G_hash_nameptr, 0);
+	if (ret != 0) {
+                Alarmp( SPLOG_FATAL, GROUPS, "G_init: Failure to Initialize GroupsIndex\n");
+	}
         ret = Mem_init_object(GROUP, "group", sizeof(group), 1000, 0);
         if (ret < 0)
         {
@@ -343,11 +421,21 @@ void	G_init()
 
         Groups_bufs          = NULL;
         Groups_bufs_fresh    = 0;
+        Groups_bufs_compact  = 0;
         Num_mess_gathered    = 0;
         Num_daemons_gathered = 0;
         Gathered.complete    = 0;
 	Gathered.next        = NULL;
 
+        Num_departed         = 0;
+        Num_set_contribs     = 0;
+        Num_digests_gathered = 0;
+        Num_cached           = 0;
+
+        if (stdhash_construct(&Compact_names, sizeof(char*), sizeof(int32u), G_compare_nameptr, G_hash_nameptr, 0) != 0) {
+          Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+        }
+
         Conf_config_copy( Conf_ref(), &Cn_active );
 
         G_shift_to_GOP();
@@ -620,7 +708,6 @@ void	G_handle_reg_memb( configuration reg_memb, membership_id reg_memb_id )
                          *	Shift to GGATHER
                          */
 
-		        
 		        for (stdskl_begin(&GroupsList, &it); !stdskl_is_end(&GroupsList, &it); ) 
 		        {
 				grp = *(group**) stdskl_it_key(&it);
@@ -656,8 +743,13 @@ void	G_handle_reg_memb( configuration reg_memb, membership_id reg_memb_id )
                          * No daemon's data about members for a given group is ever split across
                          * multiple messages.  As an optimization, only the last message is sent
                          * AGREED, and all previous messages are sent RELIABLE.  G_handle_groups depends
-                         * on this to determine when it has all the messages it is waiting for. */
-                        if( Is_synced_set_leader(My.id) ) {
+                         * on this to determine when it has all the messages it is waiting for.
+                         * With IncrementalGroupState every daemon first sends a digest of the
+                         * state it kept for departed daemons; the GROUPS messages follow once
+                         * all digests are in (G_digests_complete). */
+                        if( Conf_get_incremental_group_state() ) {
+                                G_send_digest();
+                        } else if( Is_synced_set_leader(My.id) ) {
                                 G_build_new_groups_bufs();
                                 Groups_bufs_fresh = 1;
                                 ret = G_send_groups_messages();
@@ -730,6 +822,9 @@ void	G_handle_reg_memb( configuration reg_memb, membership_id reg_memb_id )
                  * so as to not deliver potentially inconsistent groups messages
                  * if we completed the old state exchange.  Now, prepare for the next one.
                  */
+                if( Conf_get_incremental_group_state() )
+                        G_cache_departed_daemons();
+
 		for (stdskl_begin(&GroupsList, &it); !stdskl_is_end(&GroupsList, &it); ) 
 		{
 		        grp = *(group**) stdskl_it_key(&it);
@@ -758,9 +853,13 @@ void	G_handle_reg_memb( configuration reg_memb, membership_id reg_memb_id )
                 Num_mess_gathered    = 0;
                 Num_daemons_gathered = 0;
 
-                if( Is_synced_set_leader(My.id) ) {
+                if( Conf_get_incremental_group_state() ) {
+                    /* What is sent as digests depends on this membership, so rebuild later */
+                    G_discard_groups_bufs();
+                    G_send_digest();
+                } else if( Is_synced_set_leader(My.id) ) {
                     /*  Stamp own Groups message in buffer with current membership id */
-                    if( Groups_bufs_fresh ) {
+                    if( Groups_bufs_fresh && Groups_bufs_compact == Memb_compact_groups() ) {
                         G_stamp_groups_bufs();
                     } else {
                         G_discard_groups_bufs();
@@ -808,6 +907,10 @@ void	G_handle_trans_memb( configuration trans_memb, membership_id trans_memb_id
 		Trans_memb    = trans_memb;
                 Trans_memb_id = trans_memb_id;
 
+                /* Kept before the group ids change below, as the departed daemons hold them */
+                if( Conf_get_incremental_group_state() )
+                        G_cache_departed_daemons();
+
 		for (stdskl_begin(&GroupsList, &git); !stdskl_is_end(&GroupsList, &git); ) 
 		{
 		        grp = *(group**) stdskl_it_key(&git);
@@ -918,6 +1021,7 @@ void	G_handle_trans_memb( configuration trans_memb, membership_id trans_memb_id
 void	G_handle_join( char *private_group_name, char *group_name )
 {
 	group		*grp, *new_grp;
+	group_id	 new_grp_id;
         daemon_members  *dmn, *new_dmn;
 	member		*mbr, *new_mbr;
 	char		proc_name[MAX_PROC_NAME];
@@ -974,40 +1078,20 @@ void	G_handle_join( char *private_group_name, char *group_name )
 		grp = G_get_group( group_name );
 		if( grp == NULL )
 		{
-			new_grp = new( GROUP );
-			memset( new_grp->name, 0, MAX_GROUP_NAME );
-			strcpy( new_grp->name, group_name );
-
-			if (stdskl_construct(&new_grp->DaemonsList, sizeof(daemon_members*), 0, G_compare_proc_ids_by_conf) != 0) {
-			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
-			}
-
-			if (stdarr_construct(&new_grp->mboxes, sizeof(mailbox), 0) != 0) {  
-			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
-			}
-
                         /* NOTE: Older versions of groups do mark a new group as changed if it's
                          * created in GTRANS.  This is only needed if the joiner is partitioned
                          * from us [handled below]. */
-                        new_grp->changed = FALSE;
                         if( Gstate == GOP) {
-                                new_grp->grp_id.memb_id = Reg_memb_id;
+                                new_grp_id.memb_id = Reg_memb_id;
                                 
                         } else { /* Gtrans */
-                                new_grp->grp_id.memb_id = Trans_memb_id;
+                                new_grp_id.memb_id = Trans_memb_id;
                         }
-                        new_grp->grp_id.index = 0; /* This will be incremented to 1, below. */
+                        new_grp_id.index = 0; /* This will be incremented to 1, below. */
+			new_grp = G_new_group( group_name, &new_grp_id );
                         Alarmp( SPLOG_DEBUG, GROUPS, "G_handle_join: New group added with group id:\n" );
                         G_print_group_id( SPLOG_DEBUG, new_grp->grp_id, "G_handle_join" );
 
-			new_grp->num_members = 0;
-
-			if (stdskl_put(&GroupsList, NULL, &new_grp, NULL, STDFALSE) != 0) {
-			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
-			}
-			
-			Num_groups++;
-			GlobalStatus.num_groups = Num_groups;
 			grp = new_grp;
                 }
 
@@ -1015,6 +1099,7 @@ void	G_handle_join( char *private_group_name, char *group_name )
                 if( dmn == NULL ) {
                         new_dmn = new( DAEMON_MEMBERS );
                         new_dmn->proc_id = new_p.id;
+                        new_dmn->hashed  = FALSE;
 
 			if (stdskl_construct(&new_dmn->MembersList, sizeof(member*), 0, G_compare_nameptr) != 0) {
 			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
@@ -1049,6 +1134,7 @@ void	G_handle_join( char *private_group_name, char *group_name )
 		if (stdskl_put(&dmn->MembersList, NULL, &new_mbr, NULL, STDFALSE) != 0) {
 		  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
 		}
+                dmn->hashed = FALSE;
 
 		grp->num_members++;
                 grp->grp_id.index++;
@@ -1189,6 +1275,7 @@ void	G_handle_leave( char *private_group_name, char *group_name )
 		}
 
 		stdskl_erase(&dmn->MembersList, &it);
+                dmn->hashed = FALSE;
 
 		dispose(mbr);
 		grp->num_members--;
@@ -1306,6 +1393,7 @@ void	G_handle_kill( char *private_group_name )
 			}			
 			
 			stdskl_erase(&dmn->MembersList, &tit);
+                        dmn->hashed = FALSE;
 
 			dispose(mbr);
                         grp->num_members--;
@@ -1609,6 +1697,14 @@ void	G_handle_groups( message_link *mess_link )
                         return;
                 }
 
+                /* Digests are counted apart from the GROUPS messages that carry state. */
+                if( Is_digest_message( &memb_id_ptr[sizeof( membership_id )] ) )
+                {
+                        G_handle_digest( mess_link, p.id );
+                        Message_Dec_Refcount(msg);
+                        return;
+                }
+
                 /* This is a message from my rep -- don't process it. */
                 if( Is_synced_set_leader(p.id) )
                 {
@@ -1765,6 +1861,8 @@ static	void		G_compute_and_notify()
         Gathered.complete    = 0;
         Num_mess_gathered    = 0;
         Num_daemons_gathered = 0;
+        Num_digests_gathered = 0;
+        Num_cached           = 0;
 
         /* We're going back to GOP... destroy our groups messages. */
         G_discard_groups_bufs();
@@ -1782,13 +1880,50 @@ static	void		G_compute_and_notify()
  *}
  */
 
+/* Looks the name up in GroupsIndex rather than walking the GroupsList:
+ * this is on the path of every message sent to groups. */
 static	group		*G_get_group( char *group_name )
 {
         stdit it;
 
-	stdskl_find(&GroupsList, &it, &group_name);
+	stdhash_find(&GroupsIndex, &it, &group_name);
+
+	return (!stdhash_is_end(&GroupsIndex, &it) ? *(group**) stdhash_it_key(&it) : NULL);
+}
+
+/* Creates an empty group and inserts it into the GroupsList. */
+static  group  *G_new_group( char *group_name, group_id *grp_id )
+{
+        group   *grp;
+
+        grp = new( GROUP );
+        memset( grp->name, 0, MAX_GROUP_NAME );
+        strcpy( grp->name, group_name );
+
+        if (stdskl_construct(&grp->DaemonsList, sizeof(daemon_members*), 0, G_compare_proc_ids_by_conf) != 0) {
+          Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+        }
+
+        if (stdarr_construct(&grp->mboxes, sizeof(mailbox), 0) != 0) {
+          Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+        }
+
+        grp->changed     = FALSE;
+        grp->num_members = 0;
+        grp->grp_id      = *grp_id;
+
+        if (stdskl_put(&GroupsList, NULL, &grp, NULL, STDFALSE) != 0) {
+          Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+        }
+
+        if (stdhash_put(&GroupsIndex, NULL, &grp, NULL) != 0) {
+          Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+        }
 
-	return (!stdskl_is_end(&GroupsList, &it) ? *(group**) stdskl_it_key(&it) : NULL);
+        Num_groups++;
+        GlobalStatus.num_groups = Num_groups;
+
+        return( grp );
 }
 
 static  daemon_members  *G_get_daemon( group *grp, int32u proc_id ) 
@@ -2089,6 +2224,7 @@ static	int  G_build_groups_buf( char buf[], stdit *git, stdit *dit, int first_ti
         int                  couldnt_fit_daemon;
 	stdit                mit;
         int16u               send_group_changed;
+        int                  ret;
 
         /* A GROUPS message looks like this:
          * (Representative's name is in header, so we can get his proc id)
@@ -2099,6 +2235,10 @@ static	int  G_build_groups_buf( char buf[], stdit *git, stdit *dit, int first_ti
          * if flag is 1
          *   size of synced set   (int32u)
          *   proc ids of synced set represented by this daemon (int32*size)
+         *   with IncrementalGroupState:
+         *     number of daemons sent as digests (int32u)
+         *     their proc ids (int32*number) -- receivers restore these daemons
+         *     from what they kept and the groups below leave them out
          * For each group:
          *   group name (repeated for each message it appears in) (MAX_GROUP_NAME)
          *   group_id at the representative
@@ -2114,6 +2254,9 @@ static	int  G_build_groups_buf( char buf[], stdit *git, stdit *dit, int first_ti
          *     number of local members at daemon (int16u)
          *     For each local member at daemon
          *        member's private group name (MAX_GROUP_NAME)
+         * When every daemon of the membership runs CompactGroupState, the flag
+         * also has bit 0x10 set and the groups are laid out as described in
+         * G_build_compact_groups_buf.
          */
 
         num_bytes   = 0;
@@ -2136,10 +2279,28 @@ static	int  G_build_groups_buf( char buf[], stdit *git, stdit *dit, int first_ti
                 synced_set_procs_ptr  = &buf[num_bytes];
                 num_bytes            += MySyncedSet.size * sizeof(int32);
                 memcpy( synced_set_procs_ptr, &MySyncedSet.proc_ids, MySyncedSet.size*sizeof(int32) );
+                if( Conf_get_incremental_group_state() )
+                {
+                        memcpy( &buf[num_bytes], &Num_cached, sizeof(int32u) );
+                        num_bytes += sizeof(int32u);
+                        memcpy( &buf[num_bytes], Cached_ids, Num_cached * sizeof(int32) );
+                        num_bytes += Num_cached * sizeof(int32);
+                }
 		
 		stdskl_begin(&GroupsList, git);
 	}
 
+        /* The compact encoding falls back to this one for a message it cannot fill */
+        if( Groups_bufs_compact )
+        {
+                ret = G_build_compact_groups_buf( buf, num_bytes, git, dit, first_time );
+                if( ret > 0 )
+                {
+                        Set_compact_message( flag_ptr );
+                        return( ret );
+                }
+        }
+
         /* Resume where we left off in the GroupsList */
         couldnt_fit_daemon = 0;
         while (!stdskl_is_end(&GroupsList, git))
@@ -2150,6 +2311,18 @@ static	int  G_build_groups_buf( char buf[], stdit *git, stdit *dit, int first_ti
 		  stdskl_begin(&grp->DaemonsList, dit);
 		}
 
+                /* Skip groups left with only daemons the receivers restore themselves,
+                 * unless the change has to reach them */
+                if( Num_cached > 0 && !grp->changed && !G_has_sent_daemon( grp, dit ) )
+                {
+		        stdskl_it_next(git);
+		        if (!stdskl_is_end(&GroupsList, git)) {
+		          grp = *(group**) stdskl_it_key(git);
+		          stdskl_begin(&grp->DaemonsList, dit);
+		        }
+                        continue;
+                }
+
                 /* To have information about this group, we need to be able to fit
                  * its name, ID, and the number of daemons it has in this message. */
                 size_needed = GROUPS_BUF_GROUP_INFO_SIZE + Message_get_data_header_size();
@@ -2172,6 +2345,8 @@ static	int  G_build_groups_buf( char buf[], stdit *git, stdit *dit, int first_ti
 		for (; !stdskl_is_end(&grp->DaemonsList, dit); stdskl_it_next(dit))
 		{
 		        dmn = *(daemon_members**) stdskl_it_key(dit);
+                        if( Num_cached > 0 && G_is_cached_daemon( dmn->proc_id ) )
+                                continue;
                         /* To store this daemon's information about the current group,
                          * we need to be able to store its proc_id, memb_id, number of
                          * local members, and the private group names of its local members. */
@@ -2225,12 +2400,213 @@ static	int  G_build_groups_buf( char buf[], stdit *git, stdit *dit, int first_ti
         return( num_bytes );
 }
 
+static  int  G_put_varint( char *buf, int32u value )
+{
+        int     i = 0;
+
+        while( value >= 0x80 )
+        {
+                buf[i++] = (char) ( ( value & 0x7f ) | 0x80 );
+                value  >>= 7;
+        }
+        buf[i++] = (char) value;
+        return( i );
+}
+
+static  int  G_get_varint( char *buf, int32u *value )
+{
+        int     i = 0;
+        int     shift = 0;
+
+        *value = 0;
+        do {
+                *value |= (int32u) ( buf[i] & 0x7f ) << shift;
+                shift  += 7;
+        } while( ( buf[i++] & 0x80 ) && i < GROUPS_VARINT_MAX_SIZE );
+        return( i );
+}
+
+/* Fills buf, past the preamble G_build_groups_buf wrote, with the compact
+ * encoding of the groups.  Names are written without padding, member names
+ * once per message in a string table that the daemons refer to by index,
+ * daemons by their place in the synced set, and counts as varints (7 bits
+ * per byte, low bits first):
+ *   offset of the string table from the start of buf (int32u)
+ *   For each group (in GroupsList order, so neighbours share prefixes):
+ *     length of the prefix shared with the previous group's name (varint)
+ *     length of the rest of the name (varint), rest of the name
+ *     flags (char): 0x01 changed, 0x02 same memb_id as the previous group
+ *     memb_id of the group id at the representative, unless flag 0x02 (membership_id)
+ *     index of the group id (varint)
+ *     number of daemons for this group (in this message) (char)
+ *     For each daemon:
+ *       index in the synced set (varint) -- the size of the synced set is
+ *          followed by the daemon's proc id (int32) for a daemon outside it
+ *       number of local members at daemon (varint)
+ *       For each local member: index in the string table (varint)
+ *   string table: number of names (varint), then length (varint) and name of each
+ * Returns -1 when the next daemon does not fit a message by itself; that
+ * message is then sent in the fixed size encoding. */
+static  int  G_build_compact_groups_buf( char buf[], int num_bytes, stdit *git, stdit *dit, int first_time )
+{
+        group           *grp;
+        daemon_members  *dmn;
+        member          *mbr;
+        char            *table_offset_ptr;
+        char            *num_dmns_ptr;
+        unsigned char    num_dmns, flags;
+        membership_id    last_memb_id;
+        int32u           table_offset, num_names, index, len;
+        int              table_bytes, capacity, size_needed;
+        int              have_last_memb_id, couldnt_fit_daemon, num_entries, i;
+        char            *last_name;
+        int32u           prefix;
+        stdit            mit, hit;
+
+        capacity = GROUPS_BUF_SIZE - Message_get_data_header_size() - GROUPS_VARINT_MAX_SIZE;
+
+        table_offset_ptr = &buf[num_bytes];
+        num_bytes       += sizeof(int32u);
+
+        stdhash_clear( &Compact_names );
+        num_names          = 0;
+        table_bytes        = 0;
+        have_last_memb_id  = 0;
+        couldnt_fit_daemon = 0;
+        num_entries        = 0;
+        last_name          = NULL;
+        while (!stdskl_is_end(&GroupsList, git))
+        {
+	        grp = *(group**) stdskl_it_key(git);
+
+		if (first_time) {
+		  stdskl_begin(&grp->DaemonsList, dit);
+		}
+
+                if( Num_cached > 0 && !grp->changed && !G_has_sent_daemon( grp, dit ) )
+                {
+		        stdskl_it_next(git);
+		        if (!stdskl_is_end(&GroupsList, git)) {
+		          grp = *(group**) stdskl_it_key(git);
+		          stdskl_begin(&grp->DaemonsList, dit);
+		        }
+                        continue;
+                }
+
+                if( num_bytes + table_bytes + (int) GROUPS_COMPACT_GROUP_INFO_SIZE > capacity ) break;
+
+                len    = strlen( grp->name );
+                prefix = 0;
+                if( last_name != NULL )
+                        while( prefix < len && last_name[prefix] == grp->name[prefix] )
+                                prefix++;
+                last_name  = grp->name;
+                num_bytes += G_put_varint( &buf[num_bytes], prefix );
+                num_bytes += G_put_varint( &buf[num_bytes], len - prefix );
+                memcpy( &buf[num_bytes], &grp->name[prefix], len - prefix );
+                num_bytes += len - prefix;
+
+                flags = 0;
+                if( grp->changed )
+                        flags |= 0x01;
+                if( have_last_memb_id && Memb_is_equal( last_memb_id, grp->grp_id.memb_id ) )
+                        flags |= 0x02;
+                buf[num_bytes++] = (char) flags;
+                if( !( flags & 0x02 ) )
+                {
+                        memcpy( &buf[num_bytes], &grp->grp_id.memb_id, sizeof(membership_id) );
+                        num_bytes        += sizeof(membership_id);
+                        last_memb_id      = grp->grp_id.memb_id;
+                        have_last_memb_id = 1;
+                }
+                num_bytes += G_put_varint( &buf[num_bytes], grp->grp_id.index );
+
+                num_dmns_ptr = &buf[num_bytes++];
+                num_dmns     = 0;
+
+		for (; !stdskl_is_end(&grp->DaemonsList, dit); stdskl_it_next(dit))
+		{
+		        dmn = *(daemon_members**) stdskl_it_key(dit);
+                        if( Num_cached > 0 && G_is_cached_daemon( dmn->proc_id ) )
+                                continue;
+
+                        /* What this daemon takes, the names it adds to the table included */
+                        size_needed = GROUPS_COMPACT_DAEMON_INFO_SIZE;
+			for (stdskl_begin(&dmn->MembersList, &mit); !stdskl_is_end(&dmn->MembersList, &mit); stdskl_it_next(&mit))
+			{
+			        mbr = *(member**) stdskl_it_key(&mit);
+                                size_needed += GROUPS_VARINT_MAX_SIZE;
+                                if( stdhash_is_end( &Compact_names, stdhash_find( &Compact_names, &hit, &mbr ) ) )
+                                        size_needed += GROUPS_VARINT_MAX_SIZE + strlen( mbr->name );
+                        }
+                        if( num_bytes + table_bytes + size_needed > capacity )
+                        {
+                                couldnt_fit_daemon = 1;
+                                break;
+                        }
+
+                        for( i = 0; i < (int) MySyncedSet.size; ++i )
+                                if( MySyncedSet.proc_ids[i] == dmn->proc_id )
+                                        break;
+                        num_bytes += G_put_varint( &buf[num_bytes], i );
+                        if( i == (int) MySyncedSet.size )
+                        {
+                                memcpy( &buf[num_bytes], &dmn->proc_id, sizeof(int32) );
+                                num_bytes += sizeof(int32);
+                        }
+                        num_bytes += G_put_varint( &buf[num_bytes], stdskl_size(&dmn->MembersList) );
+
+			for (stdskl_begin(&dmn->MembersList, &mit); !stdskl_is_end(&dmn->MembersList, &mit); stdskl_it_next(&mit))
+			{
+			        mbr = *(member**) stdskl_it_key(&mit);
+                                if( !stdhash_is_end( &Compact_names, stdhash_find( &Compact_names, &hit, &mbr ) ) ) {
+                                        index = *(int32u*) stdhash_it_val( &hit );
+                                } else {
+                                        index = num_names++;
+                                        if (stdhash_put(&Compact_names, NULL, &mbr, &index) != 0) {
+                                          Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+                                        }
+                                        len          = strlen( mbr->name );
+                                        table_bytes += G_put_varint( &Compact_table[table_bytes], len );
+                                        memcpy( &Compact_table[table_bytes], mbr->name, len );
+                                        table_bytes += len;
+                                }
+                                num_bytes += G_put_varint( &buf[num_bytes], index );
+                        }
+                        num_dmns++;
+                        num_entries++;
+                }
+                *num_dmns_ptr = (char) num_dmns;
+                if( couldnt_fit_daemon )
+                        break;
+
+		stdskl_it_next(git);
+
+		if (!stdskl_is_end(&GroupsList, git)) {
+		  grp = *(group**) stdskl_it_key(git);
+		  stdskl_begin(&grp->DaemonsList, dit);
+		}
+        }
+        if( couldnt_fit_daemon && num_entries == 0 )
+                return( -1 );
+
+        table_offset = num_bytes;
+        memcpy( table_offset_ptr, &table_offset, sizeof(int32u) );
+        num_bytes += G_put_varint( &buf[num_bytes], num_names );
+        memcpy( &buf[num_bytes], Compact_table, table_bytes );
+        num_bytes += table_bytes;
+
+        return( num_bytes );
+}
+
 static  void  G_build_new_groups_bufs()
 {
 	stdit                git, dit;
 	int                  first_time = 1;
         groups_buf_link     *grps_buf_link;
 
+        /* Compact only when every daemon of the membership runs CompactGroupState */
+        Groups_bufs_compact = Memb_compact_groups();
         do {
                 grps_buf_link        = new( GROUPS_BUF_LINK );
                 grps_buf_link->next  = Groups_bufs;
@@ -2268,32 +2644,46 @@ static  void  G_discard_groups_bufs()
 static  int  G_send_groups_messages()
 {
         groups_buf_link *grps_buf_link;
-	down_link	*down_ptr;
-        message_obj     *msg;
-        message_header  *head_ptr;
         int              i = 0;
+        int              bytes = 0, packets = 0;
 
         for( grps_buf_link = Groups_bufs; grps_buf_link != NULL; grps_buf_link = grps_buf_link->next ) {
-                msg      = Message_new_message();
-                G_build_groups_msg_hdr( msg, grps_buf_link->bytes );
-                head_ptr = Message_get_message_header(msg);
                 if( grps_buf_link->next )
-                        head_ptr->type |= RELIABLE_MESS;
+                        packets += G_queue_groups_buf( grps_buf_link->buf, grps_buf_link->bytes, RELIABLE_MESS );
                 else
-                        head_ptr->type |= AGREED_MESS;
-                Message_Buffer_to_Message_Fragments( msg, grps_buf_link->buf, grps_buf_link->bytes );
-
-                down_ptr       = Prot_Create_Down_Link(msg, Message_get_packet_type(head_ptr->type), 0, 0);
-                down_ptr->mess = msg; 
-                Obj_Inc_Refcount(down_ptr->mess);
-                /* Use control queue--not normal session queues */
-                Prot_new_message( down_ptr, Groups_control_down_queue );
-                Message_Dec_Refcount(msg);
+                        packets += G_queue_groups_buf( grps_buf_link->buf, grps_buf_link->bytes, AGREED_MESS );
+                bytes += grps_buf_link->bytes;
                 ++i;
         }
+        Alarmp( SPLOG_INFO, GROUPS, "G_send_groups_messages: %d messages, %d bytes, %d packets%s\n",
+                i, bytes, packets, Groups_bufs_compact ? ", compact" : "" );
         return i;
 }
 
+/* Returns the number of packets the message takes. */
+static  int  G_queue_groups_buf( char buf[], int bytes, int32 type )
+{
+	down_link	*down_ptr;
+        message_obj     *msg;
+        message_header  *head_ptr;
+        int              packets;
+
+        msg      = Message_new_message();
+        G_build_groups_msg_hdr( msg, bytes );
+        head_ptr = Message_get_message_header(msg);
+        head_ptr->type |= type;
+        Message_Buffer_to_Message_Fragments( msg, buf, bytes );
+
+        down_ptr       = Prot_Create_Down_Link(msg, Message_get_packet_type(head_ptr->type), 0, 0);
+        down_ptr->mess = msg; 
+        Obj_Inc_Refcount(down_ptr->mess);
+        /* Use control queue--not normal session queues */
+        Prot_new_message( down_ptr, Groups_control_down_queue );
+        packets = Message_get_data_scatter(msg)->num_elements;
+        Message_Dec_Refcount(msg);
+        return( packets );
+}
+
 /* This function fills the synced set from the synced set portion of a
  * groups message if there is one, and adds all the group membership
  * information to the GroupsList. */
@@ -2322,6 +2712,9 @@ static	int  G_mess_to_groups( message_link *mess_link, synced_set *sset )
         char             ip_string[16];
 	stdit            it;
         int16u           sent_group_changed;
+        int32u           num_cached;
+        int32            cached_id;
+        group_id         sent_grp_id;
 
 	total_bytes = 0;
 	msg = mess_link->mess;
@@ -2354,8 +2747,26 @@ static	int  G_mess_to_groups( message_link *mess_link, synced_set *sset )
                 if( !Same_endian( head_ptr->type ) )
                         for( i = 0; i < (int) sset->size; ++i )
                                 sset->proc_ids[i] = Flip_int32( sset->proc_ids[i] );                
+                if( Conf_get_incremental_group_state() )
+                {
+                        memcpy( &num_cached, &Temp_buf[num_bytes], sizeof(int32u) );
+                        num_bytes += sizeof(int32u);
+                        if( !Same_endian( head_ptr->type ) )
+                                num_cached = Flip_int32( num_cached );
+                        for( i = 0; i < (int) num_cached; ++i )
+                        {
+                                memcpy( &cached_id, &Temp_buf[num_bytes], sizeof(int32) );
+                                num_bytes += sizeof(int32);
+                                if( !Same_endian( head_ptr->type ) )
+                                        cached_id = Flip_int32( cached_id );
+                                G_restore_departed( cached_id );
+                        }
+                }
         }
 
+        if( Is_compact_message(flag_ptr) )
+                return( G_compact_mess_to_groups( head_ptr, num_bytes, total_bytes, sset ) );
+
         /* Read the groups data, and insert it into the GroupsList */
 	for( ; num_bytes < total_bytes; )
 	{
@@ -2367,38 +2778,17 @@ static	int  G_mess_to_groups( message_link *mess_link, synced_set *sset )
                 grp = G_get_group( group_name_ptr );
                 if( grp == NULL )
                 {
-			grp = new( GROUP );
-			memset( grp->name, 0, MAX_GROUP_NAME );
-			strcpy( grp->name, group_name_ptr );
-
-			if (stdskl_construct(&grp->DaemonsList, sizeof(daemon_members*), 0, G_compare_proc_ids_by_conf) != 0) {
-			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
-			}
-
-			if (stdarr_construct(&grp->mboxes, sizeof(mailbox), 0) != 0) {
-			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
-			}
-
-                        grp->changed     = FALSE;
-			grp->num_members = 0;
-
                         /* Set a group id here, so that if the group isn't changed,
                          * everyone will have the right ID (because all must have same). */
-                        memcpy( &grp->grp_id, &Temp_buf[num_bytes], sizeof(group_id) );
+                        memcpy( &sent_grp_id, &Temp_buf[num_bytes], sizeof(group_id) );
                         if( !Same_endian( head_ptr->type ) )
                         {
                                 /* Flip group id */
-                                grp->grp_id.memb_id.proc_id = Flip_int32( grp->grp_id.memb_id.proc_id );
-                                grp->grp_id.memb_id.time    = Flip_int32( grp->grp_id.memb_id.time );
-                                grp->grp_id.index    	    = Flip_int32( grp->grp_id.index );
+                                sent_grp_id.memb_id.proc_id = Flip_int32( sent_grp_id.memb_id.proc_id );
+                                sent_grp_id.memb_id.time    = Flip_int32( sent_grp_id.memb_id.time );
+                                sent_grp_id.index    	    = Flip_int32( sent_grp_id.index );
                         }
-
-			if (stdskl_put(&GroupsList, NULL, &grp, NULL, STDFALSE) != 0) {
-			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
-			}
-
-			Num_groups++;
-			GlobalStatus.num_groups = Num_groups;
+                        grp = G_new_group( group_name_ptr, &sent_grp_id );
                 } 
                 num_bytes += sizeof(group_id);
                 /* Get the changed flag for sent group and set local group changed flag if sent group was marked changed */
@@ -2422,6 +2812,7 @@ static	int  G_mess_to_groups( message_link *mess_link, synced_set *sset )
                         /* FIXME: If I was paranoid, I could always check here that the daemon
                          *        isn't already in my GroupsList, or that it is in my conf (from Reg_memb). */
                         dmn = new( DAEMON_MEMBERS );
+                        dmn->hashed = FALSE;
                         memcpy( &dmn->proc_id, &Temp_buf[num_bytes], sizeof(int32) );
                         num_bytes += sizeof(int32);
                         memcpy( &dmn->memb_id, &Temp_buf[num_bytes], sizeof(membership_id) );
@@ -2474,33 +2865,164 @@ static	int  G_mess_to_groups( message_link *mess_link, synced_set *sset )
 	return( 0 );
 }
 
-/* TODO: G_analize_groups is O(n) when num_groups = 1 and O(n^2) when
-   num_groups > 1 (multi_group_multicast) in the number of targeted
-   mailboxes.  In the latter case, if n is large a O(n lg n) solution
-   leveraging a skiplist would be preferable.
-*/
+/* Reads the groups of a message in the compact encoding (see
+ * G_build_compact_groups_buf) into the GroupsList. */
+static  int  G_compact_mess_to_groups( message_header *head_ptr, int num_bytes, int total_bytes, synced_set *sset )
+{
+	group		*grp;
+        daemon_members  *dmn;
+	member		*mbr;
+        char             group_name[MAX_GROUP_NAME];
+        membership_id    memb_id;
+        group_id         sent_grp_id;
+        unsigned char    flags, num_dmns;
+        int32u           table_offset, num_names, num_memb, index, len, ref, prefix;
+        int              table_end, table_pos, have_memb_id, i, j;
+	stdit            it;
+
+        memcpy( &table_offset, &Temp_buf[num_bytes], sizeof(int32u) );
+        num_bytes += sizeof(int32u);
+        if( !Same_endian( head_ptr->type ) )
+                table_offset = Flip_int32( table_offset );
+        table_end = Message_get_data_header_size() + table_offset;
+        if( table_end < num_bytes || table_end >= total_bytes )
+                return( -1 );
+
+        table_pos  = table_end;
+        table_pos += G_get_varint( &Temp_buf[table_pos], &num_names );
+        if( num_names > GROUPS_BUF_SIZE / 2 )
+                return( -1 );
+        for( index = 0; index < num_names; ++index )
+        {
+                Compact_offsets[index] = table_pos;
+                table_pos += G_get_varint( &Temp_buf[table_pos], &len );
+                if( len >= MAX_GROUP_NAME )
+                        return( -1 );
+                table_pos += len;
+        }
+        if( table_pos != total_bytes )
+                return( -1 );
+
+        have_memb_id = 0;
+        memset( group_name, 0, MAX_GROUP_NAME );
+	while( num_bytes < table_end )
+	{
+                num_bytes += G_get_varint( &Temp_buf[num_bytes], &prefix );
+                num_bytes += G_get_varint( &Temp_buf[num_bytes], &len );
+                if( prefix > strlen( group_name ) || prefix + len >= MAX_GROUP_NAME )
+                        return( -1 );
+                memset( &group_name[prefix], 0, MAX_GROUP_NAME - prefix );
+                memcpy( &group_name[prefix], &Temp_buf[num_bytes], len );
+                num_bytes += len;
+
+                flags = (unsigned char) Temp_buf[num_bytes++];
+                if( !( flags & 0x02 ) )
+                {
+                        memcpy( &memb_id, &Temp_buf[num_bytes], sizeof(membership_id) );
+                        num_bytes += sizeof(membership_id);
+                        if( !Same_endian( head_ptr->type ) )
+                        {
+                                memb_id.proc_id = Flip_int32( memb_id.proc_id );
+                                memb_id.time    = Flip_int32( memb_id.time );
+                        }
+                        have_memb_id = 1;
+                } else if( !have_memb_id ) {
+                        return( -1 );
+                }
+                num_bytes += G_get_varint( &Temp_buf[num_bytes], &index );
+
+                Alarmp( SPLOG_DEBUG, GROUPS, "G_compact_mess_to_groups: group %s\n", group_name );
+                grp = G_get_group( group_name );
+                if( grp == NULL )
+                {
+                        sent_grp_id.memb_id = memb_id;
+                        sent_grp_id.index   = index;
+                        grp = G_new_group( group_name, &sent_grp_id );
+                }
+                if( flags & 0x01 )
+                        grp->changed = TRUE;
+
+                num_dmns = (unsigned char) Temp_buf[num_bytes++];
+                for( i = 0; i < num_dmns; ++i )
+                {
+                        dmn = new( DAEMON_MEMBERS );
+                        dmn->hashed = FALSE;
+                        num_bytes += G_get_varint( &Temp_buf[num_bytes], &ref );
+                        if( ref < sset->size ) {
+                                dmn->proc_id = sset->proc_ids[ref];
+                        } else if( ref == sset->size ) {
+                                memcpy( &dmn->proc_id, &Temp_buf[num_bytes], sizeof(int32) );
+                                num_bytes += sizeof(int32);
+                                if( !Same_endian( head_ptr->type ) )
+                                        dmn->proc_id = Flip_int32( dmn->proc_id );
+                        } else {
+                                dispose( dmn );
+                                return( -1 );
+                        }
+                        dmn->memb_id = memb_id;
+
+			if (stdskl_construct(&dmn->MembersList, sizeof(member*), 0, G_compare_nameptr) != 0) {
+			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+			}
 
+			if (stdskl_put(&grp->DaemonsList, NULL, &dmn, NULL, STDFALSE) != 0) {
+			  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+			}
+
+                        if( !grp->changed &&
+                            !Memb_is_equal( dmn->memb_id, grp->grp_id.memb_id ) )
+                                grp->changed = TRUE;
+
+                        num_bytes += G_get_varint( &Temp_buf[num_bytes], &num_memb );
+                        for( j = 0; j < (int) num_memb; ++j )
+                        {
+                                num_bytes += G_get_varint( &Temp_buf[num_bytes], &index );
+                                if( index >= num_names )
+                                        return( -1 );
+                                table_pos  = Compact_offsets[index];
+                                table_pos += G_get_varint( &Temp_buf[table_pos], &len );
+
+                                mbr = new( MEMBER );
+                                memset( mbr->name, 0, MAX_GROUP_NAME );
+                                memcpy( mbr->name, &Temp_buf[table_pos], len );
+
+				if (stdskl_put(&dmn->MembersList, stdskl_end(&dmn->MembersList, &it), &mbr, NULL, STDTRUE) != 0) {
+				  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+				}
+                        }
+                        grp->num_members += num_memb;
+                }
+	}
+	return( 0 );
+}
+
+/* G_analize_groups is O(n) in the number of targeted mailboxes. A
+   multi_group_multicast can name a session through several groups, so
+   each session is stamped with the generation of the current call the
+   first time it is taken and skipped when it is seen again.
+*/
 int  G_analize_groups( int num_groups, char target_groups[][MAX_GROUP_NAME], int target_sessions[] )
 {
-static  mailbox mboxes[MAX_SESSIONS];
-	int	num_mbox;
-	mailbox *bigbox_ptr;
-	mailbox *bigend_ptr;
+static  int32u  stamps[MAX_SESSIONS];
+static  int32u  generation;
 	mailbox *litbox_ptr;
 	mailbox *litend_ptr;
 	group	*grp;
 	char	proc_name[MAX_PROC_NAME];
 	char	private_name[MAX_PRIVATE_NAME+1];
+	int	num_sessions;
 	int	ses;
 	int	ret;
 	int	i;
-	int     *orig_target_sessions = target_sessions;
 
-	/* collect the target local mailboxen */
+	if( ++generation == 0 )
+	{
+		/* wrapped around: stamps left from 2^32 calls ago would look current */
+		memset( stamps, 0, sizeof(stamps) );
+		generation = 1;
+	}
 
-	num_mbox   = 0;
-	litbox_ptr = NULL;
-	litend_ptr = NULL;
+	num_sessions = 0;
 
 	for ( i=0; i < num_groups; ++i )
 	{
@@ -2519,6 +3041,7 @@ static  mailbox mboxes[MAX_SESSIONS];
 
 			} else {
                                 Alarmp( SPLOG_FATAL, GROUPS, "G_analize_groups: Gstate is %d\n", Gstate );
+                                continue;
                         }
 
 		} else {
@@ -2530,60 +3053,63 @@ static  mailbox mboxes[MAX_SESSIONS];
 			  continue; 
 			}
 
-			litbox_ptr = &Sessions[ ses ].mbox;  /* just point litbox pointer at the session's mbox */
-			litend_ptr = litbox_ptr + 1;
+			if( stamps[ses] != generation )
+			{
+				stamps[ses] = generation;
+				target_sessions[ num_sessions++ ] = ses;
+			}
+			continue;
 		}
 
-		/* NOTE: the following code assumes that grp->mboxes contains no duplicates */
-
-		if (num_groups == 1) {  /* no need to do extra copy work if only one group -> just use litbox 'array' directly */
-		  break;
+		/* NOTE: grp->mboxes contains no duplicates, so one group needs no stamping */
+		if( num_groups == 1 )
+		{
+			for( ; litbox_ptr != litend_ptr; ++litbox_ptr )
+				target_sessions[ num_sessions++ ] = Sess_get_session_index( *litbox_ptr );
+			break;
 		}
 
-		if (num_mbox != 0) {  /* mboxes contains some entries already */
-		        bigend_ptr = mboxes + num_mbox;
-
-			for (; litbox_ptr != litend_ptr; ++litbox_ptr)
-			{
-			        mailbox m = *litbox_ptr;
-
-				/* linear search over mboxes for 'm' */
-
-				for (bigbox_ptr = mboxes; bigbox_ptr != bigend_ptr && *bigbox_ptr != m; ++bigbox_ptr);  
-
-				if (bigbox_ptr == bigend_ptr) {
-				        mboxes[ num_mbox++ ] = m;
-				}
-			}
+		for( ; litbox_ptr != litend_ptr; ++litbox_ptr )
+		{
+			ses = Sess_get_session_index( *litbox_ptr );
+			if( ses < 0 || stamps[ses] == generation ) continue;
 
-		} else {
-		  num_mbox = (int) (litend_ptr - litbox_ptr);  /* if num_mbox is (still) zero, then adopt litbox 'array' */
-		  memcpy(mboxes, litbox_ptr, num_mbox * sizeof(mailbox));
+			stamps[ses] = generation;
+			target_sessions[ num_sessions++ ] = ses;
 		}
 	}
 
-	/* convert mailboxes to sessions */
-
-	if (num_groups == 1) {  /* on non-multi group multicast just use litbox 'array' in place */
-	  bigbox_ptr = litbox_ptr;
-	  bigend_ptr = litend_ptr;
+	return( num_sessions );
+}
+        
+#ifdef GROUPS_BENCH
+/* Only built into examples/groups_bench, which links the daemon objects
+ * and times G_analize_groups itself: adds the local mailboxes to group_name,
+ * creating it if needed, without sessions joining or members notified. */
+void  G_bench_group( char *group_name, mailbox mboxes[], int num_mboxes )
+{
+	group		*grp;
+	group_id	 grp_id;
+	int		 i;
 
-	} else {                /* otherwise use unique entries we've built in mboxes */
-	  bigbox_ptr = mboxes;
-	  bigend_ptr = mboxes + num_mbox;
+	grp = G_get_group( group_name );
+	if( grp == NULL )
+	{
+		grp_id.memb_id = Reg_memb_id;
+		grp_id.index   = 0;
+		grp = G_new_group( group_name, &grp_id );
 	}
-	
-	for (; bigbox_ptr != bigend_ptr; ++bigbox_ptr, ++target_sessions)
+	for( i=0; i < num_mboxes; i++ )
 	{
-	  *target_sessions = Sess_get_session_index( *bigbox_ptr );
+		if (stdarr_push_back(&grp->mboxes, &mboxes[i]) != 0) {
+		  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+		}
 	}
-
-	return (int) (target_sessions - orig_target_sessions);
 }
-        
+#endif	/* GROUPS_BENCH */
+
 static  void  G_compute_group_mask( group *grp, char *func_name )
 {
-#if (SPREAD_PROTOCOL == 4)
         int                     i;
         int                     temp;
         daemon_members         *dmn;
@@ -2597,7 +3123,7 @@ static  void  G_compute_group_mask( group *grp, char *func_name )
 	for (stdskl_begin(&grp->DaemonsList, &it); !stdskl_is_end(&grp->DaemonsList, &it); stdskl_it_next(&it)) 
 	{
 	        dmn = *(daemon_members**) stdskl_it_key(&it);
-                Conf_proc_by_id( dmn->proc_id, &p );
+                if( Conf_proc_by_id( dmn->proc_id, &p ) < 0 ) continue;
 
 		/* FIXME: TODO: isn't the following loop the same as: temp = (0x1 << (p.seg_index & 0x1F)); ??? */
 
@@ -2610,7 +3136,6 @@ static  void  G_compute_group_mask( group *grp, char *func_name )
         }
         Alarmp( SPLOG_INFO, GROUPS, "%s: Mask for group %s set to %x %x %x %x\n", func_name, 
                 grp->name, grp->grp_mask[3], grp->grp_mask[2], grp->grp_mask[1], grp->grp_mask[0]);
-#endif
 }
 
 void  G_set_mask( int num_groups, char target_groups[][MAX_GROUP_NAME], int32u *grp_mask )
@@ -2639,7 +3164,7 @@ void  G_set_mask( int num_groups, char target_groups[][MAX_GROUP_NAME], int32u *
 			/* Illegal group */
 			if( ret < 0 ) continue;
 
-		        Conf_proc_by_name( proc_name, &p ); 
+		        if( Conf_proc_by_name( proc_name, &p ) < 0 ) continue;
 		        temp = 1;
 		        for(j=0; j<p.seg_index%32; j++)
 		        {
@@ -2662,6 +3187,8 @@ void  G_set_mask( int num_groups, char target_groups[][MAX_GROUP_NAME], int32u *
 			}
 			else if(( Gstate == GOP )||(Gstate == GTRANS))
 			{
+			    /* DaemonsList also changes on membership changes, so refresh the mask */
+			    G_compute_group_mask( grp, "G_set_mask" );
 		            for(j=0; j<4; j++)
 		            {
 			        grp_mask[j] |= grp->grp_mask[j]; 
@@ -2779,18 +3306,21 @@ static  void  G_add_to_synced_set( synced_set *sset ) {
         synced_set temp;
         int32u     i = 0, j = 0;
         int        index_l = -1, index_r = -1;
-        proc       dummy_proc;
+        proc       *dummy_proc;
+
+        /* These daemons are synced with me again; drop what I kept for them. */
+        G_forget_departed( sset );
 
         temp.size = 0;
         while( i < MySyncedSet.size || j < sset->size ) {
                 if( i < MySyncedSet.size && index_l == -1 ) {
-                        index_l = Conf_proc_by_id( MySyncedSet.proc_ids[i], &dummy_proc );
+                        index_l = Conf_proc_ref_by_id( MySyncedSet.proc_ids[i], &dummy_proc );
                         if( index_l == -1 )
                                 Alarmp( SPLOG_FATAL, GROUPS, "G_add_to_synced_set: proc_id %u not in conf\n",
                                         MySyncedSet.proc_ids[i] );
                 }
                 if( j < sset->size && index_r == -1 ) {
-                        index_r = Conf_proc_by_id( sset->proc_ids[j], &dummy_proc );
+                        index_r = Conf_proc_ref_by_id( sset->proc_ids[j], &dummy_proc );
                         if( index_r == -1 )
                                 Alarmp( SPLOG_FATAL, GROUPS, "G_add_to_synced_set: proc_id %u not in conf\n",
                                         sset->proc_ids[j] );
@@ -2860,7 +3390,6 @@ static  bool  G_eliminate_partitioned_daemons_status( group *grp )
 {
         daemon_members      *dmn;
         bool                 group_changed = FALSE;
-        int                  needed;
 	stdit                it;
 
 	for (stdskl_begin(&grp->DaemonsList, &it); !stdskl_is_end(&grp->DaemonsList, &it); ) 
@@ -2868,25 +3397,7 @@ static  bool  G_eliminate_partitioned_daemons_status( group *grp )
 	        dmn = *(daemon_members**) stdskl_it_key(&it);
 	        stdskl_it_next(&it);  /* NOTE: advance here to protect against potential removal below */
 
-                needed = 0;
-                /* The first condition is sufficient, but we can optimize a bit this way. */
-                if( Gstate == GGT ) /* Called in G_handle_reg_memb after we got a cascading transitional */
-                {
-                        if( Conf_id_in_conf( &Trans_memb, dmn->proc_id ) == -1 )
-                        {
-                                needed = 1;
-                        } else {
-                                needed = 0;
-                        }
-                } else {            /* Called because we got the non-cascading regular membership */
-                        if( Is_partitioned_daemon( dmn ) )
-                        {
-                                needed = 1;
-                        } else {
-                                needed = 0;
-                        }
-                }
-                if( needed )
+                if( G_is_departing_daemon( dmn ) )
                 {
                         /* discard this daemon and its members - proc no longer in membership */
                         G_remove_daemon( grp, dmn );
@@ -2896,6 +3407,21 @@ static  bool  G_eliminate_partitioned_daemons_status( group *grp )
         return group_changed;
 }
 
+/* Whether G_eliminate_partitioned_daemons_status discards this daemon. */
+static  bool  G_is_departing_daemon( daemon_members *dmn )
+{
+        /* The first condition is sufficient, but we can optimize a bit this way. */
+        if( Gstate == GGT ) /* Called in G_handle_reg_memb after we got a cascading transitional */
+                return( Conf_id_in_conf( &Trans_memb, dmn->proc_id ) == -1 );
+
+        /* Called in G_handle_trans_memb before the daemons are marked partitioned */
+        if( Gstate == GOP )
+                return( Conf_id_in_conf( &Trans_memb, dmn->proc_id ) == -1 );
+
+        /* Called because we got the non-cascading regular membership */
+        return( Is_partitioned_daemon( dmn ) );
+}
+
 /* This function is only called when we handle a cascading transitional membership.
  * Gstate should be GGATHER, about to change to GGT */
 static  bool  G_check_if_changed_by_cascade( group *grp ) 
@@ -2951,6 +3477,7 @@ static  void  G_remove_group( group *grp )
 	}
 
 	stdskl_erase(&GroupsList, &it);
+	stdhash_erase_key(&GroupsIndex, &grp);
 
 	stdskl_destruct(&grp->DaemonsList);
 	stdarr_destruct(&grp->mboxes);
@@ -3001,3 +3528,413 @@ static  void  G_print_group_id( int priority, group_id g, char *func_name )
                 "%s: Group_id {Proc ID: %s, Time: %d, Index: %d}\n", func_name,
                 ip_string, g.memb_id.time, g.index );
 }
+
+/*
+ * IncrementalGroupState.
+ *
+ * When daemons are partitioned away, each daemon keeps what its GroupsList
+ * held for them (G_cache_departed_daemons).  At the next state exchange every
+ * daemon first sends a digest listing what it kept: proc id, length and two
+ * hashes per departed daemon.  Once all digests are in, a synced set leaves
+ * out of its GROUPS messages every daemon of the set whose current state all
+ * daemons outside the set kept identically; it only names them, and the
+ * receivers restore them from their own copies (G_restore_departed).  A
+ * partition that heals thus costs what changed on either side, not the whole
+ * GroupsList.  The copies hold the group ids too, so a restored daemon comes
+ * back exactly as the sender's set would have sent it, and a group is marked
+ * changed only as it would have been by the full exchange.  A changed group
+ * is still sent, without its restored daemons, to carry the flag.
+ */
+
+static  contribution  *G_find_contribution( contribution *contribs, int num_contribs, int32 proc_id )
+{
+        int     i;
+
+        for( i = 0; i < num_contribs; ++i )
+                if( contribs[i].proc_id == proc_id )
+                        return( &contribs[i] );
+        return( NULL );
+}
+
+static  void  G_contribution_append( contribution *c, char *data, int len )
+{
+        int     size;
+
+        if( (int) c->bytes + len > c->size )
+        {
+                size = 2 * c->size;
+                if( size < (int) c->bytes + len ) size = c->bytes + len;
+                if( size < 4096 ) size = 4096;
+                c->buf = realloc( c->buf, size );
+                if( c->buf == NULL )
+                        Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+                c->size = size;
+        }
+        memcpy( &c->buf[c->bytes], data, len );
+        c->bytes += len;
+}
+
+static  void  G_contribution_append_int32( contribution *c, int32 value )
+{
+        unsigned char   bytes[4];
+
+        bytes[0] = (unsigned char) ( value >> 24 );
+        bytes[1] = (unsigned char) ( value >> 16 );
+        bytes[2] = (unsigned char) ( value >> 8 );
+        bytes[3] = (unsigned char) value;
+        G_contribution_append( c, (char *) bytes, sizeof(bytes) );
+}
+
+static  int32  G_contribution_get_int32( char *buf )
+{
+        unsigned char  *bytes = (unsigned char *) buf;
+
+        return( (int32) ( ( (int32u) bytes[0] << 24 ) | ( (int32u) bytes[1] << 16 ) |
+                          ( (int32u) bytes[2] << 8 ) | bytes[3] ) );
+}
+
+static  void  G_free_contribution( contribution *c )
+{
+        free( c->buf );
+        c->buf  = NULL;
+        c->size = 0;
+}
+
+/* Appends one daemon's part of one group to its contribution. */
+static  void  G_serialize_daemon( contribution *c, group *grp, daemon_members *dmn )
+{
+        member          *mbr;
+        unsigned char    count[2];
+        int              num_memb;
+        stdit            mit;
+
+        num_memb = stdskl_size(&dmn->MembersList);
+        count[0] = (unsigned char) ( num_memb >> 8 );
+        count[1] = (unsigned char) num_memb;
+        G_contribution_append( c, grp->name, MAX_GROUP_NAME );
+        G_contribution_append_int32( c, grp->grp_id.memb_id.proc_id );
+        G_contribution_append_int32( c, grp->grp_id.memb_id.time );
+        G_contribution_append_int32( c, grp->grp_id.index );
+        G_contribution_append( c, (char *) count, sizeof(count) );
+        for (stdskl_begin(&dmn->MembersList, &mit); !stdskl_is_end(&dmn->MembersList, &mit); stdskl_it_next(&mit))
+        {
+                mbr = *(member**) stdskl_it_key(&mit);
+                G_contribution_append( c, mbr->name, MAX_GROUP_NAME );
+        }
+}
+
+/* Hashes one daemon's part of one group, unless it is unchanged since it
+ * was last hashed.  Joins, leaves and kills clear dmn->hashed, and every
+ * other change to the part comes with a new group id, so the hashes stay
+ * valid across memberships for all the groups that did not change. */
+static  void  G_hash_daemon( group *grp, daemon_members *dmn )
+{
+        if( dmn->hashed && dmn->hashed_grp_id.index == grp->grp_id.index &&
+            Memb_is_equal( dmn->hashed_grp_id.memb_id, grp->grp_id.memb_id ) )
+                return;
+
+        Chunk.bytes = 0;
+        G_serialize_daemon( &Chunk, grp, dmn );
+        dmn->bytes         = Chunk.bytes;
+        dmn->hash_oaat     = stdhcode_oaat( Chunk.buf, Chunk.bytes );
+        dmn->hash_sfh      = stdhcode_sfh( Chunk.buf, Chunk.bytes );
+        dmn->hashed_grp_id = grp->grp_id;
+        dmn->hashed        = TRUE;
+}
+
+/* Sums the hashes of every daemon in the GroupsList, or only of the daemons
+ * G_eliminate_partitioned_daemons is about to discard, whose state is also
+ * serialized to be kept. */
+static  void  G_collect_contributions( contribution *contribs, int *num_contribs, bool departing )
+{
+        group           *grp;
+        daemon_members  *dmn;
+        contribution    *c;
+        stdit            git, dit;
+
+        *num_contribs = 0;
+        c = NULL;
+        for (stdskl_begin(&GroupsList, &git); !stdskl_is_end(&GroupsList, &git); stdskl_it_next(&git))
+        {
+                grp = *(group**) stdskl_it_key(&git);
+                for (stdskl_begin(&grp->DaemonsList, &dit); !stdskl_is_end(&grp->DaemonsList, &dit); stdskl_it_next(&dit))
+                {
+                        dmn = *(daemon_members**) stdskl_it_key(&dit);
+                        if( departing && !G_is_departing_daemon( dmn ) )
+                                continue;
+
+                        if( c == NULL || c->proc_id != dmn->proc_id )
+                                c = G_find_contribution( contribs, *num_contribs, dmn->proc_id );
+                        if( c == NULL )
+                        {
+                                if( *num_contribs == MAX_PROCS_RING )
+                                        Alarmp( SPLOG_FATAL, GROUPS, "G_collect_contributions: more than %d daemons\n", MAX_PROCS_RING );
+                                c = &contribs[(*num_contribs)++];
+                                memset( c, 0, sizeof(contribution) );
+                                c->proc_id = dmn->proc_id;
+                        }
+                        G_hash_daemon( grp, dmn );
+                        if( departing )
+                                G_serialize_daemon( c, grp, dmn );
+                        else
+                                c->bytes += dmn->bytes;
+                        c->hash_oaat += dmn->hash_oaat;
+                        c->hash_sfh  += dmn->hash_sfh;
+                }
+        }
+}
+
+/* Keeps the state of the daemons about to be discarded from the GroupsList. */
+static  void  G_cache_departed_daemons( void )
+{
+        contribution     departing[MAX_PROCS_RING];
+        contribution    *kept;
+        int              num_departing, i;
+        char             ip_string[16];
+
+        G_collect_contributions( departing, &num_departing, TRUE );
+        for( i = 0; i < num_departing; ++i )
+        {
+                kept = G_find_contribution( Departed, Num_departed, departing[i].proc_id );
+                if( kept != NULL ) {
+                        G_free_contribution( kept );
+                } else if( Num_departed < MAX_PROCS_RING ) {
+                        kept = &Departed[Num_departed++];
+                } else {
+                        G_free_contribution( &departing[i] );
+                        continue;
+                }
+                *kept = departing[i];
+                IP_to_STR( kept->proc_id, ip_string );
+                Alarmp( SPLOG_INFO, GROUPS, "G_cache_departed_daemons: kept %u bytes of group state for %s\n",
+                        kept->bytes, ip_string );
+        }
+}
+
+static  void  G_forget_departed( synced_set *sset )
+{
+        contribution    *kept;
+        int              i;
+
+        for( i = 0; i < (int) sset->size; ++i )
+        {
+                kept = G_find_contribution( Departed, Num_departed, sset->proc_ids[i] );
+                if( kept == NULL )
+                        continue;
+                G_free_contribution( kept );
+                *kept = Departed[--Num_departed];
+        }
+}
+
+/* Adds a daemon named in a GROUPS message back from the state kept for it,
+ * as G_mess_to_groups would have added it had the sender sent it in full. */
+static  void  G_restore_departed( int32 proc_id )
+{
+        contribution    *kept;
+        group           *grp;
+        daemon_members  *dmn;
+        member          *mbr;
+        group_id         grp_id;
+        int              num_bytes, num_memb, j;
+        char             ip_string[16];
+        stdit            it;
+
+        IP_to_STR( proc_id, ip_string );
+        kept = G_find_contribution( Departed, Num_departed, proc_id );
+        if( kept == NULL )
+                Alarmp( SPLOG_FATAL, GROUPS, "G_restore_departed: no group state kept for %s\n", ip_string );
+        Alarmp( SPLOG_INFO, GROUPS, "G_restore_departed: restoring %u bytes of group state for %s\n",
+                kept->bytes, ip_string );
+
+        for( num_bytes = 0; num_bytes < (int) kept->bytes; )
+        {
+                grp_id.memb_id.proc_id = G_contribution_get_int32( &kept->buf[num_bytes + MAX_GROUP_NAME] );
+                grp_id.memb_id.time    = G_contribution_get_int32( &kept->buf[num_bytes + MAX_GROUP_NAME + 4] );
+                grp_id.index           = G_contribution_get_int32( &kept->buf[num_bytes + MAX_GROUP_NAME + 8] );
+                grp = G_get_group( &kept->buf[num_bytes] );
+                if( grp == NULL )
+                        grp = G_new_group( &kept->buf[num_bytes], &grp_id );
+                num_bytes += MAX_GROUP_NAME + 3 * sizeof(int32);
+                num_memb   = ( (unsigned char) kept->buf[num_bytes] << 8 ) | (unsigned char) kept->buf[num_bytes+1];
+                num_bytes += 2;
+
+                dmn = new( DAEMON_MEMBERS );
+                dmn->proc_id = proc_id;
+                dmn->hashed  = FALSE;
+                dmn->memb_id = grp_id.memb_id;
+                if (stdskl_construct(&dmn->MembersList, sizeof(member*), 0, G_compare_nameptr) != 0) {
+                  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+                }
+                if (stdskl_put(&grp->DaemonsList, NULL, &dmn, NULL, STDFALSE) != 0) {
+                  Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+                }
+                for( j = 0; j < num_memb; ++j )
+                {
+                        mbr = new( MEMBER );
+                        memcpy( mbr->name, &kept->buf[num_bytes], MAX_GROUP_NAME );
+                        num_bytes += MAX_GROUP_NAME;
+                        if (stdskl_put(&dmn->MembersList, stdskl_end(&dmn->MembersList, &it), &mbr, NULL, STDTRUE) != 0) {
+                          Alarmp( SPLOG_FATAL, GROUPS, "%s: %d: memory allocation failed\n", __FILE__, __LINE__ );
+                        }
+                }
+                grp->num_members += num_memb;
+                if( !Memb_is_equal( dmn->memb_id, grp->grp_id.memb_id ) )
+                        grp->changed = TRUE;
+        }
+}
+
+static  bool  G_is_cached_daemon( int32 proc_id )
+{
+        int     i;
+
+        for( i = 0; i < Num_cached; ++i )
+                if( Cached_ids[i] == proc_id )
+                        return( TRUE );
+        return( FALSE );
+}
+
+/* Whether a daemon from dit onwards in the group is sent in full. */
+static  bool  G_has_sent_daemon( group *grp, stdit *dit )
+{
+        daemon_members  *dmn;
+        stdit            it;
+
+        for( it = *dit; !stdskl_is_end(&grp->DaemonsList, &it); stdskl_it_next(&it) )
+        {
+                dmn = *(daemon_members**) stdskl_it_key(&it);
+                if( !G_is_cached_daemon( dmn->proc_id ) )
+                        return( TRUE );
+        }
+        return( FALSE );
+}
+
+/* Hashes my synced set's state and sends what I kept for departed daemons. */
+static  void  G_send_digest( void )
+{
+        char     buf[GROUPS_BUF_PREAMBLE_SIZE + sizeof(int32u) + MAX_PROCS_RING * CONTRIBUTION_DIGEST_SIZE];
+        int      num_bytes, i;
+        int32u   num_departed;
+
+        G_collect_contributions( Set_contribs, &Num_set_contribs, FALSE );
+        Num_digests_gathered = 0;
+        Num_cached           = 0;
+
+        /* A digest message looks like this:
+         * Membership id
+         * flag (2)  (char)
+         * number of daemons kept (int32u)
+         * For each daemon kept:
+         *   proc id, bytes, One-at-a-Time hash, SuperFastHash hash (int32, 3 * int32u)
+         */
+        num_bytes = 0;
+        memcpy( &buf[num_bytes], &Reg_memb_id, sizeof(membership_id) );
+        num_bytes += sizeof(membership_id);
+        Set_digest_message( &buf[num_bytes] );
+        num_bytes += sizeof(char);
+        num_departed = Num_departed;
+        memcpy( &buf[num_bytes], &num_departed, sizeof(int32u) );
+        num_bytes += sizeof(int32u);
+        for( i = 0; i < Num_departed; ++i )
+        {
+                memcpy( &buf[num_bytes], &Departed[i].proc_id, sizeof(int32) );
+                num_bytes += sizeof(int32);
+                memcpy( &buf[num_bytes], &Departed[i].bytes, sizeof(int32u) );
+                num_bytes += sizeof(int32u);
+                memcpy( &buf[num_bytes], &Departed[i].hash_oaat, sizeof(int32u) );
+                num_bytes += sizeof(int32u);
+                memcpy( &buf[num_bytes], &Departed[i].hash_sfh, sizeof(int32u) );
+                num_bytes += sizeof(int32u);
+        }
+        G_queue_groups_buf( buf, num_bytes, AGREED_MESS );
+        Alarmp( SPLOG_INFO, GROUPS, "G_send_digest: sent digest of %d departed daemons\n", Num_departed );
+}
+
+static  void  G_handle_digest( message_link *mess_link, int32 sender_id )
+{
+        message_obj     *msg;
+        message_header  *head_ptr;
+        scatter         *scat;
+        contribution    *c;
+        contribution     entry;
+        int32u           num_entries;
+        int              num_bytes, total_bytes, i;
+        bool             outside;
+
+        msg      = mess_link->mess;
+        head_ptr = Message_get_message_header(msg);
+        scat     = Message_get_data_scatter(msg);
+        total_bytes = 0;
+        for( i = 0; i < (int) scat->num_elements; i++ )
+        {
+                memcpy( &Temp_buf[total_bytes], scat->elements[i].buf, scat->elements[i].len );
+                total_bytes += scat->elements[i].len;
+        }
+
+        outside = TRUE;
+        for( i = 0; i < (int) MySyncedSet.size; ++i )
+                if( MySyncedSet.proc_ids[i] == sender_id )
+                        outside = FALSE;
+
+        num_bytes  = Message_get_data_header_size() + sizeof(membership_id) + sizeof(char);
+        memcpy( &num_entries, &Temp_buf[num_bytes], sizeof(int32u) );
+        num_bytes += sizeof(int32u);
+        if( !Same_endian( head_ptr->type ) )
+                num_entries = Flip_int32( num_entries );
+        for( i = 0; outside && i < (int) num_entries; ++i )
+        {
+                memcpy( &entry.proc_id, &Temp_buf[num_bytes], sizeof(int32) );
+                num_bytes += sizeof(int32);
+                memcpy( &entry.bytes, &Temp_buf[num_bytes], sizeof(int32u) );
+                num_bytes += sizeof(int32u);
+                memcpy( &entry.hash_oaat, &Temp_buf[num_bytes], sizeof(int32u) );
+                num_bytes += sizeof(int32u);
+                memcpy( &entry.hash_sfh, &Temp_buf[num_bytes], sizeof(int32u) );
+                num_bytes += sizeof(int32u);
+                if( !Same_endian( head_ptr->type ) )
+                {
+                        entry.proc_id   = Flip_int32( entry.proc_id );
+                        entry.bytes     = Flip_int32( entry.bytes );
+                        entry.hash_oaat = Flip_int32( entry.hash_oaat );
+                        entry.hash_sfh  = Flip_int32( entry.hash_sfh );
+                }
+                c = G_find_contribution( Set_contribs, Num_set_contribs, entry.proc_id );
+                if( c != NULL && c->bytes == entry.bytes &&
+                    c->hash_oaat == entry.hash_oaat && c->hash_sfh == entry.hash_sfh )
+                        c->matches++;
+        }
+        Sess_dispose_message( mess_link );
+
+        Num_digests_gathered++;
+        Alarmp( SPLOG_INFO, GROUPS, "G_handle_digest: digest from %s with %u entries - digests %d\n",
+                head_ptr->private_group_name, num_entries, Num_digests_gathered );
+        if( Num_digests_gathered == Conf_num_procs( &Reg_memb ) )
+                G_digests_complete();
+}
+
+/* All daemons sent their digests: pick the daemons of my synced set that
+ * every daemon outside it holds already, and (as leader) send the rest. */
+static  void  G_digests_complete( void )
+{
+        int              num_outside, i, ret;
+
+        /* After a cascading transitional, GROUPS messages sent now carry a stale membership id */
+        if( Gstate != GGATHER )
+                return;
+
+        num_outside = Conf_num_procs( &Reg_memb ) - MySyncedSet.size;
+        Num_cached  = 0;
+        for( i = 0; i < Num_set_contribs; ++i )
+                if( num_outside > 0 && Set_contribs[i].matches == num_outside )
+                        Cached_ids[Num_cached++] = Set_contribs[i].proc_id;
+
+        Alarmp( SPLOG_INFO, GROUPS, "G_digests_complete: %d of %d daemons in my synced set sent as digests\n",
+                Num_cached, MySyncedSet.size );
+
+        if( Is_synced_set_leader(My.id) ) {
+                G_discard_groups_bufs();
+                G_build_new_groups_bufs();
+                Groups_bufs_fresh = 1;
+                ret = G_send_groups_messages();
+                Alarmp( SPLOG_INFO, GROUPS, "G_digests_complete: %d GROUPS messages sent\n", ret );
+        }
+}
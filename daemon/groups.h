@@ -50,6 +50,12 @@
                                       sizeof(int16u) + sizeof(int16u) )
 #define GROUPS_BUF_DAEMON_INFO_SIZE ( sizeof(int32) + sizeof(membership_id) + \
                                       sizeof(int16u) )
+#define GROUPS_VARINT_MAX_SIZE      5
+#define GROUPS_COMPACT_GROUP_INFO_SIZE  ( 2 * GROUPS_VARINT_MAX_SIZE + MAX_GROUP_NAME + \
+                                          sizeof(char) + sizeof(membership_id) + \
+                                          GROUPS_VARINT_MAX_SIZE + sizeof(char) )
+#define GROUPS_COMPACT_DAEMON_INFO_SIZE ( GROUPS_VARINT_MAX_SIZE + sizeof(int32) + \
+                                          GROUPS_VARINT_MAX_SIZE )
 #define MAX_LOCAL_GROUP_MEMBERS (( GROUPS_BUF_SIZE - GROUPS_BUF_PREAMBLE_SIZE \
                                    - GROUPS_BUF_GROUP_INFO_SIZE               \
                                    - GROUPS_BUF_DAEMON_INFO_SIZE )            \
@@ -67,6 +73,9 @@ void	G_handle_kill( char *private_group_name );
 void	G_handle_groups( message_link *mess_link );
 
 int	G_analize_groups( int num_groups, char target_groups[][MAX_GROUP_NAME], int target_sessions[] );
+#ifdef GROUPS_BENCH
+void	G_bench_group( char *group_name, mailbox mboxes[], int num_mboxes );
+#endif
 void    G_set_mask( int num_groups, char target_groups[][MAX_GROUP_NAME], int32u *grp_mask );
 
 int	G_private_to_names( char *private_group_name, char *private_name, char *proc_name );
@@ -45,6 +45,7 @@
 #include "spu_objects.h"
 #include "spu_memory.h"
 #include "status.h"
+#include "message.h"
 #include "spu_alarm.h"
 
 #define		POTENTIAL_REP	0
@@ -86,6 +87,11 @@ static	membership_id	Membership_id;
 static	configuration	Future_membership;
 static	membership_id	Future_membership_id;
 
+/* Whether every daemon of the membership runs CompactGroupState, as
+ * gathered on the FORM token that built it */
+static	int		Compact_groups;
+static	int		Future_compact_groups;
+
 static  membership_id   Form1_memb_id;
 static  membership_id   Trans_memb_id;
 static  int32           F_trans_memb_time;
@@ -137,6 +143,7 @@ static	void	Sort_reps( reps_info *r );
 static	void	Create_form1();
 static	void	Fill_form1( sys_scatter *scat );
 static	void	Read_form2( sys_scatter *scat );
+static	bool	Memb_holds_packet( int32 seq );
 static	void	Backoff_membership();
 static	void	Flip_members( members_info *members_ptr );
 static	void	Flip_reps( reps_info *reps_ptr );
@@ -176,10 +183,34 @@ void		Memb_init( void )
 
 	if (!Conf_memb_timeouts_set()) {
 
-		if( Wide_network )
+		if( Conf_get_fast_failure_detection() )
+		{
+			/*
+			 * Sub-second LAN profile. Token_timeout is only the upper bound:
+			 * once the ring is running the protocol shortens token loss
+			 * detection to about one measured token round.
+			 */
+			if( Wide_network )
+				Alarmp( SPLOG_WARNING, MEMB, "Memb_init: FastFailureDetection is meant for a LAN but segments are on different networks\n" );
+
+			Token_timeout.sec  =   0; Token_timeout.usec  = 200000;
+			Hurry_timeout.sec  =   0; Hurry_timeout.usec  = 20000;
+			/* the measured timeout never drops below this, so a short
+			 * scheduling stall on a fast ring is not taken for a crash */
+			Token_loss_min_timeout.sec = 0; Token_loss_min_timeout.usec = 50000;
+
+			Alive_timeout.sec  =   0; Alive_timeout.usec  = 10000;
+			Join_timeout.sec   =   0; Join_timeout.usec   = 10000;
+			Rep_timeout.sec    =   0; Rep_timeout.usec    = 25000;
+			Seg_timeout.sec    =   0; Seg_timeout.usec    = 20000;
+			Gather_timeout.sec =   0; Gather_timeout.usec = 50000;
+			Form_timeout.sec   =   0; Form_timeout.usec   = 100000;
+			Lookup_timeout.sec =  30; Lookup_timeout.usec = 0;
+		}else if( Wide_network )
 		{
 			Token_timeout.sec  =   5; Token_timeout.usec  = 0;
 			Hurry_timeout.sec  =   1; Hurry_timeout.usec  = 500000;
+			Token_loss_min_timeout = Token_timeout;
 
 			Alive_timeout.sec  =   0; Alive_timeout.usec  = 250000;
 			Join_timeout.sec   =   0; Join_timeout.usec   = 250000;
@@ -191,6 +222,7 @@ void		Memb_init( void )
 		}else{
 			Token_timeout.sec  =   1; Token_timeout.usec  = 250000;
 			Hurry_timeout.sec  =   0; Hurry_timeout.usec  = 500000;
+			Token_loss_min_timeout = Token_timeout;
 
 			Alive_timeout.sec  =   0; Alive_timeout.usec  = 250000;
 			Join_timeout.sec   =   0; Join_timeout.usec   = 250000;
@@ -209,6 +241,9 @@ void		Memb_init( void )
 
 	  Token_timeout.sec  =  Conf_get_token_timeout() / 1000;  Token_timeout.usec  = Conf_get_token_timeout() % 1000 * 1000;
 	  Hurry_timeout.sec  =  Conf_get_hurry_timeout() / 1000;  Hurry_timeout.usec  = Conf_get_hurry_timeout() % 1000 * 1000;
+	  /* a quarter of the token timeout, as in the FastFailureDetection profile */
+	  Token_loss_min_timeout.sec  = Token_timeout.sec / 4;
+	  Token_loss_min_timeout.usec = ( Token_timeout.sec % 4 * 1000000 + Token_timeout.usec ) / 4;
 
 	  Alive_timeout.sec  =  Conf_get_alive_timeout() / 1000;  Alive_timeout.usec  = Conf_get_alive_timeout() % 1000 * 1000;
 	  Join_timeout.sec   =  Conf_get_join_timeout() / 1000;   Join_timeout.usec   = Conf_get_join_timeout() % 1000 * 1000;
@@ -231,6 +266,15 @@ void		Memb_init( void )
 	  */
 	}
 
+	/* TokenLossMinTimeout replaces the profile's floor, up to Token_timeout */
+	if( Conf_get_token_loss_min_timeout() > 0 )
+	{
+		Token_loss_min_timeout.sec  = Conf_get_token_loss_min_timeout() / 1000;
+		Token_loss_min_timeout.usec = Conf_get_token_loss_min_timeout() % 1000 * 1000;
+	}
+	if( E_compare_time( Token_loss_min_timeout, Token_timeout ) > 0 )
+		Token_loss_min_timeout = Token_timeout;
+
 	Membership = Conf();
 	for( i=0; i < num_seg; i++ )
 		Membership.segments[i].num_procs = 0;
@@ -245,6 +289,8 @@ void		Memb_init( void )
 	Commit_set.num_members = 1;
 	Commit_set.members[0] = My.id;
 
+	Compact_groups = Conf_get_compact_group_state();
+
 	pack_ptr = new(PACK_HEAD_OBJ);
 	pack_ptr->proc_id = My.id;
 
@@ -297,6 +343,11 @@ int	Memb_token_alive( void )
 	return( Token_alive );
 }
 
+int	Memb_compact_groups( void )
+{
+	return( Compact_groups );
+}
+
 void	Memb_handle_message( sys_scatter *scat )
 {
 	packet_header	*pack_ptr;
@@ -444,7 +495,7 @@ static	void	Memb_handle_join( sys_scatter *scat )
 	reps_info	*reps_ptr;
 	packet_header	refer_pack;
 	sys_scatter	send_scat;
-	proc		p;
+	proc		*p;
 	int		i;
 	int		ret;
 	int		dummy;
@@ -503,8 +554,8 @@ static	void	Memb_handle_join( sys_scatter *scat )
 	    break;
 
 	case SEG:
-	    ret = Conf_proc_by_id( pack_ptr->proc_id, &p );
-	    if( My.seg_index == p.seg_index && 
+	    ret = Conf_proc_ref_by_id( pack_ptr->proc_id, &p );
+	    if( ret >= 0 && My.seg_index == p->seg_index && 
 		reps_ptr->reps[0].type == SEG_REP)
 	    {
 		/* this guy is my representative */
@@ -519,8 +570,8 @@ static	void	Memb_handle_join( sys_scatter *scat )
 	    break;
 
 	case REPRESENTED:
-	    ret = Conf_proc_by_id( pack_ptr->proc_id, &p );
-	    if( My.seg_index == p.seg_index && 
+	    ret = Conf_proc_ref_by_id( pack_ptr->proc_id, &p );
+	    if( ret >= 0 && My.seg_index == p->seg_index && 
 		reps_ptr->reps[0].type == SEG_REP)
 	    {
 		if( pack_ptr->proc_id != My_seg_rep )
@@ -589,7 +640,7 @@ static	void	Memb_handle_join( sys_scatter *scat )
 static	void	Memb_handle_refer( sys_scatter *scat )
 {
 	packet_header	*pack_ptr;
-	proc		p;
+	proc		*p;
 	rep_info	temp_rep;
 	int		ret;
 
@@ -611,16 +662,16 @@ static	void	Memb_handle_refer( sys_scatter *scat )
 
 	case GATHER:
 	    Alarm( MEMB, "Handle_refer in GATHER\n");
-		ret = Conf_proc_by_id( pack_ptr->memb_id.proc_id, &p );
+		ret = Conf_proc_ref_by_id( pack_ptr->memb_id.proc_id, &p );
 		if( ret < 0 )
 		{
 			Alarm( PRINT, "Memb_handle_refer: unknown proc_id %d\n",
 				pack_ptr->memb_id.proc_id );
 			return;
 		}
-		temp_rep.proc_id   = p.id;
+		temp_rep.proc_id   = p->id;
 		temp_rep.type      = pack_ptr->memb_id.time;
-		temp_rep.seg_index = p.seg_index;
+		temp_rep.seg_index = p->seg_index;
 		Insert_rep( &Potential_reps, temp_rep );
 		break;
 
@@ -638,7 +689,7 @@ static	void	Memb_handle_refer( sys_scatter *scat )
 static	void	Memb_handle_foreign( sys_scatter *scat )
 {
 	packet_header	*pack_ptr;
-	proc		p;
+	proc		*p;
 	int		ret;
 
     pack_ptr 	= (packet_header *) scat->elements[0].buf;
@@ -647,7 +698,7 @@ static	void	Memb_handle_foreign( sys_scatter *scat )
     {
 	case OP:
 	    Alarm( NONE, "Handle_foreign in OP\n");
-		ret = Conf_proc_by_id( pack_ptr->proc_id, &p );
+		ret = Conf_proc_ref_by_id( pack_ptr->proc_id, &p );
 		if( ret < 0 )
 		{
 			Alarm( PRINT, "Memb_handle_foreign: unknown proc_id %d\n",
@@ -1358,6 +1409,23 @@ static	void	Sort_reps( reps_info *r )
 	}
 }
 
+/* Whether I have packet seq, for the holes on a FORM1 token. A SelectiveDelivery
+ * placeholder only counts once Deliver_agreed_packets has passed it, which it
+ * does only after the Aru has: before that the segments that need its payload
+ * may not have it, and if none of the daemons left there does, seq has to be
+ * a hole everywhere. No daemon has delivered beyond such a placeholder.
+ */
+static	bool	Memb_holds_packet( int32 seq )
+{
+	int	pack_entry;
+
+	pack_entry = seq & Packet_mask;
+	if( ! Packets[pack_entry].exist ) return( FALSE );
+	if( Packets[pack_entry].exist == 1 && Is_placeholder( Packets[pack_entry].head->type ) ) return( FALSE );
+
+	return( TRUE );
+}
+
 static	void	Create_form1( void )
 {
         token_header	form_token = { 0 };
@@ -1365,7 +1433,6 @@ static	void	Create_form1( void )
 	int32		*num_rings;
 	int32		*holes_procs_ptr;
 	int32		index;
-	int		pack_entry;
 	int		num_bytes;
 	sys_scatter	send_scat;
 	char		rg_info_buf[sizeof(token_body)];
@@ -1375,6 +1442,14 @@ static	void	Create_form1( void )
         members_info    valid_members;
 
 	form_token.type            = FORM1_TYPE;
+	/* flow_control is unused on FORM tokens and every daemon, older ones
+	 * included, passes it on untouched: with CompactGroupState each one
+	 * that fills the token in counts itself there (see Read_form2) */
+	if( Conf_get_compact_group_state() )
+	{
+		form_token.type   |= COMPACT_GROUPS_TYPE;
+		form_token.flow_control = 1;
+	}
 	form_token.proc_id         = My.id;
         form_token.memb_id.proc_id = My.id;             /* NOTE: this memb_id is only used to ensure a FORM2 token matches up with the most recent FORM1 token we processed */
         form_token.memb_id.time    = E_get_time().sec;
@@ -1458,10 +1533,10 @@ static	void	Create_form1( void )
 
 	rg_info->num_holes = 0;
 
-	for( index = My_aru+1; index <= Highest_seq; index++ )
+	/* not from My_aru: placeholders below it may be holes */
+	for( index = Last_discarded+1; index <= Highest_seq; index++ )
 	{
-	    pack_entry = index & PACKET_MASK;
-	    if( ! Packets[pack_entry].exist )
+	    if( ! Memb_holds_packet( index ) )
 	    {
 		num_bytes += sizeof(int32);
 		rg_info->num_holes++;
@@ -1539,7 +1614,7 @@ static	void	Create_form1( void )
 		/* singleton membership */
 		F_members.num_pending = 1;
 		F_members.num_members = 0;
-		form_token.type = FORM2_TYPE;
+		form_token.type = FORM2_TYPE | ( form_token.type & COMPACT_GROUPS_TYPE );
 		send_scat.elements[2].len = sizeof(membership_id);
 		form_token.rtr_len = send_scat.elements[1].len + send_scat.elements[2].len + send_scat.elements[3].len;
 		Net_ucast_token( My.id, &send_scat );
@@ -1580,7 +1655,6 @@ static	void	Fill_form1( sys_scatter *scat )
 	int32		*old_num_rings, *new_num_rings;
 	int32		*my_holes_procs_ptr, *new_holes_procs_ptr;
 	int32		index;
-	int		pack_entry;
 	char		rg_info_buf[sizeof(token_body)];
 	char		*c_ptr;
 	char		*rings_buf;
@@ -1600,6 +1674,8 @@ static	void	Fill_form1( sys_scatter *scat )
 	num_bytes  = 0;
 
 	form_token = (token_header *)scat->elements[0].buf;
+	if( Conf_get_compact_group_state() )
+		form_token->flow_control++;
 
 	m_info	   = (members_info *)scat->elements[1].buf;
 	num_bytes  += sizeof(members_info);
@@ -1823,8 +1899,7 @@ static	void	Fill_form1( sys_scatter *scat )
                 /* New ring_info will fit, so create it */
                 for( index = Last_discarded+1; index <= Highest_seq; index++ )
                 {
-                    pack_entry = index & PACKET_MASK;
-                    if( ! Packets[pack_entry].exist )
+                    if( ! Memb_holds_packet( index ) )
                     {
 			num_bytes += sizeof(int32);
 			new_rg_info->num_holes++;
@@ -1887,8 +1962,7 @@ static	void	Fill_form1( sys_scatter *scat )
 
 	    for( i=0; i < my_rg_info->num_holes; i++ )
 	    {
-		pack_entry = *my_holes_procs_ptr & PACKET_MASK;
-		if( ! Packets[pack_entry].exist )
+		if( ! Memb_holds_packet( *my_holes_procs_ptr ) )
 		{
 			num_bytes += sizeof(int32);
 			new_rg_info->num_holes++;
@@ -1908,8 +1982,7 @@ static	void	Fill_form1( sys_scatter *scat )
             {
 		for( index = my_rg_info->highest_seq+1; index <= Highest_seq; index++ )
 		{
-		    pack_entry = index & PACKET_MASK;
-		    if( ! Packets[pack_entry].exist )
+		    if( ! Memb_holds_packet( index ) )
 		    {
 			num_bytes += sizeof(int32);
 			new_rg_info->num_holes++;
@@ -2001,7 +2074,7 @@ static	void	Fill_form1( sys_scatter *scat )
 		Sort_members( m_info );
 		m_info->num_pending = m_info->num_members;
 		m_info->num_members = 0;
-		form_token->type = FORM2_TYPE;
+		form_token->type = FORM2_TYPE | ( form_token->type & COMPACT_GROUPS_TYPE );
 		/* this is the only difference between form1 and form2 tokens */
 		send_scat.elements[2].len = sizeof(membership_id);
 		form_token->rtr_len = send_scat.elements[1].len + send_scat.elements[2].len + send_scat.elements[3].len;
@@ -2117,7 +2190,7 @@ static	void	Read_form2( sys_scatter *scat )
 	for( i=0; i < *num_rings; i++ )
 	{
             if ( rg_info->num_trans < 1 || rg_info->num_trans > rg_info->num_commit || rg_info->num_commit > MAX_PROCS_RING || 
-                 rg_info->num_holes < 0 || rg_info->num_holes > MAX_SEQ_GAP )
+                 rg_info->num_holes < 0 || rg_info->num_holes > Packets_size )
             {
                 Alarmp( SPLOG_WARNING, MEMB, "Read_form2: WARNING!!! Malformed ring info; num_trans (%d), num_commit (%d), num_holes (%d) -- dropping!\n", 
                         rg_info->num_trans, rg_info->num_commit, rg_info->num_holes );
@@ -2147,6 +2220,9 @@ static	void	Read_form2( sys_scatter *scat )
         }
 
 	form_token->proc_id = My.id;
+	/* compact only if every member counted itself on the FORM1 token */
+	Future_compact_groups = Is_compact_groups( form_token->type ) &&
+		form_token->flow_control == m_info->num_members + m_info->num_pending;
 
 	m_info->num_members++;
 	m_info->num_pending--;
@@ -2207,7 +2283,7 @@ static	void	Read_form2( sys_scatter *scat )
 	for( i=0; i < my_rg_info->num_holes; i++ )
 	{
 	        /* create dummy messages */ 
-		pack_entry = *my_holes_procs_ptr & PACKET_MASK;
+		pack_entry = *my_holes_procs_ptr & Packet_mask;
 		Alarm( MEMB , "EXTRACT HOLE IS %d\n",*my_holes_procs_ptr);
 
 		if( Packets[pack_entry].exist != 0 )
@@ -2231,11 +2307,17 @@ static	void	Read_form2( sys_scatter *scat )
                          * consistent across all daemons, all who did get it must now forget it.  This won't
                          * violate any form of self delivery because the originator is not in this attempt. */
 
-                        Alarmp( SPLOG_WARNING, MEMB, "Read_form2: WARNING!!! Dropping packet %d from partitioning member 0x%08X received after FORM1 processed!\n", 
-                                *my_holes_procs_ptr, Packets[pack_entry].head->proc_id );
+                        /* A placeholder not delivered yet is also a hole when no
+                         * daemon here got its payload; see Memb_holds_packet. */
+                        if ( Is_placeholder( Packets[pack_entry].head->type ) )
+                                Alarmp( SPLOG_INFO, MEMB, "Read_form2: dropping placeholder %d from 0x%08X, no one here has its payload\n",
+                                        *my_holes_procs_ptr, Packets[pack_entry].head->proc_id );
+                        else
+                                Alarmp( SPLOG_WARNING, MEMB, "Read_form2: WARNING!!! Dropping packet %d from partitioning member 0x%08X received after FORM1 processed!\n", 
+                                        *my_holes_procs_ptr, Packets[pack_entry].head->proc_id );
 
                         dispose( Packets[pack_entry].head );
-                        dispose( Packets[pack_entry].body );
+                        Message_release_buffer( Packets[pack_entry].body );
                 }
 
 		Packets[pack_entry].exist = 3;
@@ -2496,7 +2578,7 @@ static	void	Backoff_membership( void )
 	for( i=Last_discarded+1; i <= Highest_seq; i++ )
 	{
 		/* clear dummy messages */
-		pack_entry = i & PACKET_MASK;
+		pack_entry = i & Packet_mask;
 		if( Packets[pack_entry].exist == 3 ) {
 		        Alarmp( SPLOG_INFO, MEMB, "Backoff_membership: reverting dummy hole to true hole for packet %d\n", pack_entry );
 			Packets[pack_entry].exist = 0;
@@ -2509,7 +2591,7 @@ static	void	Backoff_membership( void )
 	My_aru = Last_discarded;
 	for( i=Last_discarded+1; i <= Highest_seq; i++ )
 	{
-		pack_entry = i & PACKET_MASK;
+		pack_entry = i & Packet_mask;
 		if( !Packets[pack_entry].exist ) break;
 		My_aru++;
 	}
@@ -2589,6 +2671,7 @@ void	Memb_regular( void )
 
 	Membership = Future_membership;
 	Membership_id = Future_membership_id;
+	Compact_groups = Future_compact_groups;
 	Reg_membership = Membership;
 
         Commit_set.num_pending = 1;
@@ -57,6 +57,7 @@ membership_id	Memb_trans_id( void );
 int		Memb_is_equal( membership_id m1, membership_id m2 );
 int32		Memb_state( void );
 int		Memb_token_alive( void );
+int		Memb_compact_groups( void );
 void		Memb_handle_message( sys_scatter *scat );
 void		Memb_handle_token( sys_scatter *scat );
 void		Memb_token_loss(void);
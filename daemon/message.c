@@ -49,9 +49,12 @@
 
 static  char Temp_buf[100000];
 
+/* Takes another hold on a message. A message delivered to many sessions
+ * is shared by all their queues rather than copied, and its buffers go
+ * back to the pool when the last hold is released. */
 int32   Obj_Inc_Refcount(void *obj)
 {
-        return(0);
+        return( share_ref_cnt(obj) );
 }
 
 void    Message_populate_with_buffers(message_obj *msg)
@@ -245,23 +248,38 @@ void    Message_add_oldtype_to_reject( message_obj *msg, int32u old_type )
 
 void    Message_Dec_Refcount(message_obj *msg)
 {
-        /* Not needed for Spread3 */
-        return;
+        Message_dispose_message(msg);
 }
 
+/* Releases one hold on msg and frees it with the last one */
 void    Message_dispose_message(message_obj *msg)
 {
 	packet_body	*body_ptr;
 	int		i;
 
+	if( unshare_ref_cnt( msg ) > 0 ) return;
+
+	if( Mem_Obj_Type( msg ) == MESSAGE_SLICE )
+	{
+		Message_release_buffer( ((message_slice *)msg)->body );
+		dispose( msg );
+		return;
+	}
 	for( i=0; i < (int) msg->num_elements; i++ )
 	{
 		body_ptr = (packet_body *)msg->elements[i].buf;
-		dispose( body_ptr );
+		Message_release_buffer( body_ptr );
 	}
 	dispose( msg );
 }
 
+/* Drops one hold on a packet body that Deliver_packet may have shared
+ * between Packets[], the delivered message and its slices */
+void    Message_release_buffer(void *buf)
+{
+	if( unshare_ref_cnt( buf ) == 0 ) dispose( buf );
+}
+
 message_obj     *Message_dup_and_reset_old_message(message_obj *msg, int len)
 {
         message_obj     *mess_dup;
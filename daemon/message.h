@@ -41,6 +41,15 @@
 #include "prot_objs.h"
 #include "scatter.h"
 #include "session.h"
+#include "net_types.h"
+
+/* A delivered message whose single element points into a packet body
+ * shared with other messages (and possibly Packets[]). Created in
+ * Deliver_packet; Message_dispose_message releases the body. */
+typedef struct  dummy_message_slice {
+        scatter         mess;   /* must be first, used as a message_obj */
+        packet_body     *body;
+} message_slice;
 
 int32           Obj_Inc_Refcount(void *obj);
 
@@ -77,6 +86,7 @@ void            Message_Buffer_to_Message_Fragments( message_obj *msg, char buf[
 void            Message_add_oldtype_to_reject( message_obj *msg, int32u old_type );
 
 void            Message_dispose_message(message_obj *msg);
+void            Message_release_buffer(void *buf);
 void            Message_Dec_Refcount(message_obj *msg);
 
 #endif  /* INC_MESSAGE */
@@ -39,6 +39,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <errno.h>
 
 #include "arch.h"
@@ -941,12 +942,39 @@ static	void	Kill_spreads()
 	}
 }
 
+/* Print count and upper bounds of the buckets holding the median, 99th,
+ * 99.9th percentile and maximum of a status histogram. */
+static	void	Print_hist( const char *name, int32 *hist, const char *unit )
+{
+	static	const	int	per_mille[4] = { 500, 990, 999, 1000 };
+	int	bound[4];
+	double	total, seen;
+	int	i, p;
+
+	total = 0;
+	for( i=0; i < STAT_HIST_BUCKETS; i++ ) total += hist[i];
+	if( total == 0 ) return;
+
+	seen = 0;
+	p = 0;
+	for( i=0; i < STAT_HIST_BUCKETS && p < 4; i++ )
+	{
+		seen += hist[i];
+		while( p < 4 && seen * 1000 >= total * per_mille[p] )
+			bound[p++] = STAT_HIST_LOW( i+1 ) - 1;
+	}
+	printf("%-10s: %7.0f\tp50 <= %d%s  p99 <= %d%s  p99.9 <= %d%s  max <= %d%s\n", name, total,
+		bound[0], unit, bound[1], unit, bound[2], unit, bound[3], unit );
+}
+
 static	void	Report_message(mailbox fd, int dummy, void *dummy_p)
 {
 	proc	p;
 	proc	leader_p;
 	int	ret;
 	int	ret1,ret2;
+	int	i,j;
+	int	extended;
 static	int32	last_mes;
 static	int32	last_aru;
 static	int32	last_sec;
@@ -960,6 +988,18 @@ static	int32	last_sec;
             Alarm( DEBUG, "Report_messsage: DL_recv failed with ret %d, errno %d\n", ret, sock_errno);
             return;
         }
+	ret -= sizeof(packet_header);
+	if( ret < (int) offsetof( status, status_version ) )
+	{
+		printf("Report_message: Skipping short status of %d bytes\n", ret );
+		return;
+	}
+
+	if( !Same_endian( Report_pack.type ) )
+		GlobalStatus.status_version	= Flip_int16( GlobalStatus.status_version );
+
+	/* the fields after status_version are only read from a daemon laying them out as we do */
+	extended = ( ret >= (int) sizeof(status) && GlobalStatus.status_version == STATUS_VERSION );
 
 	if( !Same_endian( Report_pack.type ) )
 	{
@@ -994,6 +1034,19 @@ static	int32	last_sec;
 		GlobalStatus.minor_version		= Flip_int16( GlobalStatus.minor_version );
 		GlobalStatus.patch_version		= Flip_int16( GlobalStatus.patch_version );
 	}
+	if( !extended )
+	{
+		memset( &GlobalStatus.adaptive_window, 0, sizeof(status) - offsetof( status, adaptive_window ) );
+	}else if( !Same_endian( Report_pack.type ) ){
+		GlobalStatus.adaptive_window	= Flip_int16( GlobalStatus.adaptive_window );
+		GlobalStatus.fc_loss_rounds	= Flip_int32( GlobalStatus.fc_loss_rounds );
+		GlobalStatus.fc_adjustments	= Flip_int32( GlobalStatus.fc_adjustments );
+		GlobalStatus.placeholders_sent	= Flip_int32( GlobalStatus.placeholders_sent );
+		GlobalStatus.placeholders_recv	= Flip_int32( GlobalStatus.placeholders_recv );
+		for( i=0; i < STAT_NUM_HISTS; i++ )
+			for( j=0; j < STAT_HIST_BUCKETS; j++ )
+				GlobalStatus.hist[i][j] = Flip_int32( GlobalStatus.hist[i][j] );
+	}
 	printf("\n============================\n");
 	ret1 = Conf_proc_by_id( GlobalStatus.my_id, &p );
 	ret2 = Conf_proc_by_id( GlobalStatus.leader_id, &leader_p );
@@ -1023,6 +1076,17 @@ static	int32	last_sec;
 	printf("Sessions : %7d\tGroups    : %7d\tWindow     : %7d\n",GlobalStatus.num_sessions,GlobalStatus.num_groups,GlobalStatus.window);
 	printf("Deliver M: %7d\tDeliver Pk: %7d\tP/A Window : %7d/%d\n",GlobalStatus.message_delivered,GlobalStatus.packet_delivered,GlobalStatus.personal_window,GlobalStatus.accelerated_window);
 	printf("Delta Mes: %7d\tDelta Pk  : %7d\tDelta sec  : %7d\n",GlobalStatus.message_delivered - last_mes,GlobalStatus.aru - last_aru,GlobalStatus.sec - last_sec);
+	if( !extended )
+		printf("Status version %d of %d bytes: flow control and latency details not shown\n",
+			GlobalStatus.status_version, ret );
+	if( GlobalStatus.adaptive_window )
+		printf("Adaptive : %7s\tLoss rnds : %7d\tAdjusts    : %7d\n","on",GlobalStatus.fc_loss_rounds,GlobalStatus.fc_adjustments);
+	if( GlobalStatus.placeholders_sent || GlobalStatus.placeholders_recv )
+		printf("Placehold: %7d\tPlc recv  : %7d\n",GlobalStatus.placeholders_sent,GlobalStatus.placeholders_recv);
+	Print_hist( "Token rnd", GlobalStatus.hist[STAT_HIST_TOKEN_ROUND], "us" );
+	Print_hist( "Pack/visit", GlobalStatus.hist[STAT_HIST_TOKEN_PACKETS], "" );
+	Print_hist( "Agreed lat", GlobalStatus.hist[STAT_HIST_AGREED], "us" );
+	Print_hist( "Safe lat", GlobalStatus.hist[STAT_HIST_SAFE], "us" );
 	printf("==================================\n");
 
 	printf("\n");
@@ -56,6 +56,8 @@
 
 #define		HURRY_TYPE		0x00000040
 
+#define		PLACEHOLDER_TYPE	0x00004000	/* SelectiveDelivery: seq only, body is the route_mask of segments sent the payload */
+
 #define		ALIVE_TYPE		0x00000100
 #define		JOIN_TYPE		0x00000200
 #define		REFER_TYPE		0x00000400
@@ -64,6 +66,7 @@
 #define		FORM1_TYPE		0x00001000
 #define		FORM2_TYPE		0x00002000
 #define		FORM_TYPE		0x00003000
+#define		COMPACT_GROUPS_TYPE	0x00008000	/* FORM tokens: flow_control counts the daemons running CompactGroupState */
 
 #define		ARQ_TYPE		0x000f0000
 #define	        RETRANS_TYPE		0x00f00000
@@ -88,6 +91,9 @@
 
 #define		Is_hurry( type )	( type &  HURRY_TYPE      )
 
+#define		Is_placeholder( type )	( type &  PLACEHOLDER_TYPE )
+#define		Set_placeholder( type )	( type |  PLACEHOLDER_TYPE )
+
 #define		Is_alive( type )	( type &  ALIVE_TYPE      )
 #define		Is_join( type )		( type &  JOIN_TYPE       )
 #define		Is_refer( type )	( type &  REFER_TYPE      )
@@ -96,6 +102,7 @@
 #define		Is_form( type )		( type &  FORM_TYPE	  )
 #define		Is_form1( type )	( type &  FORM1_TYPE	  )
 #define		Is_form2( type )	( type &  FORM2_TYPE	  )
+#define		Is_compact_groups( type ) ( type & COMPACT_GROUPS_TYPE )
 
 #define		Get_arq( type )		( (type &  ARQ_TYPE) >> 16)
 #define		Set_arq( type, val )	( (type & ~ARQ_TYPE) | ((val << 16)&ARQ_TYPE) )
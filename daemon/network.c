@@ -43,6 +43,8 @@
 #include "spu_events.h"
 #include "status.h"
 #include "spu_alarm.h"
+#include "spu_memory.h"
+#include "spu_objects.h"
 #include "configuration.h"
 
 /* for Memb_print_form_token() */
@@ -55,6 +57,9 @@ static	channel		Send_channel;
 static  int             Num_bcast_channels;
 static  int             Num_token_channels;
 
+static	int		Use_gso;
+static	int		Use_gro;
+
 static	int		Bcast_needed;
 static	int32		Bcast_address;
 static	int16		Bcast_port;
@@ -62,6 +67,7 @@ static	int16		Bcast_port;
 static	int		Num_send_needed;
 static  int32		Send_address[MAX_SEGMENTS];
 static	int16		Send_ports[MAX_SEGMENTS];
+static	int		Send_segment[MAX_SEGMENTS];
 
 /* address for token sending - which is always needed */
 static	int32		Token_address;
@@ -73,12 +79,25 @@ static	int		Segment_leader;
 static 	configuration	*Cn;
 static	proc		My;
 
+/* broadcast packets waiting for Net_flush_bcast; owned by the network layer */
+static	sys_scatter	*Bcast_queue[MAX_SEND_BATCH];
+static	int		Bcast_queue_len;
+
+/* SelectiveDelivery: queued packets whose payload only goes to the segments
+ * in their mask; other segments get a placeholder carrying seq and mask */
+static	bool		Bcast_queue_selective[MAX_SEND_BATCH];
+static	route_mask	Bcast_queue_mask[MAX_SEND_BATCH];
+static	int		Bcast_queue_num_selective;
+static	packet_header	Placeholder_head[MAX_SEND_BATCH];
+static	sys_scatter	*Placeholder[MAX_SEND_BATCH];
+
 static	int16		Partition[MAX_PROCS_RING];
 static	sp_time		Partition_timeout 	= { 60, 0};
 static	int		Partition_my_index;
 
 static	void		Clear_partition_cb(int dummy, void *dummy_p);
 static	int		In_my_component( int32	proc_id );
+static	int		Net_process_recv( sys_scatter *scat, int received_bytes );
 static	void		Flip_pack( packet_header *pack_ptr );
 static	void		Flip_token( token_header *token_ptr );
 
@@ -142,6 +161,19 @@ void	Net_init()
 
 	Send_channel  = DL_init_channel( SEND_CHANNEL, My.port+2, 0, My.id );
 
+	/* DataLinkOffload: segmentation offload for packet bursts, where the kernel has it */
+	Use_gso = 0;
+	Use_gro = 0;
+	if( Conf_get_link_offload() )
+	{
+		Use_gso = DL_enable_gso( Send_channel );
+		for( i=0; i < Num_bcast_channels; i++ )
+			if( DL_enable_gro( Bcast_channel[i] ) ) Use_gro = 1;
+
+		Alarmp( SPLOG_INFO, NETWORK, "Net_init: DataLinkOffload: send offload %s, receive offload %s\n",
+			Use_gso ? "on" : "off", Use_gro ? "on" : "off" );
+	}
+
 	Num_send_needed = 0;
 }
 /* Called from above when configuration file is reloaded (potentially with changes to spread configuration
@@ -194,6 +226,7 @@ void	Net_set_membership( configuration memb )
 
 		Send_address[Num_send_needed] = Net_membership.segments[i].procs[0]->id;
 		Send_ports  [Num_send_needed] = Net_membership.segments[i].port;
+		Send_segment[Num_send_needed] = i;
 
 		Num_send_needed++;
 	    }
@@ -248,6 +281,7 @@ int	Net_bcast( sys_scatter *scat )
 	int		ret;
 
 	ret = 0;
+	Net_flush_bcast();
 	/* routing on channels if needed according to membership */
 	pack_ptr = (packet_header *)scat->elements[0].buf;
 	pack_ptr->type  = Set_routed( pack_ptr->type );
@@ -272,6 +306,135 @@ int	Net_bcast( sys_scatter *scat )
 	return( ret );
 }
 
+/* Queues a new(SYS_SCATTER) packet for broadcast; it is disposed once sent.
+ * Queued packets go out together, one sendmmsg per destination, when
+ * Net_flush_bcast is called, the queue fills, or any other packet or the
+ * token is sent, so the order on the wire is the order of the calls.
+ */
+int	Net_queue_bcast( sys_scatter *scat )
+{
+	if( Bcast_queue_len == MAX_SEND_BATCH )
+		Net_flush_bcast();
+
+	Bcast_queue_selective[Bcast_queue_len] = FALSE;
+	Bcast_queue[Bcast_queue_len++] = scat;
+
+	return( 1 );
+}
+
+/* Like Net_queue_bcast, but Net_flush_bcast sends a placeholder for the
+ * packet instead of its payload to each segment it unicasts to (those of
+ * the membership but mine) whose bit is clear in seg_mask. My own segment
+ * always gets the payload, by broadcast, whatever seg_mask says.
+ */
+int	Net_queue_bcast_selective( sys_scatter *scat, route_mask seg_mask )
+{
+	if( Bcast_queue_len == MAX_SEND_BATCH )
+		Net_flush_bcast();
+
+	Bcast_queue_selective[Bcast_queue_len] = TRUE;
+	memcpy( Bcast_queue_mask[Bcast_queue_len], seg_mask, sizeof(route_mask) );
+	Bcast_queue_num_selective++;
+	Bcast_queue[Bcast_queue_len++] = scat;
+
+	return( 1 );
+}
+
+static	sys_scatter	*Net_placeholder( int index )
+{
+	packet_header	*pack_ptr;
+	sys_scatter	*scat;
+
+	if( Placeholder[index] != NULL ) return( Placeholder[index] );
+
+	pack_ptr = &Placeholder_head[index];
+	memcpy( pack_ptr, Bcast_queue[index]->elements[0].buf, sizeof(packet_header) );
+	pack_ptr->type     = Set_placeholder( pack_ptr->type );
+	pack_ptr->data_len = sizeof(route_mask);
+
+	scat = new( SYS_SCATTER );
+	scat->num_elements    = 2;
+	scat->elements[0].buf = (char *) pack_ptr;
+	scat->elements[0].len = sizeof(packet_header);
+	scat->elements[1].buf = (char *) Bcast_queue_mask[index];
+	scat->elements[1].len = sizeof(route_mask);
+	Placeholder[index] = scat;
+
+	return( scat );
+}
+
+int	Net_flush_bcast( void )
+{
+static	sys_scatter	*Seg_queue[MAX_SEND_BATCH];
+	sys_scatter	**send_queue;
+	packet_header	*pack_ptr;
+	int32u		seg_bit;
+	int		num_packets;
+	int 		i, j;
+
+	num_packets = Bcast_queue_len;
+	if( num_packets == 0 ) return( 0 );
+
+	/* routing on channels if needed according to membership */
+	for( i=0; i < num_packets; i++ )
+	{
+	    pack_ptr = (packet_header *)Bcast_queue[i]->elements[0].buf;
+	    pack_ptr->type  = Set_routed( pack_ptr->type );
+	    pack_ptr->type  = Set_endian( pack_ptr->type );
+	    pack_ptr->conf_hash = Cn->hash_code;
+	    pack_ptr->transmiter_id = My.id;
+	}
+	for ( i=0; i< Num_send_needed; i++ )
+	{
+	    send_queue = Bcast_queue;
+	    if( Bcast_queue_num_selective > 0 )
+	    {
+		seg_bit = 0x1 << ( Send_segment[i] % 32 );
+		for( j=0; j < num_packets; j++ )
+		{
+		    if( Bcast_queue_selective[j] && !( Bcast_queue_mask[j][Send_segment[i] / 32] & seg_bit ) )
+			Seg_queue[j] = Net_placeholder( j );
+		    else
+			Seg_queue[j] = Bcast_queue[j];
+		}
+		send_queue = Seg_queue;
+	    }
+	    if( Use_gso )
+		DL_send_gso( Send_channel, Send_address[i], Send_ports[i], send_queue, num_packets );
+	    else
+		DL_send_batch( Send_channel, Send_address[i], Send_ports[i], send_queue, num_packets );
+	}
+	for( i=0; i < num_packets; i++ )
+	{
+	    pack_ptr = (packet_header *)Bcast_queue[i]->elements[0].buf;
+	    pack_ptr->type = Clear_routed( pack_ptr->type );
+	}
+
+	/* broadcasting if needed according to configuration */
+	if( Bcast_needed )
+	{
+	    if( Use_gso )
+		DL_send_gso( Send_channel, Bcast_address, Bcast_port, Bcast_queue, num_packets );
+	    else
+		DL_send_batch( Send_channel, Bcast_address, Bcast_port, Bcast_queue, num_packets );
+	}
+
+	for( i=0; i < num_packets; i++ )
+	{
+		dispose( Bcast_queue[i] );
+		if( Placeholder[i] != NULL )
+		{
+			dispose( Placeholder[i] );
+			Placeholder[i] = NULL;
+			GlobalStatus.placeholders_sent++;
+		}
+	}
+	Bcast_queue_len = 0;
+	Bcast_queue_num_selective = 0;
+
+	return( num_packets );
+}
+
 int	Net_scast( int16 seg_index, sys_scatter *scat )
 {
 	packet_header	*pack_ptr;
@@ -279,6 +442,7 @@ int	Net_scast( int16 seg_index, sys_scatter *scat )
         bool            send_not_needed_p = FALSE;
 
 	ret = 0;
+	Net_flush_bcast();
 	pack_ptr = (packet_header *)scat->elements[0].buf;
 	pack_ptr->type = Set_endian( pack_ptr->type );
         pack_ptr->conf_hash = Cn->hash_code;
@@ -312,49 +476,144 @@ int	Net_scast( int16 seg_index, sys_scatter *scat )
 int	Net_ucast( int32 proc_id, sys_scatter *scat )
 {
 	packet_header	*pack_ptr;
-	proc		p;
+	proc		*p;
 	int		ret;
 
+	Net_flush_bcast();
 	pack_ptr = (packet_header *)scat->elements[0].buf;
 	pack_ptr->type = Set_endian( pack_ptr->type );
         pack_ptr->conf_hash = Cn->hash_code;
 	pack_ptr->transmiter_id = My.id;
-	ret = Conf_proc_by_id( proc_id, &p );
+	ret = Conf_proc_ref_by_id( proc_id, &p );
 	if( ret < 0 )
 	{
 		Alarm( PRINT, "Net_ucast: non existing proc_id %d\n",proc_id );
 		return( ret );
 	}
-	ret = DL_send( Send_channel, proc_id, p.port, scat );
+	ret = DL_send( Send_channel, proc_id, p->port, scat );
 	return( ret );
 }
 
-int	Net_recv ( channel fd, sys_scatter *scat )
+/* Sets the header fields Net_scast and Net_ucast set, on each of scats */
+static	void	Net_stamp_batch( sys_scatter *scats[], int num_scats )
 {
-static	scatter		save;
 	packet_header	*pack_ptr;
-	int		bytes_left;
-	int		received_bytes;
 	int		i;
-        bool            ch_found;
 
-	pack_ptr = (packet_header *)scat->elements[0].buf;
+	for( i=0; i < num_scats; i++ )
+	{
+		pack_ptr = (packet_header *)scats[i]->elements[0].buf;
+		pack_ptr->type = Set_endian( pack_ptr->type );
+		pack_ptr->conf_hash = Cn->hash_code;
+		pack_ptr->transmiter_id = My.id;
+	}
+}
+
+/* Net_scast for several packets, passed to the kernel together */
+int	Net_scast_batch( int16 seg_index, sys_scatter *scats[], int num_scats )
+{
+	packet_header	*pack_ptr;
+	int		ret;
+	int		i;
+
+	Net_flush_bcast();
+	Net_stamp_batch( scats, num_scats );
+	if( seg_index == My.seg_index )
+	{
+	    if( !Bcast_needed ) return( num_scats );
+	    return( DL_send_batch( Send_channel, Bcast_address, Bcast_port, scats, num_scats ) );
+	}
+	if( Net_membership.segments[seg_index].num_procs == 0 ) return( num_scats );
+
+	for( i=0; i < num_scats; i++ )
+	{
+	    pack_ptr = (packet_header *)scats[i]->elements[0].buf;
+	    pack_ptr->type = Set_routed( pack_ptr->type );
+	}
+	ret = DL_send_batch( Send_channel, 
+		Net_membership.segments[seg_index].procs[0]->id,
+		Net_membership.segments[seg_index].port,
+		scats, num_scats );
+	for( i=0; i < num_scats; i++ )
+	{
+	    pack_ptr = (packet_header *)scats[i]->elements[0].buf;
+	    pack_ptr->type = Clear_routed( pack_ptr->type );
+	}
+	return( ret );
+}
+
+/* Net_ucast for several packets, passed to the kernel together */
+int	Net_ucast_batch( int32 proc_id, sys_scatter *scats[], int num_scats )
+{
+	proc		*p;
+	int		ret;
+
+	Net_flush_bcast();
+	Net_stamp_batch( scats, num_scats );
+	ret = Conf_proc_ref_by_id( proc_id, &p );
+	if( ret < 0 )
+	{
+		Alarm( PRINT, "Net_ucast_batch: non existing proc_id %d\n",proc_id );
+		return( ret );
+	}
+	return( DL_send_batch( Send_channel, proc_id, p->port, scats, num_scats ) );
+}
+
+static	void	Net_check_bcast_channel( channel fd )
+{
+	int		i;
 
-        ch_found = FALSE;
         for (i = 0 ; i < Num_bcast_channels; i++) {
-            if ( fd == Bcast_channel[i]) {
-                ch_found = TRUE; 
-                break;
-            }
-        }
-        if (ch_found == FALSE) {
-            Alarm(EXIT, "Net_recv: Listening and received packet on un-used interface %d\n", fd);
+            if ( fd == Bcast_channel[i]) return;
         }
+        Alarm(EXIT, "Net_recv: Listening and received packet on un-used interface %d\n", fd);
+}
+
+int	Net_recv ( channel fd, sys_scatter *scat )
+{
+	int		received_bytes;
+
+        Net_check_bcast_channel( fd );
 
 	received_bytes = DL_recv( fd, scat ); 
 
 	if( received_bytes <= 0 ) return( received_bytes );
 
+	return( Net_process_recv( scat, received_bytes ) );
+}
+
+/* Like Net_recv but drains up to num_scats packets in one call. lens[i] is
+ * set to what Net_recv would have returned for the packet in scats[i].
+ * Returns the number of entries filled, or -1 if receiving failed.
+ */
+int	Net_recv_batch( channel fd, sys_scatter *scats[], int num_scats, int *lens )
+{
+	int		num_recv;
+	int		i;
+
+        Net_check_bcast_channel( fd );
+
+	if( Use_gro )
+		num_recv = DL_recv_gro( fd, scats, num_scats, lens );
+	else
+		num_recv = DL_recv_batch( fd, scats, num_scats, lens );
+
+	for( i=0; i < num_recv; i++ )
+	{
+		if( lens[i] > 0 ) lens[i] = Net_process_recv( scats[i], lens[i] );
+	}
+	return( num_recv );
+}
+
+static	int	Net_process_recv( sys_scatter *scat, int received_bytes )
+{
+static	scatter		save;
+	packet_header	*pack_ptr;
+	int		bytes_left;
+	int		i;
+
+	pack_ptr = (packet_header *)scat->elements[0].buf;
+
 	if( received_bytes < sizeof( packet_header ) ) 
 	{
 		Alarm(PRINT, "Net_recv: ignoring packet of size %d, smaller than packet header size %d\n", 
@@ -498,6 +757,9 @@ int	Net_send_token( sys_scatter *scat )
                         send_len, MAX_PACKET_SIZE );
         }
 
+	/* queued packets must precede the token */
+	Net_flush_bcast();
+
 	token_ptr->type          = Set_endian( token_ptr->type );
         token_ptr->conf_hash     = Cn->hash_code;
 	token_ptr->transmiter_id = My.id;
@@ -561,7 +823,7 @@ int	Net_ucast_token( int32 proc_id, sys_scatter *scat )
 {
 	token_header *token_ptr = ( token_header * ) scat->elements[0].buf;
         int           send_len  = 0;
-	proc	      p;
+	proc	      *p;
 	int	      ret;
         int           i;
 
@@ -585,11 +847,14 @@ int	Net_ucast_token( int32 proc_id, sys_scatter *scat )
                         send_len, MAX_PACKET_SIZE );
         }
 
+	/* queued packets must precede the token */
+	Net_flush_bcast();
+
 	token_ptr->type = Set_endian( token_ptr->type );
         token_ptr->conf_hash = Cn->hash_code;
 	token_ptr->transmiter_id = My.id;
 
-	ret = Conf_proc_by_id( proc_id, &p );
+	ret = Conf_proc_ref_by_id( proc_id, &p );
 
 	if( ret < 0 )
 	{
@@ -604,7 +869,7 @@ int	Net_ucast_token( int32 proc_id, sys_scatter *scat )
 		IP( proc_id ), token_ptr->type, token_ptr->transmiter_id, token_ptr->seq, token_ptr->proc_id, 
                 token_ptr->aru, token_ptr->aru_last_id, Token_address, send_len );
 
-	ret = DL_send( Send_channel, proc_id, p.port+1, scat );
+	ret = DL_send( Send_channel, proc_id, p->port+1, scat );
 	return( ret );
 }
 
@@ -653,10 +918,10 @@ static	void	Clear_partition_cb(int dummy, void *dummy_p)
 static	int	In_my_component( int32	proc_id )
 {
 	int	proc_index;
-	proc	dummy_proc;
+	proc	*dummy_proc;
 	char	ip[16];
 
-	proc_index = Conf_proc_by_id( proc_id, &dummy_proc );
+	proc_index = Conf_proc_ref_by_id( proc_id, &dummy_proc );
 	if( proc_index < 0 )
 	{
 		Conf_id_to_str( proc_id, ip );
@@ -40,6 +40,7 @@
 #include "arch.h"
 #include "scatter.h"
 #include "configuration.h"
+#include "prot_objs.h"
 
 void	Net_init();
 void	Net_set_membership( configuration memb );
@@ -47,10 +48,14 @@ void    Net_signal_conf_reload(void);
 
 int	Net_bcast( sys_scatter *scat );
 int     Net_queue_bcast(sys_scatter *scat);
+int     Net_queue_bcast_selective(sys_scatter *scat, route_mask seg_mask);
 int     Net_flush_bcast(void);
 int	Net_scast( int16 seg_index, sys_scatter *scat );
 int	Net_ucast( int32 proc_id, sys_scatter *scat );
+int	Net_scast_batch( int16 seg_index, sys_scatter *scats[], int num_scats );
+int	Net_ucast_batch( int32 proc_id, sys_scatter *scats[], int num_scats );
 int	Net_recv ( channel fd, sys_scatter *scat );
+int	Net_recv_batch( channel fd, sys_scatter *scats[], int num_scats, int *lens );
 int	Net_send_token( sys_scatter *scat );
 int	Net_recv_token( channel fd, sys_scatter *scat );
 int	Net_ucast_token( int32 proc_id, sys_scatter *scat );
@@ -40,6 +40,7 @@
 #include "configuration.h"
 #include "spread_params.h"
 #include "net_types.h"
+#include "prot_objs.h"
 #include "spu_events.h" /* for sp_time */
 #include "protocol.h"
 
@@ -49,6 +50,9 @@ typedef	struct	dummy_packet_info {
 	packet_body	*body;
 	int		exist;
 	int		proc_index;
+	sp_time		enq_time;	/* own packets: enq_time of the message that starts it */
+	bool		selective;	/* own packets: only segments in seg_mask get the payload */
+	route_mask	seg_mask;
 } packet_info;
 
 typedef	struct	dummy_up_queue {
@@ -66,7 +70,9 @@ typedef	struct	dummy_up_queue {
 ext	down_queue	*Down_queue_ptr;
 ext	up_queue	Up_queue[MAX_PROCS_RING+1];
 
-ext	packet_info	Packets[MAX_PACKETS_IN_STRUCT];
+ext	packet_info	*Packets;		/* Packets_size entries, indexed by seq & Packet_mask */
+ext	int32		Packets_size;
+ext	int32		Packet_mask;
 
 ext	int32		Aru;
 ext	int32		My_aru;
@@ -89,6 +95,7 @@ ext	int		Last_num_sent;
 
 ext	sp_time		Token_timeout;
 ext	sp_time		Hurry_timeout;
+ext	sp_time		Token_loss_min_timeout;	/* floor of the measured token loss timeout */
 
 ext	sp_time		Alive_timeout;
 ext	sp_time		Join_timeout;
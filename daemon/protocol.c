@@ -36,6 +36,7 @@
 #define ext_prot_body
 
 #include <string.h>
+#include <stdlib.h>
 
 #include "prot_body.h"
 #include "spread_params.h"
@@ -51,6 +52,8 @@
 #include "spu_memory.h"
 #include "spu_alarm.h"
 #include "sess_types.h"
+#include "message.h"
+#include "groups.h"
 
 typedef struct queue_link
 {
@@ -80,11 +83,26 @@ static  proc            My;
 static  int             My_index;
 
 static  int32           Prev_proc_id; /* predecessor in ring (i.e. process that sends me the token) */
+static  sp_time         Last_token_time; /* when the previous token visit was processed */
+
+/* Token loss detection scaled from measured token rounds (FastFailureDetection), in usec */
+static  int32           Round_srtt;
+static  int32           Round_rttvar;
+static  int             Round_samples;
+static  sp_time         Token_loss_timeout;
 static  bool            Token_has_priority; /* true when token channels have higher priority than bcast channels */
 static  int             Token_counter;
 
 /* Used ONLY in Prot_handle_bcast, inited in Prot_init */
-static  sys_scatter     New_pack;
+static  sys_scatter     New_packs[MAX_RECV_BATCH];
+static  sys_scatter    *New_pack_ptrs[MAX_RECV_BATCH];
+
+/* Work deferred to the end of a received batch by Prot_handle_packet */
+static  bool            Batch_token_seen;
+static  bool            Batch_deliver_agreed;
+static  int             Batch_num_packets;
+static  int             Batch_num_reliable;
+static  int32           Batch_reliable_seq[MAX_RECV_BATCH];
 
 /* Used ONLY in Prot_handle_token and grurot, inited in Prot_init */
 static  sys_scatter     New_token;
@@ -103,8 +121,11 @@ static  down_queue      Protocol_down_queue[2]; /* only used in spread3 */
 static  int             Prot_delivery_threshold = BLOCK_REGULAR_DELIVERY;
 
 static  void    Prot_handle_bcast( int fd, int dmy, void *dmy_ptr );
+static  bool    Prot_handle_packet( sys_scatter *scat );
+static  void    Prot_flush_batch( void );
 static  void    Prot_handle_token( int fd, int dmy, void *dmy_ptr );
 static  int     Answer_retrans( int *ret_new_ptr, int32 *proc_id, int16 *seg_index );
+static  void    Send_retrans( ring_rtr *rtr, sys_scatter *scats[], int num_scats );
 static  int     Send_new_packets( int num_allowed );
 static  int     Prot_queue_bcast( sys_scatter *send_pack_ptr, packet_queue *pack_queue );
 static  int     Prot_flush_bcast( packet_queue *pack_queue );
@@ -122,6 +143,13 @@ static  void    Deliver_agreed_packets_event( int dmy, void *dmy_ptr );
 static  void    Deliver_agreed_packets();
 
 static  void    Prot_handle_conf_reload( sys_scatter *scat );
+static  void    Prot_size_packets( int32 max_seq_gap );
+static  bool    Prot_add_message_mask( scatter *mess, route_mask seg_mask );
+static  void    Prot_net_queue_bcast( sys_scatter *send_pack_ptr );
+static  bool    Prot_accept_placeholder( packet_header *pack_ptr, int32 *seg_mask );
+static  bool    Prot_placeholder_answers( int pack_entry, ring_rtr *ring_rtr_ptr );
+static  void    Prot_measure_round( int32 round );
+static  sp_time Prot_token_loss_timeout( void );
 
 void Prot_init( void )
 {
@@ -129,11 +157,12 @@ void Prot_init( void )
         channel *bcast_channels;
         channel *token_channels;
 
-        Mem_init_object( PACK_HEAD_OBJ, "pack_head", sizeof( packet_header ), MAX_PACKETS_IN_STRUCT, 0 );
-        Mem_init_object( PACKET_BODY, "packet_body", sizeof( packet_body ), MAX_PACKETS_IN_STRUCT, 0 );
+        Mem_init_object( PACK_HEAD_OBJ, "pack_head", sizeof( packet_header ), MIN_PACKETS_IN_STRUCT, 0 );
+        Mem_init_object( PACKET_BODY, "packet_body", sizeof( packet_body ), MIN_PACKETS_IN_STRUCT, 0 );
         Mem_init_object( TOKEN_HEAD_OBJ, "token_head", sizeof( token_header ), 10, 0 );
         Mem_init_object( TOKEN_BODY_OBJ, "token_body", sizeof( token_body ), 10, 0 );
         Mem_init_object( SCATTER, "scatter", sizeof( scatter ), 200+MAX_PROCS_RING, 0 );
+        Mem_init_object( MESSAGE_SLICE, "message_slice", sizeof( message_slice ), 200, 0 );
         Mem_init_object( SYS_SCATTER, "sys_scatter", sizeof( sys_scatter ), 200, 0 );
         Mem_init_object( QUEUE_LINK, "queue_link", sizeof( queue_link ), 200, 0 );
 
@@ -146,8 +175,9 @@ void Prot_init( void )
         for( i=0; i < MAX_PROCS_RING+1; i++ )
                 Up_queue[i].exist = 0;
 
-        for( i=0; i < MAX_PACKETS_IN_STRUCT; i++ )
-                Packets[i].exist = 0;
+        Packets      = NULL;
+        Packets_size = 0;
+        Prot_size_packets( Conf_get_max_seq_gap() );
 
         if ( Conf_debug_initial_sequence() ) {
                 Highest_seq      = INITIAL_SEQUENCE_NEAR_WRAP;
@@ -169,11 +199,15 @@ void Prot_init( void )
         Send_pack_queue.first = NULL;
         Send_pack_queue.last = NULL;
 
-        New_pack.num_elements = 2;
-        New_pack.elements[0].len = sizeof(packet_header);
-        New_pack.elements[0].buf = (char *) new(PACK_HEAD_OBJ);
-        New_pack.elements[1].len = sizeof(packet_body);
-        New_pack.elements[1].buf = (char *) new(PACKET_BODY);
+        for( i=0; i < MAX_RECV_BATCH; i++ )
+        {
+                New_packs[i].num_elements = 2;
+                New_packs[i].elements[0].len = sizeof(packet_header);
+                New_packs[i].elements[0].buf = (char *) new(PACK_HEAD_OBJ);
+                New_packs[i].elements[1].len = sizeof(packet_body);
+                New_packs[i].elements[1].buf = (char *) new(PACKET_BODY);
+                New_pack_ptrs[i] = &New_packs[i];
+        }
 
         New_token.num_elements  = 2;
         New_token.elements[0].len = sizeof(token_header);
@@ -279,13 +313,67 @@ down_link *Prot_Create_Down_Link( message_obj *msg, int type, int mbox, int cur_
 }
 
 static void Prot_handle_bcast( channel fd, int dummy, void *dummy_p )
+{
+        int             received_bytes[MAX_RECV_BATCH];
+        int             num_recv;
+        int             i;
+
+        /* Drain whatever is already queued on the socket. Delivery, timer rearming
+         * and status updates are done once for the batch in Prot_flush_batch */
+        num_recv = Net_recv_batch( fd, New_pack_ptrs, MAX_RECV_BATCH, received_bytes );
+
+        for( i=0; i < num_recv; i++ )
+        {
+                /* problem in receiving */
+                if ( received_bytes[i] <= 0 ) continue;
+
+                if ( Prot_handle_packet( &New_packs[i] ) )
+                {
+                        /* packet kept in Packets[], prepare its buffers for next packet */
+                        New_packs[i].elements[0].buf = (char *) new( PACK_HEAD_OBJ );
+                        New_packs[i].elements[1].buf = (char *) new( PACKET_BODY );
+                }
+        }
+        Prot_flush_batch();
+}
+
+/* Does the deferred part of handling the packets inserted since the last call */
+static void Prot_flush_batch( void )
+{
+        int             i;
+
+        if ( !Batch_token_seen ) return;
+
+        if ( Memb_token_alive() ) {
+                E_queue( Memb_token_loss_event, 0, NULL, Prot_token_loss_timeout() );
+                if ( Conf_leader( Memb_active_ptr() ) == My.id ) 
+                {
+                        E_queue( Prot_token_hurry_event, 0, NULL, Hurry_timeout );
+                }
+        }
+
+        if ( Batch_deliver_agreed ) Deliver_agreed_packets();
+        for( i=0; i < Batch_num_reliable; i++ )
+                Deliver_reliable_packets( Batch_reliable_seq[i], 1 );
+
+        GlobalStatus.packet_recv += Batch_num_packets;
+        GlobalStatus.my_aru = My_aru;
+        GlobalStatus.highest_seq = Highest_seq;
+
+        Batch_token_seen     = FALSE;
+        Batch_deliver_agreed = FALSE;
+        Batch_num_packets    = 0;
+        Batch_num_reliable   = 0;
+}
+
+/* Handles one received packet. Returns TRUE if the packet buffers were kept in Packets[] */
+static bool Prot_handle_packet( sys_scatter *scat )
 {
         packet_header   *pack_ptr;
         packet_body     *pack_body_ptr;
         fragment_header *frag_ptr;
         int             pack_entry;
-        proc            p;
-        int             received_bytes;
+        proc            *p;
         int             processed_bytes;
         int             padding_bytes;
         int             i, ret;
@@ -294,29 +382,30 @@ static void Prot_handle_bcast( channel fd, int dummy, void *dummy_p )
         channel         *bcast_channels;
         channel         *token_channels;
 
-        received_bytes = Net_recv( fd, &New_pack );
-
-        /* problem in receiving */
-        if ( received_bytes <= 0 ) return;
+        pack_ptr = (packet_header *) scat->elements[0].buf;
 
-        pack_ptr = (packet_header *) New_pack.elements[0].buf;
+        if ( !Is_regular( pack_ptr->type ) || !Memb_is_equal( Memb_id(), pack_ptr->memb_id ) )
+        {
+                /* let control packets see the effects of earlier regular ones */
+                Prot_flush_batch();
+        }
 
         if ( Is_status( pack_ptr->type ) )
         {
-                Stat_handle_message( &New_pack );
-                return;
+                Stat_handle_message( scat );
+                return( FALSE );
         }
 
         if ( Is_fc( pack_ptr->type ) )
         {
-                FC_handle_message( &New_pack );
-                return;
+                FC_handle_message( scat );
+                return( FALSE );
         }
 
         if ( Is_conf_reload( pack_ptr->type ) )
         {
-                Prot_handle_conf_reload( &New_pack );
-                return;
+                Prot_handle_conf_reload( scat );
+                return( FALSE );
         }
 
         /* delete random  
@@ -326,62 +415,62 @@ static void Prot_handle_bcast( channel fd, int dummy, void *dummy_p )
 
         if ( Is_membership( pack_ptr->type ) )
         {
-                Memb_handle_message( &New_pack );
-                return;
+                Memb_handle_message( scat );
+                return( FALSE );
         }
 
         if ( Is_hurry( pack_ptr->type ) )
         {
                 Handle_hurry( pack_ptr );
-                return;
+                return( FALSE );
         }
 
         if ( !Is_regular( pack_ptr->type ) )
         {
                 Alarm( PROTOCOL, "Prot_handle_bcast: Unknown packet type %d\n",
                        pack_ptr->type );
-                return;
+                return( FALSE );
         }
 
         if ( !Memb_is_equal( Memb_id(), pack_ptr->memb_id ) )
         {
                 /* Foreign message */
-                Memb_handle_message( &New_pack );
-                return;
+                Memb_handle_message( scat );
+                return( FALSE );
         }
 
-        if (Memb_token_alive() ) {
-                E_queue( Memb_token_loss_event, 0, NULL, Token_timeout );
-                if ( Conf_leader( Memb_active_ptr() ) == My.id ) 
-                {
-                        E_queue( Prot_token_hurry_event, 0, NULL, Hurry_timeout );
-                }
-        }
+        /* token loss and hurry timers are rearmed once per batch */
+        Batch_token_seen = TRUE;
 
         /* do we have this packet */
         if ( pack_ptr->seq <= Last_discarded )
         {
                 Alarm( PROTOCOL, "Prot_handle_bcast: delayed packet %d already delivered (Last_discarded %d)\n", pack_ptr->seq, Last_discarded );
-                return;
+                return( FALSE );
         }
 
-        pack_entry = pack_ptr->seq & PACKET_MASK;
+        pack_entry = pack_ptr->seq & Packet_mask;
         if ( Packets[pack_entry].exist ) 
         {
                 Alarm( PROTOCOL, "Prot_handle_bcast: packet %d already exist\n", pack_ptr->seq );
-                return;
+                return( FALSE );
         }
 
-        Packets[pack_entry].proc_index = Conf_proc_by_id( pack_ptr->proc_id, &p );
+        Packets[pack_entry].proc_index = Conf_proc_ref_by_id( pack_ptr->proc_id, &p );
         if ( Packets[pack_entry].proc_index < 0 )
         {
                 Alarm( PROTOCOL, "Prot_handle_bcast: unknown proc %d\n", pack_ptr->proc_id );
-                return;
+                return( FALSE );
         }
 
-        pack_body_ptr = (packet_body *)New_pack.elements[1].buf;
+        pack_body_ptr = (packet_body *)scat->elements[1].buf;
         frag_ptr = &(pack_ptr->first_frag_header);
-        if ( !Same_endian( pack_ptr->type ) ) 
+        if ( Is_placeholder( pack_ptr->type ) )
+        {
+                if ( !Prot_accept_placeholder( pack_ptr, (int32 *)pack_body_ptr ) ) return( FALSE );
+                GlobalStatus.placeholders_recv++;
+        }
+        else if ( !Same_endian( pack_ptr->type ) ) 
         {
                 Flip_frag( frag_ptr );
                 processed_bytes = frag_ptr->fragment_len;
@@ -426,8 +515,11 @@ static void Prot_handle_bcast( channel fd, int dummy, void *dummy_p )
 
         /* insert new packet */
         Packets[pack_entry].head  = pack_ptr;
-        Packets[pack_entry].body  = (packet_body *)New_pack.elements[1].buf;
+        Packets[pack_entry].body  = (packet_body *)scat->elements[1].buf;
         Packets[pack_entry].exist = 1;
+        Packets[pack_entry].enq_time.sec  = 0;
+        Packets[pack_entry].enq_time.usec = 0;
+        Packets[pack_entry].selective = FALSE;
 
         Alarmp( SPLOG_INFO, PROTOCOL, "Prot_handle_bcast: inserting packet %d\n", pack_ptr->seq );
 
@@ -481,23 +573,18 @@ static void Prot_handle_bcast( channel fd, int dummy, void *dummy_p )
         {
                 for( i=pack_ptr->seq; i <= Highest_seq; i++ )
                 {
-                        if ( ! Packets[i & PACKET_MASK].exist ) break;
+                        if ( ! Packets[i & Packet_mask].exist ) break;
                         My_aru++;
                 }
-                Deliver_agreed_packets();
+                Batch_deliver_agreed = TRUE;
         }
         else
         {
-                Deliver_reliable_packets( pack_ptr->seq, 1 );
+                Batch_reliable_seq[Batch_num_reliable++] = pack_ptr->seq;
         }
+        Batch_num_packets++;
 
-        GlobalStatus.packet_recv++;
-        GlobalStatus.my_aru = My_aru;
-        GlobalStatus.highest_seq = Highest_seq;
-
-        /* prepare New_pack for next packet */
-        New_pack.elements[0].buf = (char *) new( PACK_HEAD_OBJ );
-        New_pack.elements[1].buf = (char *) new( PACKET_BODY );
+        return( TRUE );
 }
 
 void Prot_handle_token( channel fd, int dummy, void *dummy_p )
@@ -513,6 +600,8 @@ void Prot_handle_token( channel fd, int dummy, void *dummy_p )
         int             retrans_allowed; /* how many of my retrans are allowed on token */
         int             max_rtr_seq;
         int             i, ret;
+        sp_time         now;
+        int32           round;
         int             num_bcast, num_token;
         channel         *bcast_channels;
         channel         *token_channels;
@@ -648,6 +737,15 @@ void Prot_handle_token( channel fd, int dummy, void *dummy_p )
          *  all bcast packets sent in the previous round, so I should give 
          *  bcast channels a higher priority until then */
         Received_token_rounds++;
+        now = E_get_time();
+        if ( Last_token_time.sec != 0 )
+        {
+                round = ( now.sec - Last_token_time.sec ) * 1000000 + ( now.usec - Last_token_time.usec );
+                Stat_hist_record( STAT_HIST_TOKEN_ROUND, round );
+                if ( Conf_get_fast_failure_detection() )
+                        Prot_measure_round( round );
+        }
+        Last_token_time = now;
         if ( Token_has_priority )
         {
                 bcast_channels = Net_bcast_channel();
@@ -689,6 +787,8 @@ void Prot_handle_token( channel fd, int dummy, void *dummy_p )
         num_allowed = FC_allowed( flow_control, num_retrans );
         num_sent    = Send_new_packets( num_allowed );
         GlobalStatus.packet_sent += num_sent;
+        Stat_hist_record( STAT_HIST_TOKEN_PACKETS, num_sent + num_retrans );
+        FC_token_round( Token->rtr_len, num_retrans, num_allowed, num_sent );
 
         /* Flow control calculations */
         Token->flow_control = Token->flow_control
@@ -701,7 +801,7 @@ void Prot_handle_token( channel fd, int dummy, void *dummy_p )
 
         for( i = My_aru+1; i <= Highest_seq; i++ )
         {
-                if ( ! Packets[i & PACKET_MASK].exist ) break;
+                if ( ! Packets[i & Packet_mask].exist ) break;
                 My_aru++;
         }
         GlobalStatus.my_aru = My_aru;
@@ -731,7 +831,7 @@ void Prot_handle_token( channel fd, int dummy, void *dummy_p )
                         new_ptr += sizeof(ring_rtr);
                         for( i=My_aru+1; i <= max_rtr_seq && retrans_allowed > 0; i++ )
                         {
-                                if ( ! Packets[i & PACKET_MASK].exist ) 
+                                if ( ! Packets[i & Packet_mask].exist ) 
                                 {
                                         memcpy( &new_rtr[new_ptr], &i, sizeof(int32) ); 
                                         new_ptr += sizeof(int32);
@@ -779,6 +879,9 @@ void Prot_handle_token( channel fd, int dummy, void *dummy_p )
                 Token->type = Set_retrans( Token->type, 0   );
         }
 
+        /* Send the packets queued this round ahead of the token, even if it is held */
+        Net_flush_bcast();
+
         /* Send token */
         if ( ! ( Conf_leader( Memb_active_ptr() ) == My.id &&
                 To_hold_token() ) )
@@ -803,7 +906,7 @@ void Prot_handle_token( channel fd, int dummy, void *dummy_p )
         if ( Conf_leader( Memb_active_ptr() ) == My.id ) 
                 E_queue( Prot_token_hurry_event, 0, NULL, Hurry_timeout );
 
-        E_queue( Memb_token_loss_event, 0, NULL, Token_timeout );
+        E_queue( Memb_token_loss_event, 0, NULL, Prot_token_loss_timeout() );
 
         /* Send any packets remaining in queue */
         Prot_flush_bcast(&Send_pack_queue);
@@ -937,6 +1040,8 @@ void    Prot_initiate_conf_reload( int code, void *data )
         Sess_signal_conf_reload();
         /* Signal flow control to reload window parameters */
         FC_signal_conf_reload();
+        /* A larger MaxSeqGap may need a larger packet store */
+        Prot_size_packets( Conf_get_max_seq_gap() );
 
         /* update protocol variables with new conf */
         My = Conf_my();
@@ -956,10 +1061,54 @@ void    Prot_initiate_conf_reload( int code, void *data )
 }
 
 
+/* Size of the Packets[] store needed for a MaxSeqGap of max_seq_gap */
+int32   Prot_packets_for_gap( int32 max_seq_gap )
+{
+        int32           size;
+
+        size = MIN_PACKETS_IN_STRUCT;
+        while( size < PACKETS_PER_SEQ_GAP * max_seq_gap )
+                size <<= 1;
+        return( size );
+}
+
+/* Make sure Packets[] can hold every packet that may be live at once when
+ * Highest_seq runs up to max_seq_gap ahead of Aru. The store only grows;
+ * packets still held (Last_discarded+1 .. Highest_seq) move to their slot
+ * under the new mask.
+ */
+static  void    Prot_size_packets( int32 max_seq_gap )
+{
+        packet_info     *new_packets;
+        int32           new_size;
+        int32           i;
+
+        new_size = Prot_packets_for_gap( max_seq_gap );
+        if( new_size <= Packets_size ) return;
+
+        new_packets = calloc( new_size, sizeof( packet_info ) );
+        if( new_packets == NULL )
+                Alarmp( SPLOG_FATAL, PROTOCOL, "Prot_size_packets: failed to allocate %d packet entries\n", new_size );
+
+        if( Packets != NULL )
+        {
+                for( i = Last_discarded + 1; i <= Highest_seq; i++ )
+                        new_packets[i & ( new_size - 1 )] = Packets[i & Packet_mask];
+                free( Packets );
+        }
+        Packets      = new_packets;
+        Packets_size = new_size;
+        Packet_mask  = new_size - 1;
+
+        Alarmp( SPLOG_INFO, PROTOCOL, "Prot_size_packets: packet store holds %d packets for MaxSeqGap %d\n",
+                Packets_size, max_seq_gap );
+}
+
 void    Prot_new_message( down_link *down_ptr, int not_used_in_spread3_p )
 {
         int32   leader_id;
 
+        down_ptr->enq_time = E_get_time();
         if ( Down_queue_ptr->num_mess > 0 )
         {
                 down_ptr->next = NULL;
@@ -991,6 +1140,8 @@ void    Prot_new_message( down_link *down_ptr, int not_used_in_spread3_p )
 static  int     Answer_retrans( int *ret_new_ptr, 
                                 int32 *proc_id, int16 *seg_index )
 {
+static  sys_scatter     *retrans[MAX_SEND_BATCH];
+        int             num_queued;
         int             num_retrans;
         sys_scatter     *send_pack_ptr;
         char            *rtr;
@@ -999,7 +1150,10 @@ static  int     Answer_retrans( int *ret_new_ptr,
         int             pack_entry;
         int             bytes_to_copy;
         packet_header   *pack_ptr;
-        int             i, ret;
+        ring_rtr        kept_rtr;
+        int             kept_ptr;
+        int             num_seq;
+        int             i;
         int32           *req_seq;
 
         num_retrans     = 0;
@@ -1015,17 +1169,30 @@ static  int     Answer_retrans( int *ret_new_ptr,
                         ring_rtr_ptr = (ring_rtr *)&rtr[old_ptr];
                         if ( Memb_is_equal(ring_rtr_ptr->memb_id,Memb_id() ) )
                         {
-                                /* retransmit requests from my ring */
+                                /* retransmit requests from my ring; those I hold only a
+                                 * placeholder for are left on the token for the sender */
+                                kept_rtr = *ring_rtr_ptr;
+                                kept_rtr.num_seq = 0;
+                                num_seq = ring_rtr_ptr->num_seq;
+                                kept_ptr = new_ptr;
                                 old_ptr += sizeof(ring_rtr);
-                                for( i=0; i < ring_rtr_ptr->num_seq; i++ )
+                                num_queued = 0;
+                                for( i=0; i < num_seq; i++ )
                                 {
                                         req_seq = (int32 *)&rtr[old_ptr];
                                         old_ptr += sizeof(int32);
-                                        pack_entry = *req_seq & PACKET_MASK;
+                                        pack_entry = *req_seq & Packet_mask;
                                         if ( *req_seq < Aru ) 
                                                 Alarm( EXIT, "Answer_retrans: retrans of %d requested while Aru is %d\n", *req_seq, Aru );
 
-                                        if ( Packets[pack_entry].exist )
+                                        if ( Packets[pack_entry].exist && !Prot_placeholder_answers( pack_entry, &kept_rtr ) )
+                                        {
+                                                memmove( &rtr[kept_ptr + sizeof(ring_rtr) + kept_rtr.num_seq * sizeof(int32)], req_seq, sizeof(int32) );
+                                                kept_rtr.num_seq++;
+                                                *proc_id = -1;
+                                                if ( kept_rtr.seg_index != My.seg_index )
+                                                        *seg_index = -1;
+                                        }else if ( Packets[pack_entry].exist )
                                         {
                                                 send_pack_ptr = new(SYS_SCATTER);
                                                 send_pack_ptr->num_elements = 2;
@@ -1035,37 +1202,33 @@ static  int     Answer_retrans( int *ret_new_ptr,
                                                 send_pack_ptr->elements[1].buf = (char *)Packets[pack_entry].body;
                                                 send_pack_ptr->elements[1].len = pack_ptr->data_len; 
 
-                                                if ( ring_rtr_ptr->proc_id != -1 )
-                                                {
-                                                        ret = Net_ucast ( ring_rtr_ptr->proc_id, send_pack_ptr );
-                                                        dispose(send_pack_ptr);
-                                                        GlobalStatus.u_retrans++;
-
-                                                        Alarmp( SPLOG_INFO, PROTOCOL, "Answer_retrans: retransmit %d to proc 0x%08X\n", *req_seq, ring_rtr_ptr->proc_id );
-
-                                                }else if ( ring_rtr_ptr->seg_index != -1 ) {
-                                                        ret = Net_scast ( ring_rtr_ptr->seg_index, send_pack_ptr );
-                                                        dispose(send_pack_ptr);
-                                                        GlobalStatus.s_retrans++;
-
-                                                        Alarmp( SPLOG_INFO, PROTOCOL, "Answer_retrans: retransmit %d to seg 0x%08X\n", *req_seq, ring_rtr_ptr->seg_index );
-
-                                                }else{
-                                                        /* NOTE: we bcast retransmissions immediately rather than queue them to give such retranmissions a better chance of 
-                                                           being received before the token at the next member, so that they don't re-request retransmissions we are sending now */
-                                                        ret = Net_bcast( send_pack_ptr );
-                                                        dispose( send_pack_ptr );
-                                                        GlobalStatus.b_retrans++;
-
+                                                if ( kept_rtr.proc_id != -1 )
+                                                        Alarmp( SPLOG_INFO, PROTOCOL, "Answer_retrans: retransmit %d to proc 0x%08X\n", *req_seq, kept_rtr.proc_id );
+                                                else if ( kept_rtr.seg_index != -1 )
+                                                        Alarmp( SPLOG_INFO, PROTOCOL, "Answer_retrans: retransmit %d to seg 0x%08X\n", *req_seq, kept_rtr.seg_index );
+                                                else
                                                         Alarmp( SPLOG_INFO, PROTOCOL, "Answer_retrans: retransmit %d to all\n", *req_seq);
+
+                                                /* the ones for one request go out together */
+                                                retrans[num_queued++] = send_pack_ptr;
+                                                if ( num_queued == MAX_SEND_BATCH )
+                                                {
+                                                        Send_retrans( &kept_rtr, retrans, num_queued );
+                                                        num_queued = 0;
                                                 }
                                                 num_retrans++;
                                         }else{
                                                 *proc_id = -1;
-                                                if ( ring_rtr_ptr->seg_index != My.seg_index )
+                                                if ( kept_rtr.seg_index != My.seg_index )
                                                         *seg_index = -1;
                                         }
                                 }
+                                Send_retrans( &kept_rtr, retrans, num_queued );
+                                if ( kept_rtr.num_seq > 0 )
+                                {
+                                        memcpy( &rtr[kept_ptr], &kept_rtr, sizeof(ring_rtr) );
+                                        new_ptr = kept_ptr + sizeof(ring_rtr) + kept_rtr.num_seq * sizeof(int32);
+                                }
                         }else{
                                 /* copy requests of other rings */
                                 bytes_to_copy = sizeof(ring_rtr) + 
@@ -1085,6 +1248,34 @@ static  int     Answer_retrans( int *ret_new_ptr,
         return (num_retrans);
 }
 
+/* Sends the retransmissions answering one request, disposing of them.
+ * Broadcast ones are flushed at once rather than left queued, to give them
+ * a better chance of being received before the token at the next member,
+ * so that it does not re-request what is being sent now. */
+static  void    Send_retrans( ring_rtr *rtr, sys_scatter *scats[], int num_scats )
+{
+        int             i;
+
+        if ( num_scats == 0 ) return;
+
+        if ( rtr->proc_id != -1 )
+        {
+                Net_ucast_batch( rtr->proc_id, scats, num_scats );
+                GlobalStatus.u_retrans += num_scats;
+        }else if ( rtr->seg_index != -1 ) {
+                Net_scast_batch( rtr->seg_index, scats, num_scats );
+                GlobalStatus.s_retrans += num_scats;
+        }else{
+                for( i=0; i < num_scats; i++ )
+                        Net_queue_bcast( scats[i] );
+                Net_flush_bcast();
+                GlobalStatus.b_retrans += num_scats;
+                return;
+        }
+        for( i=0; i < num_scats; i++ )
+                dispose( scats[i] );
+}
+
 static  int     Send_new_packets( int num_allowed )
 {
         packet_header   *pack_ptr;
@@ -1097,6 +1288,13 @@ static  int     Send_new_packets( int num_allowed )
         int             padding_bytes;
         int             available_bytes;
         int             ret;
+        sp_time         enq_time;
+        bool            selective, pack_selective;
+        route_mask      seg_mask;
+
+        /* SelectiveDelivery: group state must reflect every packet ordered so far */
+        selective = ( Conf_get_selective_delivery() && Conf_num_segments( Conf_ref() ) > 1 &&
+                      Memb_state() == OP && GlobalStatus.gstate == GOP && Last_delivered == Highest_seq );
 
         num_sent = 0;
         while( num_sent < num_allowed )
@@ -1108,6 +1306,7 @@ static  int     Send_new_packets( int num_allowed )
                 pack_ptr =  new(PACK_HEAD_OBJ);
 
                 scat_ptr = Down_queue_ptr->first->mess;
+                enq_time = Down_queue_ptr->first->enq_time;
 
                 pack_ptr->type = Down_queue_ptr->first->type;
                 pack_ptr->proc_id = My.id;
@@ -1121,7 +1320,7 @@ static  int     Send_new_packets( int num_allowed )
                 pack_ptr->first_frag_header.fragment_len = scat_ptr->elements[
                         Down_queue_ptr->cur_element].len;
 
-                send_pack_ptr = new(SYS_SCATTER); /* send_pack_ptr is freed when the packet is sent (after Net_bcast is called)  */
+                send_pack_ptr = new(SYS_SCATTER); /* send_pack_ptr is freed by the network layer once the queued packet is sent  */
                 send_pack_ptr->num_elements = 2;
                 send_pack_ptr->elements[0].len = sizeof(packet_header);
                 send_pack_ptr->elements[1].buf = scat_ptr->elements[
@@ -1131,6 +1330,13 @@ static  int     Send_new_packets( int num_allowed )
                 /* Set frag_ptr to point to the fragment header in the packet header */
                 frag_ptr = &(pack_ptr->first_frag_header); 
 
+                pack_selective = FALSE;
+                if ( selective && Down_queue_ptr->cur_element == 0 )
+                {
+                        memset( seg_mask, 0, sizeof(route_mask) );
+                        pack_selective = Prot_add_message_mask( scat_ptr, seg_mask );
+                }
+
                 /* Loop for filling the packet:
                  *
                  * Advance the down queue and set the fragment index for the fragment
@@ -1215,6 +1421,8 @@ static  int     Send_new_packets( int num_allowed )
                                     !(Is_fifo(Down_queue_ptr->first->type) || Is_agreed(Down_queue_ptr->first->type)) )
                                         break;
                         }
+                        if ( pack_selective )
+                                pack_selective = Prot_add_message_mask( scat_ptr, seg_mask );
                         /* 
                          * If the next fragment can be added (i.e. we didn't break for one of the 3
                          * reasons above), set the frag_ptr to point after the end of the last fragment
@@ -1238,10 +1446,7 @@ static  int     Send_new_packets( int num_allowed )
                 send_pack_ptr->elements[0].buf = (char *) pack_ptr;
                 send_pack_ptr->elements[1].len = pack_ptr->data_len;
 
-                ret = Prot_queue_bcast( send_pack_ptr, &Send_pack_queue );
-                num_sent++;
- 
-                pack_entry = pack_ptr->seq & PACKET_MASK;
+                pack_entry = pack_ptr->seq & Packet_mask;
                 if ( Packets[pack_entry].exist ) 
                         Alarm( EXIT, 
                                "Send_new_packets: created packet %d already exist %d\n",
@@ -1252,6 +1457,13 @@ static  int     Send_new_packets( int num_allowed )
                 Packets[pack_entry].body       = (packet_body *) body_ptr;
                 Packets[pack_entry].exist      = 1;
                 Packets[pack_entry].proc_index = My_index;
+                Packets[pack_entry].enq_time   = enq_time;
+                Packets[pack_entry].selective  = pack_selective;
+                if ( pack_selective )
+                        memcpy( Packets[pack_entry].seg_mask, seg_mask, sizeof(route_mask) );
+
+                ret = Prot_queue_bcast( send_pack_ptr, &Send_pack_queue );
+                num_sent++;
                 Alarm( PROTOCOL, 
                        "Send_new_packets: packet %d sent and inserted \n",
                        pack_ptr->seq );
@@ -1300,8 +1512,7 @@ static  int     Prot_queue_bcast( sys_scatter *send_pack_ptr, packet_queue *pack
                 dispose(link_ptr);
                 pack_ptr = (packet_header *) scat_ptr->elements[0].buf;
                 pack_ptr->token_round = Token_rounds;
-                Net_bcast(scat_ptr);
-                dispose(scat_ptr);
+                Prot_net_queue_bcast(scat_ptr);
         }
         ret = num_pack_to_send;
 
@@ -1309,8 +1520,7 @@ static  int     Prot_queue_bcast( sys_scatter *send_pack_ptr, packet_queue *pack
         {
                 pack_ptr = (packet_header *) send_pack_ptr->elements[0].buf;
                 pack_ptr->token_round = Token_rounds;
-                Net_bcast(send_pack_ptr);
-                dispose(send_pack_ptr);
+                Prot_net_queue_bcast(send_pack_ptr);
                 ret++;
         }else{
                 link_ptr = new(QUEUE_LINK);
@@ -1330,6 +1540,90 @@ static  int     Prot_queue_bcast( sys_scatter *send_pack_ptr, packet_queue *pack
         return ( ret );
 }
 
+/* Queues one of my new packets, restricting its payload to the segments
+ * with members of its groups when Send_new_packets could work them out.
+ */
+static  void    Prot_net_queue_bcast( sys_scatter *send_pack_ptr )
+{
+        packet_header   *pack_ptr;
+        packet_info     *info;
+
+        pack_ptr = (packet_header *) send_pack_ptr->elements[0].buf;
+        info = &Packets[pack_ptr->seq & Packet_mask];
+        if ( info->exist && info->head == pack_ptr && info->selective )
+                Net_queue_bcast_selective( send_pack_ptr, info->seg_mask );
+        else
+                Net_queue_bcast( send_pack_ptr );
+}
+
+/* SelectiveDelivery: adds to seg_mask the segments of the daemons with members
+ * in the groups a message is sent to. Returns FALSE when the message has to
+ * reach every daemon: group changes and other control messages, and messages
+ * that span packets (their fragments could otherwise be split between
+ * payloads and placeholders).
+ */
+static  bool    Prot_add_message_mask( scatter *mess, route_mask seg_mask )
+{
+        message_header  *head_ptr;
+        int32u          mess_mask[4];
+        int             i;
+
+        if ( mess->num_elements != 1 ) return( FALSE );
+        head_ptr = Message_get_message_header( mess );
+        if ( !Is_only_regular_mess( head_ptr->type ) ) return( FALSE );
+
+        G_set_mask( head_ptr->num_groups, (char (*)[MAX_GROUP_NAME]) Message_get_groups_array( mess ), mess_mask );
+        for( i=0; i < 4; i++ )
+                seg_mask[i] |= mess_mask[i];
+
+        return( TRUE );
+}
+
+/* A placeholder stands in for a packet whose payload only went to other
+ * segments. It never stands in for the payload where that was sent: there
+ * I wait for the payload, from its sender or from any daemon that has it.
+ */
+static  bool    Prot_accept_placeholder( packet_header *pack_ptr, int32 *seg_mask )
+{
+        int     i;
+
+        if ( pack_ptr->data_len != sizeof(route_mask) )
+        {
+                Alarm( PRINT, "Prot_handle_bcast: invalid placeholder %d from %d, data_len %d\n",
+                       pack_ptr->seq, pack_ptr->proc_id, pack_ptr->data_len );
+                return( FALSE );
+        }
+        if ( !Same_endian( pack_ptr->type ) )
+                for( i=0; i < 4; i++ )
+                        seg_mask[i] = Flip_int32( seg_mask[i] );
+
+        return( !( seg_mask[My.seg_index / 32] & ( 0x1 << ( My.seg_index % 32 ) ) ) );
+}
+
+/* Whether the copy I hold can answer a retransmission request: a placeholder
+ * only serves requesters outside the segments that need the payload.
+ */
+static  bool    Prot_placeholder_answers( int pack_entry, ring_rtr *ring_rtr_ptr )
+{
+        packet_header   *pack_ptr;
+        int32           *seg_mask;
+        proc            p;
+        int             seg;
+
+        pack_ptr = Packets[pack_entry].head;
+        if ( !Is_placeholder( pack_ptr->type ) ) return( TRUE );
+
+        if ( ring_rtr_ptr->proc_id != -1 ) {
+                if ( Conf_proc_by_id( ring_rtr_ptr->proc_id, &p ) < 0 ) return( FALSE );
+                seg = p.seg_index;
+        }else if ( ring_rtr_ptr->seg_index != -1 ) {
+                seg = ring_rtr_ptr->seg_index;
+        }else return( FALSE );
+
+        seg_mask = (int32 *) Packets[pack_entry].body;
+        return( !( seg_mask[seg / 32] & ( 0x1 << ( seg % 32 ) ) ) );
+}
+
 static  int     Prot_flush_bcast( packet_queue *pack_queue )
 {
         sys_scatter *scat_ptr;
@@ -1347,9 +1641,9 @@ static  int     Prot_flush_bcast( packet_queue *pack_queue )
                 dispose(link_ptr);
                 pack_ptr = (packet_header *) scat_ptr->elements[0].buf;
                 pack_ptr->token_round = Token_rounds;
-                Net_bcast(scat_ptr);
-                dispose(scat_ptr);
+                Prot_net_queue_bcast(scat_ptr);
         }
+        Net_flush_bcast();
         return( ret );
 }
  
@@ -1359,26 +1653,44 @@ static  void    Deliver_packet( int pack_entry, int to_copy )
         up_queue        *up_ptr;
         packet_header   *pack_ptr;
         message_link    *mess_link;
+        message_slice   *slice;
         fragment_header *frag_ptr;
         char            *pack_body_ptr;
         message_queue   mess_queue;
         int             processed_bytes;
         int             padding_bytes;
         int             index;
+        int             share;
+        sp_time         now;
 
         pack_ptr = Packets[pack_entry].head;
 
+        if ( Is_placeholder( pack_ptr->type ) )
+        {
+                /* nothing to deliver here; the payload went to other segments */
+                if ( !to_copy ) Message_release_buffer( Packets[pack_entry].body );
+                Packets[pack_entry].exist = 2;
+                return;
+        }
+
         /* 
          * For multi-fragment packets, the following observations can be made:
          *     1. The first fragment is either the last fragment in a multi-packet message
          *        or a whole message.
          *     2. Each fragment after the first must be a whole message.
          *
-         * For any fragment beyond the first, we create a message (with a new packet body)
-         * and put it in a queue. We then process the first fragment, including the
-         * decision whether to copy it or not. Finally, we deliver to session all queued
-         * messages coming from the additional fragments.
+         * For any fragment beyond the first, we create a message and put it in a queue.
+         * We then process the first fragment, including the decision whether to copy it
+         * or not. Finally, we deliver to session all queued messages coming from the
+         * additional fragments.
+         *
+         * Delivery may flip message headers in place when the sender has the other
+         * endianness. Unless that can happen to a body we still keep for retransmission
+         * (to_copy), the body is shared instead of copied: the first fragment keeps using
+         * it, and every other fragment becomes a message_slice pointing into it. Each
+         * holder takes a reference and drops it through Message_release_buffer.
          */
+        share = ( !to_copy || Same_endian( pack_ptr->type ) );
 
         mess_queue.num_messages = 0;
         mess_queue.first = NULL;
@@ -1414,11 +1726,22 @@ static  void    Deliver_packet( int pack_entry, int to_copy )
                 /* Creating new message */
                 mess_link = new(MESSAGE_LINK);
                 mess_link->next = NULL;
-                mess_link->mess = new(SCATTER);
-                mess_link->mess->num_elements = 1;
-                mess_link->mess->elements[0].len = frag_ptr->fragment_len;
-                mess_link->mess->elements[0].buf = new(PACKET_BODY);
-                memcpy(mess_link->mess->elements[0].buf, &pack_body_ptr[processed_bytes], frag_ptr->fragment_len);
+                if ( share )
+                {
+                        slice = new(MESSAGE_SLICE);
+                        slice->body = Packets[pack_entry].body;
+                        share_ref_cnt( slice->body );
+                        mess_link->mess = &slice->mess;
+                        mess_link->mess->num_elements = 1;
+                        mess_link->mess->elements[0].len = frag_ptr->fragment_len;
+                        mess_link->mess->elements[0].buf = &pack_body_ptr[processed_bytes];
+                }else{
+                        mess_link->mess = new(SCATTER);
+                        mess_link->mess->num_elements = 1;
+                        mess_link->mess->elements[0].len = frag_ptr->fragment_len;
+                        mess_link->mess->elements[0].buf = new(PACKET_BODY);
+                        memcpy(mess_link->mess->elements[0].buf, &pack_body_ptr[processed_bytes], frag_ptr->fragment_len);
+                }
                 processed_bytes += frag_ptr->fragment_len;
                 if ( mess_queue.num_messages == 0 ) {
                         mess_queue.first = mess_link;
@@ -1468,7 +1791,12 @@ static  void    Deliver_packet( int pack_entry, int to_copy )
         up_ptr->mess->num_elements++;
         up_ptr->mess->elements[index-1].len = Packets[pack_entry].head->first_frag_header.fragment_len;
         up_ptr->mess->elements[index-1].buf = (char *)Packets[pack_entry].body;
-        if ( to_copy )
+        if ( to_copy && share )
+        {
+                /* Packets[] and the delivered message both hold the body */
+                share_ref_cnt( Packets[pack_entry].body );
+        }
+        else if ( to_copy )
         {
                 /* 
                  * copy the packet.
@@ -1489,6 +1817,14 @@ static  void    Deliver_packet( int pack_entry, int to_copy )
 
         if ( pack_ptr->first_frag_header.fragment_index < 0 )
         {
+                if ( Packets[pack_entry].enq_time.sec != 0 )
+                {
+                        /* my own message: record how long it took from Prot_new_message */
+                        now = E_get_time();
+                        Stat_hist_record( Is_safe( pack_ptr->type ) ? STAT_HIST_SAFE : STAT_HIST_AGREED,
+                                          ( now.sec - Packets[pack_entry].enq_time.sec ) * 1000000 +
+                                          ( now.usec - Packets[pack_entry].enq_time.usec ) );
+                }
                 /* end of message */
                 /* Push up big_scatter. i.e. up_ptr->mess */
                 mess_link = new(MESSAGE_LINK);
@@ -1526,11 +1862,12 @@ static  void    Deliver_reliable_packets( int32 start_seq, int num_packets )
 
         for( i = start_seq; i <= end_seq  ; i++ )
         {
-                pack_entry = i & PACKET_MASK;
+                pack_entry = i & Packet_mask;
 
                 if ( Packets[pack_entry].exist == 1 )
                 {
                         if ( Is_reliable( Packets[pack_entry].head->type ) &&
+                            !Is_placeholder( Packets[pack_entry].head->type ) &&
                             Packets[pack_entry].head->first_frag_header.fragment_index == -1 )
                         {
                                 Alarm( PROTOCOL, "Deliver_reliable_packets: delivering packet %d\n", i );
@@ -1558,10 +1895,18 @@ static  void    Deliver_agreed_packets()
 
         for( i = Last_delivered+1; i <= My_aru; i++ )
         {
-                pack_entry = i & PACKET_MASK;
+                pack_entry = i & Packet_mask;
 
                 if ( Packets[pack_entry].exist == 1 ) 
                 {
+                        /* the segments a placeholder stands in for may not all have
+                         * the payload yet; until the Aru says they do, the packet can
+                         * still become a hole if its sender fails (Memb_holds_packet).
+                         * This holds back every agreed message after it here, for
+                         * any group, by up to a token round; selective_bench -i
+                         * measures it */
+                        if ( Is_placeholder( Packets[pack_entry].head->type ) && i > Aru ) return;
+
                         if ( !Is_safe( Packets[pack_entry].head->type ) )
                         {
                                 Alarm( PROTOCOL, "Deliver_agreed_packets: delivering packet %d\n", i );
@@ -1609,7 +1954,7 @@ void    Discard_packets()
 
                 for( i = Last_discarded+1; i <= Highest_seq; i++ )
                 {
-                        pack_entry = i & PACKET_MASK;
+                        pack_entry = i & Packet_mask;
                         if ( ! Packets[pack_entry].exist )
                                 Alarmp( SPLOG_FATAL, PROTOCOL, "Discard_packets: (EVS before transitional) packet %d not exist\n", i);
                         if ( Packets[pack_entry].exist == 3 )
@@ -1625,7 +1970,7 @@ void    Discard_packets()
                         if ( Packets[pack_entry].exist == 1 ){
                                 Deliver_packet( pack_entry, 0 );
                         } else {
-                                dispose( Packets[pack_entry].body );
+                                Message_release_buffer( Packets[pack_entry].body );
                         }
                         /* dispose packet header in any case */
                         dispose( Packets[pack_entry].head );
@@ -1643,7 +1988,7 @@ void    Discard_packets()
                 found_hole = 0;
                 for( i = Last_discarded+1; i <= Highest_seq; i++ )
                 {
-                        pack_entry = i & PACKET_MASK;
+                        pack_entry = i & Packet_mask;
                         if ( ! Packets[pack_entry].exist )
                                 Alarm( EXIT, "Discard_packets: (EVS after transitional) packet %d not exist\n", i);
                         if ( Packets[pack_entry].exist == 3 )
@@ -1661,7 +2006,7 @@ void    Discard_packets()
                                 if ( Packets[pack_entry].exist == 1 ){
                                         Deliver_packet( pack_entry, 0 );
                                 }else{
-                                        dispose( Packets[pack_entry].body );
+                                        Message_release_buffer( Packets[pack_entry].body );
                                 }
                                 /* dispose packet header in any case */
                                 dispose( Packets[pack_entry].head );
@@ -1669,13 +2014,13 @@ void    Discard_packets()
                         }else{
                                 /* should not deliver packet */
                                 dispose( Packets[pack_entry].head );
-                                dispose(   Packets[pack_entry].body );
+                                Message_release_buffer( Packets[pack_entry].body );
                                 Alarm( PROTOCOL, "Discard_packets: Due to hole, not delivering %d \n",i);
                         }
                         Packets[pack_entry].exist = 0;
                 }
 
-                for ( i = 0; i < MAX_PACKETS_IN_STRUCT; ++i )
+                for ( i = 0; i < Packets_size; ++i )
                         if ( Packets[i].exist )
                                 Alarmp( SPLOG_FATAL, PROTOCOL, "Discard_packets: Just delivered all packets, but some (%d) still exist?!!!\n", i );
 
@@ -1701,7 +2046,7 @@ void    Discard_packets()
                                         for( i=0; i < (int) up_ptr->mess->num_elements; i++ )
                                         {
                                                 body_ptr = (packet_body *)up_ptr->mess->elements[i].buf;
-                                                dispose( body_ptr );
+                                                Message_release_buffer( body_ptr );
                                         }
                                 }
                                 dispose( Up_queue[proc_index].mess );
@@ -1757,13 +2102,13 @@ void    Discard_packets()
 
                 for( i = Last_discarded+1; i <= Aru; i++ )
                 {
-                        pack_entry = i & PACKET_MASK;
+                        pack_entry = i & Packet_mask;
                         if ( ! Packets[pack_entry].exist )
                                 Alarm( EXIT, "Discard_packets: (NOT EVS) packet %d not exist\n",i);
 
                         /* should deliver packet or dispose the body if it was delivered already */
                         if ( Packets[pack_entry].exist == 1 ) Deliver_packet( pack_entry, 0 );
-                        else dispose( Packets[pack_entry].body );
+                        else Message_release_buffer( Packets[pack_entry].body );
                         /* dispose packet header in any case */
                         dispose( Packets[pack_entry].head );
                         Packets[pack_entry].exist = 0;
@@ -1879,6 +2224,57 @@ void    Prot_set_prev_proc(configuration *memb)
 {
         Prev_proc_id = Conf_previous(memb);
         Alarm( PROTOCOL, "Prev_proc_id: %d, My.id: %d\n", Prev_proc_id, My.id );
+        /* a new ring: do not count the membership gap as a token round */
+        Last_token_time.sec  = 0;
+        Last_token_time.usec = 0;
+        /* and measure its rounds afresh before shortening token loss detection */
+        Round_samples = 0;
+}
+
+/*
+ * Smooths the measured token rounds the way TCP smooths its RTT and derives
+ * the token loss timeout from them. The token is the heartbeat between ring
+ * neighbours (an idle leader still releases it every Hurry_timeout), so the
+ * predecessor is suspected once a jitter padded round plus FAST_LOSS_HURRIES
+ * resends of a lost token by the leader have passed. Kept between
+ * Token_loss_min_timeout and Token_timeout.
+ */
+static  void    Prot_measure_round( int32 round )
+{
+        int32   max_round, min_loss, err, loss;
+
+        max_round = Token_timeout.sec * 1000000 + Token_timeout.usec;
+        min_loss  = Token_loss_min_timeout.sec * 1000000 + Token_loss_min_timeout.usec;
+        if ( round > max_round ) round = max_round;
+
+        if ( Round_samples == 0 )
+        {
+                Round_srtt   = round;
+                Round_rttvar = round / 2;
+        }else{
+                err = round - Round_srtt;
+                Round_srtt += err / 8;
+                if ( err < 0 ) err = -err;
+                Round_rttvar += ( err - Round_rttvar ) / 4;
+        }
+        if ( Round_samples < FAST_LOSS_MIN_SAMPLES ) Round_samples++;
+
+        loss = Round_srtt + 4 * Round_rttvar
+                + FAST_LOSS_HURRIES * ( Hurry_timeout.sec * 1000000 + Hurry_timeout.usec );
+        if ( loss < min_loss ) loss = min_loss;
+        if ( loss >= max_round )
+        {
+                Token_loss_timeout = Token_timeout;
+        }else{
+                Token_loss_timeout.sec  = loss / 1000000;
+                Token_loss_timeout.usec = loss % 1000000;
+        }
+}
+
+static  sp_time Prot_token_loss_timeout( void )
+{
+        if ( Round_samples < FAST_LOSS_MIN_SAMPLES ) return( Token_timeout );
+        return( Token_loss_timeout );
 }
 
 void    Flip_token_body( char *buf, token_header *token_ptr )
@@ -40,10 +40,12 @@
 #include "arch.h"
 #include "scatter.h"
 #include "session.h"
+#include "spu_events.h" /* for sp_time */
 
 typedef struct  dummy_down_link {
 	int32			type;
 	scatter 		*mess; 
+	sp_time			enq_time;	/* when handed to Prot_new_message */
 	struct	dummy_down_link *next;
 } down_link;
 
@@ -66,6 +68,7 @@ void    Prot_Destroy_Local_Session(session *old_sess);
 down_link       *Prot_Create_Down_Link(message_obj *msg, int type, int mbox, int cur_element);
 void    Prot_kill_session(message_obj *msg);
 void	Prot_set_prev_proc(configuration *memb);
+int32   Prot_packets_for_gap( int32 max_seq_gap );
 
 /* thresholds defined in net_types.h: UNRELIABLE_TYPE, AGREED_TYPE, BLOCK_REGULAR_DELIVERY, etc. */
 
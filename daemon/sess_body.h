@@ -81,6 +81,11 @@ typedef struct  dummy_daemon_members {
         int32           proc_id;        /* NOTE: groups.c depends on 'proc_id' being the first member (DaemonsList) */
 	membership_id   memb_id;        /* used for vs_set sorting in G_build_memb_vs_buf; unknown_memb_id means partitioned. */
         stdskl          MembersList;    /* (member*) -> nil */
+        bool            hashed;         /* IncrementalGroupState: bytes and hashes below are of this */
+        group_id        hashed_grp_id;  /*   daemon's part of the group while it had this group id */
+        int32u          bytes;
+        int32u          hash_oaat;
+        int32u          hash_sfh;
 } daemon_members;
 
 typedef	struct	dummy_group {
@@ -119,5 +124,8 @@ void	Sess_write( int ses, message_link *mess_link, int *needed );
 void	Sess_dispose_message( message_link *mess_link );
 int	Sess_get_session( char *name );
 int	Sess_get_session_index (int mbox);
+#ifdef GROUPS_BENCH
+void	Sess_bench_session( int ses, mailbox mbox );
+#endif
 
 #endif	/* INC_SESS_BODY */
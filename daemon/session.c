@@ -58,6 +58,8 @@
 #include <sys/un.h>
 #include <signal.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 
 #else   /* ARCH_PC_WIN95 */
 
@@ -98,6 +100,20 @@ static	mailbox		Accept_unix_mbox;
 
 static	int		Protocol_threshold;
 
+#define	SPILL_CHUNK	( 1024 * 1024 )	/* first size of a spill file, doubled as it fills */
+static	int		Spill_dir = -1;	/* SessionSpillDir, opened before any chroot */
+
+/* Sess_recv reads sockets ahead into here and Sess_read takes every whole
+ * message read before returning, since select() will not report them. A
+ * read stops short of this to keep what a session queues past the
+ * protocol's WATER_MARK in one go small. */
+#define	READ_AHEAD_SIZE	( 16 * 1024 )
+static	char		Read_ahead[READ_AHEAD_SIZE];
+static	int		Read_ahead_head;
+static	int		Read_ahead_tail;
+
+#define	Has_write_backlog( ses )	( Sessions[ses].num_mess > 0 || Sessions[ses].spill.num_mess > 0 )
+
 #define SESSION_FD_HASH_SIZE    256
 static	session		*Sessions_hash_head[SESSION_FD_HASH_SIZE];
 static	session		*Sessions_head;
@@ -110,10 +126,20 @@ static  void    Sess_recv_client_auth(mailbox mbox, int dummy, void *dummy_p);
 static	void    Sess_accept( mailbox mbox, int domain, void *dummy );
 static	void	Sess_accept_continue( mailbox, int, void * );
 static	void    Sess_read( mailbox mbox, int domain, void *dummy );
+static	void	Sess_read_message( mailbox mbox );
 static	void	Sess_badger( mailbox mbox );
 static	void	Sess_badger_TO( mailbox mbox, void *dummy );
 static  void    Sess_badger_FD( mailbox mbox, int dmy, void *dmy2 );
+static	int	Sess_send_elements( mailbox mbox, scat_element *elements, int num_elements );
+static	int	Sess_scat_bytes( scatter *scat, int num_elements );
 static	void	Sess_kill( mailbox mbox );
+static	int	Sess_write_queue_full( int ses );
+static	int	Sess_spill_write( int ses, message_obj *msg );
+static	int	Sess_spill_reserve( int fd, int from, int to );
+static	int	Sess_spill_gather( int ses, sys_scatter *scat );
+static	void	Sess_spill_consume( int ses, int bytes );
+static	void	Sess_spill_close( int ses );
+static	int	Sess_recv( int ses, char *buf, int len );
 static	void	Sess_handle_join( message_link *mess_link );
 static	void	Sess_handle_leave( message_link *mess_link );
 static	void	Sess_handle_kill( message_link *mess_link );
@@ -428,6 +454,15 @@ void	Sess_init()
 	Accept_unix_mbox = mbox;
         Alarm( SESSION, "Sess_init: UNIX went ok on mailbox %d\n", mbox );
 
+	/* spill files are created relative to this, so it has to be opened before the chroot */
+	if( Conf_get_session_spill() )
+	{
+		Spill_dir = open( Conf_get_session_spill_dir(), O_RDONLY );
+		if( Spill_dir < 0 )
+			Alarmp( SPLOG_WARNING, SESSION, "Sess_init: cannot open SessionSpillDir %s: %s; sessions that do not read will be killed\n",
+				Conf_get_session_spill_dir(), strerror( errno ) );
+	}
+
 #endif	/* ARCH_PC_WIN95 */
 
 	Sess_attach_accept();
@@ -1035,6 +1070,7 @@ void    Sess_session_authorized(int ses)
 {
         char        ip[16];
         char        response;
+        int         ioctl_cmd;
         unsigned int    name_len;
         char	private_group_name[MAX_GROUP_NAME];
 
@@ -1055,6 +1091,10 @@ void    Sess_session_authorized(int ses)
          *
          */
         Sessions[ses].num_mess = 0;
+        Sessions[ses].queued_bytes = 0;
+        Sessions[ses].spill.fd = -1;
+        Sessions[ses].spill.map = NULL;
+        Sessions[ses].spill.num_mess = 0;
         response = ACCEPT_SESSION;
         send( Sessions[ses].mbox, &response, 1, 0 );
 
@@ -1077,6 +1117,11 @@ void    Sess_session_authorized(int ses)
         /* sending the private group name */
         send( Sessions[ses].mbox, private_group_name, name_len, 0 );
 
+        /* From here on the session is only read and written without blocking:
+         * Sess_read and Sess_badger pick up where a short read or write stopped */
+        ioctl_cmd = 1;
+        ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd );
+
         E_attach_fd( Sessions[ses].mbox, READ_FD, Sess_read, Sessions[ses].type, NULL, 
                      LOW_PRIORITY );
         E_attach_fd( Sessions[ses].mbox, EXCEPT_FD, Sess_read, Sessions[ses].type, NULL, 
@@ -1164,6 +1209,20 @@ static  int     Sess_validate_read_header( mailbox mbox, int ses, int head_size,
 }
 
 static	void	Sess_read( mailbox mbox, int dummy, void *d2 )
+{
+	int		ses;
+
+	do{
+		Sess_read_message( mbox );
+		ses = Sess_get_session_index( mbox );
+	}while( Read_ahead_head < Read_ahead_tail && ses >= 0 && ses < MAX_SESSIONS &&
+		Is_op_session( Sessions[ses].status ) );
+
+	/* anything left belongs to a session killed meanwhile */
+	Read_ahead_head = Read_ahead_tail = 0;
+}
+
+static	void	Sess_read_message( mailbox mbox )
 {
 	message_header	*head_ptr, *msg_head;
         message_obj     *msg;
@@ -1173,7 +1232,7 @@ static	void	Sess_read( mailbox mbox, int dummy, void *d2 )
 	int		packet_index, byte_index, to_read;
 	int             len, remain, ret;
         int             head_size, data_frag_len;
-        int             ses, ioctl_cmd;
+        int             ses;
         char            *head_cbuf;
 #if 0
 #ifndef ARCH_SCATTER_NONE
@@ -1212,41 +1271,29 @@ static  struct  msghdr  msgh;
         head_cbuf = (char *) head_ptr;
         head_size = Message_get_header_size();
 
-        /* set file descriptor to non blocking */
-	ioctl_cmd = 1;
-	ret = ioctl( mbox, FIONBIO, &ioctl_cmd);
-
         if ( Sessions[ses].read.in_mess_head == 1 )
         {
                 /* read up to size of message_header */
                 len = Sessions[ses].read.cur_byte;
                 remain = sizeof(message_header) - len;
-                ret = recv( mbox, (char *) &head_cbuf[len], remain, 0 );
+                ret = Sess_recv( ses, (char *) &head_cbuf[len], remain );
                 if( ret  == remain )
                 {
                         Sessions[ses].read.cur_byte += ret;
                         Message_set_location_begin_body(&(Sessions[ses].read) );
                 } else  if (ret > 0 ) {
                         Sessions[ses].read.cur_byte += ret;
-                        ioctl_cmd = 0;
-                        ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
                         return;
                 } else {
                         /* error reading */
                         if ( (ret == -1) && ( (sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK) ) ) {
-                                ioctl_cmd = 0;
-                                ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
                                 return;
                         }
                         Alarm( SESSION, "Sess_read: failed receiving header on session %d: ret %d: error: %s \n", mbox, ret, sock_strerror(sock_errno) );
                         Sess_kill( mbox );
-                        ioctl_cmd = 0;
-                        ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
                         return;
                 }
                 /* When we get here we have a complete header */
-                ioctl_cmd = 0;
-                ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
 
                 /* Fliping message header to my form if needed */
                 if( !Same_endian( head_ptr->type ) ) 
@@ -1285,10 +1332,6 @@ static  struct  msghdr  msgh;
 	/* read the rest of the message if needed, reserving room at the beginning
          * of the first fragment(scat buf) for the message header and the lts and seq fields. */
 
-        /* enable non-blocking io */
-	ioctl_cmd = 1;
-	ret = ioctl( mbox, FIONBIO, &ioctl_cmd);
-
         data_frag_len = Message_get_data_fragment_len();
         scat = Message_get_data_scatter(msg);
 	remain = ( head_ptr->data_len + MAX_GROUP_NAME*head_ptr->num_groups )  - Sessions[ses].read.total_bytes;
@@ -1304,8 +1347,8 @@ static  struct  msghdr  msgh;
                 }
 		to_read = ( data_frag_len - byte_index );
 		if( to_read > remain ) to_read = remain;
-		ret = recv( mbox, &scat->elements[packet_index].buf[byte_index],
-				to_read, 0 );
+		ret = Sess_recv( ses, &scat->elements[packet_index].buf[byte_index],
+				to_read );
                 if( ret  == to_read )
                 {
                         Sessions[ses].read.cur_byte = 0;
@@ -1314,27 +1357,19 @@ static  struct  msghdr  msgh;
                 } else  if (ret > 0 ) {
                         Sessions[ses].read.cur_byte += ret;
                         Sessions[ses].read.total_bytes += ret;
-                        ioctl_cmd = 0;
-                        ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
                         return;
                 } else {
                         if ( (ret == -1) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) ) {
-                                ioctl_cmd = 0;
-                                ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
                                 return;
                         }
 			Alarm( SESSION, "Sess_read: failed receiving message on session %d, ret is %d: error: %s\n", mbox, ret, sock_strerror(sock_errno) );
 			Alarm( SESSION, "Sess_read: failed recv msg more info: len read: %d, remain: %d, to_read: %d, pkt_index: %d, b_index: %d, scat_nums: %d\n",Sessions[ses].read.total_bytes, remain, to_read, packet_index, byte_index, scat->num_elements );
 			Sess_kill( mbox );
-                        ioctl_cmd = 0;
-                        ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
 			return;
 		}
 	}
 
         /* We now have a complete message */
-        ioctl_cmd = 0;
-        ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);        
 
         /* reset active read_mess to empty */
         Message_reset_current_location(&(Sessions[ses].read));
@@ -1469,6 +1504,8 @@ static  struct  msghdr  msgh;
                         Sess_dispose_message( mess_link );
                         Sessions[ses].num_mess--;
                 }
+                Sessions[ses].queued_bytes = 0;
+                Sess_spill_close( ses );
 
                 /* close the mailbox and mark it unoperational */
                 E_dequeue( Sess_badger_TO, mbox, NULL );
@@ -1542,27 +1579,75 @@ static  void    Sess_deliver_reject( message_obj *msg )
         return;
 }
 
+/* Writes elements to a client socket in a single sendmsg (one send per
+ * element where there is no scatter/gather). Client sockets are non-blocking,
+ * so this returns the number of bytes the socket took, possibly 0.
+ */
+static	int	Sess_send_elements( mailbox mbox, scat_element *elements, int num_elements )
+{
+	int		ret;
+#ifndef ARCH_SCATTER_NONE
+	struct	msghdr	msgh;
+
+	memset( &msgh, 0, sizeof(msgh) );
+	msgh.msg_iov    = (struct iovec *) elements;
+	msgh.msg_iovlen = num_elements;
+
+	while( ( ret = sendmsg( mbox, &msgh, 0 ) ) == -1 && sock_errno == EINTR );
+	if( ret < 0 ) return( 0 );
+
+	return( ret );
+#else
+	int		total;
+	int		i;
+
+	for( total=0, i=0; i < num_elements; i++ )
+	{
+		ret = send( mbox, elements[i].buf, elements[i].len, 0 );
+		if( ret > 0 ) total += ret;
+		if( ret != (int) elements[i].len ) break;
+	}
+	return( total );
+#endif  /* ARCH_SCATTER_NONE */
+}
+
+/* bytes in the first num_elements elements of scat */
+static	int	Sess_scat_bytes( scatter *scat, int num_elements )
+{
+	int		bytes;
+	int		i;
+
+	for( bytes=0, i=0; i < num_elements; i++ )
+		bytes += scat->elements[i].len;
+
+	return( bytes );
+}
+
 void    Sess_write( int ses, message_link *mess_link, int *needed )
 {
         message_obj     *msg;
 	message_link	*tmp_link;
         scatter         *scat;
-	int		ioctl_cmd;
-	int 		ret;
 	int		total_to_send;
-	int		len_sent, first_data_len;
-        char            *first_data_ptr;
-	int		i;
+	int		len_sent;
+#ifdef  PROBE_LATENCY
         message_header  *head_ptr;
+#endif
 
 	if( !Is_op_session( Sessions[ses].status ) ) return;
 
-	if( Sessions[ses].num_mess >= Conf_get_max_session_messages() )
+	/* once a session has spilled, everything goes after the spilled messages */
+	if( Sessions[ses].spill.num_mess > 0 || Sess_write_queue_full( ses ) )
 	{
-		Alarm( SESSION, 
-			"Sess_write: killing mbox %d for not reading\n",
-			Sessions[ses].mbox );
-		Sess_kill( Sessions[ses].mbox );
+		if( !Conf_get_session_spill() || Sess_spill_write( ses, mess_link->mess ) < 0 )
+		{
+			Alarm( SESSION, 
+				"Sess_write: killing mbox %d for not reading\n",
+				Sessions[ses].mbox );
+			Sess_kill( Sessions[ses].mbox );
+			return;
+		}
+		if( Sessions[ses].num_mess == 0 ) Sess_badger( Sessions[ses].mbox );
 		return;
 	}
 
@@ -1575,14 +1660,11 @@ void    Sess_write( int ses, message_link *mess_link, int *needed )
         Obj_Inc_Refcount(msg);
         scat = Message_get_data_scatter(msg);
 
-	for( total_to_send=0, i=0; i < (int) scat->num_elements; i++ )
-		total_to_send += scat->elements[i].len;
-
-        /* since also sending message_header */
-        total_to_send += Message_get_non_body_header_size();
+	/* the message_header leads the first element, so the elements are the whole message */
+	total_to_send = Sess_scat_bytes( scat, scat->num_elements ) + Message_get_non_body_header_size();
 
-        head_ptr = Message_get_message_header(msg);
 #ifdef  PROBE_LATENCY
+        head_ptr = Message_get_message_header(msg);
         if (Is_latency_mess( head_ptr->type ) )
         {
                 int32u          initial_offset, htime_offset;
@@ -1604,44 +1686,7 @@ void    Sess_write( int ses, message_link *mess_link, int *needed )
 	len_sent = 0;
 	if( Sessions[ses].num_mess == 0 )
 	{
-		/* set file descriptor to non blocking */
-		ioctl_cmd = 1;
-		ret = ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);
-
-                /* Send the first part of message which must be handled specially */
-                ret = send(Sessions[ses].mbox, (char *) head_ptr, 
-                           sizeof(message_header), 0);
-                if ( ret > 0 ) len_sent += ret;
-                if ( ret != sizeof(message_header) )
-                {
-                        goto end_write;
-                }
-                /* Send the first data of message which must be handled specially */
-                first_data_ptr = Message_get_first_data_ptr(msg);
-                first_data_len = Message_get_first_data_len(msg);
-                ret = send(Sessions[ses].mbox, first_data_ptr, 
-                           first_data_len, 0);
-                if ( ret > 0 ) len_sent += ret;
-                if ( ret != first_data_len )
-                {
-                        goto end_write;
-                }
-		/* send the message after first buffer*/
-		for( i=1; i < (int) scat->num_elements; i++ )
-		{
-			ret = send( Sessions[ses].mbox, scat->elements[i].buf, 
-							scat->elements[i].len, 0);
-			if( ret > 0 ) len_sent += ret;
-			if( ret != scat->elements[i].len )
-			{ 
-				break;
-			}
-		}
-		/* set file descriptor back to blocking */
-        end_write:
-		ioctl_cmd = 0;
-		ret = ioctl( Sessions[ses].mbox, FIONBIO, &ioctl_cmd);
-
+		len_sent = Sess_send_elements( Sessions[ses].mbox, scat->elements, scat->num_elements );
 	}
 
 	if( len_sent < total_to_send )
@@ -1649,13 +1694,14 @@ void    Sess_write( int ses, message_link *mess_link, int *needed )
 		/* this message has to be linked */
 		if( *needed )
 		{
-			/* create a copy of mess_link and link it */
+			/* link another hold on the same message; each session keeps its own place in it */
 			tmp_link = new(MESSAGE_LINK);
                         if (tmp_link == NULL ) {
                                 Alarm(EXIT, "Sess_write: Failed to allocate a new MESSAGE_LINK.\n");
                                 return;
                         }
-                        tmp_link->mess = Message_copy_message(msg);
+                        tmp_link->mess = msg;
+                        Obj_Inc_Refcount(msg);
 			++*needed;
 		}else{
 			/* should link mess_link itself */
@@ -1680,92 +1726,84 @@ void    Sess_write( int ses, message_link *mess_link, int *needed )
 			Sessions[ses].last = tmp_link;
 		}
 		Sessions[ses].num_mess++;
+		Sessions[ses].queued_bytes += total_to_send - len_sent;
 	}
         Message_Dec_Refcount(msg);
 }
 
 static	void	Sess_badger( mailbox mbox )
 {
+static	sys_scatter	write_scat;
 	int		ses;
 	message_link	*mess_link;
 	int		able_to_write;
-        message_obj     *msg;
         scatter         *scat;
-	int		ioctl_cmd;
-	int		bytes_to_send, from;
+	int		bytes_to_send, bytes_sent;
+	int		from, msg_left;
 	int		i;
-	int		ret;
 
 	Alarm( SESSION, "Sess_badger: for mbox %d\n", mbox );
 	ses = Sess_get_session_index( mbox );
-	if( ses < 0 || ses >= MAX_SESSIONS || !Is_op_session( Sessions[ses].status ) || Sessions[ses].num_mess <= 0 ) goto NO_WORK;
-
-	/* set file descriptor to non blocking */
-	ioctl_cmd = 1;
-	ret = ioctl( mbox, FIONBIO, &ioctl_cmd);
+	if( ses < 0 || ses >= MAX_SESSIONS || !Is_op_session( Sessions[ses].status ) || !Has_write_backlog( ses ) ) goto NO_WORK;
 
-	for( able_to_write = 1 ; Sessions[ses].num_mess > 0 && able_to_write;  )
+	for( able_to_write = 1 ; Has_write_backlog( ses ) && able_to_write;  )
 	{
-		msg = Sessions[ses].first->mess;
-                Obj_Inc_Refcount(msg);
+		/* gather the unsent rest of the first message and as many
+		 * following messages as fit, and write them all at once */
+		write_scat.num_elements = 0;
+		bytes_to_send = 0;
+		for( mess_link = Sessions[ses].first; mess_link != NULL && write_scat.num_elements < ARCH_SCATTER_SIZE; mess_link = mess_link->next )
+		{
+			scat = Message_get_data_scatter( mess_link->mess );
+			if( mess_link == Sessions[ses].first ) {
+				i    = Sessions[ses].write.cur_element;
+				from = Sessions[ses].write.cur_byte;
+			}else{
+				i    = 0;
+				from = 0;
+			}
+			for( ; i < (int) scat->num_elements && write_scat.num_elements < ARCH_SCATTER_SIZE; i++, from = 0 )
+			{
+				write_scat.elements[write_scat.num_elements].buf = &scat->elements[i].buf[from];
+				write_scat.elements[write_scat.num_elements].len = scat->elements[i].len - from;
+				bytes_to_send += scat->elements[i].len - from;
+				write_scat.num_elements++;
+			}
+		}
+		/* the spill file follows the messages in memory */
+		if( mess_link == NULL )
+			bytes_to_send += Sess_spill_gather( ses, &write_scat );
 
-                /* First if we havn't sent the mess_head yet, send that special
-                 * and then reset the cur_byte and in_mess_head fields 
-                 */
-                if ( Sessions[ses].write.in_mess_head == 1 )
-                {
-                        char *tmp_buf;
+		bytes_sent = Sess_send_elements( mbox, write_scat.elements, write_scat.num_elements );
+		if( bytes_sent < bytes_to_send ) able_to_write = 0;
 
-                        tmp_buf = (char *) Message_get_message_header(msg);
-                        from = Sessions[ses].write.cur_byte;
-                        bytes_to_send = sizeof(message_header) - from;
-                        ret = send(mbox, &tmp_buf[from], bytes_to_send, 0);
-                        if (ret == bytes_to_send)
-                        {
-                                Message_set_location_begin_body(&(Sessions[ses].write));
-                        } else 
-                        {
-                                if (ret > 0) Sessions[ses].write.cur_byte = from + ret;
-                                able_to_write = 0;
-                        }
-                }
-                /* Next if we still can, send some body of this messsage */
-                if ( able_to_write )
-                {
-                        scat = Message_get_data_scatter(msg);
-                        for( i=Sessions[ses].write.cur_element, from=Sessions[ses].write.cur_byte;
-                             i < (int) scat->num_elements; 
-                             i++, from=0 )
-                        {
-                                bytes_to_send = scat->elements[i].len - from;
-                                ret = send( mbox, &(scat->elements[i].buf[from]), bytes_to_send, 0);
-                                if( ret == bytes_to_send )
-                                {        
-                                        Sessions[ses].write.cur_byte = 0;
-                                        Sessions[ses].write.cur_element++;
-                                }else{
-                                        if( ret > 0 ) Sessions[ses].write.cur_byte += ret;
-                                        able_to_write = 0;
-                                        break; 
-                                }
-                        }
-                }
-		if( able_to_write )
+		/* free the messages fully written and note how far into the next one we got */
+		while( Sessions[ses].num_mess > 0 )
 		{
-			/* free that message */
+			scat = Message_get_data_scatter( Sessions[ses].first->mess );
+			from = Sess_scat_bytes( scat, Sessions[ses].write.cur_element ) + Sessions[ses].write.cur_byte;
+			msg_left = Sess_scat_bytes( scat, scat->num_elements ) - from;
+			if( bytes_sent < msg_left )
+			{
+				if( bytes_sent > 0 )
+					Message_calculate_current_location( Sessions[ses].first->mess, from + bytes_sent, &(Sessions[ses].write) );
+				Sessions[ses].queued_bytes -= bytes_sent;
+				bytes_sent = 0;
+				break;
+			}
+			bytes_sent -= msg_left;
+			Sessions[ses].queued_bytes -= msg_left;
+
 			mess_link = Sessions[ses].first;
 			Sessions[ses].first = Sessions[ses].first->next;
 			Sessions[ses].num_mess--;
                         Message_reset_current_location(&(Sessions[ses].write) );
 			Sess_dispose_message( mess_link );
 		}
-                Message_Dec_Refcount(msg);
-	} /* for loop per message */
-	/* set file descriptor back to blocking */
-	ioctl_cmd = 0;
-	ret = ioctl( mbox, FIONBIO, &ioctl_cmd);
+		if( bytes_sent > 0 ) Sess_spill_consume( ses, bytes_sent );
+	} /* for loop per write */
 
-	if( Sessions[ses].num_mess > 0 ) {
+	if( Has_write_backlog( ses ) ) {
 	  E_queue( Sess_badger_TO, mbox, NULL, Badger_timeout );
 	  E_attach_fd( mbox, WRITE_FD, Sess_badger_FD, 0, NULL, LOW_PRIORITY );
 
@@ -1786,6 +1824,224 @@ static void Sess_badger_FD( mailbox mbox, int dmy, void *dmy2 )
         Sess_badger( mbox );
 }
 
+/* MaxSessionMessages and MaxSessionBytes bound what a session keeps queued in memory */
+static	int	Sess_write_queue_full( int ses )
+{
+	if( Sessions[ses].num_mess >= Conf_get_max_session_messages() ) return( 1 );
+	if( Conf_get_max_session_bytes() > 0 && Sessions[ses].queued_bytes >= Conf_get_max_session_bytes() ) return( 1 );
+	return( 0 );
+}
+
+/* Appends msg to the spill file of a session whose write queue is full,
+ * creating the file for the first message. The records are sent in order
+ * by Sess_badger once the messages in memory are gone. Returns -1 when
+ * the session has to be killed instead, as it would be without spilling,
+ * which includes the disk filling up.
+ */
+static	int	Sess_spill_write( int ses, message_obj *msg )
+{
+#ifndef	ARCH_PC_WIN95
+	struct	spill_file_info	*spill;
+	scatter		*scat;
+	char		name[40];
+	char		*map;
+	int32		len;
+	int		need, size, offset;
+	int		ret, i;
+
+	spill = &Sessions[ses].spill;
+	scat  = Message_get_data_scatter( msg );
+	len   = Sess_scat_bytes( scat, scat->num_elements );
+	need  = sizeof(int32) + len;
+
+	if( Spill_dir < 0 ) return( -1 );
+	if( spill->tail - spill->head + need > Conf_get_max_session_spill_bytes() )
+	{
+		Alarmp( SPLOG_INFO, SESSION, "Sess_spill_write: session %s has %d bytes spilled, more would pass MaxSessionSpillBytes\n",
+			Sessions[ses].name, spill->tail - spill->head );
+		return( -1 );
+	}
+	if( spill->fd < 0 )
+	{
+		snprintf( name, sizeof(name), "spread-spill-%d-%d", (int) getpid(), Sessions[ses].mbox );
+		spill->fd = openat( Spill_dir, name, O_RDWR | O_CREAT | O_EXCL, 0600 );
+		if( spill->fd < 0 )
+		{
+			Alarmp( SPLOG_WARNING, SESSION, "Sess_spill_write: cannot create %s in %s: %s\n",
+				name, Conf_get_session_spill_dir(), strerror( errno ) );
+			return( -1 );
+		}
+		/* the file goes away with the last reference to it */
+		unlinkat( Spill_dir, name, 0 );
+		spill->map  = NULL;
+		spill->size = spill->head = spill->tail = spill->sent = spill->num_mess = 0;
+		Alarmp( SPLOG_INFO, SESSION, "Sess_spill_write: session %s spills to disk with %d messages (%d bytes) queued\n",
+			Sessions[ses].name, Sessions[ses].num_mess, Sessions[ses].queued_bytes );
+	}
+	if( spill->tail + need > spill->size && spill->head > 0 )
+	{
+		/* move the unsent records to the front before growing the file */
+		memmove( spill->map, &spill->map[spill->head], spill->tail - spill->head );
+		spill->tail -= spill->head;
+		spill->head  = 0;
+	}
+	if( spill->tail + need > spill->size )
+	{
+		size = ( spill->size > 0 ? spill->size : SPILL_CHUNK );
+		while( size < spill->tail + need )
+			size = ( size < ( 1 << 29 ) ? 2 * size : spill->tail + need );
+
+		/* a full disk has to fail here: storing into an unallocated page of the map raises SIGBUS */
+		ret = Sess_spill_reserve( spill->fd, spill->size, size );
+		if( ret != 0 )
+		{
+			Alarmp( SPLOG_WARNING, SESSION, "Sess_spill_write: cannot grow the spill file of session %s to %d bytes: %s\n",
+				Sessions[ses].name, size, strerror( ret ) );
+			return( -1 );
+		}
+		if( spill->map != NULL ) munmap( spill->map, spill->size );
+		spill->map = NULL;
+		if( ( map = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, spill->fd, 0 ) ) == MAP_FAILED )
+		{
+			Alarmp( SPLOG_WARNING, SESSION, "Sess_spill_write: cannot map the spill file of session %s: %s\n",
+				Sessions[ses].name, strerror( errno ) );
+			return( -1 );
+		}
+		spill->map  = map;
+		spill->size = size;
+	}
+
+	memcpy( &spill->map[spill->tail], &len, sizeof(int32) );
+	offset = spill->tail + sizeof(int32);
+	for( i = 0; i < (int) scat->num_elements; i++ )
+	{
+		memcpy( &spill->map[offset], scat->elements[i].buf, scat->elements[i].len );
+		offset += scat->elements[i].len;
+	}
+	spill->tail = offset;
+	spill->num_mess++;
+	return( 0 );
+#else
+	return( -1 );
+#endif	/* ARCH_PC_WIN95 */
+}
+
+/* Allocates the blocks of a spill file from byte from up to byte to, which
+ * also extends the file. Returns 0, or the errno of the failure. */
+static	int	Sess_spill_reserve( int fd, int from, int to )
+{
+#ifndef	ARCH_PC_WIN95
+#ifdef	HAVE_POSIX_FALLOCATE
+	return( posix_fallocate( fd, from, to - from ) );
+#else
+static	char	zeros[8192];
+	int	ret;
+
+	for( ; from < to; from += ret )
+	{
+		ret = pwrite( fd, zeros, ( to - from < (int) sizeof(zeros) ? to - from : (int) sizeof(zeros) ), from );
+		if( ret < 0 )
+		{
+			if( errno == EINTR ) { ret = 0; continue; }
+			return( errno );
+		}
+	}
+	return( 0 );
+#endif	/* HAVE_POSIX_FALLOCATE */
+#else
+	return( ENOSYS );
+#endif	/* ARCH_PC_WIN95 */
+}
+
+/* Adds the unsent spilled records to scat, as many as fit, and returns their bytes */
+static	int	Sess_spill_gather( int ses, sys_scatter *scat )
+{
+	struct	spill_file_info	*spill;
+	int32		len;
+	int		offset, from;
+	int		bytes;
+
+	spill = &Sessions[ses].spill;
+	bytes = 0;
+	for( offset = spill->head, from = spill->sent; offset < spill->tail && scat->num_elements < ARCH_SCATTER_SIZE; from = 0 )
+	{
+		memcpy( &len, &spill->map[offset], sizeof(int32) );
+		scat->elements[scat->num_elements].buf = &spill->map[offset + sizeof(int32) + from];
+		scat->elements[scat->num_elements].len = len - from;
+		scat->num_elements++;
+		bytes  += len - from;
+		offset += sizeof(int32) + len;
+	}
+	return( bytes );
+}
+
+/* Moves past the first bytes sent of the spilled records. The file is
+ * dropped once all are sent. */
+static	void	Sess_spill_consume( int ses, int bytes )
+{
+	struct	spill_file_info	*spill;
+	int32		len;
+
+	spill = &Sessions[ses].spill;
+	while( spill->num_mess > 0 )
+	{
+		memcpy( &len, &spill->map[spill->head], sizeof(int32) );
+		if( bytes < len - spill->sent )
+		{
+			spill->sent += bytes;
+			break;
+		}
+		bytes -= len - spill->sent;
+		spill->head += sizeof(int32) + len;
+		spill->sent  = 0;
+		spill->num_mess--;
+	}
+	if( spill->num_mess == 0 )
+	{
+		Alarmp( SPLOG_INFO, SESSION, "Sess_spill_consume: session %s caught up with its spill file\n", Sessions[ses].name );
+		Sess_spill_close( ses );
+	}
+}
+
+static	void	Sess_spill_close( int ses )
+{
+	struct	spill_file_info	*spill;
+
+	spill = &Sessions[ses].spill;
+	if( spill->fd < 0 ) return;
+#ifndef	ARCH_PC_WIN95
+	if( spill->map != NULL ) munmap( spill->map, spill->size );
+	close( spill->fd );
+#endif	/* ARCH_PC_WIN95 */
+	spill->fd   = -1;
+	spill->map  = NULL;
+	spill->size = spill->head = spill->tail = spill->sent = spill->num_mess = 0;
+}
+
+/* recv() from the client, reading the socket ahead of len so one recv()
+ * can bring in many small messages. */
+static	int	Sess_recv( int ses, char *buf, int len )
+{
+	int		ret;
+
+	if( Read_ahead_head == Read_ahead_tail )
+	{
+		if( len >= READ_AHEAD_SIZE )
+			return( recv( Sessions[ses].mbox, buf, len, 0 ) );
+
+		ret = recv( Sessions[ses].mbox, Read_ahead, READ_AHEAD_SIZE, 0 );
+		if( ret <= 0 ) return( ret );
+		Read_ahead_head = 0;
+		Read_ahead_tail = ret;
+	}
+	ret = Read_ahead_tail - Read_ahead_head;
+	if( ret > len ) ret = len;
+	memcpy( buf, &Read_ahead[Read_ahead_head], ret );
+	Read_ahead_head += ret;
+	return( ret );
+
+}
+
 static	void	Sess_kill( mailbox mbox )
 {
 	int		ses;
@@ -1837,6 +2093,8 @@ static	void	Sess_kill( mailbox mbox )
 		Sess_dispose_message( mess_link );
 		Sessions[ses].num_mess--;
 	}
+	Sessions[ses].queued_bytes = 0;
+	Sess_spill_close( ses );
         /* reset active read_mess to empty */
         Message_reset_current_location(&(Sessions[ses].read));
         Sessions[ses].read.in_mess_head = 1;
@@ -2022,6 +2280,16 @@ void	Sess_dispose_message( message_link *mess_link )
 	dispose( mess_link );
 }
 
+#ifdef GROUPS_BENCH
+/* Only built into examples/groups_bench: makes Sessions[ses] findable by
+ * mbox, as an accepted session is, without a connection behind it. */
+void	Sess_bench_session( int ses, mailbox mbox )
+{
+	Sessions[ses].mbox = mbox;
+	Sess_hash_session( &Sessions[ses] );
+}
+#endif	/* GROUPS_BENCH */
+
 int	Sess_get_session( char *name )
 {
 	int	ret;
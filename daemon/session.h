@@ -56,6 +56,17 @@ struct partial_message_info {
         int     total_bytes;
 };
 
+/* Messages past a session's write queue limits, when SessionSpill is on */
+struct spill_file_info {
+        int     fd;             /* -1 while the session has not spilled */
+        char    *map;           /* the file mapped: records of an int32 length and the message bytes */
+        int     size;           /* bytes mapped */
+        int     head;           /* offset of the first record not fully sent */
+        int     tail;           /* offset the next record goes to */
+        int     sent;           /* bytes of the first record already sent */
+        int     num_mess;       /* records from head to tail */
+};
+
 typedef	struct	dummy_session {
 	char		name[MAX_PRIVATE_NAME+1]; /* +1 for the null */
         char            lib_version[3];
@@ -72,6 +83,8 @@ typedef	struct	dummy_session {
         struct partial_message_info     write;  /* Write Queue to Client */
 	message_link	*first;                 /* Write Queue to Client */
 	message_link	*last;                  /* Write Queue to Client */
+        int             queued_bytes;           /* Write Queue to Client: bytes not yet sent */
+        struct spill_file_info  spill;          /* Write Queue to Client: overflow, drained after it */
 	struct dummy_session *sort_prev;
 	struct dummy_session *sort_next;
 	struct dummy_session *hash_next;
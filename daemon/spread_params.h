@@ -70,10 +70,18 @@
 #define         MAX_REPS                 25
 #define         MAX_FORM_REPS            20
 
-#define		MAX_PACKETS_IN_STRUCT 	8192
-#define		PACKET_MASK		0x00001fff
+#define		MIN_PACKETS_IN_STRUCT 	8192	/* smallest Packets[] store; always a power of 2 */
+#define		PACKETS_PER_SEQ_GAP	5	/* Packets[] holds at least this many seq gaps worth of packets */
 
-#define		MAX_SEQ_GAP		1600	/* used in flow control to limit difference between highest_seq and aru */
+#define		DEFAULT_MAX_SEQ_GAP	1600	/* used in flow control to limit difference between highest_seq and aru */
+#define		MIN_MAX_SEQ_GAP		 100
+#define		MAX_MAX_SEQ_GAP		100000
+
+#define		MAX_RECV_BATCH		64	/* most broadcast packets received per Prot_handle_bcast call; covers one UDP_GRO receive */
+#define		MAX_SEND_BATCH		256	/* most broadcast packets queued by Net_queue_bcast before a flush */
+
+#define		FAST_LOSS_MIN_SAMPLES	8	/* token rounds measured before FastFailureDetection shortens token loss */
+#define		FAST_LOSS_HURRIES	2	/* lost tokens the leader may resend before the predecessor is suspected */
 
 #define		MAX_EVS_ROUNDS		500 	/* used in EVS state to limit total # of rounds to complete EVS */
 
@@ -87,6 +95,8 @@
 #define		MAX_SESSIONS		( ( MAX_FD_EVENTS-5 ) / 2 ) /* reserves 2 for each connection */
 
 #define		DEFAULT_MAX_SESSION_MESSAGES	1000
+#define		DEFAULT_MAX_SESSION_BYTES	0	/* no limit on the bytes a session queues in memory */
+#define		DEFAULT_MAX_SESSION_SPILL_BYTES	(256*1024*1024)	/* backlog a session may spill to disk */
 #define         MAX_GROUPS_PER_MESSAGE  100     /* Each multicast can't send to more groups then this */
 
 #define         MAX_WRAP_SEQUENCE_VALUE (1<<30) /* Maximum value for token->seq before reseting to zero with membership */
@@ -75,6 +75,7 @@ void	Stat_init()
 	GlobalStatus.major_version = SP_MAJOR_VERSION;
 	GlobalStatus.minor_version = SP_MINOR_VERSION;
 	GlobalStatus.patch_version = SP_PATCH_VERSION;
+	GlobalStatus.status_version = STATUS_VERSION;
 
 	Alarm( STATUS, "Stat_init: went ok\n" );
 
@@ -110,3 +111,17 @@ void	Stat_handle_message( sys_scatter *scat )
 			p.name );
 }
 
+void	Stat_hist_record( int hist, int32 value )
+{
+	int	msb;
+	int	i;
+
+	if( value < 2 ) {
+		i = ( value < 0 ) ? 0 : value;
+	} else {
+		for( msb = 1; ( value >> ( msb + 1 ) ) != 0; msb++ );
+		i = 2 * msb + ( ( value >> ( msb - 1 ) ) & 1 );
+		if( i >= STAT_HIST_BUCKETS ) i = STAT_HIST_BUCKETS - 1;
+	}
+	GlobalStatus.hist[hist][i]++;
+}
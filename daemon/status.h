@@ -40,6 +40,24 @@
 #include "arch.h"
 #include "scatter.h"
 
+/* Latency histograms carried in the status packet. Bucket i counts values
+ * in [STAT_HIST_LOW(i), STAT_HIST_LOW(i+1)): exact below 2, then two buckets
+ * per power of two (so within 50% of the true value). Times are in
+ * microseconds; the last bucket also holds everything above about 8 sec.
+ */
+#define	STAT_HIST_BUCKETS	48
+#define	STAT_HIST_LOW(i)	( (i) < 2 ? (i) : ( ( 1 << ((i)/2) ) + ((i)%2) * ( 1 << ((i)/2 - 1) ) ) )
+
+#define	STAT_HIST_TOKEN_ROUND	0	/* usec between token visits */
+#define	STAT_HIST_TOKEN_PACKETS	1	/* packets sent (new + retrans) per token visit */
+#define	STAT_HIST_AGREED	2	/* usec from Prot_new_message to delivery, non safe */
+#define	STAT_HIST_SAFE		3	/* usec from Prot_new_message to safe delivery */
+#define	STAT_NUM_HISTS		4
+
+/* Bumped whenever the fields after status_version change. Daemons from
+ * before it leave status_version 0 and send only the fields before it. */
+#define	STATUS_VERSION		1
+
 typedef	struct	dummy_status{
 	int32	sec;
 	int32	state;
@@ -71,6 +89,13 @@ typedef	struct	dummy_status{
 	int16	major_version;
 	int16	minor_version;
 	int16	patch_version;
+	int16	status_version;
+	int16	adaptive_window;
+	int32	fc_loss_rounds;
+	int32	fc_adjustments;
+	int32	placeholders_sent;
+	int32	placeholders_recv;
+	int32	hist[STAT_NUM_HISTS][STAT_HIST_BUCKETS];
 } status;
 
 #undef  ext
@@ -84,5 +109,6 @@ ext 	status	GlobalStatus;
 
 void	Stat_init();
 void	Stat_handle_message( sys_scatter *scat );
+void	Stat_hist_record( int hist, int32 value );
 
 #endif	/* INC_STATUS */ 
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton implementation for Bison's Yacc-like parsers in C
+/* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -36,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -43,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "2.3"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -55,170 +57,17 @@
 /* Pure parsers.  */
 #define YYPURE 0
 
-/* Using locations.  */
-#define YYLSP_NEEDED 0
-
-
+/* Push parsers.  */
+#define YYPUSH 0
 
-/* Tokens.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     SEGMENT = 258,
-     EVENTLOGFILE = 259,
-     EVENTTIMESTAMP = 260,
-     EVENTPRECISETIMESTAMP = 261,
-     EVENTPRIORITY = 262,
-     IPADDR = 263,
-     NUMBER = 264,
-     COLON = 265,
-     PDEBUG = 266,
-     PINFO = 267,
-     PWARNING = 268,
-     PERROR = 269,
-     PCRITICAL = 270,
-     PFATAL = 271,
-     OPENBRACE = 272,
-     CLOSEBRACE = 273,
-     EQUALS = 274,
-     STRING = 275,
-     DEBUGFLAGS = 276,
-     BANG = 277,
-     DDEBUG = 278,
-     DEXIT = 279,
-     DPRINT = 280,
-     DDATA_LINK = 281,
-     DNETWORK = 282,
-     DPROTOCOL = 283,
-     DSESSION = 284,
-     DCONF = 285,
-     DMEMB = 286,
-     DFLOW_CONTROL = 287,
-     DSTATUS = 288,
-     DEVENTS = 289,
-     DGROUPS = 290,
-     DMEMORY = 291,
-     DSKIPLIST = 292,
-     DACM = 293,
-     DSECURITY = 294,
-     DALL = 295,
-     DNONE = 296,
-     DEBUGINITIALSEQUENCE = 297,
-     DANGEROUSMONITOR = 298,
-     SOCKETPORTREUSE = 299,
-     RUNTIMEDIR = 300,
-     SPUSER = 301,
-     SPGROUP = 302,
-     ALLOWEDAUTHMETHODS = 303,
-     REQUIREDAUTHMETHODS = 304,
-     ACCESSCONTROLPOLICY = 305,
-     MAXSESSIONMESSAGES = 306,
-     WINDOW = 307,
-     PERSONALWINDOW = 308,
-     ACCELERATEDRING = 309,
-     ACCELERATEDWINDOW = 310,
-     TOKENTIMEOUT = 311,
-     HURRYTIMEOUT = 312,
-     ALIVETIMEOUT = 313,
-     JOINTIMEOUT = 314,
-     REPTIMEOUT = 315,
-     SEGTIMEOUT = 316,
-     GATHERTIMEOUT = 317,
-     FORMTIMEOUT = 318,
-     LOOKUPTIMEOUT = 319,
-     SP_BOOL = 320,
-     SP_TRIVAL = 321,
-     LINKPROTOCOL = 322,
-     PHOP = 323,
-     PTCPHOP = 324,
-     IMONITOR = 325,
-     ICLIENT = 326,
-     IDAEMON = 327,
-     ROUTEMATRIX = 328,
-     LINKCOST = 329
-   };
-#endif
-/* Tokens.  */
-#define SEGMENT 258
-#define EVENTLOGFILE 259
-#define EVENTTIMESTAMP 260
-#define EVENTPRECISETIMESTAMP 261
-#define EVENTPRIORITY 262
-#define IPADDR 263
-#define NUMBER 264
-#define COLON 265
-#define PDEBUG 266
-#define PINFO 267
-#define PWARNING 268
-#define PERROR 269
-#define PCRITICAL 270
-#define PFATAL 271
-#define OPENBRACE 272
-#define CLOSEBRACE 273
-#define EQUALS 274
-#define STRING 275
-#define DEBUGFLAGS 276
-#define BANG 277
-#define DDEBUG 278
-#define DEXIT 279
-#define DPRINT 280
-#define DDATA_LINK 281
-#define DNETWORK 282
-#define DPROTOCOL 283
-#define DSESSION 284
-#define DCONF 285
-#define DMEMB 286
-#define DFLOW_CONTROL 287
-#define DSTATUS 288
-#define DEVENTS 289
-#define DGROUPS 290
-#define DMEMORY 291
-#define DSKIPLIST 292
-#define DACM 293
-#define DSECURITY 294
-#define DALL 295
-#define DNONE 296
-#define DEBUGINITIALSEQUENCE 297
-#define DANGEROUSMONITOR 298
-#define SOCKETPORTREUSE 299
-#define RUNTIMEDIR 300
-#define SPUSER 301
-#define SPGROUP 302
-#define ALLOWEDAUTHMETHODS 303
-#define REQUIREDAUTHMETHODS 304
-#define ACCESSCONTROLPOLICY 305
-#define MAXSESSIONMESSAGES 306
-#define WINDOW 307
-#define PERSONALWINDOW 308
-#define ACCELERATEDRING 309
-#define ACCELERATEDWINDOW 310
-#define TOKENTIMEOUT 311
-#define HURRYTIMEOUT 312
-#define ALIVETIMEOUT 313
-#define JOINTIMEOUT 314
-#define REPTIMEOUT 315
-#define SEGTIMEOUT 316
-#define GATHERTIMEOUT 317
-#define FORMTIMEOUT 318
-#define LOOKUPTIMEOUT 319
-#define SP_BOOL 320
-#define SP_TRIVAL 321
-#define LINKPROTOCOL 322
-#define PHOP 323
-#define PTCPHOP 324
-#define IMONITOR 325
-#define ICLIENT 326
-#define IDAEMON 327
-#define ROUTEMATRIX 328
-#define LINKCOST 329
+/* Pull parsers.  */
+#define YYPULL 1
 
 
 
 
-/* Copy the first part of user declarations.  */
-#line 1 "./config_parse.y"
+/* First part of user prologue.  */
+#line 1 "config_parse.y"
 
 /*
  * The Spread Toolkit.
@@ -537,69 +386,405 @@ static  int    convert_segment_to_string(char *segstr, int strsize, segment *seg
 
 
 
+#line 390 "y.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
 
-/* Enabling traces.  */
+/* Use api.header.include to #include this header
+   instead of duplicating it here.  */
+#ifndef YY_YY_Y_TAB_H_INCLUDED
+# define YY_YY_Y_TAB_H_INCLUDED
+/* Debug traces.  */
 #ifndef YYDEBUG
 # define YYDEBUG 0
 #endif
-
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
+#if YYDEBUG
+extern int yydebug;
 #endif
 
-/* Enabling the token table.  */
-#ifndef YYTOKEN_TABLE
-# define YYTOKEN_TABLE 0
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    SEGMENT = 258,                 /* SEGMENT  */
+    EVENTLOGFILE = 259,            /* EVENTLOGFILE  */
+    EVENTTIMESTAMP = 260,          /* EVENTTIMESTAMP  */
+    EVENTPRECISETIMESTAMP = 261,   /* EVENTPRECISETIMESTAMP  */
+    EVENTPRIORITY = 262,           /* EVENTPRIORITY  */
+    IPADDR = 263,                  /* IPADDR  */
+    NUMBER = 264,                  /* NUMBER  */
+    COLON = 265,                   /* COLON  */
+    PDEBUG = 266,                  /* PDEBUG  */
+    PINFO = 267,                   /* PINFO  */
+    PWARNING = 268,                /* PWARNING  */
+    PERROR = 269,                  /* PERROR  */
+    PCRITICAL = 270,               /* PCRITICAL  */
+    PFATAL = 271,                  /* PFATAL  */
+    OPENBRACE = 272,               /* OPENBRACE  */
+    CLOSEBRACE = 273,              /* CLOSEBRACE  */
+    EQUALS = 274,                  /* EQUALS  */
+    STRING = 275,                  /* STRING  */
+    DEBUGFLAGS = 276,              /* DEBUGFLAGS  */
+    BANG = 277,                    /* BANG  */
+    DDEBUG = 278,                  /* DDEBUG  */
+    DEXIT = 279,                   /* DEXIT  */
+    DPRINT = 280,                  /* DPRINT  */
+    DDATA_LINK = 281,              /* DDATA_LINK  */
+    DNETWORK = 282,                /* DNETWORK  */
+    DPROTOCOL = 283,               /* DPROTOCOL  */
+    DSESSION = 284,                /* DSESSION  */
+    DCONF = 285,                   /* DCONF  */
+    DMEMB = 286,                   /* DMEMB  */
+    DFLOW_CONTROL = 287,           /* DFLOW_CONTROL  */
+    DSTATUS = 288,                 /* DSTATUS  */
+    DEVENTS = 289,                 /* DEVENTS  */
+    DGROUPS = 290,                 /* DGROUPS  */
+    DMEMORY = 291,                 /* DMEMORY  */
+    DSKIPLIST = 292,               /* DSKIPLIST  */
+    DACM = 293,                    /* DACM  */
+    DSECURITY = 294,               /* DSECURITY  */
+    DALL = 295,                    /* DALL  */
+    DNONE = 296,                   /* DNONE  */
+    DEBUGINITIALSEQUENCE = 297,    /* DEBUGINITIALSEQUENCE  */
+    DANGEROUSMONITOR = 298,        /* DANGEROUSMONITOR  */
+    SOCKETPORTREUSE = 299,         /* SOCKETPORTREUSE  */
+    RUNTIMEDIR = 300,              /* RUNTIMEDIR  */
+    SPUSER = 301,                  /* SPUSER  */
+    SPGROUP = 302,                 /* SPGROUP  */
+    ALLOWEDAUTHMETHODS = 303,      /* ALLOWEDAUTHMETHODS  */
+    REQUIREDAUTHMETHODS = 304,     /* REQUIREDAUTHMETHODS  */
+    ACCESSCONTROLPOLICY = 305,     /* ACCESSCONTROLPOLICY  */
+    MAXSESSIONMESSAGES = 306,      /* MAXSESSIONMESSAGES  */
+    WINDOW = 307,                  /* WINDOW  */
+    PERSONALWINDOW = 308,          /* PERSONALWINDOW  */
+    ACCELERATEDRING = 309,         /* ACCELERATEDRING  */
+    ACCELERATEDWINDOW = 310,       /* ACCELERATEDWINDOW  */
+    TOKENTIMEOUT = 311,            /* TOKENTIMEOUT  */
+    HURRYTIMEOUT = 312,            /* HURRYTIMEOUT  */
+    ALIVETIMEOUT = 313,            /* ALIVETIMEOUT  */
+    JOINTIMEOUT = 314,             /* JOINTIMEOUT  */
+    REPTIMEOUT = 315,              /* REPTIMEOUT  */
+    SEGTIMEOUT = 316,              /* SEGTIMEOUT  */
+    GATHERTIMEOUT = 317,           /* GATHERTIMEOUT  */
+    FORMTIMEOUT = 318,             /* FORMTIMEOUT  */
+    LOOKUPTIMEOUT = 319,           /* LOOKUPTIMEOUT  */
+    SP_BOOL = 320,                 /* SP_BOOL  */
+    SP_TRIVAL = 321,               /* SP_TRIVAL  */
+    LINKPROTOCOL = 322,            /* LINKPROTOCOL  */
+    PHOP = 323,                    /* PHOP  */
+    PTCPHOP = 324,                 /* PTCPHOP  */
+    IMONITOR = 325,                /* IMONITOR  */
+    ICLIENT = 326,                 /* ICLIENT  */
+    IDAEMON = 327,                 /* IDAEMON  */
+    ROUTEMATRIX = 328,             /* ROUTEMATRIX  */
+    LINKCOST = 329                 /* LINKCOST  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
+#define SEGMENT 258
+#define EVENTLOGFILE 259
+#define EVENTTIMESTAMP 260
+#define EVENTPRECISETIMESTAMP 261
+#define EVENTPRIORITY 262
+#define IPADDR 263
+#define NUMBER 264
+#define COLON 265
+#define PDEBUG 266
+#define PINFO 267
+#define PWARNING 268
+#define PERROR 269
+#define PCRITICAL 270
+#define PFATAL 271
+#define OPENBRACE 272
+#define CLOSEBRACE 273
+#define EQUALS 274
+#define STRING 275
+#define DEBUGFLAGS 276
+#define BANG 277
+#define DDEBUG 278
+#define DEXIT 279
+#define DPRINT 280
+#define DDATA_LINK 281
+#define DNETWORK 282
+#define DPROTOCOL 283
+#define DSESSION 284
+#define DCONF 285
+#define DMEMB 286
+#define DFLOW_CONTROL 287
+#define DSTATUS 288
+#define DEVENTS 289
+#define DGROUPS 290
+#define DMEMORY 291
+#define DSKIPLIST 292
+#define DACM 293
+#define DSECURITY 294
+#define DALL 295
+#define DNONE 296
+#define DEBUGINITIALSEQUENCE 297
+#define DANGEROUSMONITOR 298
+#define SOCKETPORTREUSE 299
+#define RUNTIMEDIR 300
+#define SPUSER 301
+#define SPGROUP 302
+#define ALLOWEDAUTHMETHODS 303
+#define REQUIREDAUTHMETHODS 304
+#define ACCESSCONTROLPOLICY 305
+#define MAXSESSIONMESSAGES 306
+#define WINDOW 307
+#define PERSONALWINDOW 308
+#define ACCELERATEDRING 309
+#define ACCELERATEDWINDOW 310
+#define TOKENTIMEOUT 311
+#define HURRYTIMEOUT 312
+#define ALIVETIMEOUT 313
+#define JOINTIMEOUT 314
+#define REPTIMEOUT 315
+#define SEGTIMEOUT 316
+#define GATHERTIMEOUT 317
+#define FORMTIMEOUT 318
+#define LOOKUPTIMEOUT 319
+#define SP_BOOL 320
+#define SP_TRIVAL 321
+#define LINKPROTOCOL 322
+#define PHOP 323
+#define PTCPHOP 324
+#define IMONITOR 325
+#define ICLIENT 326
+#define IDAEMON 327
+#define ROUTEMATRIX 328
+#define LINKCOST 329
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 typedef int YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
 
+extern YYSTYPE yylval;
+
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_Y_TAB_H_INCLUDED  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_SEGMENT = 3,                    /* SEGMENT  */
+  YYSYMBOL_EVENTLOGFILE = 4,               /* EVENTLOGFILE  */
+  YYSYMBOL_EVENTTIMESTAMP = 5,             /* EVENTTIMESTAMP  */
+  YYSYMBOL_EVENTPRECISETIMESTAMP = 6,      /* EVENTPRECISETIMESTAMP  */
+  YYSYMBOL_EVENTPRIORITY = 7,              /* EVENTPRIORITY  */
+  YYSYMBOL_IPADDR = 8,                     /* IPADDR  */
+  YYSYMBOL_NUMBER = 9,                     /* NUMBER  */
+  YYSYMBOL_COLON = 10,                     /* COLON  */
+  YYSYMBOL_PDEBUG = 11,                    /* PDEBUG  */
+  YYSYMBOL_PINFO = 12,                     /* PINFO  */
+  YYSYMBOL_PWARNING = 13,                  /* PWARNING  */
+  YYSYMBOL_PERROR = 14,                    /* PERROR  */
+  YYSYMBOL_PCRITICAL = 15,                 /* PCRITICAL  */
+  YYSYMBOL_PFATAL = 16,                    /* PFATAL  */
+  YYSYMBOL_OPENBRACE = 17,                 /* OPENBRACE  */
+  YYSYMBOL_CLOSEBRACE = 18,                /* CLOSEBRACE  */
+  YYSYMBOL_EQUALS = 19,                    /* EQUALS  */
+  YYSYMBOL_STRING = 20,                    /* STRING  */
+  YYSYMBOL_DEBUGFLAGS = 21,                /* DEBUGFLAGS  */
+  YYSYMBOL_BANG = 22,                      /* BANG  */
+  YYSYMBOL_DDEBUG = 23,                    /* DDEBUG  */
+  YYSYMBOL_DEXIT = 24,                     /* DEXIT  */
+  YYSYMBOL_DPRINT = 25,                    /* DPRINT  */
+  YYSYMBOL_DDATA_LINK = 26,                /* DDATA_LINK  */
+  YYSYMBOL_DNETWORK = 27,                  /* DNETWORK  */
+  YYSYMBOL_DPROTOCOL = 28,                 /* DPROTOCOL  */
+  YYSYMBOL_DSESSION = 29,                  /* DSESSION  */
+  YYSYMBOL_DCONF = 30,                     /* DCONF  */
+  YYSYMBOL_DMEMB = 31,                     /* DMEMB  */
+  YYSYMBOL_DFLOW_CONTROL = 32,             /* DFLOW_CONTROL  */
+  YYSYMBOL_DSTATUS = 33,                   /* DSTATUS  */
+  YYSYMBOL_DEVENTS = 34,                   /* DEVENTS  */
+  YYSYMBOL_DGROUPS = 35,                   /* DGROUPS  */
+  YYSYMBOL_DMEMORY = 36,                   /* DMEMORY  */
+  YYSYMBOL_DSKIPLIST = 37,                 /* DSKIPLIST  */
+  YYSYMBOL_DACM = 38,                      /* DACM  */
+  YYSYMBOL_DSECURITY = 39,                 /* DSECURITY  */
+  YYSYMBOL_DALL = 40,                      /* DALL  */
+  YYSYMBOL_DNONE = 41,                     /* DNONE  */
+  YYSYMBOL_DEBUGINITIALSEQUENCE = 42,      /* DEBUGINITIALSEQUENCE  */
+  YYSYMBOL_DANGEROUSMONITOR = 43,          /* DANGEROUSMONITOR  */
+  YYSYMBOL_SOCKETPORTREUSE = 44,           /* SOCKETPORTREUSE  */
+  YYSYMBOL_RUNTIMEDIR = 45,                /* RUNTIMEDIR  */
+  YYSYMBOL_SPUSER = 46,                    /* SPUSER  */
+  YYSYMBOL_SPGROUP = 47,                   /* SPGROUP  */
+  YYSYMBOL_ALLOWEDAUTHMETHODS = 48,        /* ALLOWEDAUTHMETHODS  */
+  YYSYMBOL_REQUIREDAUTHMETHODS = 49,       /* REQUIREDAUTHMETHODS  */
+  YYSYMBOL_ACCESSCONTROLPOLICY = 50,       /* ACCESSCONTROLPOLICY  */
+  YYSYMBOL_MAXSESSIONMESSAGES = 51,        /* MAXSESSIONMESSAGES  */
+  YYSYMBOL_WINDOW = 52,                    /* WINDOW  */
+  YYSYMBOL_PERSONALWINDOW = 53,            /* PERSONALWINDOW  */
+  YYSYMBOL_ACCELERATEDRING = 54,           /* ACCELERATEDRING  */
+  YYSYMBOL_ACCELERATEDWINDOW = 55,         /* ACCELERATEDWINDOW  */
+  YYSYMBOL_TOKENTIMEOUT = 56,              /* TOKENTIMEOUT  */
+  YYSYMBOL_HURRYTIMEOUT = 57,              /* HURRYTIMEOUT  */
+  YYSYMBOL_ALIVETIMEOUT = 58,              /* ALIVETIMEOUT  */
+  YYSYMBOL_JOINTIMEOUT = 59,               /* JOINTIMEOUT  */
+  YYSYMBOL_REPTIMEOUT = 60,                /* REPTIMEOUT  */
+  YYSYMBOL_SEGTIMEOUT = 61,                /* SEGTIMEOUT  */
+  YYSYMBOL_GATHERTIMEOUT = 62,             /* GATHERTIMEOUT  */
+  YYSYMBOL_FORMTIMEOUT = 63,               /* FORMTIMEOUT  */
+  YYSYMBOL_LOOKUPTIMEOUT = 64,             /* LOOKUPTIMEOUT  */
+  YYSYMBOL_SP_BOOL = 65,                   /* SP_BOOL  */
+  YYSYMBOL_SP_TRIVAL = 66,                 /* SP_TRIVAL  */
+  YYSYMBOL_LINKPROTOCOL = 67,              /* LINKPROTOCOL  */
+  YYSYMBOL_PHOP = 68,                      /* PHOP  */
+  YYSYMBOL_PTCPHOP = 69,                   /* PTCPHOP  */
+  YYSYMBOL_IMONITOR = 70,                  /* IMONITOR  */
+  YYSYMBOL_ICLIENT = 71,                   /* ICLIENT  */
+  YYSYMBOL_IDAEMON = 72,                   /* IDAEMON  */
+  YYSYMBOL_ROUTEMATRIX = 73,               /* ROUTEMATRIX  */
+  YYSYMBOL_LINKCOST = 74,                  /* LINKCOST  */
+  YYSYMBOL_YYACCEPT = 75,                  /* $accept  */
+  YYSYMBOL_Config = 76,                    /* Config  */
+  YYSYMBOL_ConfigStructs = 77,             /* ConfigStructs  */
+  YYSYMBOL_AlarmBit = 78,                  /* AlarmBit  */
+  YYSYMBOL_AlarmBitComp = 79,              /* AlarmBitComp  */
+  YYSYMBOL_PriorityLevel = 80,             /* PriorityLevel  */
+  YYSYMBOL_ParamStruct = 81,               /* ParamStruct  */
+  YYSYMBOL_SegmentStruct = 82,             /* SegmentStruct  */
+  YYSYMBOL_Segmentparams = 83,             /* Segmentparams  */
+  YYSYMBOL_Segmentparam = 84,              /* Segmentparam  */
+  YYSYMBOL_IfType = 85,                    /* IfType  */
+  YYSYMBOL_IfTypeComp = 86,                /* IfTypeComp  */
+  YYSYMBOL_Interfaceparams = 87,           /* Interfaceparams  */
+  YYSYMBOL_Interfaceparam = 88,            /* Interfaceparam  */
+  YYSYMBOL_RouteStruct = 89,               /* RouteStruct  */
+  YYSYMBOL_Routevectors = 90,              /* Routevectors  */
+  YYSYMBOL_Routevector = 91                /* Routevector  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
 
-/* Copy the second part of user declarations.  */
 
 
-/* Line 216 of yacc.c.  */
-#line 573 "y.tab.c"
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
-#elif (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
 typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef short int yytype_int8;
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_uint8;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
 #else
-typedef short int yytype_int16;
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -607,55 +792,106 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
 #  if ENABLE_NLS
 #   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
-#   define YY_(msgid) dgettext ("bison-runtime", msgid)
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
 #  endif
 # endif
 # ifndef YY_
-#  define YY_(msgid) msgid
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(e) ((void) (e))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(e) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-/* Identity function, used to suppress warnings about constant conditions.  */
-#ifndef lint
-# define YYID(n) (n)
-#else
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static int
-YYID (int i)
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
 #else
-static int
-YYID (i)
-    int i;
+# define YY_INITIAL_VALUE(Value) Value
 #endif
-{
-  return i;
-}
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
 
 /* The parser invokes alloca or malloc; define the necessary symbols.  */
 
@@ -672,11 +908,11 @@ YYID (i)
 #    define alloca _alloca
 #   else
 #    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
 #     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#     ifndef _STDLIB_H
-#      define _STDLIB_H 1
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
 #     endif
 #    endif
 #   endif
@@ -684,8 +920,8 @@ YYID (i)
 # endif
 
 # ifdef YYSTACK_ALLOC
-   /* Pacify GCC's `empty if-body' warning.  */
-#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (YYID (0))
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
     /* The OS might guarantee only one guard page at the bottom of the stack,
        and a page size can be as small as 4096 bytes.  So we cannot safely
@@ -699,111 +935,117 @@ YYID (i)
 #  ifndef YYSTACK_ALLOC_MAXIMUM
 #   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
 #  endif
-#  if (defined __cplusplus && ! defined _STDLIB_H \
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
        && ! ((defined YYMALLOC || defined malloc) \
-	     && (defined YYFREE || defined free)))
+             && (defined YYFREE || defined free)))
 #   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-#   ifndef _STDLIB_H
-#    define _STDLIB_H 1
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
 #   endif
 #  endif
 #  ifndef YYMALLOC
 #   define YYMALLOC malloc
-#   if ! defined malloc && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined malloc && ! defined EXIT_SUCCESS
 void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 #  ifndef YYFREE
 #   define YYFREE free
-#   if ! defined free && ! defined _STDLIB_H && (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
+#   if ! defined free && ! defined EXIT_SUCCESS
 void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-	 || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss;
-  YYSTYPE yyvs;
-  };
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
       + YYSTACK_GAP_MAXIMUM)
 
-/* Copy COUNT objects from FROM to TO.  The source and destination do
-   not overlap.  */
-# ifndef YYCOPY
-#  if defined __GNUC__ && 1 < __GNUC__
-#   define YYCOPY(To, From, Count) \
-      __builtin_memcpy (To, From, (Count) * sizeof (*(From)))
-#  else
-#   define YYCOPY(To, From, Count)		\
-      do					\
-	{					\
-	  YYSIZE_T yyi;				\
-	  for (yyi = 0; yyi < (Count); yyi++)	\
-	    (To)[yyi] = (From)[yyi];		\
-	}					\
-      while (YYID (0))
-#  endif
-# endif
+# define YYCOPY_NEEDED 1
 
 /* Relocate STACK from its old location to the new one.  The
    local variables YYSIZE and YYSTACKSIZE give the old and new number of
    elements in the stack, and YYPTR gives the new location of the
    stack.  Advance YYPTR to a properly aligned location for the next
    stack.  */
-# define YYSTACK_RELOCATE(Stack)					\
-    do									\
-      {									\
-	YYSIZE_T yynewbytes;						\
-	YYCOPY (&yyptr->Stack, Stack, yysize);				\
-	Stack = &yyptr->Stack;						\
-	yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-	yyptr += yynewbytes / sizeof (*yyptr);				\
-      }									\
-    while (YYID (0))
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
 
 #endif
 
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
 /* YYFINAL -- State number of the termination state.  */
-#define YYFINAL  66
+#define YYFINAL  68
 /* YYLAST -- Last index in YYTABLE.  */
-#define YYLAST   162
+#define YYLAST   168
 
 /* YYNTOKENS -- Number of terminals.  */
 #define YYNTOKENS  75
 /* YYNNTS -- Number of nonterminals.  */
 #define YYNNTS  17
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  84
-/* YYNRULES -- Number of states.  */
-#define YYNSTATES  153
+#define YYNRULES  88
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  159
 
-/* YYTRANSLATE(YYLEX) -- Bison symbol number corresponding to YYLEX.  */
-#define YYUNDEFTOK  2
+/* YYMAXUTOK -- Last valid token kind.  */
 #define YYMAXUTOK   329
 
-#define YYTRANSLATE(YYX)						\
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
 
-/* YYTRANSLATE[YYLEX] -- Bison symbol number corresponding to YYLEX.  */
-static const yytype_uint8 yytranslate[] =
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -841,53 +1083,8 @@ static const yytype_uint8 yytranslate[] =
 };
 
 #if YYDEBUG
-/* YYPRHS[YYN] -- Index of the first RHS symbol of rule number YYN in
-   YYRHS.  */
-static const yytype_uint8 yyprhs[] =
-{
-       0,     0,     3,     5,     8,    11,    14,    15,    17,    19,
-      21,    23,    25,    27,    29,    31,    33,    35,    37,    39,
-      41,    43,    45,    47,    49,    51,    53,    56,    60,    61,
-      63,    65,    67,    69,    71,    73,    79,    83,    87,    91,
-      93,    95,    99,   103,   107,   109,   113,   117,   121,   125,
-     129,   133,   137,   141,   145,   149,   153,   157,   161,   165,
-     169,   173,   177,   181,   185,   189,   193,   199,   202,   203,
-     209,   214,   217,   219,   221,   223,   225,   228,   229,   232,
-     233,   236,   241,   244,   245
-};
-
-/* YYRHS -- A `-1'-separated list of the rules' RHS.  */
-static const yytype_int8 yyrhs[] =
-{
-      76,     0,    -1,    77,    -1,    82,    77,    -1,    81,    77,
-      -1,    89,    77,    -1,    -1,    23,    -1,    24,    -1,    25,
-      -1,    26,    -1,    27,    -1,    28,    -1,    29,    -1,    30,
-      -1,    31,    -1,    32,    -1,    33,    -1,    34,    -1,    35,
-      -1,    36,    -1,    37,    -1,    38,    -1,    39,    -1,    40,
-      -1,    41,    -1,    79,    78,    -1,    79,    22,    78,    -1,
-      -1,    11,    -1,    12,    -1,    13,    -1,    14,    -1,    15,
-      -1,    16,    -1,    21,    19,    17,    79,    18,    -1,     7,
-      19,    80,    -1,     4,    19,    20,    -1,     5,    19,    20,
-      -1,     5,    -1,     6,    -1,    43,    19,    65,    -1,    44,
-      19,    66,    -1,    45,    19,    20,    -1,    42,    -1,    46,
-      19,    20,    -1,    47,    19,    20,    -1,    48,    19,    20,
-      -1,    49,    19,    20,    -1,    50,    19,    20,    -1,    51,
-      19,     9,    -1,    67,    19,    68,    -1,    67,    19,    69,
-      -1,    52,    19,     9,    -1,    53,    19,     9,    -1,    54,
-      19,    65,    -1,    55,    19,     9,    -1,    56,    19,     9,
-      -1,    57,    19,     9,    -1,    58,    19,     9,    -1,    59,
-      19,     9,    -1,    60,    19,     9,    -1,    61,    19,     9,
-      -1,    62,    19,     9,    -1,    63,    19,     9,    -1,    64,
-      19,     9,    -1,     3,     8,    17,    83,    18,    -1,    84,
-      83,    -1,    -1,    20,     8,    17,    87,    18,    -1,    20,
-      17,    87,    18,    -1,    20,     8,    -1,    20,    -1,    70,
-      -1,    71,    -1,    72,    -1,    86,    85,    -1,    -1,    88,
-      87,    -1,    -1,    86,     8,    -1,    73,    17,    90,    18,
-      -1,    90,    91,    -1,    -1,    74,    -1
-};
-
-/* YYRLINE[YYN] -- source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
        0,   336,   336,   345,   346,   347,   348,   351,   352,   353,
      354,   355,   356,   357,   358,   359,   360,   361,   362,   363,
@@ -895,26 +1092,33 @@ static const yytype_uint16 yyrline[] =
      383,   384,   385,   386,   387,   390,   398,   405,   413,   425,
      435,   446,   452,   470,   474,   478,   482,   486,   510,   534,
      543,   547,   551,   555,   559,   563,   568,   572,   576,   580,
-     584,   588,   592,   596,   600,   604,   609,   643,   644,   647,
-     667,   688,   709,   733,   734,   735,   738,   742,   745,   746,
-     749,   765,   771,   772,   775
+     584,   588,   592,   596,   600,   604,   608,   613,   618,   623,
+     629,   663,   664,   667,   687,   708,   729,   753,   754,   755,
+     758,   762,   765,   766,   769,   785,   791,   792,   795
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || YYTOKEN_TABLE
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "SEGMENT", "EVENTLOGFILE",
-  "EVENTTIMESTAMP", "EVENTPRECISETIMESTAMP", "EVENTPRIORITY", "IPADDR",
-  "NUMBER", "COLON", "PDEBUG", "PINFO", "PWARNING", "PERROR", "PCRITICAL",
-  "PFATAL", "OPENBRACE", "CLOSEBRACE", "EQUALS", "STRING", "DEBUGFLAGS",
-  "BANG", "DDEBUG", "DEXIT", "DPRINT", "DDATA_LINK", "DNETWORK",
-  "DPROTOCOL", "DSESSION", "DCONF", "DMEMB", "DFLOW_CONTROL", "DSTATUS",
-  "DEVENTS", "DGROUPS", "DMEMORY", "DSKIPLIST", "DACM", "DSECURITY",
-  "DALL", "DNONE", "DEBUGINITIALSEQUENCE", "DANGEROUSMONITOR",
-  "SOCKETPORTREUSE", "RUNTIMEDIR", "SPUSER", "SPGROUP",
+  "\"end of file\"", "error", "\"invalid token\"", "SEGMENT",
+  "EVENTLOGFILE", "EVENTTIMESTAMP", "EVENTPRECISETIMESTAMP",
+  "EVENTPRIORITY", "IPADDR", "NUMBER", "COLON", "PDEBUG", "PINFO",
+  "PWARNING", "PERROR", "PCRITICAL", "PFATAL", "OPENBRACE", "CLOSEBRACE",
+  "EQUALS", "STRING", "DEBUGFLAGS", "BANG", "DDEBUG", "DEXIT", "DPRINT",
+  "DDATA_LINK", "DNETWORK", "DPROTOCOL", "DSESSION", "DCONF", "DMEMB",
+  "DFLOW_CONTROL", "DSTATUS", "DEVENTS", "DGROUPS", "DMEMORY", "DSKIPLIST",
+  "DACM", "DSECURITY", "DALL", "DNONE", "DEBUGINITIALSEQUENCE",
+  "DANGEROUSMONITOR", "SOCKETPORTREUSE", "RUNTIMEDIR", "SPUSER", "SPGROUP",
   "ALLOWEDAUTHMETHODS", "REQUIREDAUTHMETHODS", "ACCESSCONTROLPOLICY",
   "MAXSESSIONMESSAGES", "WINDOW", "PERSONALWINDOW", "ACCELERATEDRING",
   "ACCELERATEDWINDOW", "TOKENTIMEOUT", "HURRYTIMEOUT", "ALIVETIMEOUT",
@@ -925,272 +1129,215 @@ static const char *const yytname[] =
   "AlarmBitComp", "PriorityLevel", "ParamStruct", "SegmentStruct",
   "Segmentparams", "Segmentparam", "IfType", "IfTypeComp",
   "Interfaceparams", "Interfaceparam", "RouteStruct", "Routevectors",
-  "Routevector", 0
+  "Routevector", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[YYLEX-NUM] -- Internal token number corresponding to
-   token YYLEX-NUM.  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292,   293,   294,
-     295,   296,   297,   298,   299,   300,   301,   302,   303,   304,
-     305,   306,   307,   308,   309,   310,   311,   312,   313,   314,
-     315,   316,   317,   318,   319,   320,   321,   322,   323,   324,
-     325,   326,   327,   328,   329
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-/* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
-{
-       0,    75,    76,    77,    77,    77,    77,    78,    78,    78,
-      78,    78,    78,    78,    78,    78,    78,    78,    78,    78,
-      78,    78,    78,    78,    78,    78,    79,    79,    79,    80,
-      80,    80,    80,    80,    80,    81,    81,    81,    81,    81,
-      81,    81,    81,    81,    81,    81,    81,    81,    81,    81,
-      81,    81,    81,    81,    81,    81,    81,    81,    81,    81,
-      81,    81,    81,    81,    81,    81,    82,    83,    83,    84,
-      84,    84,    84,    85,    85,    85,    86,    86,    87,    87,
-      88,    89,    90,    90,    91
-};
+#define YYPACT_NINF (-141)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-/* YYR2[YYN] -- Number of symbols composing right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+#define YYTABLE_NINF (-84)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
 {
-       0,     2,     1,     2,     2,     2,     0,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
-       1,     1,     1,     1,     1,     1,     2,     3,     0,     1,
-       1,     1,     1,     1,     1,     5,     3,     3,     3,     1,
-       1,     3,     3,     3,     1,     3,     3,     3,     3,     3,
-       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
-       3,     3,     3,     3,     3,     3,     5,     2,     0,     5,
-       4,     2,     1,     1,     1,     1,     2,     0,     2,     0,
-       2,     4,     2,     0,     1
+      -3,     7,    -9,    10,  -141,    11,    13,    14,  -141,    15,
+      16,    17,    18,    19,    44,    46,    47,    50,    57,    58,
+      98,    99,   100,   101,   102,   103,   104,   105,   106,   107,
+     108,   109,     4,    31,  -141,    -3,    -3,    -3,   112,    55,
+     110,    12,     2,   114,    67,    68,   113,   115,   116,   117,
+     118,   119,   131,   132,   133,    78,   135,   136,   137,   138,
+     139,   140,   141,   142,   143,   144,   -49,  -141,  -141,  -141,
+    -141,  -141,   134,  -141,  -141,  -141,  -141,  -141,  -141,  -141,
+    -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,
+    -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,
+    -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,
+    -141,   -12,    -1,   145,   134,    56,  -141,  -141,  -141,   147,
+     148,  -141,  -141,  -141,    75,  -141,  -141,  -141,  -141,  -141,
+    -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141,
+    -141,  -141,  -141,  -141,  -141,   148,     1,   149,   148,  -141,
+     150,  -141,  -141,  -141,  -141,  -141,  -141,  -141,  -141
 };
 
-/* YYDEFACT[STATE-NAME] -- Default rule to reduce with in state
-   STATE-NUM when YYTABLE doesn't specify something else to do.  Zero
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
    means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+static const yytype_int8 yydefact[] =
 {
-       6,     0,     0,    39,    40,     0,     0,    44,     0,     0,
+       6,     0,     0,    39,    40,     0,     0,     0,    44,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     2,     6,     6,     6,     0,     0,     0,
+       0,     0,     0,     0,     2,     6,     6,     6,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
        0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,    83,     1,     4,     3,     5,
-      68,    37,    38,    29,    30,    31,    32,    33,    34,    36,
-      28,    41,    42,    43,    45,    46,    47,    48,    49,    50,
-      53,    54,    55,    56,    57,    58,    59,    60,    61,    62,
-      63,    64,    65,    51,    52,     0,    72,     0,    68,     0,
-      81,    84,    82,    71,    77,    66,    67,    35,     0,     7,
-       8,     9,    10,    11,    12,    13,    14,    15,    16,    17,
-      18,    19,    20,    21,    22,    23,    24,    25,    26,    77,
-       0,     0,    77,    27,     0,    80,    73,    74,    75,    76,
-      70,    78,    69
+       0,     0,     0,     0,     0,     0,     0,    87,     1,     4,
+       3,     5,    72,    37,    38,    29,    30,    31,    32,    33,
+      34,    36,    68,    69,    66,    67,    28,    41,    42,    43,
+      45,    46,    47,    48,    49,    50,    53,    54,    55,    56,
+      57,    58,    59,    60,    61,    62,    63,    64,    65,    51,
+      52,     0,    76,     0,    72,     0,    85,    88,    86,    75,
+      81,    70,    71,    35,     0,     7,     8,     9,    10,    11,
+      12,    13,    14,    15,    16,    17,    18,    19,    20,    21,
+      22,    23,    24,    25,    26,    81,     0,     0,    81,    27,
+       0,    84,    77,    78,    79,    80,    74,    82,    73
 };
 
-/* YYDEFGOTO[NTERM-NUM].  */
-static const yytype_int16 yydefgoto[] =
-{
-      -1,    32,    33,   138,   109,    79,    34,    35,   107,   108,
-     149,   140,   141,   142,    36,   105,   112
-};
-
-/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-   STATE-NUM.  */
-#define YYPACT_NINF -135
-static const yytype_int16 yypact[] =
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
 {
-      -3,     7,    -2,    19,  -135,    44,    46,  -135,    47,    48,
-      49,    50,    57,    58,    85,    86,    88,    89,    90,    91,
-      92,    93,    94,    95,    96,    97,    98,    99,   100,   101,
-     102,   105,    75,  -135,    -3,    -3,    -3,   106,   104,   107,
-      87,   108,    41,    60,   109,   110,   111,   112,   113,   114,
-     119,   126,   127,    72,   129,   130,   131,   132,   133,   134,
-     135,   136,   137,   138,   -55,  -135,  -135,  -135,  -135,  -135,
-     128,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,
-    -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,
-    -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,
-    -135,  -135,  -135,  -135,  -135,   -12,    -1,   139,   128,    56,
-    -135,  -135,  -135,   141,   142,  -135,  -135,  -135,    -4,  -135,
-    -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,
-    -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,  -135,   142,
-       1,   143,   142,  -135,   144,  -135,  -135,  -135,  -135,  -135,
-    -135,  -135,  -135
+    -141,  -141,   -23,    32,  -141,  -141,  -141,  -141,    41,  -141,
+    -141,  -141,  -140,  -141,  -141,  -141,  -141
 };
 
-/* YYPGOTO[NTERM-NUM].  */
-static const yytype_int16 yypgoto[] =
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
 {
-    -135,  -135,   -24,    31,  -135,  -135,  -135,  -135,    42,  -135,
-    -135,  -135,  -134,  -135,  -135,  -135,  -135
+       0,    33,    34,   144,   115,    81,    35,    36,   113,   114,
+     155,   146,   147,   148,    37,   111,   118
 };
 
-/* YYTABLE[YYPACT[STATE-NUM]].  What to do in state STATE-NUM.  If
-   positive, shift that token.  If negative, reduce the rule which
-   number is the opposite.  If zero, do what YYDEFACT says.
-   If YYTABLE_NINF, syntax error.  */
-#define YYTABLE_NINF -80
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int16 yytable[] =
 {
-       1,     2,     3,     4,     5,   144,   110,   113,   151,   145,
-      67,    68,    69,   103,   104,    37,   114,    38,     6,   119,
-     120,   121,   122,   123,   124,   125,   126,   127,   128,   129,
-     130,   131,   132,   133,   134,   135,   136,   137,    39,     7,
-       8,     9,    10,    11,    12,    13,    14,    15,    16,    17,
-      18,    19,    20,    21,    22,    23,    24,    25,    26,    27,
-      28,    29,   111,    40,    30,    41,    42,    43,    44,    45,
-      31,   146,   147,   148,   117,    66,    46,    47,   118,   119,
-     120,   121,   122,   123,   124,   125,   126,   127,   128,   129,
-     130,   131,   132,   133,   134,   135,   136,   137,    73,    74,
-      75,    76,    77,    78,    48,    49,    81,    50,    51,    52,
-      53,    54,    55,    56,    57,    58,    59,    60,    61,    62,
-      63,    64,    65,    70,    71,    80,    82,    72,    89,    83,
-      84,    85,    86,    87,    88,    90,    91,    92,    93,    94,
-      95,    96,    97,    98,    99,   100,   101,   102,   106,   143,
-     116,     0,     0,     0,     0,     0,     0,   115,   139,     0,
-     -79,   150,   152
+       1,     2,     3,     4,     5,   150,   116,   119,   157,   151,
+      39,    82,    69,    70,    71,    38,   120,     6,     7,   109,
+     110,    67,    83,    75,    76,    77,    78,    79,    80,    40,
+      41,    68,    42,    43,    44,    45,    46,    47,    48,     8,
+       9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
+      19,    20,    21,    22,    23,    24,    25,    26,    27,    28,
+      29,    30,   117,    49,    31,    50,    51,    84,    85,    52,
+      32,   152,   153,   154,   123,    73,    53,    54,   124,   125,
+     126,   127,   128,   129,   130,   131,   132,   133,   134,   135,
+     136,   137,   138,   139,   140,   141,   142,   143,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,   134,   135,   136,
+     137,   138,   139,   140,   141,   142,   143,    55,    56,    57,
+      58,    59,    60,    61,    62,    63,    64,    65,    66,    72,
+      74,    86,    87,    89,    88,    90,    91,    92,    93,    94,
+      95,    96,    97,    98,    99,   100,   101,   102,   103,   104,
+     105,   106,   107,   108,   112,   122,   149,     0,     0,     0,
+       0,     0,     0,   121,   145,     0,   -83,   156,   158
 };
 
 static const yytype_int16 yycheck[] =
 {
-       3,     4,     5,     6,     7,   139,    18,     8,   142,     8,
-      34,    35,    36,    68,    69,     8,    17,    19,    21,    23,
-      24,    25,    26,    27,    28,    29,    30,    31,    32,    33,
-      34,    35,    36,    37,    38,    39,    40,    41,    19,    42,
+       3,     4,     5,     6,     7,   145,    18,     8,   148,     8,
+      19,     9,    35,    36,    37,     8,    17,    20,    21,    68,
+      69,    17,    20,    11,    12,    13,    14,    15,    16,    19,
+      19,     0,    19,    19,    19,    19,    19,    19,    19,    42,
       43,    44,    45,    46,    47,    48,    49,    50,    51,    52,
       53,    54,    55,    56,    57,    58,    59,    60,    61,    62,
-      63,    64,    74,    19,    67,    19,    19,    19,    19,    19,
-      73,    70,    71,    72,    18,     0,    19,    19,    22,    23,
+      63,    64,    74,    19,    67,    19,    19,    65,    66,    19,
+      73,    70,    71,    72,    18,    20,    19,    19,    22,    23,
       24,    25,    26,    27,    28,    29,    30,    31,    32,    33,
-      34,    35,    36,    37,    38,    39,    40,    41,    11,    12,
-      13,    14,    15,    16,    19,    19,    65,    19,    19,    19,
-      19,    19,    19,    19,    19,    19,    19,    19,    19,    19,
-      19,    19,    17,    17,    20,    17,    66,    20,     9,    20,
-      20,    20,    20,    20,    20,     9,     9,    65,     9,     9,
-       9,     9,     9,     9,     9,     9,     9,     9,    20,   118,
-     108,    -1,    -1,    -1,    -1,    -1,    -1,    18,    17,    -1,
-      18,    18,    18
+      34,    35,    36,    37,    38,    39,    40,    41,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    19,    19,    19,
+      19,    19,    19,    19,    19,    19,    19,    19,    19,    17,
+      20,    17,    65,    20,    66,    20,    20,    20,    20,    20,
+       9,     9,     9,    65,     9,     9,     9,     9,     9,     9,
+       9,     9,     9,     9,    20,   114,   124,    -1,    -1,    -1,
+      -1,    -1,    -1,    18,    17,    -1,    18,    18,    18
 };
 
-/* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-   symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-       0,     3,     4,     5,     6,     7,    21,    42,    43,    44,
-      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
-      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
-      67,    73,    76,    77,    81,    82,    89,     8,    19,    19,
+       0,     3,     4,     5,     6,     7,    20,    21,    42,    43,
+      44,    45,    46,    47,    48,    49,    50,    51,    52,    53,
+      54,    55,    56,    57,    58,    59,    60,    61,    62,    63,
+      64,    67,    73,    76,    77,    81,    82,    89,     8,    19,
       19,    19,    19,    19,    19,    19,    19,    19,    19,    19,
       19,    19,    19,    19,    19,    19,    19,    19,    19,    19,
-      19,    19,    19,    19,    19,    17,     0,    77,    77,    77,
-      17,    20,    20,    11,    12,    13,    14,    15,    16,    80,
-      17,    65,    66,    20,    20,    20,    20,    20,    20,     9,
-       9,     9,    65,     9,     9,     9,     9,     9,     9,     9,
-       9,     9,     9,    68,    69,    90,    20,    83,    84,    79,
-      18,    74,    91,     8,    17,    18,    83,    18,    22,    23,
-      24,    25,    26,    27,    28,    29,    30,    31,    32,    33,
-      34,    35,    36,    37,    38,    39,    40,    41,    78,    17,
-      86,    87,    88,    78,    87,     8,    70,    71,    72,    85,
-      18,    87,    18
+      19,    19,    19,    19,    19,    19,    19,    17,     0,    77,
+      77,    77,    17,    20,    20,    11,    12,    13,    14,    15,
+      16,    80,     9,    20,    65,    66,    17,    65,    66,    20,
+      20,    20,    20,    20,    20,     9,     9,     9,    65,     9,
+       9,     9,     9,     9,     9,     9,     9,     9,     9,    68,
+      69,    90,    20,    83,    84,    79,    18,    74,    91,     8,
+      17,    18,    83,    18,    22,    23,    24,    25,    26,    27,
+      28,    29,    30,    31,    32,    33,    34,    35,    36,    37,
+      38,    39,    40,    41,    78,    17,    86,    87,    88,    78,
+      87,     8,    70,    71,    72,    85,    18,    87,    18
 };
 
-#define yyerrok		(yyerrstatus = 0)
-#define yyclearin	(yychar = YYEMPTY)
-#define YYEMPTY		(-2)
-#define YYEOF		0
-
-#define YYACCEPT	goto yyacceptlab
-#define YYABORT		goto yyabortlab
-#define YYERROR		goto yyerrorlab
-
-
-/* Like YYERROR except do call yyerror.  This remains here temporarily
-   to ease the transition to the new meaning of YYERROR, for GCC.
-   Once GCC version 2 has supplanted version 1, this can go.  */
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    75,    76,    77,    77,    77,    77,    78,    78,    78,
+      78,    78,    78,    78,    78,    78,    78,    78,    78,    78,
+      78,    78,    78,    78,    78,    78,    79,    79,    79,    80,
+      80,    80,    80,    80,    80,    81,    81,    81,    81,    81,
+      81,    81,    81,    81,    81,    81,    81,    81,    81,    81,
+      81,    81,    81,    81,    81,    81,    81,    81,    81,    81,
+      81,    81,    81,    81,    81,    81,    81,    81,    81,    81,
+      82,    83,    83,    84,    84,    84,    84,    85,    85,    85,
+      86,    86,    87,    87,    88,    89,    90,    90,    91
+};
 
-#define YYFAIL		goto yyerrlab
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     2,     2,     2,     0,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     1,     2,     3,     0,     1,
+       1,     1,     1,     1,     1,     5,     3,     3,     3,     1,
+       1,     3,     3,     3,     1,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     3,
+       5,     2,     0,     5,     4,     2,     1,     1,     1,     1,
+       2,     0,     2,     0,     2,     4,     2,     0,     1
+};
 
-#define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)					\
-do								\
-  if (yychar == YYEMPTY && yylen == 1)				\
-    {								\
-      yychar = (Token);						\
-      yylval = (Value);						\
-      yytoken = YYTRANSLATE (yychar);				\
-      YYPOPSTACK (1);						\
-      goto yybackup;						\
-    }								\
-  else								\
-    {								\
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;							\
-    }								\
-while (YYID (0))
-
-
-#define YYTERROR	1
-#define YYERRCODE	256
-
-
-/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
-   If N is 0, then set CURRENT to the empty location which ends
-   the previous symbol: RHS[0] (always defined).  */
-
-#define YYRHSLOC(Rhs, K) ((Rhs)[K])
-#ifndef YYLLOC_DEFAULT
-# define YYLLOC_DEFAULT(Current, Rhs, N)				\
-    do									\
-      if (YYID (N))                                                    \
-	{								\
-	  (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;	\
-	  (Current).first_column = YYRHSLOC (Rhs, 1).first_column;	\
-	  (Current).last_line    = YYRHSLOC (Rhs, N).last_line;		\
-	  (Current).last_column  = YYRHSLOC (Rhs, N).last_column;	\
-	}								\
-      else								\
-	{								\
-	  (Current).first_line   = (Current).last_line   =		\
-	    YYRHSLOC (Rhs, 0).last_line;				\
-	  (Current).first_column = (Current).last_column =		\
-	    YYRHSLOC (Rhs, 0).last_column;				\
-	}								\
-    while (YYID (0))
-#endif
+enum { YYENOMEM = -2 };
 
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
 
-/* YY_LOCATION_PRINT -- Print the location on the stream.
-   This macro was not mandated originally: define only if we know
-   we won't break user code: when these are the locations we know.  */
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
-#ifndef YY_LOCATION_PRINT
-# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
-#  define YY_LOCATION_PRINT(File, Loc)			\
-     fprintf (File, "%d.%d-%d.%d",			\
-	      (Loc).first_line, (Loc).first_column,	\
-	      (Loc).last_line,  (Loc).last_column)
-# else
-#  define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-# endif
-#endif
 
+#define YYRECOVERING()  (!!yyerrstatus)
 
-/* YYLEX -- calling `yylex' with the right arguments.  */
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
 
-#ifdef YYLEX_PARAM
-# define YYLEX yylex (YYLEX_PARAM)
-#else
-# define YYLEX yylex ()
-#endif
 
 /* Enable debugging if requested.  */
 #if YYDEBUG
@@ -1200,80 +1347,58 @@ while (YYID (0))
 #  define YYFPRINTF fprintf
 # endif
 
-# define YYDPRINTF(Args)			\
-do {						\
-  if (yydebug)					\
-    YYFPRINTF Args;				\
-} while (YYID (0))
-
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)			  \
-do {									  \
-  if (yydebug)								  \
-    {									  \
-      YYFPRINTF (stderr, "%s ", Title);					  \
-      yy_symbol_print (stderr,						  \
-		  Type, Value); \
-      YYFPRINTF (stderr, "\n");						  \
-    }									  \
-} while (YYID (0))
-
-
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
-
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
 static void
-yy_symbol_value_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# else
-  YYUSE (yyoutput);
-# endif
-  switch (yytype)
-    {
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
-#else
 static void
-yy_symbol_print (yyoutput, yytype, yyvaluep)
-    FILE *yyoutput;
-    int yytype;
-    YYSTYPE const * const yyvaluep;
-#endif
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep)
 {
-  if (yytype < YYNTOKENS)
-    YYFPRINTF (yyoutput, "token %s (", yytname[yytype]);
-  else
-    YYFPRINTF (yyoutput, "nterm %s (", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  yy_symbol_value_print (yyo, yykind, yyvaluep);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -1281,80 +1406,68 @@ yy_symbol_print (yyoutput, yytype, yyvaluep)
 | TOP (included).                                                   |
 `------------------------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static void
-yy_stack_print (yytype_int16 *bottom, yytype_int16 *top)
-#else
 static void
-yy_stack_print (bottom, top)
-    yytype_int16 *bottom;
-    yytype_int16 *top;
-#endif
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
-  for (; bottom <= top; ++bottom)
-    YYFPRINTF (stderr, " %d", *bottom);
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
   YYFPRINTF (stderr, "\n");
 }
 
-# define YY_STACK_PRINT(Bottom, Top)				\
-do {								\
-  if (yydebug)							\
-    yy_stack_print ((Bottom), (Top));				\
-} while (YYID (0))
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
 
 
 /*------------------------------------------------.
 | Report that the YYRULE is going to be reduced.  |
 `------------------------------------------------*/
 
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yy_reduce_print (YYSTYPE *yyvsp, int yyrule)
-#else
-static void
-yy_reduce_print (yyvsp, yyrule)
-    YYSTYPE *yyvsp;
-    int yyrule;
-#endif
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule)
 {
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  unsigned long int yylno = yyrline[yyrule];
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
-	     yyrule - 1, yylno);
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
-      fprintf (stderr, "   $%d = ", yyi + 1);
-      yy_symbol_print (stderr, yyrhs[yyprhs[yyrule] + yyi],
-		       &(yyvsp[(yyi + 1) - (yynrhs)])
-		       		       );
-      fprintf (stderr, "\n");
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)]);
+      YYFPRINTF (stderr, "\n");
     }
 }
 
-# define YY_REDUCE_PRINT(Rule)		\
-do {					\
-  if (yydebug)				\
-    yy_reduce_print (yyvsp, Rule); \
-} while (YYID (0))
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule); \
+} while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
 
 
 /* YYINITDEPTH -- initial size of the parser's stacks.  */
-#ifndef	YYINITDEPTH
+#ifndef YYINITDEPTH
 # define YYINITDEPTH 200
 #endif
 
@@ -1369,478 +1482,219 @@ int yydebug;
 # define YYMAXDEPTH 10000
 #endif
 
-
-
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static YYSIZE_T
-yystrlen (const char *yystr)
-#else
-static YYSIZE_T
-yystrlen (yystr)
-    const char *yystr;
-#endif
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-#else
-static char *
-yystpcpy (yydest, yysrc)
-    char *yydest;
-    const char *yysrc;
-#endif
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
-
-  return yyd - 1;
-}
-#  endif
-# endif
-
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-	switch (*++yyp)
-	  {
-	  case '\'':
-	  case ',':
-	    goto do_not_strip_quotes;
-
-	  case '\\':
-	    if (*++yyp != '\\')
-	      goto do_not_strip_quotes;
-	    /* Fall through.  */
-	  default:
-	    if (yyres)
-	      yyres[yyn] = *yyp;
-	    yyn++;
-	    break;
-
-	  case '"':
-	    if (yyres)
-	      yyres[yyn] = '\0';
-	    return yyn;
-	  }
-    do_not_strip_quotes: ;
-    }
 
-  if (! yyres)
-    return yystrlen (yystr);
 
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
 
-/* Copy into YYRESULT an error message about the unexpected token
-   YYCHAR while in state YYSTATE.  Return the number of bytes copied,
-   including the terminating null byte.  If YYRESULT is null, do not
-   copy anything; just return the number of bytes that would be
-   copied.  As a special case, return 0 if an ordinary "syntax error"
-   message will do.  Return YYSIZE_MAXIMUM if overflow occurs during
-   size calculation.  */
-static YYSIZE_T
-yysyntax_error (char *yyresult, int yystate, int yychar)
-{
-  int yyn = yypact[yystate];
 
-  if (! (YYPACT_NINF < yyn && yyn <= YYLAST))
-    return 0;
-  else
-    {
-      int yytype = YYTRANSLATE (yychar);
-      YYSIZE_T yysize0 = yytnamerr (0, yytname[yytype]);
-      YYSIZE_T yysize = yysize0;
-      YYSIZE_T yysize1;
-      int yysize_overflow = 0;
-      enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-      char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-      int yyx;
-
-# if 0
-      /* This is so xgettext sees the translatable formats that are
-	 constructed on the fly.  */
-      YY_("syntax error, unexpected %s");
-      YY_("syntax error, unexpected %s, expecting %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s");
-      YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s");
-# endif
-      char *yyfmt;
-      char const *yyf;
-      static char const yyunexpected[] = "syntax error, unexpected %s";
-      static char const yyexpecting[] = ", expecting %s";
-      static char const yyor[] = " or %s";
-      char yyformat[sizeof yyunexpected
-		    + sizeof yyexpecting - 1
-		    + ((YYERROR_VERBOSE_ARGS_MAXIMUM - 2)
-		       * (sizeof yyor - 1))];
-      char const *yyprefix = yyexpecting;
-
-      /* Start YYX at -YYN if negative to avoid negative indexes in
-	 YYCHECK.  */
-      int yyxbegin = yyn < 0 ? -yyn : 0;
-
-      /* Stay within bounds of both yycheck and yytname.  */
-      int yychecklim = YYLAST - yyn + 1;
-      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-      int yycount = 1;
-
-      yyarg[0] = yytname[yytype];
-      yyfmt = yystpcpy (yyformat, yyunexpected);
-
-      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-	if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR)
-	  {
-	    if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-	      {
-		yycount = 1;
-		yysize = yysize0;
-		yyformat[sizeof yyunexpected - 1] = '\0';
-		break;
-	      }
-	    yyarg[yycount++] = yytname[yyx];
-	    yysize1 = yysize + yytnamerr (0, yytname[yyx]);
-	    yysize_overflow |= (yysize1 < yysize);
-	    yysize = yysize1;
-	    yyfmt = yystpcpy (yyfmt, yyprefix);
-	    yyprefix = yyor;
-	  }
-
-      yyf = YY_(yyformat);
-      yysize1 = yysize + yystrlen (yyf);
-      yysize_overflow |= (yysize1 < yysize);
-      yysize = yysize1;
-
-      if (yysize_overflow)
-	return YYSIZE_MAXIMUM;
-
-      if (yyresult)
-	{
-	  /* Avoid sprintf, as that infringes on the user's name space.
-	     Don't have undefined behavior even if the translation
-	     produced a string with the wrong number of "%s"s.  */
-	  char *yyp = yyresult;
-	  int yyi = 0;
-	  while ((*yyp = *yyf) != '\0')
-	    {
-	      if (*yyp == '%' && yyf[1] == 's' && yyi < yycount)
-		{
-		  yyp += yytnamerr (yyp, yyarg[yyi++]);
-		  yyf += 2;
-		}
-	      else
-		{
-		  yyp++;
-		  yyf++;
-		}
-	    }
-	}
-      return yysize;
-    }
-}
-#endif /* YYERROR_VERBOSE */
-
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
-/*ARGSUSED*/
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
-#else
-static void
-yydestruct (yymsg, yytype, yyvaluep)
-    const char *yymsg;
-    int yytype;
-    YYSTYPE *yyvaluep;
-#endif
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep)
 {
-  YYUSE (yyvaluep);
-
+  YY_USE (yyvaluep);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
-  switch (yytype)
-    {
-
-      default:
-	break;
-    }
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
-
-
-/* Prevent warnings from -Wmissing-prototypes.  */
-
-#ifdef YYPARSE_PARAM
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void *YYPARSE_PARAM);
-#else
-int yyparse ();
-#endif
-#else /* ! YYPARSE_PARAM */
-#if defined __STDC__ || defined __cplusplus
-int yyparse (void);
-#else
-int yyparse ();
-#endif
-#endif /* ! YYPARSE_PARAM */
 
 
-
-/* The look-ahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
-/* The semantic value of the look-ahead symbol.  */
+/* The semantic value of the lookahead symbol.  */
 YYSTYPE yylval;
-
 /* Number of syntax errors so far.  */
 int yynerrs;
 
 
 
+
 /*----------.
 | yyparse.  |
 `----------*/
 
-#ifdef YYPARSE_PARAM
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
-int
-yyparse (void *YYPARSE_PARAM)
-#else
-int
-yyparse (YYPARSE_PARAM)
-    void *YYPARSE_PARAM;
-#endif
-#else /* ! YYPARSE_PARAM */
-#if (defined __STDC__ || defined __C99__FUNC__ \
-     || defined __cplusplus || defined _MSC_VER)
 int
 yyparse (void)
-#else
-int
-yyparse ()
-
-#endif
-#endif
 {
-  
-  int yystate;
-  int yyn;
-  int yyresult;
-  /* Number of tokens to shift before error messages enabled.  */
-  int yyerrstatus;
-  /* Look-ahead token as an internal (translated) token number.  */
-  int yytoken = 0;
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
-
-  /* Three stacks and their tools:
-     `yyss': related to states,
-     `yyvs': related to semantic values,
-     `yyls': related to locations.
-
-     Refer to the stacks thru separate pointers, to allow yyoverflow
-     to reallocate them elsewhere.  */
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
 
-  /* The state stack.  */
-  yytype_int16 yyssa[YYINITDEPTH];
-  yytype_int16 *yyss = yyssa;
-  yytype_int16 *yyssp;
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
-  /* The semantic value stack.  */
-  YYSTYPE yyvsa[YYINITDEPTH];
-  YYSTYPE *yyvs = yyvsa;
-  YYSTYPE *yyvsp;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
 
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
 
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
-
-  YYSIZE_T yystacksize = YYINITDEPTH;
-
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
 
 
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
-  yychar = YYEMPTY;		/* Cause a token to be read.  */
-
-  /* Initialize stack pointers.
-     Waste one element of value and location stack
-     so that they stay on the same level as the state stack.
-     The wasted elements are never initialized.  */
-
-  yyssp = yyss;
-  yyvsp = yyvs;
+  yychar = YYEMPTY; /* Cause a token to be read.  */
 
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
-	/* Give user a chance to reallocate the stack.  Use copies of
-	   these so that the &'s don't force the real ones into
-	   memory.  */
-	YYSTYPE *yyvs1 = yyvs;
-	yytype_int16 *yyss1 = yyss;
-
-
-	/* Each stack pointer address is followed by the size of the
-	   data in use in that stack, in bytes.  This used to be a
-	   conditional around just the two extra args, but that might
-	   be undefined if yyoverflow is a macro.  */
-	yyoverflow (YY_("memory exhausted"),
-		    &yyss1, yysize * sizeof (*yyssp),
-		    &yyvs1, yysize * sizeof (*yyvsp),
-
-		    &yystacksize);
-
-	yyss = yyss1;
-	yyvs = yyvs1;
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-	goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
-	yystacksize = YYMAXDEPTH;
+        yystacksize = YYMAXDEPTH;
 
       {
-	yytype_int16 *yyss1 = yyss;
-	union yyalloc *yyptr =
-	  (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
-	if (! yyptr)
-	  goto yyexhaustedlab;
-	YYSTACK_RELOCATE (yyss);
-	YYSTACK_RELOCATE (yyvs);
-
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
 #  undef YYSTACK_RELOCATE
-	if (yyss1 != yyssa)
-	  YYSTACK_FREE (yyss1);
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
 
-
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-		  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
-	YYABORT;
+        YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
-     look-ahead token if we need one and don't already have one.  */
+     lookahead token if we need one and don't already have one.  */
 
-  /* First try to decide what to do without reference to look-ahead token.  */
+  /* First try to decide what to do without reference to lookahead token.  */
   yyn = yypact[yystate];
-  if (yyn == YYPACT_NINF)
+  if (yypact_value_is_default (yyn))
     goto yydefault;
 
-  /* Not known => get a look-ahead token if don't already have one.  */
+  /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid look-ahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = YYLEX;
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex ();
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1855,30 +1709,26 @@ yybackup:
   yyn = yytable[yyn];
   if (yyn <= 0)
     {
-      if (yyn == 0 || yyn == YYTABLE_NINF)
-	goto yyerrlab;
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
       yyn = -yyn;
       goto yyreduce;
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
   /* Count tokens shifted since error; after three, turn off error
      status.  */
   if (yyerrstatus)
     yyerrstatus--;
 
-  /* Shift the look-ahead token.  */
+  /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token unless it is eof.  */
-  if (yychar != YYEOF)
-    yychar = YYEMPTY;
-
   yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1893,14 +1743,14 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
   yylen = yyr2[yyn];
 
   /* If YYLEN is nonzero, implement the default value of the action:
-     `$$ = $1'.
+     '$$ = $1'.
 
      Otherwise, the following line sets YYVAL to garbage.
      This behavior is undocumented and Bison
@@ -1913,196 +1763,228 @@ yyreduce:
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 337 "./config_parse.y"
-    {
+  case 2: /* Config: ConfigStructs  */
+#line 337 "config_parse.y"
+                        {
 			  Config->num_segments = segments;
 			  Config->num_total_procs = num_procs;
 			  Alarm(CONF_SYS, "Finished configuration file.\n");
                           Alarmp( SPLOG_DEBUG, CONF_SYS, "config_parse.y:The full segment string is %d characters long:\n%s", strlen(ConfStringRep), ConfStringRep);
 			}
+#line 1775 "y.tab.c"
     break;
 
-  case 7:
-#line 351 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 7: /* AlarmBit: DDEBUG  */
+#line 351 "config_parse.y"
+                               { yyval = yyvsp[0]; }
+#line 1781 "y.tab.c"
     break;
 
-  case 8:
-#line 352 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 8: /* AlarmBit: DEXIT  */
+#line 352 "config_parse.y"
+                              { yyval = yyvsp[0]; }
+#line 1787 "y.tab.c"
     break;
 
-  case 9:
-#line 353 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 9: /* AlarmBit: DPRINT  */
+#line 353 "config_parse.y"
+                               { yyval = yyvsp[0]; }
+#line 1793 "y.tab.c"
     break;
 
-  case 10:
-#line 354 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 10: /* AlarmBit: DDATA_LINK  */
+#line 354 "config_parse.y"
+                                   { yyval = yyvsp[0]; }
+#line 1799 "y.tab.c"
     break;
 
-  case 11:
-#line 355 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 11: /* AlarmBit: DNETWORK  */
+#line 355 "config_parse.y"
+                                 { yyval = yyvsp[0]; }
+#line 1805 "y.tab.c"
     break;
 
-  case 12:
-#line 356 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 12: /* AlarmBit: DPROTOCOL  */
+#line 356 "config_parse.y"
+                                  { yyval = yyvsp[0]; }
+#line 1811 "y.tab.c"
     break;
 
-  case 13:
-#line 357 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 13: /* AlarmBit: DSESSION  */
+#line 357 "config_parse.y"
+                                 { yyval = yyvsp[0]; }
+#line 1817 "y.tab.c"
     break;
 
-  case 14:
-#line 358 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 14: /* AlarmBit: DCONF  */
+#line 358 "config_parse.y"
+                              { yyval = yyvsp[0]; }
+#line 1823 "y.tab.c"
     break;
 
-  case 15:
-#line 359 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 15: /* AlarmBit: DMEMB  */
+#line 359 "config_parse.y"
+                              { yyval = yyvsp[0]; }
+#line 1829 "y.tab.c"
     break;
 
-  case 16:
-#line 360 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 16: /* AlarmBit: DFLOW_CONTROL  */
+#line 360 "config_parse.y"
+                                      { yyval = yyvsp[0]; }
+#line 1835 "y.tab.c"
     break;
 
-  case 17:
-#line 361 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 17: /* AlarmBit: DSTATUS  */
+#line 361 "config_parse.y"
+                                { yyval = yyvsp[0]; }
+#line 1841 "y.tab.c"
     break;
 
-  case 18:
-#line 362 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 18: /* AlarmBit: DEVENTS  */
+#line 362 "config_parse.y"
+                                { yyval = yyvsp[0]; }
+#line 1847 "y.tab.c"
     break;
 
-  case 19:
-#line 363 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 19: /* AlarmBit: DGROUPS  */
+#line 363 "config_parse.y"
+                                { yyval = yyvsp[0]; }
+#line 1853 "y.tab.c"
     break;
 
-  case 20:
-#line 364 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 20: /* AlarmBit: DMEMORY  */
+#line 364 "config_parse.y"
+                                { yyval = yyvsp[0]; }
+#line 1859 "y.tab.c"
     break;
 
-  case 21:
-#line 365 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 21: /* AlarmBit: DSKIPLIST  */
+#line 365 "config_parse.y"
+                                  { yyval = yyvsp[0]; }
+#line 1865 "y.tab.c"
     break;
 
-  case 22:
-#line 366 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 22: /* AlarmBit: DACM  */
+#line 366 "config_parse.y"
+                             { yyval = yyvsp[0]; }
+#line 1871 "y.tab.c"
     break;
 
-  case 23:
-#line 367 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 23: /* AlarmBit: DSECURITY  */
+#line 367 "config_parse.y"
+                                  { yyval = yyvsp[0]; }
+#line 1877 "y.tab.c"
     break;
 
-  case 24:
-#line 368 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 24: /* AlarmBit: DALL  */
+#line 368 "config_parse.y"
+                             { yyval = yyvsp[0]; }
+#line 1883 "y.tab.c"
     break;
 
-  case 25:
-#line 369 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 25: /* AlarmBit: DNONE  */
+#line 369 "config_parse.y"
+                              { yyval = yyvsp[0]; }
+#line 1889 "y.tab.c"
     break;
 
-  case 26:
-#line 373 "./config_parse.y"
-    {
-			  (yyval).mask = ((yyvsp[(1) - (2)]).mask | (yyvsp[(2) - (2)]).mask);
+  case 26: /* AlarmBitComp: AlarmBitComp AlarmBit  */
+#line 373 "config_parse.y"
+                        {
+			  yyval.mask = (yyvsp[-1].mask | yyvsp[0].mask);
 			}
+#line 1897 "y.tab.c"
     break;
 
-  case 27:
-#line 377 "./config_parse.y"
-    {
-			  (yyval).mask = ((yyvsp[(1) - (3)]).mask & ~((yyvsp[(3) - (3)]).mask));
+  case 27: /* AlarmBitComp: AlarmBitComp BANG AlarmBit  */
+#line 377 "config_parse.y"
+                        {
+			  yyval.mask = (yyvsp[-2].mask & ~(yyvsp[0].mask));
 			}
+#line 1905 "y.tab.c"
     break;
 
-  case 28:
-#line 380 "./config_parse.y"
-    { (yyval).mask = NONE; }
+  case 28: /* AlarmBitComp: %empty  */
+#line 380 "config_parse.y"
+                        { yyval.mask = NONE; }
+#line 1911 "y.tab.c"
     break;
 
-  case 29:
-#line 382 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 29: /* PriorityLevel: PDEBUG  */
+#line 382 "config_parse.y"
+                               { yyval = yyvsp[0]; }
+#line 1917 "y.tab.c"
     break;
 
-  case 30:
-#line 383 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 30: /* PriorityLevel: PINFO  */
+#line 383 "config_parse.y"
+                              { yyval = yyvsp[0]; }
+#line 1923 "y.tab.c"
     break;
 
-  case 31:
-#line 384 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 31: /* PriorityLevel: PWARNING  */
+#line 384 "config_parse.y"
+                                 { yyval = yyvsp[0]; }
+#line 1929 "y.tab.c"
     break;
 
-  case 32:
-#line 385 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 32: /* PriorityLevel: PERROR  */
+#line 385 "config_parse.y"
+                               { yyval = yyvsp[0]; }
+#line 1935 "y.tab.c"
     break;
 
-  case 33:
-#line 386 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 33: /* PriorityLevel: PCRITICAL  */
+#line 386 "config_parse.y"
+                                  { yyval = yyvsp[0]; }
+#line 1941 "y.tab.c"
     break;
 
-  case 34:
-#line 387 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 34: /* PriorityLevel: PFATAL  */
+#line 387 "config_parse.y"
+                               { yyval = yyvsp[0]; }
+#line 1947 "y.tab.c"
     break;
 
-  case 35:
-#line 391 "./config_parse.y"
-    {
+  case 35: /* ParamStruct: DEBUGFLAGS EQUALS OPENBRACE AlarmBitComp CLOSEBRACE  */
+#line 391 "config_parse.y"
+                        {
 			  if (! Alarm_get_interactive() ) {
                             Alarm_clear_types(ALL);
-			    Alarm_set_types((yyvsp[(4) - (5)]).mask);
+			    Alarm_set_types(yyvsp[-1].mask);
 			    Alarm(CONF_SYS, "Set Alarm mask to: %x\n", Alarm_get_types());
                           }
 			}
+#line 1959 "y.tab.c"
     break;
 
-  case 36:
-#line 399 "./config_parse.y"
-    {
+  case 36: /* ParamStruct: EVENTPRIORITY EQUALS PriorityLevel  */
+#line 399 "config_parse.y"
+                        {
                             if (! Alarm_get_interactive() ) {
-                                Alarm_set_priority((yyvsp[(3) - (3)]).number);
+                                Alarm_set_priority(yyvsp[0].number);
                             }
                         }
+#line 1969 "y.tab.c"
     break;
 
-  case 37:
-#line 406 "./config_parse.y"
-    {
+  case 37: /* ParamStruct: EVENTLOGFILE EQUALS STRING  */
+#line 406 "config_parse.y"
+                        {
 			  if (! Alarm_get_interactive() ) {
                             char file_buf[MAXPATHLEN];
-                            expand_filename(file_buf, MAXPATHLEN, (yyvsp[(3) - (3)]).string);
+                            expand_filename(file_buf, MAXPATHLEN, yyvsp[0].string);
                             Alarm_set_output(file_buf);
                           }
 			}
+#line 1981 "y.tab.c"
     break;
 
-  case 38:
-#line 414 "./config_parse.y"
-    {
+  case 38: /* ParamStruct: EVENTTIMESTAMP EQUALS STRING  */
+#line 414 "config_parse.y"
+                        {
 			  if (! Alarm_get_interactive() ) {
-                              strncpy(alarm_format, (yyvsp[(3) - (3)]).string, MAX_ALARM_FORMAT);
+                              strncpy(alarm_format, yyvsp[0].string, MAX_ALARM_FORMAT);
                               alarm_custom_format = 1;
                               if (alarm_precise) {
                                   Alarm_enable_timestamp_high_res(alarm_format);
@@ -2111,11 +1993,12 @@ yyreduce:
                               }
                           }
 			}
+#line 1997 "y.tab.c"
     break;
 
-  case 39:
-#line 426 "./config_parse.y"
-    {
+  case 39: /* ParamStruct: EVENTTIMESTAMP  */
+#line 426 "config_parse.y"
+                        {
 			  if (! Alarm_get_interactive() ) {
                               if (alarm_precise) {
                                   Alarm_enable_timestamp_high_res(NULL);
@@ -2124,11 +2007,12 @@ yyreduce:
                               }
                           }
 			}
+#line 2011 "y.tab.c"
     break;
 
-  case 40:
-#line 436 "./config_parse.y"
-    {
+  case 40: /* ParamStruct: EVENTPRECISETIMESTAMP  */
+#line 436 "config_parse.y"
+                        {
 			  if (! Alarm_get_interactive() ) {
                               alarm_precise = 1;
                               if (alarm_custom_format) {
@@ -2138,26 +2022,28 @@ yyreduce:
                               }
                           }
 			}
+#line 2026 "y.tab.c"
     break;
 
-  case 41:
-#line 447 "./config_parse.y"
-    {
+  case 41: /* ParamStruct: DANGEROUSMONITOR EQUALS SP_BOOL  */
+#line 447 "config_parse.y"
+                        {
 			  if (! Alarm_get_interactive() ) {
-                            Conf_set_dangerous_monitor_state((yyvsp[(3) - (3)]).boolean);
+                            Conf_set_dangerous_monitor_state(yyvsp[0].boolean);
                           }
 			}
+#line 2036 "y.tab.c"
     break;
 
-  case 42:
-#line 453 "./config_parse.y"
-    {
+  case 42: /* ParamStruct: SOCKETPORTREUSE EQUALS SP_TRIVAL  */
+#line 453 "config_parse.y"
+                        {
                             port_reuse state;
-                            if ((yyvsp[(3) - (3)]).number == 1)
+                            if (yyvsp[0].number == 1)
                             {
                                 state = port_reuse_on;
                             }
-                            else if ((yyvsp[(3) - (3)]).number == 0)
+                            else if (yyvsp[0].number == 0)
                             {
                                 state = port_reuse_off;
                             }
@@ -2168,39 +2054,44 @@ yyreduce:
                             }
                             Conf_set_port_reuse_type(state);
                         }
+#line 2058 "y.tab.c"
     break;
 
-  case 43:
-#line 471 "./config_parse.y"
-    {
-                            Conf_set_runtime_dir((yyvsp[(3) - (3)]).string);
+  case 43: /* ParamStruct: RUNTIMEDIR EQUALS STRING  */
+#line 471 "config_parse.y"
+                        {
+                            Conf_set_runtime_dir(yyvsp[0].string);
                         }
+#line 2066 "y.tab.c"
     break;
 
-  case 44:
-#line 475 "./config_parse.y"
-    {
+  case 44: /* ParamStruct: DEBUGINITIALSEQUENCE  */
+#line 475 "config_parse.y"
+                        {
                             Conf_set_debug_initial_sequence();
                         }
+#line 2074 "y.tab.c"
     break;
 
-  case 45:
-#line 479 "./config_parse.y"
-    {
-                            Conf_set_user((yyvsp[(3) - (3)]).string);
+  case 45: /* ParamStruct: SPUSER EQUALS STRING  */
+#line 479 "config_parse.y"
+                        {
+                            Conf_set_user(yyvsp[0].string);
                         }
+#line 2082 "y.tab.c"
     break;
 
-  case 46:
-#line 483 "./config_parse.y"
-    {
-                            Conf_set_group((yyvsp[(3) - (3)]).string);
+  case 46: /* ParamStruct: SPGROUP EQUALS STRING  */
+#line 483 "config_parse.y"
+                        {
+                            Conf_set_group(yyvsp[0].string);
                         }
+#line 2090 "y.tab.c"
     break;
 
-  case 47:
-#line 487 "./config_parse.y"
-    {
+  case 47: /* ParamStruct: ALLOWEDAUTHMETHODS EQUALS STRING  */
+#line 487 "config_parse.y"
+                        {
                             char auth_list[MAX_AUTH_LIST_LEN];
                             int i, len;
                             char *c_ptr;
@@ -2209,7 +2100,7 @@ yyreduce:
                             }
                             authentication_configured = 1;
 
-                            strncpy(auth_list, (yyvsp[(3) - (3)]).string, MAX_AUTH_LIST_LEN);
+                            strncpy(auth_list, yyvsp[0].string, MAX_AUTH_LIST_LEN);
                             len = strlen(auth_list); 
                             for (i=0; i < len; )
                             {
@@ -2223,11 +2114,12 @@ yyreduce:
                                 i++; /* for null */
                             }
                         }
+#line 2118 "y.tab.c"
     break;
 
-  case 48:
-#line 511 "./config_parse.y"
-    {
+  case 48: /* ParamStruct: REQUIREDAUTHMETHODS EQUALS STRING  */
+#line 511 "config_parse.y"
+                        {
                             char auth_list[MAX_AUTH_LIST_LEN];
                             int i, len;
                             char *c_ptr;
@@ -2236,7 +2128,7 @@ yyreduce:
                             }
                             authentication_configured = 1;
 
-                            strncpy(auth_list, (yyvsp[(3) - (3)]).string, MAX_AUTH_LIST_LEN);
+                            strncpy(auth_list, yyvsp[0].string, MAX_AUTH_LIST_LEN);
                             len = strlen(auth_list); 
                             for (i=0; i < len; )
                             {
@@ -2250,142 +2142,196 @@ yyreduce:
                                 i++; /* for null */
                             }
                         }
+#line 2146 "y.tab.c"
     break;
 
-  case 49:
-#line 535 "./config_parse.y"
-    {
+  case 49: /* ParamStruct: ACCESSCONTROLPOLICY EQUALS STRING  */
+#line 535 "config_parse.y"
+                        {
                             int ret;
-                            ret = Acm_acp_set_policy((yyvsp[(3) - (3)]).string);
+                            ret = Acm_acp_set_policy(yyvsp[0].string);
                             if (!ret)
                             {
                                     yyerror("Invalid Access Control Policy name. Make sure it is spelled right and any needed mocdules are loaded");
                             }
                         }
+#line 2159 "y.tab.c"
     break;
 
-  case 50:
-#line 544 "./config_parse.y"
-    {
-                            Conf_set_max_session_messages((yyvsp[(3) - (3)]).number);
+  case 50: /* ParamStruct: MAXSESSIONMESSAGES EQUALS NUMBER  */
+#line 544 "config_parse.y"
+                        {
+                            Conf_set_max_session_messages(yyvsp[0].number);
 			}
+#line 2167 "y.tab.c"
     break;
 
-  case 51:
-#line 548 "./config_parse.y"
-    {
+  case 51: /* ParamStruct: LINKPROTOCOL EQUALS PHOP  */
+#line 548 "config_parse.y"
+                        {
                             Conf_set_link_protocol(HOP_PROT);
 			}
+#line 2175 "y.tab.c"
     break;
 
-  case 52:
-#line 552 "./config_parse.y"
-    {
+  case 52: /* ParamStruct: LINKPROTOCOL EQUALS PTCPHOP  */
+#line 552 "config_parse.y"
+                        {
                             Conf_set_link_protocol(TCP_PROT);
 			}
+#line 2183 "y.tab.c"
     break;
 
-  case 53:
-#line 556 "./config_parse.y"
-    {
-			    Conf_set_window((yyvsp[(3) - (3)]).number);
+  case 53: /* ParamStruct: WINDOW EQUALS NUMBER  */
+#line 556 "config_parse.y"
+                        {
+			    Conf_set_window(yyvsp[0].number);
 			}
+#line 2191 "y.tab.c"
     break;
 
-  case 54:
-#line 560 "./config_parse.y"
-    {
-			    Conf_set_personal_window((yyvsp[(3) - (3)]).number);
+  case 54: /* ParamStruct: PERSONALWINDOW EQUALS NUMBER  */
+#line 560 "config_parse.y"
+                        {
+			    Conf_set_personal_window(yyvsp[0].number);
 			}
+#line 2199 "y.tab.c"
     break;
 
-  case 55:
-#line 564 "./config_parse.y"
-    {
+  case 55: /* ParamStruct: ACCELERATEDRING EQUALS SP_BOOL  */
+#line 564 "config_parse.y"
+                        {
 			    Conf_set_accelerated_ring_flag(TRUE);
-			    Conf_set_accelerated_ring((yyvsp[(3) - (3)]).boolean);
+			    Conf_set_accelerated_ring(yyvsp[0].boolean);
 			}
+#line 2208 "y.tab.c"
     break;
 
-  case 56:
-#line 569 "./config_parse.y"
-    {
-			    Conf_set_accelerated_window((yyvsp[(3) - (3)]).number);
+  case 56: /* ParamStruct: ACCELERATEDWINDOW EQUALS NUMBER  */
+#line 569 "config_parse.y"
+                        {
+			    Conf_set_accelerated_window(yyvsp[0].number);
 			}
+#line 2216 "y.tab.c"
     break;
 
-  case 57:
-#line 573 "./config_parse.y"
-    {
-			    Conf_set_token_timeout((yyvsp[(3) - (3)]).number);
+  case 57: /* ParamStruct: TOKENTIMEOUT EQUALS NUMBER  */
+#line 573 "config_parse.y"
+                        {
+			    Conf_set_token_timeout(yyvsp[0].number);
 			}
+#line 2224 "y.tab.c"
     break;
 
-  case 58:
-#line 577 "./config_parse.y"
-    {
-			    Conf_set_hurry_timeout((yyvsp[(3) - (3)]).number);
+  case 58: /* ParamStruct: HURRYTIMEOUT EQUALS NUMBER  */
+#line 577 "config_parse.y"
+                        {
+			    Conf_set_hurry_timeout(yyvsp[0].number);
 			}
+#line 2232 "y.tab.c"
     break;
 
-  case 59:
-#line 581 "./config_parse.y"
-    {
-			    Conf_set_alive_timeout((yyvsp[(3) - (3)]).number);
+  case 59: /* ParamStruct: ALIVETIMEOUT EQUALS NUMBER  */
+#line 581 "config_parse.y"
+                        {
+			    Conf_set_alive_timeout(yyvsp[0].number);
 			}
+#line 2240 "y.tab.c"
     break;
 
-  case 60:
-#line 585 "./config_parse.y"
-    {
-			    Conf_set_join_timeout((yyvsp[(3) - (3)]).number);
+  case 60: /* ParamStruct: JOINTIMEOUT EQUALS NUMBER  */
+#line 585 "config_parse.y"
+                        {
+			    Conf_set_join_timeout(yyvsp[0].number);
 			}
+#line 2248 "y.tab.c"
     break;
 
-  case 61:
-#line 589 "./config_parse.y"
-    {
-			    Conf_set_rep_timeout((yyvsp[(3) - (3)]).number);
+  case 61: /* ParamStruct: REPTIMEOUT EQUALS NUMBER  */
+#line 589 "config_parse.y"
+                        {
+			    Conf_set_rep_timeout(yyvsp[0].number);
 			}
+#line 2256 "y.tab.c"
     break;
 
-  case 62:
-#line 593 "./config_parse.y"
-    {
-			    Conf_set_seg_timeout((yyvsp[(3) - (3)]).number);
+  case 62: /* ParamStruct: SEGTIMEOUT EQUALS NUMBER  */
+#line 593 "config_parse.y"
+                        {
+			    Conf_set_seg_timeout(yyvsp[0].number);
 			}
+#line 2264 "y.tab.c"
     break;
 
-  case 63:
-#line 597 "./config_parse.y"
-    {
-			    Conf_set_gather_timeout((yyvsp[(3) - (3)]).number);
+  case 63: /* ParamStruct: GATHERTIMEOUT EQUALS NUMBER  */
+#line 597 "config_parse.y"
+                        {
+			    Conf_set_gather_timeout(yyvsp[0].number);
 			}
+#line 2272 "y.tab.c"
     break;
 
-  case 64:
-#line 601 "./config_parse.y"
-    {
-			    Conf_set_form_timeout((yyvsp[(3) - (3)]).number);
+  case 64: /* ParamStruct: FORMTIMEOUT EQUALS NUMBER  */
+#line 601 "config_parse.y"
+                        {
+			    Conf_set_form_timeout(yyvsp[0].number);
 			}
+#line 2280 "y.tab.c"
     break;
 
-  case 65:
-#line 605 "./config_parse.y"
-    {
-			    Conf_set_lookup_timeout((yyvsp[(3) - (3)]).number);
+  case 65: /* ParamStruct: LOOKUPTIMEOUT EQUALS NUMBER  */
+#line 605 "config_parse.y"
+                        {
+			    Conf_set_lookup_timeout(yyvsp[0].number);
+			}
+#line 2288 "y.tab.c"
+    break;
+
+  case 66: /* ParamStruct: STRING EQUALS SP_BOOL  */
+#line 609 "config_parse.y"
+                        {
+			    if (!Conf_set_named_param(yyvsp[-2].string, yyvsp[0].boolean))
+			        yyerror("Unknown configuration parameter");
+			}
+#line 2297 "y.tab.c"
+    break;
+
+  case 67: /* ParamStruct: STRING EQUALS SP_TRIVAL  */
+#line 614 "config_parse.y"
+                        {
+			    if (!Conf_set_named_param(yyvsp[-2].string, yyvsp[0].number))
+			        yyerror("Unknown configuration parameter");
+			}
+#line 2306 "y.tab.c"
+    break;
+
+  case 68: /* ParamStruct: STRING EQUALS NUMBER  */
+#line 619 "config_parse.y"
+                        {
+			    if (!Conf_set_named_param(yyvsp[-2].string, yyvsp[0].number))
+			        yyerror("Unknown configuration parameter");
 			}
+#line 2315 "y.tab.c"
     break;
 
-  case 66:
-#line 610 "./config_parse.y"
-    { int i;
+  case 69: /* ParamStruct: STRING EQUALS STRING  */
+#line 624 "config_parse.y"
+                        {
+			    if (!Conf_set_named_string_param(yyvsp[-2].string, yyvsp[0].string))
+			        yyerror("Unknown configuration parameter");
+			}
+#line 2324 "y.tab.c"
+    break;
+
+  case 70: /* SegmentStruct: SEGMENT IPADDR OPENBRACE Segmentparams CLOSEBRACE  */
+#line 630 "config_parse.y"
+                        { int i;
                           int added_len;
-                          SEGMENT_CHECK( segments, inet_ntoa((yyvsp[(2) - (5)]).ip.addr) );
+                          SEGMENT_CHECK( segments, inet_ntoa(yyvsp[-3].ip.addr) );
 			  Config->segments[segments].num_procs = segment_procs;
-			  Config->segments[segments].port = (yyvsp[(2) - (5)]).ip.port;
+			  Config->segments[segments].port = yyvsp[-3].ip.port;
 			  Config->segments[segments].bcast_address =
-			    (yyvsp[(2) - (5)]).ip.addr.s_addr;
+			    yyvsp[-3].ip.addr.s_addr;
 			  if(Config->segments[segments].port == 0)
 			    Config->segments[segments].port = DEFAULT_SPREAD_PORT;
 			  Alarm(CONF_SYS, "Successfully configured Segment %d [%s] with %d procs:\n",
@@ -2410,20 +2356,21 @@ yyreduce:
 			  segments++;
 			  segment_procs = 0;
 			}
+#line 2360 "y.tab.c"
     break;
 
-  case 69:
-#line 648 "./config_parse.y"
-    { 
-                          PROC_NAME_CHECK( (yyvsp[(1) - (5)]).string );
-                          PROCS_CHECK( num_procs, (yyvsp[(1) - (5)]).string );
-                          SEGMENT_CHECK( segments, (yyvsp[(1) - (5)]).string );
-                          SEGMENT_SIZE_CHECK( segment_procs, (yyvsp[(1) - (5)]).string );
+  case 73: /* Segmentparam: STRING IPADDR OPENBRACE Interfaceparams CLOSEBRACE  */
+#line 668 "config_parse.y"
+                        { 
+                          PROC_NAME_CHECK( yyvsp[-4].string );
+                          PROCS_CHECK( num_procs, yyvsp[-4].string );
+                          SEGMENT_CHECK( segments, yyvsp[-4].string );
+                          SEGMENT_SIZE_CHECK( segment_procs, yyvsp[-4].string );
                           if (procs_interfaces == 0)
                                   yyerror("Interfaces section declared but no actual interface addresses defined\n");
-                          strcpy(Config->allprocs[num_procs].name, (yyvsp[(1) - (5)]).string);
-                          Config->allprocs[num_procs].id = (yyvsp[(2) - (5)]).ip.addr.s_addr;
- 		          Config->allprocs[num_procs].port = (yyvsp[(2) - (5)]).ip.port;
+                          strcpy(Config->allprocs[num_procs].name, yyvsp[-4].string);
+                          Config->allprocs[num_procs].id = yyvsp[-3].ip.addr.s_addr;
+ 		          Config->allprocs[num_procs].port = yyvsp[-3].ip.port;
 			  Config->allprocs[num_procs].seg_index = segments;
 			  Config->allprocs[num_procs].index_in_seg = segment_procs;
                           Config->allprocs[num_procs].num_if = procs_interfaces;
@@ -2433,18 +2380,19 @@ yyreduce:
 			  segment_procs++;
                           procs_interfaces = 0;
 			}
+#line 2384 "y.tab.c"
     break;
 
-  case 70:
-#line 668 "./config_parse.y"
-    { 
-                          PROC_NAME_CHECK( (yyvsp[(1) - (4)]).string );
-                          PROCS_CHECK( num_procs, (yyvsp[(1) - (4)]).string );
-                          SEGMENT_CHECK( segments, (yyvsp[(1) - (4)]).string );
-                          SEGMENT_SIZE_CHECK( segment_procs, (yyvsp[(1) - (4)]).string );
+  case 74: /* Segmentparam: STRING OPENBRACE Interfaceparams CLOSEBRACE  */
+#line 688 "config_parse.y"
+                        { 
+                          PROC_NAME_CHECK( yyvsp[-3].string );
+                          PROCS_CHECK( num_procs, yyvsp[-3].string );
+                          SEGMENT_CHECK( segments, yyvsp[-3].string );
+                          SEGMENT_SIZE_CHECK( segment_procs, yyvsp[-3].string );
                           if (procs_interfaces == 0)
                                   yyerror("Interfaces section declared but no actual interface addresses defined\n");
-                          strcpy(Config->allprocs[num_procs].name, (yyvsp[(1) - (4)]).string);
+                          strcpy(Config->allprocs[num_procs].name, yyvsp[-3].string);
                           Config->allprocs[num_procs].id =
 			    name2ip(Config->allprocs[num_procs].name);
  		          Config->allprocs[num_procs].port = 0;
@@ -2457,18 +2405,19 @@ yyreduce:
 			  segment_procs++;
                           procs_interfaces = 0;
 			}
-    break;
-
-  case 71:
-#line 689 "./config_parse.y"
-    { 
-                          PROC_NAME_CHECK( (yyvsp[(1) - (2)]).string );
-                          PROCS_CHECK( num_procs, (yyvsp[(1) - (2)]).string );
-                          SEGMENT_CHECK( segments, (yyvsp[(1) - (2)]).string );
-                          SEGMENT_SIZE_CHECK( segment_procs, (yyvsp[(1) - (2)]).string );
-                          strcpy(Config->allprocs[num_procs].name, (yyvsp[(1) - (2)]).string);
-                          Config->allprocs[num_procs].id = (yyvsp[(2) - (2)]).ip.addr.s_addr;
- 		          Config->allprocs[num_procs].port = (yyvsp[(2) - (2)]).ip.port;
+#line 2409 "y.tab.c"
+    break;
+
+  case 75: /* Segmentparam: STRING IPADDR  */
+#line 709 "config_parse.y"
+                        { 
+                          PROC_NAME_CHECK( yyvsp[-1].string );
+                          PROCS_CHECK( num_procs, yyvsp[-1].string );
+                          SEGMENT_CHECK( segments, yyvsp[-1].string );
+                          SEGMENT_SIZE_CHECK( segment_procs, yyvsp[-1].string );
+                          strcpy(Config->allprocs[num_procs].name, yyvsp[-1].string);
+                          Config->allprocs[num_procs].id = yyvsp[0].ip.addr.s_addr;
+ 		          Config->allprocs[num_procs].port = yyvsp[0].ip.port;
 			  Config->allprocs[num_procs].seg_index = segments;
 			  Config->allprocs[num_procs].index_in_seg = segment_procs;
                           Config->allprocs[num_procs].num_if = 1;
@@ -2481,16 +2430,17 @@ yyreduce:
 			  segment_procs++;
                           procs_interfaces = 0;
 			}
+#line 2434 "y.tab.c"
     break;
 
-  case 72:
-#line 710 "./config_parse.y"
-    { 
-                          PROC_NAME_CHECK( (yyvsp[(1) - (1)]).string );
-                          PROCS_CHECK( num_procs, (yyvsp[(1) - (1)]).string );
-                          SEGMENT_CHECK( segments, (yyvsp[(1) - (1)]).string );
-                          SEGMENT_SIZE_CHECK( segment_procs, (yyvsp[(1) - (1)]).string );
-                          strcpy(Config->allprocs[num_procs].name, (yyvsp[(1) - (1)]).string);
+  case 76: /* Segmentparam: STRING  */
+#line 730 "config_parse.y"
+                        { 
+                          PROC_NAME_CHECK( yyvsp[0].string );
+                          PROCS_CHECK( num_procs, yyvsp[0].string );
+                          SEGMENT_CHECK( segments, yyvsp[0].string );
+                          SEGMENT_SIZE_CHECK( segment_procs, yyvsp[0].string );
+                          strcpy(Config->allprocs[num_procs].name, yyvsp[0].string);
                           Config->allprocs[num_procs].id =
 			    name2ip(Config->allprocs[num_procs].name);
  		          Config->allprocs[num_procs].port = 0;
@@ -2506,167 +2456,151 @@ yyreduce:
 			  segment_procs++;
                           procs_interfaces = 0;
 			}
+#line 2460 "y.tab.c"
     break;
 
-  case 73:
-#line 733 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 77: /* IfType: IMONITOR  */
+#line 753 "config_parse.y"
+                                 { yyval = yyvsp[0]; }
+#line 2466 "y.tab.c"
     break;
 
-  case 74:
-#line 734 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 78: /* IfType: ICLIENT  */
+#line 754 "config_parse.y"
+                                { yyval = yyvsp[0]; }
+#line 2472 "y.tab.c"
     break;
 
-  case 75:
-#line 735 "./config_parse.y"
-    { (yyval) = (yyvsp[(1) - (1)]); }
+  case 79: /* IfType: IDAEMON  */
+#line 755 "config_parse.y"
+                                { yyval = yyvsp[0]; }
+#line 2478 "y.tab.c"
     break;
 
-  case 76:
-#line 739 "./config_parse.y"
-    {
-			  (yyval).mask = ((yyvsp[(1) - (2)]).mask | (yyvsp[(2) - (2)]).mask);
+  case 80: /* IfTypeComp: IfTypeComp IfType  */
+#line 759 "config_parse.y"
+                        {
+			  yyval.mask = (yyvsp[-1].mask | yyvsp[0].mask);
 			}
+#line 2486 "y.tab.c"
     break;
 
-  case 77:
-#line 742 "./config_parse.y"
-    { (yyval).mask = 0; }
+  case 81: /* IfTypeComp: %empty  */
+#line 762 "config_parse.y"
+                        { yyval.mask = 0; }
+#line 2492 "y.tab.c"
     break;
 
-  case 80:
-#line 750 "./config_parse.y"
-    { 
-                          PROCS_CHECK( num_procs, (yyvsp[(1) - (2)]).string );
-                          SEGMENT_CHECK( segments, (yyvsp[(1) - (2)]).string );
-                          SEGMENT_SIZE_CHECK( segment_procs, (yyvsp[(1) - (2)]).string );
-                          INTERFACE_NUM_CHECK( procs_interfaces, (yyvsp[(1) - (2)]).string );
-                          Config->allprocs[num_procs].ifc[procs_interfaces].ip = (yyvsp[(2) - (2)]).ip.addr.s_addr;
-                          Config->allprocs[num_procs].ifc[procs_interfaces].port = (yyvsp[(2) - (2)]).ip.port;
-                          if ((yyvsp[(1) - (2)]).mask == 0)
+  case 84: /* Interfaceparam: IfTypeComp IPADDR  */
+#line 770 "config_parse.y"
+                        { 
+                          PROCS_CHECK( num_procs, yyvsp[-1].string );
+                          SEGMENT_CHECK( segments, yyvsp[-1].string );
+                          SEGMENT_SIZE_CHECK( segment_procs, yyvsp[-1].string );
+                          INTERFACE_NUM_CHECK( procs_interfaces, yyvsp[-1].string );
+                          Config->allprocs[num_procs].ifc[procs_interfaces].ip = yyvsp[0].ip.addr.s_addr;
+                          Config->allprocs[num_procs].ifc[procs_interfaces].port = yyvsp[0].ip.port;
+                          if (yyvsp[-1].mask == 0)
                                   Config->allprocs[num_procs].ifc[procs_interfaces].type = IFTYPE_ALL;
                           else 
-                                  Config->allprocs[num_procs].ifc[procs_interfaces].type = (yyvsp[(1) - (2)]).mask;
+                                  Config->allprocs[num_procs].ifc[procs_interfaces].type = yyvsp[-1].mask;
                           procs_interfaces++;
 			}
+#line 2510 "y.tab.c"
     break;
 
-  case 81:
-#line 766 "./config_parse.y"
-    { 
+  case 85: /* RouteStruct: ROUTEMATRIX OPENBRACE Routevectors CLOSEBRACE  */
+#line 786 "config_parse.y"
+                        { 
 			  Alarm(CONF_SYS, "Successfully configured Routing Matrix for %d Segments with %d rows in the routing matrix\n",segments, rvec_num);
 			}
+#line 2518 "y.tab.c"
     break;
 
-  case 84:
-#line 776 "./config_parse.y"
-    { 
+  case 88: /* Routevector: LINKCOST  */
+#line 796 "config_parse.y"
+                        { 
                                 int rvec_element;
                                 for (rvec_element = 0; rvec_element < segments; rvec_element++) {
-                                        if ((yyvsp[(1) - (1)]).cost[rvec_element] < 0) yyerror("Wrong number of entries for routing matrix");
-                                        LinkWeights[rvec_num][rvec_element] = (yyvsp[(1) - (1)]).cost[rvec_element];
+                                        if (yyvsp[0].cost[rvec_element] < 0) yyerror("Wrong number of entries for routing matrix");
+                                        LinkWeights[rvec_num][rvec_element] = yyvsp[0].cost[rvec_element];
                                 }
                                 rvec_num++;
                         }
+#line 2531 "y.tab.c"
     break;
 
 
-/* Line 1267 of yacc.c.  */
-#line 2577 "y.tab.c"
+#line 2535 "y.tab.c"
+
       default: break;
     }
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
 
-
-  /* Now `shift' the result of the reduction.  Determine what state
+  /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
 
-/*------------------------------------.
-| yyerrlab -- here on detecting error |
-`------------------------------------*/
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
 yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-      {
-	YYSIZE_T yysize = yysyntax_error (0, yystate, yychar);
-	if (yymsg_alloc < yysize && yymsg_alloc < YYSTACK_ALLOC_MAXIMUM)
-	  {
-	    YYSIZE_T yyalloc = 2 * yysize;
-	    if (! (yysize <= yyalloc && yyalloc <= YYSTACK_ALLOC_MAXIMUM))
-	      yyalloc = YYSTACK_ALLOC_MAXIMUM;
-	    if (yymsg != yymsgbuf)
-	      YYSTACK_FREE (yymsg);
-	    yymsg = (char *) YYSTACK_ALLOC (yyalloc);
-	    if (yymsg)
-	      yymsg_alloc = yyalloc;
-	    else
-	      {
-		yymsg = yymsgbuf;
-		yymsg_alloc = sizeof yymsgbuf;
-	      }
-	  }
-
-	if (0 < yysize && yysize <= yymsg_alloc)
-	  {
-	    (void) yysyntax_error (yymsg, yystate, yychar);
-	    yyerror (yymsg);
-	  }
-	else
-	  {
-	    yyerror (YY_("syntax error"));
-	    if (yysize != 0)
-	      goto yyexhaustedlab;
-	  }
-      }
-#endif
     }
 
-
-
   if (yyerrstatus == 3)
     {
-      /* If just tried and failed to reuse look-ahead token after an
-	 error, discard it.  */
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
 
       if (yychar <= YYEOF)
-	{
-	  /* Return failure if at end of input.  */
-	  if (yychar == YYEOF)
-	    YYABORT;
-	}
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
       else
-	{
-	  yydestruct ("Error: discarding",
-		      yytoken, &yylval);
-	  yychar = YYEMPTY;
-	}
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval);
+          yychar = YYEMPTY;
+        }
     }
 
-  /* Else will try to reuse look-ahead token after shifting the error
+  /* Else will try to reuse lookahead token after shifting the error
      token.  */
   goto yyerrlab1;
 
@@ -2675,14 +2609,13 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
-
-  /* Do not reclaim the symbols of the rule which action triggered
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
   YYPOPSTACK (yylen);
   yylen = 0;
@@ -2695,42 +2628,42 @@ yyerrorlab:
 | yyerrlab1 -- common code for both syntax error and YYERROR.  |
 `-------------------------------------------------------------*/
 yyerrlab1:
-  yyerrstatus = 3;	/* Each real token shifted decrements this.  */
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
-      if (yyn != YYPACT_NINF)
-	{
-	  yyn += YYTERROR;
-	  if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
-	    {
-	      yyn = yytable[yyn];
-	      if (0 < yyn)
-		break;
-	    }
-	}
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
 
       /* Pop the current state because it cannot handle the error token.  */
       if (yyssp == yyss)
-	YYABORT;
+        YYABORT;
 
 
       yydestruct ("Error: popping",
-		  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
     }
 
-  if (yyn == YYFINAL)
-    YYACCEPT;
-
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2741,53 +2674,57 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#ifndef yyoverflow
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
 
-yyreturn:
-  if (yychar != YYEOF && yychar != YYEMPTY)
-     yydestruct ("Cleanup: discarding lookahead",
-		 yytoken, &yylval);
-  /* Do not reclaim the symbols of the rule which action triggered
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
   YYPOPSTACK (yylen);
   YY_STACK_PRINT (yyss, yyssp);
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-		  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp);
       YYPOPSTACK (1);
     }
 #ifndef yyoverflow
   if (yyss != yyssa)
     YYSTACK_FREE (yyss);
 #endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
-  /* Make sure YYID is used.  */
-  return YYID (yyresult);
-}
 
+  return yyresult;
+}
 
-#line 785 "./config_parse.y"
+#line 805 "config_parse.y"
 
 void yywarn(char *str) {
         fprintf(stderr, "-------Parse Warning-----------\n");
@@ -2802,4 +2739,3 @@ int yyerror(char *str) {
   fprintf(stderr, "Offending token: %s\n", yytext);
   exit(1);
 }
-
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,87 +31,109 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_Y_TAB_H_INCLUDED
+# define YY_YY_Y_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     SEGMENT = 258,
-     EVENTLOGFILE = 259,
-     EVENTTIMESTAMP = 260,
-     EVENTPRECISETIMESTAMP = 261,
-     EVENTPRIORITY = 262,
-     IPADDR = 263,
-     NUMBER = 264,
-     COLON = 265,
-     PDEBUG = 266,
-     PINFO = 267,
-     PWARNING = 268,
-     PERROR = 269,
-     PCRITICAL = 270,
-     PFATAL = 271,
-     OPENBRACE = 272,
-     CLOSEBRACE = 273,
-     EQUALS = 274,
-     STRING = 275,
-     DEBUGFLAGS = 276,
-     BANG = 277,
-     DDEBUG = 278,
-     DEXIT = 279,
-     DPRINT = 280,
-     DDATA_LINK = 281,
-     DNETWORK = 282,
-     DPROTOCOL = 283,
-     DSESSION = 284,
-     DCONF = 285,
-     DMEMB = 286,
-     DFLOW_CONTROL = 287,
-     DSTATUS = 288,
-     DEVENTS = 289,
-     DGROUPS = 290,
-     DMEMORY = 291,
-     DSKIPLIST = 292,
-     DACM = 293,
-     DSECURITY = 294,
-     DALL = 295,
-     DNONE = 296,
-     DEBUGINITIALSEQUENCE = 297,
-     DANGEROUSMONITOR = 298,
-     SOCKETPORTREUSE = 299,
-     RUNTIMEDIR = 300,
-     SPUSER = 301,
-     SPGROUP = 302,
-     ALLOWEDAUTHMETHODS = 303,
-     REQUIREDAUTHMETHODS = 304,
-     ACCESSCONTROLPOLICY = 305,
-     MAXSESSIONMESSAGES = 306,
-     WINDOW = 307,
-     PERSONALWINDOW = 308,
-     ACCELERATEDRING = 309,
-     ACCELERATEDWINDOW = 310,
-     TOKENTIMEOUT = 311,
-     HURRYTIMEOUT = 312,
-     ALIVETIMEOUT = 313,
-     JOINTIMEOUT = 314,
-     REPTIMEOUT = 315,
-     SEGTIMEOUT = 316,
-     GATHERTIMEOUT = 317,
-     FORMTIMEOUT = 318,
-     LOOKUPTIMEOUT = 319,
-     SP_BOOL = 320,
-     SP_TRIVAL = 321,
-     LINKPROTOCOL = 322,
-     PHOP = 323,
-     PTCPHOP = 324,
-     IMONITOR = 325,
-     ICLIENT = 326,
-     IDAEMON = 327,
-     ROUTEMATRIX = 328,
-     LINKCOST = 329
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    SEGMENT = 258,                 /* SEGMENT  */
+    EVENTLOGFILE = 259,            /* EVENTLOGFILE  */
+    EVENTTIMESTAMP = 260,          /* EVENTTIMESTAMP  */
+    EVENTPRECISETIMESTAMP = 261,   /* EVENTPRECISETIMESTAMP  */
+    EVENTPRIORITY = 262,           /* EVENTPRIORITY  */
+    IPADDR = 263,                  /* IPADDR  */
+    NUMBER = 264,                  /* NUMBER  */
+    COLON = 265,                   /* COLON  */
+    PDEBUG = 266,                  /* PDEBUG  */
+    PINFO = 267,                   /* PINFO  */
+    PWARNING = 268,                /* PWARNING  */
+    PERROR = 269,                  /* PERROR  */
+    PCRITICAL = 270,               /* PCRITICAL  */
+    PFATAL = 271,                  /* PFATAL  */
+    OPENBRACE = 272,               /* OPENBRACE  */
+    CLOSEBRACE = 273,              /* CLOSEBRACE  */
+    EQUALS = 274,                  /* EQUALS  */
+    STRING = 275,                  /* STRING  */
+    DEBUGFLAGS = 276,              /* DEBUGFLAGS  */
+    BANG = 277,                    /* BANG  */
+    DDEBUG = 278,                  /* DDEBUG  */
+    DEXIT = 279,                   /* DEXIT  */
+    DPRINT = 280,                  /* DPRINT  */
+    DDATA_LINK = 281,              /* DDATA_LINK  */
+    DNETWORK = 282,                /* DNETWORK  */
+    DPROTOCOL = 283,               /* DPROTOCOL  */
+    DSESSION = 284,                /* DSESSION  */
+    DCONF = 285,                   /* DCONF  */
+    DMEMB = 286,                   /* DMEMB  */
+    DFLOW_CONTROL = 287,           /* DFLOW_CONTROL  */
+    DSTATUS = 288,                 /* DSTATUS  */
+    DEVENTS = 289,                 /* DEVENTS  */
+    DGROUPS = 290,                 /* DGROUPS  */
+    DMEMORY = 291,                 /* DMEMORY  */
+    DSKIPLIST = 292,               /* DSKIPLIST  */
+    DACM = 293,                    /* DACM  */
+    DSECURITY = 294,               /* DSECURITY  */
+    DALL = 295,                    /* DALL  */
+    DNONE = 296,                   /* DNONE  */
+    DEBUGINITIALSEQUENCE = 297,    /* DEBUGINITIALSEQUENCE  */
+    DANGEROUSMONITOR = 298,        /* DANGEROUSMONITOR  */
+    SOCKETPORTREUSE = 299,         /* SOCKETPORTREUSE  */
+    RUNTIMEDIR = 300,              /* RUNTIMEDIR  */
+    SPUSER = 301,                  /* SPUSER  */
+    SPGROUP = 302,                 /* SPGROUP  */
+    ALLOWEDAUTHMETHODS = 303,      /* ALLOWEDAUTHMETHODS  */
+    REQUIREDAUTHMETHODS = 304,     /* REQUIREDAUTHMETHODS  */
+    ACCESSCONTROLPOLICY = 305,     /* ACCESSCONTROLPOLICY  */
+    MAXSESSIONMESSAGES = 306,      /* MAXSESSIONMESSAGES  */
+    WINDOW = 307,                  /* WINDOW  */
+    PERSONALWINDOW = 308,          /* PERSONALWINDOW  */
+    ACCELERATEDRING = 309,         /* ACCELERATEDRING  */
+    ACCELERATEDWINDOW = 310,       /* ACCELERATEDWINDOW  */
+    TOKENTIMEOUT = 311,            /* TOKENTIMEOUT  */
+    HURRYTIMEOUT = 312,            /* HURRYTIMEOUT  */
+    ALIVETIMEOUT = 313,            /* ALIVETIMEOUT  */
+    JOINTIMEOUT = 314,             /* JOINTIMEOUT  */
+    REPTIMEOUT = 315,              /* REPTIMEOUT  */
+    SEGTIMEOUT = 316,              /* SEGTIMEOUT  */
+    GATHERTIMEOUT = 317,           /* GATHERTIMEOUT  */
+    FORMTIMEOUT = 318,             /* FORMTIMEOUT  */
+    LOOKUPTIMEOUT = 319,           /* LOOKUPTIMEOUT  */
+    SP_BOOL = 320,                 /* SP_BOOL  */
+    SP_TRIVAL = 321,               /* SP_TRIVAL  */
+    LINKPROTOCOL = 322,            /* LINKPROTOCOL  */
+    PHOP = 323,                    /* PHOP  */
+    PTCPHOP = 324,                 /* PTCPHOP  */
+    IMONITOR = 325,                /* IMONITOR  */
+    ICLIENT = 326,                 /* ICLIENT  */
+    IDAEMON = 327,                 /* IDAEMON  */
+    ROUTEMATRIX = 328,             /* ROUTEMATRIX  */
+    LINKCOST = 329                 /* LINKCOST  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define SEGMENT 258
 #define EVENTLOGFILE 259
 #define EVENTTIMESTAMP 260
@@ -187,15 +207,18 @@
 #define ROUTEMATRIX 328
 #define LINKCOST 329
 
-
-
-
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
 typedef int YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
+
 extern YYSTYPE yylval;
 
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_Y_TAB_H_INCLUDED  */
@@ -0,0 +1,175 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+/*
+ * batch_bench: compares small multicasts sent one SP_multicast each with
+ * the same multicasts sent between SP_batch_begin and SP_batch_flush. One
+ * session sends a window of messages to a group another session in the
+ * same process has joined, and the receiver takes them all before the next
+ * window goes out, so the rate reported covers the library, the daemon
+ * reading and ordering the messages, and the delivery back.
+ *
+ *   batch_bench -s 4803@localhost -n 200000 -l 32 -w 200
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "sp.h"
+
+#define	MAX_BENCH_MESS		1024
+#define	MAX_BENCH_WINDOW	500	/* well under the daemon's MaxSessionMessages */
+#define	RECV_BATCH		64
+
+static	char	*Spread_name = "4803";
+static	int	Num_messages = 200000;
+static	int	Mess_len = 32;
+static	int	Window = 200;
+
+static	mailbox	Send_mbox;
+static	mailbox	Recv_mbox;
+static	char	Mess[MAX_BENCH_MESS];
+static	sp_message	Recv_mess[RECV_BATCH];
+
+static	double	Now_ms( void )
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0 );
+}
+
+static	void	Usage( char *exe )
+{
+	fprintf( stderr, "Usage: %s\n"
+		"\t[-s <daemon>]       : daemon to connect to (default %s)\n"
+		"\t[-n <messages>]     : messages sent each way (default %d)\n"
+		"\t[-l <bytes>]        : message length (default %d)\n"
+		"\t[-w <window>]       : messages per batch (default %d, at most %d)\n",
+		exe, Spread_name, Num_messages, Mess_len, Window, MAX_BENCH_WINDOW );
+	exit( 1 );
+}
+
+static	void	Bail( char *what, int ret )
+{
+	fprintf( stderr, "batch_bench: %s: ", what );
+	SP_error( ret );
+	exit( 1 );
+}
+
+/* takes num regular messages; returns at the membership when num is 0 */
+static	void	Receive( int num )
+{
+	int	i, j, ret;
+
+	for( i=0; i < num || num == 0; )
+	{
+		ret = SP_receive_many( Recv_mbox, RECV_BATCH, Recv_mess );
+		if( ret < 0 ) Bail( "SP_receive_many", ret );
+		for( j=0; j < ret; j++ )
+		{
+			if( Is_regular_mess( Recv_mess[j].service_type ) ) i++;
+			else if( num == 0 && Is_reg_memb_mess( Recv_mess[j].service_type ) ) return;
+		}
+	}
+}
+
+static	double	Run( int batched )
+{
+	double	start;
+	int	sent, window, i, ret;
+
+	start = Now_ms();
+	for( sent=0; sent < Num_messages; sent += window )
+	{
+		window = Num_messages - sent;
+		if( window > Window ) window = Window;
+		if( batched && ( ret = SP_batch_begin( Send_mbox ) ) < 0 ) Bail( "SP_batch_begin", ret );
+		for( i=0; i < window; i++ )
+		{
+			ret = SP_multicast( Send_mbox, RELIABLE_MESS, "batch_bench", 0, Mess_len, Mess );
+			if( ret < 0 ) Bail( "SP_multicast", ret );
+		}
+		if( batched && ( ret = SP_batch_flush( Send_mbox ) ) < 0 ) Bail( "SP_batch_flush", ret );
+		Receive( window );
+	}
+	return( Now_ms() - start );
+}
+
+int	main( int argc, char *argv[] )
+{
+	char	private_group[MAX_GROUP_NAME];
+	double	single_ms, batch_ms;
+	int	i, ret;
+
+	for( i=1; i < argc; i++ )
+	{
+		if( i+1 >= argc ) Usage( argv[0] );
+		if(      !strcmp( argv[i], "-s" ) ) Spread_name = argv[++i];
+		else if( !strcmp( argv[i], "-n" ) ) Num_messages = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-l" ) ) Mess_len = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-w" ) ) Window = atoi( argv[++i] );
+		else Usage( argv[0] );
+	}
+	if( Num_messages <= 0 || Mess_len < 0 || Mess_len > MAX_BENCH_MESS ||
+	    Window <= 0 || Window > MAX_BENCH_WINDOW ) Usage( argv[0] );
+
+	ret = SP_connect( Spread_name, NULL, 0, 0, &Send_mbox, private_group );
+	if( ret != ACCEPT_SESSION ) Bail( "connecting the sender", ret );
+	ret = SP_connect( Spread_name, NULL, 0, 1, &Recv_mbox, private_group );
+	if( ret != ACCEPT_SESSION ) Bail( "connecting the receiver", ret );
+	ret = SP_join( Recv_mbox, "batch_bench" );
+	if( ret < 0 ) Bail( "SP_join", ret );
+
+	/* messages sent before the join is in would not reach the receiver */
+	Receive( 0 );
+	memset( Mess, 'x', sizeof(Mess) );
+
+	single_ms = Run( 0 );
+	batch_ms  = Run( 1 );
+
+	printf( "%d messages of %d bytes through %s\n", Num_messages, Mess_len, Spread_name );
+	printf( "SP_multicast:     %8.1f ms  %10.0f msgs/s\n",
+		single_ms, Num_messages / ( single_ms / 1000.0 ) );
+	printf( "batches of %4d:  %8.1f ms  %10.0f msgs/s\n",
+		Window, batch_ms, Num_messages / ( batch_ms / 1000.0 ) );
+
+	SP_disconnect( Recv_mbox );
+	SP_disconnect( Send_mbox );
+	return( 0 );
+}
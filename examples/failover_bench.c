@@ -0,0 +1,237 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+
+/*
+ * failover_bench: measures how long the surviving daemons take to agree on
+ * a new membership after a daemon dies. It connects one client to each
+ * survivor and one to the victim, joins them all to a group and waits for
+ * the group to settle. Then it kills the victim daemon (SIGKILL) and times,
+ * on each survivor, the arrival of the regular membership caused by the
+ * network, which the daemon sends from Sess_deliver_reg_memb. Compare runs
+ * with and without FastFailureDetection in spread.conf.
+ *
+ *   failover_bench -v 4803@host1 -k <pid of that daemon> -s 4803@host2 -s 4803@host3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "sp.h"
+
+#define	MAX_SURVIVORS		16
+#define	MAX_BENCH_GROUPS	(MAX_SURVIVORS+1)
+#define	MAX_BENCH_MESS		1024
+
+static	char	Group[MAX_GROUP_NAME] = "failover_bench";
+static	char	*Victim_name;
+static	pid_t	Victim_pid;
+static	char	*Survivor_names[MAX_SURVIVORS];
+static	int	Num_survivors;
+static	int	Settle_secs = 2;
+static	int	Max_wait_secs = 30;
+
+static	mailbox	Victim_mbox;
+static	mailbox	Survivor_mbox[MAX_SURVIVORS];
+static	double	Survivor_ms[MAX_SURVIVORS];
+
+static	double	Now_ms( void )
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0 );
+}
+
+static	void	Usage( char *exe )
+{
+	fprintf( stderr, "Usage: %s -v <victim daemon> -k <victim pid> -s <survivor daemon> [-s ...]\n"
+		"\t[-g <group>]        : group to join (default %s)\n"
+		"\t[-w <secs>]         : time to let the ring settle before the kill (default %d)\n"
+		"\t[-t <secs>]         : give up waiting for a membership after this long (default %d)\n",
+		exe, Group, Settle_secs, Max_wait_secs );
+	exit( 1 );
+}
+
+static	void	Connect( char *daemon, mailbox *mbox )
+{
+	char	private_group[MAX_GROUP_NAME];
+	int	ret;
+
+	ret = SP_connect( daemon, NULL, 0, 1, mbox, private_group );
+	if( ret != ACCEPT_SESSION )
+	{
+		fprintf( stderr, "failover_bench: connecting to %s: ", daemon );
+		SP_error( ret );
+		exit( 1 );
+	}
+	ret = SP_join( *mbox, Group );
+	if( ret < 0 )
+	{
+		SP_error( ret );
+		exit( 1 );
+	}
+}
+
+/* receives one message; returns its service type, and the member count for memberships */
+static	service	Receive( mailbox mbox, int *num_members )
+{
+	static	char	groups[MAX_BENCH_GROUPS][MAX_GROUP_NAME];
+	static	char	mess[MAX_BENCH_MESS];
+	char		sender[MAX_GROUP_NAME];
+	service		service_type;
+	int16		mess_type;
+	int		endian_mismatch;
+	int		ret;
+
+	service_type = 0;
+	ret = SP_receive( mbox, &service_type, sender, MAX_BENCH_GROUPS, num_members, groups,
+			  &mess_type, &endian_mismatch, sizeof(mess), mess );
+	if( ret < 0 )
+	{
+		fprintf( stderr, "failover_bench: " );
+		SP_error( ret );
+		exit( 1 );
+	}
+	return( service_type );
+}
+
+/* waits until every client sees all the others in the group */
+static	void	Settle( void )
+{
+	int	i, num_members;
+	service	service_type;
+
+	for( i=0; i < Num_survivors; i++ )
+	{
+		do {
+			service_type = Receive( Survivor_mbox[i], &num_members );
+		} while( !Is_reg_memb_mess( service_type ) || num_members < Num_survivors + 1 );
+	}
+	do {
+		service_type = Receive( Victim_mbox, &num_members );
+	} while( !Is_reg_memb_mess( service_type ) || num_members < Num_survivors + 1 );
+}
+
+int	main( int argc, char *argv[] )
+{
+	fd_set		mask;
+	struct timeval	timeout;
+	double		start, worst;
+	int		i, max_fd, num_left, num_members, ret;
+	service		service_type;
+
+	for( i=1; i < argc; i++ )
+	{
+		if( i+1 >= argc ) Usage( argv[0] );
+		if(      !strcmp( argv[i], "-v" ) ) Victim_name = argv[++i];
+		else if( !strcmp( argv[i], "-k" ) ) Victim_pid = (pid_t) atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-g" ) ) strncpy( Group, argv[++i], MAX_GROUP_NAME - 1 );
+		else if( !strcmp( argv[i], "-w" ) ) Settle_secs = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-t" ) ) Max_wait_secs = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-s" ) && Num_survivors < MAX_SURVIVORS )
+			Survivor_names[Num_survivors++] = argv[++i];
+		else Usage( argv[0] );
+	}
+	if( Victim_name == NULL || Victim_pid <= 0 || Num_survivors == 0 ) Usage( argv[0] );
+
+	for( i=0; i < Num_survivors; i++ )
+		Connect( Survivor_names[i], &Survivor_mbox[i] );
+	Connect( Victim_name, &Victim_mbox );
+	Settle();
+
+	/* let the daemons measure a few token rounds of the settled ring */
+	sleep( Settle_secs );
+
+	start = Now_ms();
+	if( kill( Victim_pid, SIGKILL ) < 0 )
+	{
+		perror( "failover_bench: kill" );
+		exit( 1 );
+	}
+
+	for( i=0; i < Num_survivors; i++ )
+		Survivor_ms[i] = -1.0;
+	num_left = Num_survivors;
+	while( num_left > 0 )
+	{
+		FD_ZERO( &mask );
+		max_fd = 0;
+		for( i=0; i < Num_survivors; i++ )
+		{
+			if( Survivor_ms[i] >= 0 ) continue;
+			FD_SET( Survivor_mbox[i], &mask );
+			if( Survivor_mbox[i] > max_fd ) max_fd = Survivor_mbox[i];
+		}
+		timeout.tv_sec  = Max_wait_secs;
+		timeout.tv_usec = 0;
+		ret = select( max_fd + 1, &mask, NULL, NULL, &timeout );
+		if( ret < 0 && errno == EINTR ) continue;
+		if( ret <= 0 )
+		{
+			fprintf( stderr, "failover_bench: no membership after %d seconds\n", Max_wait_secs );
+			exit( 1 );
+		}
+		for( i=0; i < Num_survivors; i++ )
+		{
+			if( Survivor_ms[i] >= 0 || !FD_ISSET( Survivor_mbox[i], &mask ) ) continue;
+			service_type = Receive( Survivor_mbox[i], &num_members );
+			if( Is_reg_memb_mess( service_type ) && Is_caused_network_mess( service_type ) )
+			{
+				Survivor_ms[i] = Now_ms() - start;
+				num_left--;
+			}
+		}
+	}
+
+	worst = 0;
+	for( i=0; i < Num_survivors; i++ )
+	{
+		printf( "%-24s %10.1f ms\n", Survivor_names[i], Survivor_ms[i] );
+		if( Survivor_ms[i] > worst ) worst = Survivor_ms[i];
+	}
+	printf( "%-24s %10.1f ms\n", "all survivors", worst );
+
+	for( i=0; i < Num_survivors; i++ )
+		SP_disconnect( Survivor_mbox[i] );
+	return( 0 );
+}
@@ -0,0 +1,294 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+
+/*
+ * gap_bench: estimates ring throughput under a simulated round trip time
+ * for different MaxSeqGap settings. It links the daemon objects, and at
+ * every token visit asks the daemon's own FC_allowed how many new packets
+ * the holder may send, with Highest_seq, Aru and the token's flow_control
+ * set as the ring would have them; the packet store sizes come from
+ * Prot_packets_for_gap. Only the network is simulated: the token passes
+ * with a one way delay of half the RTT, packets leave at the link rate, a
+ * daemon's aru covers every packet sent at least one delay before it holds
+ * the token, and the token aru is the lowest aru reported around the ring.
+ * With large windows the gap is what bounds the packets in flight, so
+ * throughput follows gap / RTT until the link fills.
+ */
+
+#include "arch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "spread_params.h"
+#include "net_types.h"
+#include "protocol.h"
+#include "prot_body.h"
+#include "flow_control.h"
+#include "configuration.h"
+#include "spu_events.h"
+#include "spu_alarm.h"
+
+#define	MAX_BENCH_POINTS	16
+
+static	int	Num_procs     = 5;
+static	int	Window        = 20000;
+static	int	Pers_window   = 2000;
+static	int	Packet_bytes  = 1400;
+static	double	Link_mbps     = 1000.0;
+static	int	Num_rounds    = 500;
+
+static	double	Rtts_ms[MAX_BENCH_POINTS] = { 0.1, 1.0, 5.0, 20.0, 50.0 };
+static	int	Num_rtts = 5;
+static	int	Gaps[MAX_BENCH_POINTS]    = { 400, 1600, 6400, 25600, 100000 };
+static	int	Num_gaps = 5;
+
+static	double	*Send_time;
+static	int	Send_time_size;
+
+static	void	Usage( int argc, char *argv[] );
+
+static	void	Record_send( int seq, double when )
+{
+	if( seq >= Send_time_size )
+	{
+		Send_time_size = Send_time_size ? 2 * Send_time_size : 65536;
+		Send_time = realloc( Send_time, Send_time_size * sizeof(double) );
+		if( Send_time == NULL )
+		{
+			printf( "gap_bench: out of memory\n" );
+			exit( 1 );
+		}
+	}
+	Send_time[seq] = when;
+}
+
+/* number of packets that had left their sender by 'when' (send times only grow) */
+static	int	Sent_by( int highest, double when )
+{
+	int	lo, hi, mid;
+
+	lo = 0;
+	hi = highest;
+	while( lo < hi )
+	{
+		mid = ( lo + hi ) / 2;
+		if( Send_time[mid] <= when ) lo = mid + 1;
+		else hi = mid;
+	}
+	return( lo );
+}
+
+/* A configuration of this one daemon with the bench's windows, which FC_init reads */
+static	void	Init_daemon(void)
+{
+	char	conf_name[] = "/tmp/gap_bench.XXXXXX";
+	FILE	*fp;
+	int	fd;
+
+	fd = mkstemp( conf_name );
+	if( fd < 0 || ( fp = fdopen( fd, "w" ) ) == NULL )
+	{
+		printf( "gap_bench: cannot write a configuration file\n" );
+		exit( 1 );
+	}
+	fprintf( fp, "Spread_Segment 127.0.0.255:4803 {\n\tbench 127.0.0.1\n}\n" );
+	fclose( fp );
+
+	Alarm_set_types( NONE );
+	E_init();
+	Conf_init( conf_name, "bench" );
+	unlink( conf_name );
+	Conf_set_window( Window );
+	Conf_set_personal_window( Pers_window );
+}
+
+/* returns throughput in Mbit/s of the packets every daemon has received */
+static	double	Run_ring( double rtt_ms, int gap )
+{
+	int	*seen_aru, *last_sent;
+	double	delay, tx, now;
+	int	flow_control, allowed;
+	int	visit, d, i;
+
+	seen_aru  = calloc( Num_procs, sizeof(int) );
+	last_sent = calloc( Num_procs, sizeof(int) );
+	if( !seen_aru || !last_sent )
+	{
+		printf( "gap_bench: out of memory\n" );
+		exit( 1 );
+	}
+	Conf_set_max_seq_gap( gap );
+	FC_init();
+	FC_new_configuration();
+
+	delay        = rtt_ms / 2000.0;
+	tx           = Packet_bytes * 8.0 / ( Link_mbps * 1000000.0 );
+	now          = 0;
+	flow_control = 0;
+	Highest_seq  = 0;
+
+	for( visit=0; visit < Num_rounds * Num_procs; visit++ )
+	{
+		d = visit % Num_procs;
+
+		seen_aru[d] = Sent_by( Highest_seq, now - delay );
+		Aru = seen_aru[0];
+		for( i=1; i < Num_procs; i++ )
+			if( seen_aru[i] < Aru ) Aru = seen_aru[i];
+
+		allowed = FC_allowed( flow_control, 0 );
+		for( i=0; i < allowed; i++ )
+			Record_send( Highest_seq++, now + ( i + 1 ) * tx );
+
+		/* as Prot_handle_token updates the token's flow_control */
+		flow_control += allowed - last_sent[d];
+		last_sent[d] = allowed;
+		now += allowed * tx + delay;
+	}
+	Aru = Sent_by( Highest_seq, now - delay );
+
+	free( seen_aru );
+	free( last_sent );
+
+	return( (double) Aru * Packet_bytes * 8.0 / now / 1000000.0 );
+}
+
+int main( int argc, char *argv[] )
+{
+	int	r, g;
+
+	Usage( argc, argv );
+	Init_daemon();
+
+	printf( "gap_bench: %d daemons, Window %d, PersonalWindow %d, %d byte packets, %.0f Mbit/s link, %d rounds\n",
+		Num_procs, Window, Pers_window, Packet_bytes, Link_mbps, Num_rounds );
+	printf( "%-12s", "MaxSeqGap" );
+	for( g=0; g < Num_gaps; g++ )
+		printf( " %10d", Gaps[g] );
+	printf( "\n%-12s", "store" );
+	for( g=0; g < Num_gaps; g++ )
+		printf( " %10d", Prot_packets_for_gap( Gaps[g] ) );
+	printf( "\n" );
+
+	for( r=0; r < Num_rtts; r++ )
+	{
+		printf( "rtt %6.2fms", Rtts_ms[r] );
+		for( g=0; g < Num_gaps; g++ )
+			printf( " %10.1f", Run_ring( Rtts_ms[r], Gaps[g] ) );
+		printf( "\n" );
+	}
+	printf( "(throughput in Mbit/s)\n" );
+
+	return( 0 );
+}
+
+static	int	Parse_list( char *arg, double values[] )
+{
+	char	*tok;
+	int	n;
+
+	n = 0;
+	for( tok = strtok( arg, "," ); tok && n < MAX_BENCH_POINTS; tok = strtok( NULL, "," ) )
+		values[n++] = atof( tok );
+	return( n );
+}
+
+static	void	Usage( int argc, char *argv[] )
+{
+	double	values[MAX_BENCH_POINTS];
+	int	i;
+
+	for( --argc, ++argv; argc > 0; --argc, ++argv )
+	{
+		if( !strncmp( *argv, "-n", 2 ) && argc > 1 ){
+			Num_procs = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-w", 2 ) && argc > 1 ){
+			Window = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-p", 2 ) && argc > 1 ){
+			Pers_window = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-b", 2 ) && argc > 1 ){
+			Packet_bytes = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-l", 2 ) && argc > 1 ){
+			Link_mbps = atof( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-o", 2 ) && argc > 1 ){
+			Num_rounds = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-r", 2 ) && argc > 1 ){
+			Num_rtts = Parse_list( argv[1], Rtts_ms );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-g", 2 ) && argc > 1 ){
+			Num_gaps = Parse_list( argv[1], values );
+			for( i=0; i < Num_gaps; i++ )
+				Gaps[i] = (int) values[i];
+			--argc; ++argv;
+		}else{
+			printf( "Usage: gap_bench\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n%s\n",
+				"\t[-n <num>]   : daemons in the ring, default 5",
+				"\t[-w <num>]   : Window, default 20000",
+				"\t[-p <num>]   : PersonalWindow, default 2000",
+				"\t[-b <bytes>] : packet size, default 1400",
+				"\t[-l <mbps>]  : link rate in Mbit/s, default 1000",
+				"\t[-o <num>]   : token rounds to simulate, default 500",
+				"\t[-r <list>]  : comma separated RTTs in ms, default 0.1,1,5,20,50",
+				"\t[-g <list>]  : comma separated MaxSeqGap values, default 400,1600,6400,25600,100000" );
+			exit( 0 );
+		}
+	}
+	if( Num_procs    <= 0 ) Num_procs    = 1;
+	if( Num_rounds   <= 0 ) Num_rounds   = 1;
+	if( Packet_bytes <= 0 ) Packet_bytes = 1;
+	if( Link_mbps    <= 0 ) Link_mbps    = 1;
+	if( Num_rtts     <= 0 ) Num_rtts     = 1;
+	if( Num_gaps     <= 0 ) Num_gaps     = 1;
+	for( i=0; i < Num_gaps; i++ )
+	{
+		if( Gaps[i] < MIN_MAX_SEQ_GAP ) Gaps[i] = MIN_MAX_SEQ_GAP;
+		if( Gaps[i] > MAX_MAX_SEQ_GAP ) Gaps[i] = MAX_MAX_SEQ_GAP;
+	}
+	/* the daemon keeps its windows in 16 bits */
+	if( Window       <= 0 ) Window       = 1;
+	if( Window       > 32767 ) Window    = 32767;
+	if( Pers_window  <= 0 ) Pers_window  = 1;
+	if( Pers_window  > Window ) Pers_window = Window;
+}
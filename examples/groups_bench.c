@@ -0,0 +1,266 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+/*
+ * groups_bench: compares the two ways G_analize_groups has had of
+ * collecting the local sessions a multi-group multicast goes to. It links
+ * the daemon objects and times the daemon's own G_analize_groups against
+ * the former linear search, kept below as the baseline. GroupsList is
+ * filled with synthetic groups whose mailboxes draw members from a common
+ * set of sessions, so targeted groups overlap the way many subscribers of
+ * related groups do.
+ */
+
+#include "arch.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "spread_params.h"
+#include "net_types.h"
+#include "protocol.h"
+#include "sess_types.h"
+#include "sess_body.h"
+#include "groups.h"
+#include "configuration.h"
+#include "spu_events.h"
+#include "spu_alarm.h"
+
+typedef	struct dummy_bench_group {
+	char		name[MAX_GROUP_NAME];
+	mailbox		*mboxes;
+	int		size;
+} bench_group;
+
+static	int		Num_bench_groups   = 1000;
+static	int		Num_members        = 500;
+static	int		Num_bench_sessions = 997;
+static	int		Num_targets        = 100;
+static	int		Num_ops            = 2000;
+
+static	bench_group	*Bench_groups;
+static	mailbox		*Mboxes;
+
+static	void	Usage( int argc, char *argv[] );
+
+static	double	Now_usec(void)
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000000.0 + tv.tv_usec );
+}
+
+/* The former G_analize_groups: a linear search of the mailboxes collected so far */
+static	int	Analize_linear( int num_groups, int targets[], int target_sessions[] )
+{
+	mailbox	*bigbox_ptr, *bigend_ptr;
+	mailbox	*litbox_ptr, *litend_ptr;
+	int	num_mbox;
+	int	i, n;
+
+	num_mbox = 0;
+	for( i=0; i < num_groups; i++ )
+	{
+		litbox_ptr = Bench_groups[targets[i]].mboxes;
+		litend_ptr = litbox_ptr + Bench_groups[targets[i]].size;
+		if( num_mbox != 0 )
+		{
+			bigend_ptr = Mboxes + num_mbox;
+			for( ; litbox_ptr != litend_ptr; ++litbox_ptr )
+			{
+				for( bigbox_ptr = Mboxes; bigbox_ptr != bigend_ptr && *bigbox_ptr != *litbox_ptr; ++bigbox_ptr );
+				if( bigbox_ptr == bigend_ptr )
+					Mboxes[ num_mbox++ ] = *litbox_ptr;
+			}
+		}else{
+			num_mbox = litend_ptr - litbox_ptr;
+			memcpy( Mboxes, litbox_ptr, num_mbox * sizeof(mailbox) );
+		}
+	}
+	for( n=0; n < num_mbox; n++ )
+		target_sessions[n] = Sess_get_session_index( Mboxes[n] );
+
+	return( num_mbox );
+}
+
+/* A configuration of this one daemon, which G_init needs */
+static	void	Init_daemon(void)
+{
+	char	conf_name[] = "/tmp/groups_bench.XXXXXX";
+	FILE	*fp;
+	int	fd;
+
+	fd = mkstemp( conf_name );
+	if( fd < 0 || ( fp = fdopen( fd, "w" ) ) == NULL )
+	{
+		printf( "groups_bench: cannot write a configuration file\n" );
+		exit( 1 );
+	}
+	fprintf( fp, "Spread_Segment 127.0.0.255:4803 {\n\tbench 127.0.0.1\n}\n" );
+	fclose( fp );
+
+	Alarm_set_types( NONE );
+	E_init();
+	Conf_init( conf_name, "bench" );
+	unlink( conf_name );
+	G_init();
+}
+
+static	void	Build_groups(void)
+{
+	int		*pick;
+	int		i, j, k, tmp;
+
+	Mboxes       = malloc( Num_bench_sessions * sizeof(mailbox) );
+	pick         = malloc( Num_bench_sessions * sizeof(int) );
+	Bench_groups = malloc( Num_bench_groups * sizeof(bench_group) );
+	if( !Mboxes || !pick || !Bench_groups )
+	{
+		printf( "groups_bench: out of memory\n" );
+		exit( 1 );
+	}
+	/* mailboxes are socket numbers: a few taken by the daemon, then the sessions */
+	for( i=0; i < Num_bench_sessions; i++ )
+	{
+		Sess_bench_session( i, 13 + i );
+		pick[i] = i;
+	}
+	/* each group holds a random subset of the sessions, without duplicates like grp->mboxes */
+	for( i=0; i < Num_bench_groups; i++ )
+	{
+		snprintf( Bench_groups[i].name, MAX_GROUP_NAME, "group%d", i );
+		Bench_groups[i].size   = Num_members;
+		Bench_groups[i].mboxes = malloc( Num_members * sizeof(mailbox) );
+		for( j=0; j < Num_members; j++ )
+		{
+			k = j + rand() % ( Num_bench_sessions - j );
+			tmp = pick[j]; pick[j] = pick[k]; pick[k] = tmp;
+			Bench_groups[i].mboxes[j] = 13 + pick[j];
+		}
+		G_bench_group( Bench_groups[i].name, Bench_groups[i].mboxes, Num_members );
+	}
+	free( pick );
+}
+
+int main( int argc, char *argv[] )
+{
+	double	start, linear, stamped;
+	int	*targets, *target_sessions;
+	char	(*target_groups)[MAX_GROUP_NAME];
+	int	num_linear, num_stamped;
+	int	i, j;
+
+	Usage( argc, argv );
+
+	srand( 1 );
+	Init_daemon();
+	Build_groups();
+	targets         = malloc( Num_targets * sizeof(int) );
+	target_groups   = malloc( Num_targets * MAX_GROUP_NAME );
+	target_sessions = malloc( Num_bench_sessions * sizeof(int) );
+
+	linear = stamped = 0;
+	num_linear = num_stamped = 0;
+	for( i=0; i < Num_ops; i++ )
+	{
+		for( j=0; j < Num_targets; j++ )
+		{
+			targets[j] = rand() % Num_bench_groups;
+			memcpy( target_groups[j], Bench_groups[targets[j]].name, MAX_GROUP_NAME );
+		}
+
+		start = Now_usec();
+		num_linear = Analize_linear( Num_targets, targets, target_sessions );
+		linear += Now_usec() - start;
+
+		start = Now_usec();
+		num_stamped = G_analize_groups( Num_targets, target_groups, target_sessions );
+		stamped += Now_usec() - start;
+
+		if( num_linear != num_stamped )
+		{
+			printf( "groups_bench: linear found %d sessions, G_analize_groups found %d\n", num_linear, num_stamped );
+			exit( 1 );
+		}
+	}
+
+	printf("groups_bench: %d groups of %d members over %d sessions, %d groups per message, %d messages\n",
+	       Num_bench_groups, Num_members, Num_bench_sessions, Num_targets, Num_ops );
+	printf("%-24s %12s %12s\n", "", "linear (us)", "stamped (us)" );
+	printf("%-24s %12.3f %12.3f\n", "per message", linear / Num_ops, stamped / Num_ops );
+
+	return( 0 );
+}
+
+static	void	Usage( int argc, char *argv[] )
+{
+	for( --argc, ++argv; argc > 0; --argc, ++argv )
+	{
+		if( !strncmp( *argv, "-g", 2 ) && argc > 1 ){
+			Num_bench_groups = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-m", 2 ) && argc > 1 ){
+			Num_members = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-s", 2 ) && argc > 1 ){
+			Num_bench_sessions = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-t", 2 ) && argc > 1 ){
+			Num_targets = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-o", 2 ) && argc > 1 ){
+			Num_ops = atoi( argv[1] );
+			--argc; ++argv;
+		}else{
+			printf( "Usage: groups_bench\n%s\n%s\n%s\n%s\n%s\n",
+				"\t[-g <num>]   : number of groups, default 1000",
+				"\t[-m <num>]   : members in each group, default 500",
+				"\t[-s <num>]   : number of local sessions, default 997",
+				"\t[-t <num>]   : groups each message is sent to, default 100",
+				"\t[-o <num>]   : number of messages to time, default 2000" );
+			exit( 0 );
+		}
+	}
+	if( Num_bench_sessions <= 0 ) Num_bench_sessions = 1;
+	if( Num_bench_sessions > MAX_SESSIONS ) Num_bench_sessions = MAX_SESSIONS;
+	if( Num_bench_groups   <= 0 ) Num_bench_groups   = 1;
+	if( Num_targets  <= 0 ) Num_targets  = 1;
+	if( Num_members > Num_bench_sessions ) Num_members = Num_bench_sessions;
+	if( Num_members < 0 ) Num_members = 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+/*
+ * mt_bench: threads each calling the library on a mailbox of their own,
+ * to see how the library scales with them. For each thread count every
+ * thread connects its own session and then, for the given time, either
+ * calls SP_poll (-m poll, the session lookup and little else) or sends
+ * small messages to a group nobody has joined in batches (-m send). The
+ * total calls per second is printed for each count. Build against the
+ * threaded library (libtspread-core).
+ *
+ *   mt_bench -s 4803 -m poll -t 1,2,4,8,16,32 -d 2
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+#include "sp.h"
+
+#define	MAX_BENCH_THREADS	64
+#define	MAX_BENCH_POINTS	16
+#define	SEND_BATCH		100
+#define	MESS_LEN		32
+
+static	char	*Spread_name = "4803";
+static	int	Send_mode = 0;
+static	int	Num_points = 0;
+static	int	Thread_counts[MAX_BENCH_POINTS];
+static	int	Secs = 2;
+
+static	volatile int	Go;
+static	volatile int	Stop;
+
+typedef	struct	dummy_bench_thread {
+	pthread_t	thread;
+	mailbox		mbox;
+	double		calls;
+} bench_thread;
+
+static	bench_thread	Threads[MAX_BENCH_THREADS];
+
+static	void	Usage( char *exe )
+{
+	fprintf( stderr, "Usage: %s\n"
+		"\t[-s <daemon>]       : daemon to connect to (default %s)\n"
+		"\t[-m poll|send]      : call SP_poll, or multicast in batches (default poll)\n"
+		"\t[-t <n,n,...>]      : thread counts to run (default 1,2,4,8,16,32)\n"
+		"\t[-d <secs>]         : time for each thread count (default %d)\n",
+		exe, Spread_name, Secs );
+	exit( 1 );
+}
+
+static	void	Bail( char *what, int ret )
+{
+	fprintf( stderr, "mt_bench: %s: ", what );
+	SP_error( ret );
+	exit( 1 );
+}
+
+static	void	*Run_thread( void *arg )
+{
+	bench_thread	*t = arg;
+	char		mess[MESS_LEN];
+	double		calls;
+	int		i, ret;
+
+	memset( mess, 'x', sizeof(mess) );
+	while( !Go ) usleep( 100 );
+
+	for( calls = 0; !Stop; )
+	{
+		if( !Send_mode )
+		{
+			ret = SP_poll( t->mbox );
+			if( ret < 0 ) Bail( "SP_poll", ret );
+			calls++;
+			continue;
+		}
+		ret = SP_batch_begin( t->mbox );
+		if( ret < 0 ) Bail( "SP_batch_begin", ret );
+		for( i=0; i < SEND_BATCH; i++ )
+		{
+			ret = SP_multicast( t->mbox, RELIABLE_MESS, "mt_bench", 0, sizeof(mess), mess );
+			if( ret < 0 ) Bail( "SP_multicast", ret );
+		}
+		ret = SP_batch_flush( t->mbox );
+		if( ret < 0 ) Bail( "SP_batch_flush", ret );
+		calls += SEND_BATCH + 2;
+	}
+	t->calls = calls;
+	return( NULL );
+}
+
+static	double	Run( int num_threads )
+{
+	char		private_group[MAX_GROUP_NAME];
+	struct timeval	start, end;
+	double		calls, secs;
+	int		i, ret;
+
+	Go = Stop = 0;
+	for( i=0; i < num_threads; i++ )
+	{
+		ret = SP_connect( Spread_name, NULL, 0, 0, &Threads[i].mbox, private_group );
+		if( ret != ACCEPT_SESSION ) Bail( "SP_connect", ret );
+		if( pthread_create( &Threads[i].thread, NULL, Run_thread, &Threads[i] ) != 0 )
+		{
+			fprintf( stderr, "mt_bench: could not start thread %d\n", i );
+			exit( 1 );
+		}
+	}
+
+	gettimeofday( &start, NULL );
+	Go = 1;
+	sleep( Secs );
+	Stop = 1;
+
+	for( i=0, calls=0; i < num_threads; i++ )
+	{
+		pthread_join( Threads[i].thread, NULL );
+		calls += Threads[i].calls;
+	}
+	gettimeofday( &end, NULL );
+	for( i=0; i < num_threads; i++ )
+		SP_disconnect( Threads[i].mbox );
+
+	secs = ( end.tv_sec - start.tv_sec ) + ( end.tv_usec - start.tv_usec ) / 1000000.0;
+	return( calls / secs );
+}
+
+static	void	Parse_counts( char *list )
+{
+	char	*p;
+
+	for( p = strtok( list, "," ); p != NULL; p = strtok( NULL, "," ) )
+	{
+		if( Num_points == MAX_BENCH_POINTS ) break;
+		Thread_counts[Num_points] = atoi( p );
+		if( Thread_counts[Num_points] <= 0 || Thread_counts[Num_points] > MAX_BENCH_THREADS )
+			Usage( "mt_bench" );
+		Num_points++;
+	}
+}
+
+int	main( int argc, char *argv[] )
+{
+	char	counts[] = "1,2,4,8,16,32";
+	double	rate, one;
+	int	i;
+
+	for( i=1; i < argc; i++ )
+	{
+		if( i+1 >= argc ) Usage( argv[0] );
+		if(      !strcmp( argv[i], "-s" ) ) Spread_name = argv[++i];
+		else if( !strcmp( argv[i], "-m" ) ) Send_mode = !strcmp( argv[++i], "send" );
+		else if( !strcmp( argv[i], "-t" ) ) Parse_counts( argv[++i] );
+		else if( !strcmp( argv[i], "-d" ) ) Secs = atoi( argv[++i] );
+		else Usage( argv[0] );
+	}
+	if( Num_points == 0 ) Parse_counts( counts );
+	if( Secs <= 0 ) Usage( argv[0] );
+
+	printf( "%s on %s, %d s per point\n", Send_mode ? "SP_multicast" : "SP_poll", Spread_name, Secs );
+	printf( "threads       calls/s   per thread   vs 1 thread\n" );
+	for( i=0, one=0; i < Num_points; i++ )
+	{
+		rate = Run( Thread_counts[i] );
+		if( one == 0 ) one = rate / Thread_counts[i];
+		printf( "%7d  %12.0f %12.0f %10.2fx\n", Thread_counts[i], rate,
+			rate / Thread_counts[i], rate / one );
+		fflush( stdout );
+	}
+	return( 0 );
+}
@@ -0,0 +1,235 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+
+/*
+ * nb_bench: one thread multiplexing many mailboxes with poll() and the
+ * non-blocking libspread API. Every receiver mailbox joins a group a
+ * sender mailbox multicasts to; the loop calls SP_receive_many on each
+ * readable receiver until it says it needs more, and feeds the sender
+ * whenever it is writable and the slowest receiver is within a window.
+ * Connect with a port alone to use the local unix domain socket.
+ *
+ *   nb_bench -s 4803 -r 100 -n 20000 -l 64
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <poll.h>
+#include <sys/time.h>
+
+#include "sp.h"
+
+#define	MAX_BENCH_RECEIVERS	1000
+#define	MAX_BENCH_MESS		100000
+#define	BATCH			64
+#define	SEND_WINDOW		500	/* well under the daemon's MaxSessionMessages */
+
+static	char	*Spread_name = "4803";
+static	int	Num_receivers = 100;
+static	int	Num_messages = 20000;
+static	int	Mess_len = 64;
+
+static	mailbox	Send_mbox;
+static	mailbox	Recv_mbox[MAX_BENCH_RECEIVERS];
+static	int	Received[MAX_BENCH_RECEIVERS];
+static	int	Joined[MAX_BENCH_RECEIVERS];
+static	struct pollfd	Fds[MAX_BENCH_RECEIVERS+1];
+static	char	Mess[MAX_BENCH_MESS];
+static	sp_message	Batch_mess[BATCH];
+
+static	int	Sent;
+static	int	Pending;	/* bytes the sender has queued */
+static	int	Empty_calls;	/* SP_receive_many calls that needed more */
+static	int	Calls;
+
+static	double	Now_ms( void )
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0 );
+}
+
+static	void	Usage( char *exe )
+{
+	fprintf( stderr, "Usage: %s\n"
+		"\t[-s <daemon>]       : daemon to connect to (default %s)\n"
+		"\t[-r <receivers>]    : receiver mailboxes (default %d)\n"
+		"\t[-n <messages>]     : messages multicast (default %d)\n"
+		"\t[-l <bytes>]        : message length (default %d)\n",
+		exe, Spread_name, Num_receivers, Num_messages, Mess_len );
+	exit( 1 );
+}
+
+static	void	Bail( char *what, int ret )
+{
+	fprintf( stderr, "nb_bench: %s: ", what );
+	SP_error( ret );
+	exit( 1 );
+}
+
+/* takes what receiver r has until it needs more */
+static	void	Drain( int r )
+{
+	int	i, ret;
+
+	for( ;; )
+	{
+		ret = SP_receive_many( Recv_mbox[r], BATCH, Batch_mess );
+		if( ret < 0 ) Bail( "SP_receive_many", ret );
+		Calls++;
+		if( ret == 0 ) {
+			Empty_calls++;
+			return;
+		}
+		for( i=0; i < ret; i++ )
+		{
+			if( Is_regular_mess( Batch_mess[i].service_type ) ) Received[r]++;
+			else if( Is_reg_memb_mess( Batch_mess[i].service_type ) ) Joined[r] = 1;
+		}
+	}
+}
+
+static	int	Slowest( void )
+{
+	int	r, min;
+
+	for( min = Num_messages, r=0; r < Num_receivers; r++ )
+		if( Received[r] < min ) min = Received[r];
+	return( min );
+}
+
+/* multicasts while the window allows, until the socket pushes back */
+static	void	Feed( void )
+{
+	int	ret;
+
+	if( Pending > 0 )
+	{
+		Pending = SP_send_pending( Send_mbox );
+		if( Pending < 0 ) Bail( "SP_send_pending", Pending );
+	}
+	while( Pending == 0 && Sent < Num_messages && Sent - Slowest() < SEND_WINDOW )
+	{
+		ret = SP_multicast( Send_mbox, RELIABLE_MESS, "nb_bench", 0, Mess_len, Mess );
+		if( ret < 0 ) Bail( "SP_multicast", ret );
+		Sent++;
+		Pending = SP_send_pending( Send_mbox );
+		if( Pending < 0 ) Bail( "SP_send_pending", Pending );
+	}
+}
+
+/* runs the loop until every receiver is joined or has every message */
+static	void	Run( int joining )
+{
+	int	r, done, ret;
+
+	for( ;; )
+	{
+		for( done = 1, r=0; r < Num_receivers; r++ )
+			if( joining ? !Joined[r] : Received[r] < Num_messages ) done = 0;
+		if( done ) return;
+
+		if( !joining ) Feed();
+		for( r=0; r < Num_receivers; r++ )
+		{
+			Fds[r].fd = Recv_mbox[r];
+			Fds[r].events = POLLIN;
+		}
+		Fds[r].fd = Send_mbox;
+		Fds[r].events = ( Pending > 0 ? POLLOUT : 0 );
+
+		ret = poll( Fds, Num_receivers+1, 1000 );
+		if( ret < 0 ) {
+			perror( "nb_bench: poll" );
+			exit( 1 );
+		}
+		for( r=0; r < Num_receivers; r++ )
+			if( Fds[r].revents ) Drain( r );
+	}
+}
+
+int	main( int argc, char *argv[] )
+{
+	char	private_group[MAX_GROUP_NAME];
+	double	start, ms;
+	int	i, ret;
+
+	for( i=1; i < argc; i++ )
+	{
+		if( i+1 >= argc ) Usage( argv[0] );
+		if(      !strcmp( argv[i], "-s" ) ) Spread_name = argv[++i];
+		else if( !strcmp( argv[i], "-r" ) ) Num_receivers = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-n" ) ) Num_messages = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-l" ) ) Mess_len = atoi( argv[++i] );
+		else Usage( argv[0] );
+	}
+	if( Num_receivers <= 0 || Num_receivers > MAX_BENCH_RECEIVERS ||
+	    Num_messages <= 0 || Mess_len < 0 || Mess_len > MAX_BENCH_MESS ) Usage( argv[0] );
+
+	ret = SP_connect( Spread_name, NULL, 0, 0, &Send_mbox, private_group );
+	if( ret != ACCEPT_SESSION ) Bail( "connecting the sender", ret );
+	ret = SP_set_nonblocking( Send_mbox, 1 );
+	if( ret < 0 ) Bail( "SP_set_nonblocking", ret );
+	for( i=0; i < Num_receivers; i++ )
+	{
+		ret = SP_connect( Spread_name, NULL, 0, 1, &Recv_mbox[i], private_group );
+		if( ret != ACCEPT_SESSION ) Bail( "connecting a receiver", ret );
+		ret = SP_set_nonblocking( Recv_mbox[i], 1 );
+		if( ret < 0 ) Bail( "SP_set_nonblocking", ret );
+		ret = SP_join( Recv_mbox[i], "nb_bench" );
+		if( ret < 0 ) Bail( "SP_join", ret );
+	}
+	/* messages sent before a join is in would not reach that receiver */
+	Run( 1 );
+	memset( Mess, 'x', sizeof(Mess) );
+
+	start = Now_ms();
+	Run( 0 );
+	ms = Now_ms() - start;
+
+	printf( "%d messages of %d bytes to %d receivers from %s, one thread\n",
+		Num_messages, Mess_len, Num_receivers, Spread_name );
+	printf( "%8.1f ms  %10.0f deliveries/s  (%d SP_receive_many calls, %d needed more)\n",
+		ms, (double) Num_messages * Num_receivers / ( ms / 1000.0 ), Calls, Empty_calls );
+
+	for( i=0; i < Num_receivers; i++ )
+		SP_disconnect( Recv_mbox[i] );
+	SP_disconnect( Send_mbox );
+	return( 0 );
+}
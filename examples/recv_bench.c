@@ -0,0 +1,271 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+/*
+ * recv_bench: compares SP_receive with SP_receive_many and
+ * SP_receive_buffer on a stream of small messages. One session multicasts
+ * a window of messages to a group another session in the same process has
+ * joined, then the receiver drains the window, first one SP_receive call
+ * per message, then with SP_receive_many, then one SP_receive_buffer call
+ * per message, releasing each buffer after a look at the data. The bench waits for the daemon to deliver the window
+ * before it starts the clock, so the time reported is the library's.
+ * Connect with a port alone to use the local unix domain socket.
+ *
+ *   recv_bench -s 4803 -n 200000 -l 64 -b 64
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "sp.h"
+
+#define	MAX_BENCH_BATCH		1024
+#define	MAX_BENCH_MESS		100000
+#define	SEND_WINDOW		500	/* well under the daemon's MaxSessionMessages */
+
+static	char	*Spread_name = "4803";
+static	int	Num_messages = 200000;
+static	int	Mess_len = 64;
+static	int	Batch = 64;
+
+static	mailbox	Send_mbox;
+static	mailbox	Recv_mbox;
+static	char	Mess[MAX_BENCH_MESS];
+static	sp_message	Batch_mess[MAX_BENCH_BATCH];
+
+static	double	Now_ms( void )
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0 );
+}
+
+static	void	Usage( char *exe )
+{
+	fprintf( stderr, "Usage: %s\n"
+		"\t[-s <daemon>]       : daemon to connect to (default %s)\n"
+		"\t[-n <messages>]     : messages received with each call (default %d)\n"
+		"\t[-l <bytes>]        : message length (default %d)\n"
+		"\t[-b <batch>]        : max_messages for SP_receive_many (default %d)\n",
+		exe, Spread_name, Num_messages, Mess_len, Batch );
+	exit( 1 );
+}
+
+static	void	Bail( char *what, int ret )
+{
+	fprintf( stderr, "recv_bench: %s: ", what );
+	SP_error( ret );
+	exit( 1 );
+}
+
+static	void	Send_window( int num )
+{
+	int	i, ret;
+
+	for( i=0; i < num; i++ )
+	{
+		ret = SP_multicast( Send_mbox, RELIABLE_MESS, "recv_bench", 0, Mess_len, Mess );
+		if( ret < 0 ) Bail( "SP_multicast", ret );
+	}
+}
+
+static	void	Wait_joined( void )
+{
+	static	char	groups[4][MAX_GROUP_NAME];
+	char		sender[MAX_GROUP_NAME];
+	service		service_type;
+	int16		mess_type;
+	int		endian_mismatch;
+	int		num_groups;
+	int		ret;
+
+	do{
+		service_type = 0;
+		ret = SP_receive( Recv_mbox, &service_type, sender, 4, &num_groups, groups,
+				  &mess_type, &endian_mismatch, sizeof(Mess), Mess );
+		if( ret < 0 ) Bail( "SP_receive", ret );
+	}while( !Is_reg_memb_mess( service_type ) );
+}
+
+/* waits until the bytes waiting on the receiver stop growing */
+static	void	Wait_delivered( void )
+{
+	int	last, now;
+
+	last = -1;
+	while( ( now = SP_poll( Recv_mbox ) ) != last || now == 0 )
+	{
+		last = now;
+		usleep( 2000 );
+	}
+}
+
+/* receives num messages one call each; returns the ms spent receiving */
+static	double	Receive_single( int num )
+{
+	static	char	groups[4][MAX_GROUP_NAME];
+	char		sender[MAX_GROUP_NAME];
+	service		service_type;
+	int16		mess_type;
+	int		endian_mismatch;
+	int		num_groups;
+	double		start;
+	int		i, ret;
+
+	start = Now_ms();
+	for( i=0; i < num; )
+	{
+		service_type = 0;
+		ret = SP_receive( Recv_mbox, &service_type, sender, 4, &num_groups, groups,
+				  &mess_type, &endian_mismatch, sizeof(Mess), Mess );
+		if( ret < 0 ) Bail( "SP_receive", ret );
+		if( Is_regular_mess( service_type ) ) i++;
+	}
+	return( Now_ms() - start );
+}
+
+/* receives num messages in batches; returns the ms spent receiving */
+static	double	Receive_many( int num, int *calls )
+{
+	double		start;
+	int		i, j, ret;
+
+	start = Now_ms();
+	for( i=0; i < num; )
+	{
+		ret = SP_receive_many( Recv_mbox, Batch, Batch_mess );
+		if( ret < 0 ) Bail( "SP_receive_many", ret );
+		(*calls)++;
+		for( j=0; j < ret; j++ )
+			if( Is_regular_mess( Batch_mess[j].service_type ) ) i++;
+	}
+	return( Now_ms() - start );
+}
+
+/* receives num messages into pooled buffers; returns the ms spent receiving */
+static	double	Receive_buffer( int num )
+{
+	sp_message	mess;
+	sp_buffer	*buf;
+	double		start;
+	int		i, ret;
+
+	start = Now_ms();
+	for( i=0; i < num; )
+	{
+		ret = SP_receive_buffer( Recv_mbox, &mess, &buf );
+		if( ret < 0 ) Bail( "SP_receive_buffer", ret );
+		if( Is_regular_mess( mess.service_type ) && ( mess.data_len == 0 || mess.data[0] == 'x' ) ) i++;
+		SP_buffer_release( buf );
+	}
+	return( Now_ms() - start );
+}
+
+int	main( int argc, char *argv[] )
+{
+	char	private_group[MAX_GROUP_NAME];
+	double	single_ms, many_ms, buffer_ms;
+	int	calls, window, sent, i, ret;
+
+	for( i=1; i < argc; i++ )
+	{
+		if( i+1 >= argc ) Usage( argv[0] );
+		if(      !strcmp( argv[i], "-s" ) ) Spread_name = argv[++i];
+		else if( !strcmp( argv[i], "-n" ) ) Num_messages = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-l" ) ) Mess_len = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-b" ) ) Batch = atoi( argv[++i] );
+		else Usage( argv[0] );
+	}
+	if( Num_messages <= 0 || Mess_len < 0 || Mess_len > MAX_BENCH_MESS ||
+	    Batch <= 0 || Batch > MAX_BENCH_BATCH ) Usage( argv[0] );
+
+	ret = SP_connect( Spread_name, NULL, 0, 0, &Send_mbox, private_group );
+	if( ret != ACCEPT_SESSION ) Bail( "connecting the sender", ret );
+	ret = SP_connect( Spread_name, NULL, 0, 1, &Recv_mbox, private_group );
+	if( ret != ACCEPT_SESSION ) Bail( "connecting the receiver", ret );
+	ret = SP_join( Recv_mbox, "recv_bench" );
+	if( ret < 0 ) Bail( "SP_join", ret );
+	/* messages sent before the join is in would not reach the receiver */
+	Wait_joined();
+	memset( Mess, 'x', sizeof(Mess) );
+
+	single_ms = 0;
+	for( sent=0; sent < Num_messages; sent += window )
+	{
+		window = Num_messages - sent;
+		if( window > SEND_WINDOW ) window = SEND_WINDOW;
+		Send_window( window );
+		Wait_delivered();
+		single_ms += Receive_single( window );
+	}
+
+	many_ms = 0;
+	calls = 0;
+	for( sent=0; sent < Num_messages; sent += window )
+	{
+		window = Num_messages - sent;
+		if( window > SEND_WINDOW ) window = SEND_WINDOW;
+		Send_window( window );
+		Wait_delivered();
+		many_ms += Receive_many( window, &calls );
+	}
+
+	buffer_ms = 0;
+	for( sent=0; sent < Num_messages; sent += window )
+	{
+		window = Num_messages - sent;
+		if( window > SEND_WINDOW ) window = SEND_WINDOW;
+		Send_window( window );
+		Wait_delivered();
+		buffer_ms += Receive_buffer( window );
+	}
+
+	printf( "%d messages of %d bytes from %s\n", Num_messages, Mess_len, Spread_name );
+	printf( "SP_receive:      %8.1f ms  %10.0f msgs/s\n",
+		single_ms, Num_messages / ( single_ms / 1000.0 ) );
+	printf( "SP_receive_many: %8.1f ms  %10.0f msgs/s  (%d calls, %.1f messages per call, batch %d)\n",
+		many_ms, Num_messages / ( many_ms / 1000.0 ), calls, (double) Num_messages / calls, Batch );
+	printf( "SP_receive_buffer: %6.1f ms  %10.0f msgs/s\n",
+		buffer_ms, Num_messages / ( buffer_ms / 1000.0 ) );
+
+	SP_disconnect( Recv_mbox );
+	SP_disconnect( Send_mbox );
+	return( 0 );
+}
@@ -0,0 +1,360 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+
+/*
+ * selective_bench: the loopback harness for SelectiveDelivery. It runs a
+ * ring of daemons on one host, each in its own segment, and streams
+ * messages from a publisher on one daemon to subscribers on some of the
+ * others; the rest of the daemons host no member of the group. The
+ * subscribers check that every message arrives once and in order, and the
+ * bench prints the throughput and the time from send to delivery. Compare
+ * runs with and without SelectiveDelivery in spread.conf; spmonitor shows
+ * the placeholders the idle daemons received instead of the payloads.
+ *
+ * Loopback addresses make one segment per daemon, e.g. in spread.conf
+ *
+ *   Spread_Segment 127.0.0.1:4803 { d1 127.0.0.1 }
+ *   Spread_Segment 127.0.0.2:4813 { d2 127.0.0.2 }
+ *   Spread_Segment 127.0.0.3:4823 { d3 127.0.0.3 }
+ *   Spread_Segment 127.0.0.4:4833 { d4 127.0.0.4 }
+ *
+ * then "spread -n d1", ..., "spread -n d4", and
+ *
+ *   selective_bench -p 4803@127.0.0.1 -s 4813@127.0.0.2 -n 100000 -b 1000
+ *
+ * leaves d3 and d4 idle.
+ *
+ * With -i the bench also joins a probe group on an idle daemon and sends
+ * it a short message after every -e messages of the stream. An idle
+ * daemon delivers nothing past a placeholder until the token's aru covers
+ * it, so the probe latency shows what SelectiveDelivery costs the other
+ * groups of a daemon that is not interested in the stream:
+ *
+ *   selective_bench -p 4803@127.0.0.1 -s 4813@127.0.0.2 -i 4823@127.0.0.3
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+
+#include "sp.h"
+
+#define	MAX_SUBSCRIBERS		16
+#define	MAX_BENCH_GROUPS	(MAX_SUBSCRIBERS+1)
+#define	MAX_BENCH_MESS		100000
+
+typedef	struct	dummy_bench_stamp {
+	int32	seq;
+	int32	sec;
+	int32	usec;
+} bench_stamp;
+
+static	char	Group[MAX_GROUP_NAME] = "selective_bench";
+static	char	*Publisher_name;
+static	char	*Subscriber_names[MAX_SUBSCRIBERS];
+static	int	Num_subscribers;
+static	int	Num_mess = 100000;
+static	int	Mess_len = 1000;
+static	int	Window = 200;
+static	char	Probe_group[MAX_GROUP_NAME];
+static	char	*Probe_name;
+static	int	Probe_every = 100;
+
+static	mailbox	Publisher_mbox;
+static	mailbox	Subscriber_mbox[MAX_SUBSCRIBERS];
+static	int	Received[MAX_SUBSCRIBERS];
+static	double	Latency_sum;
+static	double	Latency_max;
+static	mailbox	Probe_mbox;
+static	int	Probes_sent;
+static	int	Probes_received;
+static	double	Probe_latency_sum;
+static	double	Probe_latency_max;
+static	char	Mess[MAX_BENCH_MESS];
+
+static	double	Now_ms( void )
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0 );
+}
+
+static	void	Usage( char *exe )
+{
+	fprintf( stderr, "Usage: %s -p <publisher daemon> -s <subscriber daemon> [-s ...]\n"
+		"\t[-g <group>]        : group to stream to (default %s)\n"
+		"\t[-n <messages>]     : messages to send (default %d)\n"
+		"\t[-b <bytes>]        : message size (default %d, at most %d)\n"
+		"\t[-w <messages>]     : messages in flight to the slowest subscriber (default %d)\n"
+		"\t[-i <idle daemon>]  : time probes to a group on a daemon outside the stream\n"
+		"\t[-e <messages>]     : stream messages between probes (default %d)\n",
+		exe, Group, Num_mess, Mess_len, MAX_BENCH_MESS, Window, Probe_every );
+	exit( 1 );
+}
+
+static	void	Connect( char *daemon, mailbox *mbox, char *group )
+{
+	char	private_group[MAX_GROUP_NAME];
+	int	ret;
+
+	ret = SP_connect( daemon, NULL, 0, 1, mbox, private_group );
+	if( ret != ACCEPT_SESSION )
+	{
+		fprintf( stderr, "selective_bench: connecting to %s: ", daemon );
+		SP_error( ret );
+		exit( 1 );
+	}
+	if( group == NULL ) return;
+	ret = SP_join( *mbox, group );
+	if( ret < 0 )
+	{
+		SP_error( ret );
+		exit( 1 );
+	}
+}
+
+/* receives one message into Mess; returns its service type, and the member count for memberships */
+static	service	Receive( mailbox mbox, int *num_members, int *len )
+{
+	static	char	groups[MAX_BENCH_GROUPS][MAX_GROUP_NAME];
+	char		sender[MAX_GROUP_NAME];
+	service		service_type;
+	int16		mess_type;
+	int		endian_mismatch;
+	int		ret;
+
+	service_type = 0;
+	ret = SP_receive( mbox, &service_type, sender, MAX_BENCH_GROUPS, num_members, groups,
+			  &mess_type, &endian_mismatch, sizeof(Mess), Mess );
+	if( ret < 0 )
+	{
+		fprintf( stderr, "selective_bench: " );
+		SP_error( ret );
+		exit( 1 );
+	}
+	*len = ret;
+	return( service_type );
+}
+
+/* waits until every subscriber sees all the others in the group, and the probe its own join */
+static	void	Settle( void )
+{
+	int	i, len, num_members;
+	service	service_type;
+
+	for( i=0; i < Num_subscribers; i++ )
+	{
+		do {
+			service_type = Receive( Subscriber_mbox[i], &num_members, &len );
+		} while( !Is_reg_memb_mess( service_type ) || num_members < Num_subscribers );
+	}
+	if( Probe_name == NULL ) return;
+	do {
+		service_type = Receive( Probe_mbox, &num_members, &len );
+	} while( !Is_reg_memb_mess( service_type ) );
+}
+
+/* takes one message off subscriber i, checking that it is the next one */
+static	void	Deliver( int i )
+{
+	bench_stamp	stamp;
+	double		latency;
+	int		len, num_members;
+	service		service_type;
+
+	service_type = Receive( Subscriber_mbox[i], &num_members, &len );
+	if( !Is_regular_mess( service_type ) )
+	{
+		if( Is_membership_mess( service_type ) )
+			fprintf( stderr, "selective_bench: membership changed on %s during the run\n", Subscriber_names[i] );
+		return;
+	}
+	memcpy( &stamp, Mess, sizeof(stamp) );
+	if( len != Mess_len || stamp.seq != Received[i] )
+	{
+		fprintf( stderr, "selective_bench: %s got message %d (%d bytes), expected %d (%d bytes)\n",
+			 Subscriber_names[i], stamp.seq, len, Received[i], Mess_len );
+		exit( 1 );
+	}
+	Received[i]++;
+
+	latency = Now_ms() - ( stamp.sec * 1000.0 + stamp.usec / 1000.0 );
+	Latency_sum += latency;
+	if( latency > Latency_max ) Latency_max = latency;
+}
+
+/* takes one message off the probe session */
+static	void	Deliver_probe( void )
+{
+	bench_stamp	stamp;
+	double		latency;
+	int		len, num_members;
+	service		service_type;
+
+	service_type = Receive( Probe_mbox, &num_members, &len );
+	if( !Is_regular_mess( service_type ) ) return;
+
+	memcpy( &stamp, Mess, sizeof(stamp) );
+	Probes_received++;
+	latency = Now_ms() - ( stamp.sec * 1000.0 + stamp.usec / 1000.0 );
+	Probe_latency_sum += latency;
+	if( latency > Probe_latency_max ) Probe_latency_max = latency;
+}
+
+static	void	Send( char *group, int seq, int len )
+{
+	struct timeval	tv;
+	bench_stamp	stamp;
+	int		ret;
+
+	gettimeofday( &tv, NULL );
+	stamp.seq  = seq;
+	stamp.sec  = tv.tv_sec;
+	stamp.usec = tv.tv_usec;
+	memcpy( Mess, &stamp, sizeof(stamp) );
+	ret = SP_multicast( Publisher_mbox, AGREED_MESS, group, 0, len, Mess );
+	if( ret < 0 )
+	{
+		SP_error( ret );
+		exit( 1 );
+	}
+}
+
+int	main( int argc, char *argv[] )
+{
+	struct timeval	timeout;
+	fd_set		mask;
+	double		start, elapsed;
+	int		i, max_fd, slowest, sent, ret;
+
+	for( i=1; i < argc; i++ )
+	{
+		if( i+1 >= argc ) Usage( argv[0] );
+		if(      !strcmp( argv[i], "-p" ) ) Publisher_name = argv[++i];
+		else if( !strcmp( argv[i], "-g" ) ) strncpy( Group, argv[++i], MAX_GROUP_NAME - 1 );
+		else if( !strcmp( argv[i], "-n" ) ) Num_mess = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-b" ) ) Mess_len = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-w" ) ) Window = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-i" ) ) Probe_name = argv[++i];
+		else if( !strcmp( argv[i], "-e" ) ) Probe_every = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-s" ) && Num_subscribers < MAX_SUBSCRIBERS )
+			Subscriber_names[Num_subscribers++] = argv[++i];
+		else Usage( argv[0] );
+	}
+	if( Publisher_name == NULL || Num_subscribers == 0 || Num_mess <= 0 || Window <= 0 || Probe_every <= 0 ||
+	    Mess_len < (int) sizeof(bench_stamp) || Mess_len > MAX_BENCH_MESS ) Usage( argv[0] );
+
+	for( i=0; i < Num_subscribers; i++ )
+		Connect( Subscriber_names[i], &Subscriber_mbox[i], Group );
+	if( Probe_name != NULL )
+	{
+		snprintf( Probe_group, MAX_GROUP_NAME, "%.*s_probe", MAX_GROUP_NAME - 7, Group );
+		Connect( Probe_name, &Probe_mbox, Probe_group );
+	}
+	Settle();
+
+	/* the publisher is not a member, so only the subscribers' daemons need the payloads */
+	Connect( Publisher_name, &Publisher_mbox, NULL );
+
+	memset( Mess, 0, sizeof(Mess) );
+	start = Now_ms();
+	sent = 0;
+	for(;;)
+	{
+		slowest = 0;
+		for( i=1; i < Num_subscribers; i++ )
+			if( Received[i] < Received[slowest] ) slowest = i;
+		if( Received[slowest] == Num_mess ) break;
+
+		while( sent < Num_mess && sent - Received[slowest] < Window )
+		{
+			Send( Group, sent, Mess_len );
+			sent++;
+			if( Probe_name != NULL && sent % Probe_every == 0 )
+				Send( Probe_group, Probes_sent++, sizeof(bench_stamp) );
+		}
+
+		FD_ZERO( &mask );
+		max_fd = 0;
+		for( i=0; i < Num_subscribers; i++ )
+		{
+			if( Received[i] == Num_mess ) continue;
+			FD_SET( Subscriber_mbox[i], &mask );
+			if( Subscriber_mbox[i] > max_fd ) max_fd = Subscriber_mbox[i];
+		}
+		if( Probe_name != NULL )
+		{
+			FD_SET( Probe_mbox, &mask );
+			if( Probe_mbox > max_fd ) max_fd = Probe_mbox;
+		}
+		timeout.tv_sec  = 30;
+		timeout.tv_usec = 0;
+		ret = select( max_fd + 1, &mask, NULL, NULL, &timeout );
+		if( ret < 0 && errno == EINTR ) continue;
+		if( ret <= 0 )
+		{
+			fprintf( stderr, "selective_bench: no message for 30 seconds\n" );
+			exit( 1 );
+		}
+		for( i=0; i < Num_subscribers; i++ )
+			if( Received[i] < Num_mess && FD_ISSET( Subscriber_mbox[i], &mask ) )
+				Deliver( i );
+		if( Probe_name != NULL && FD_ISSET( Probe_mbox, &mask ) )
+			Deliver_probe();
+	}
+	elapsed = Now_ms() - start;
+	while( Probes_received < Probes_sent )
+		Deliver_probe();
+
+	printf( "%d messages of %d bytes to %d subscribers in %.1f ms\n", Num_mess, Mess_len, Num_subscribers, elapsed );
+	printf( "%10.0f messages/s %10.2f Mbps\n", Num_mess * 1000.0 / elapsed, Num_mess * 8.0 * Mess_len / ( elapsed * 1000.0 ) );
+	printf( "latency %8.2f ms average %8.2f ms max\n", Latency_sum / ( (double) Num_mess * Num_subscribers ), Latency_max );
+	if( Probes_received > 0 )
+		printf( "probe   %8.2f ms average %8.2f ms max (%d probes to %s)\n",
+			Probe_latency_sum / Probes_received, Probe_latency_max, Probes_received, Probe_name );
+
+	SP_disconnect( Publisher_mbox );
+	if( Probe_name != NULL ) SP_disconnect( Probe_mbox );
+	for( i=0; i < Num_subscribers; i++ )
+		SP_disconnect( Subscriber_mbox[i] );
+	return( 0 );
+}
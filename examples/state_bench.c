@@ -0,0 +1,210 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+
+/*
+ * state_bench: loads one daemon with many groups and times how long a
+ * daemon joining the ring takes to learn them. Clients connected to the
+ * loaded daemon join the groups, then the bench keeps trying to connect
+ * to the joining daemon; start that daemon once the groups are in. As soon
+ * as it accepts, a client there joins the first group and the bench waits
+ * for the membership that shows the members on both daemons, which comes
+ * after the GROUPS state exchange. The loaded daemon logs the messages,
+ * bytes and packets it sent in that exchange (G_send_groups_messages, with
+ * GROUPS in DebugFlags and EventPriority INFO). Compare runs with and
+ * without CompactGroupState in spread.conf.
+ *
+ *   state_bench -s 4803@host1 -j 4803@host2 -n 50000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "sp.h"
+
+#define	MAX_BENCH_CLIENTS	64
+#define	MAX_BENCH_GROUPS	8
+#define	MAX_BENCH_MESS		1024
+#define	JOIN_WINDOW		500	/* well under the daemon's MaxSessionMessages */
+
+static	char	*Loaded_name;
+static	char	*Joining_name;
+static	int	Num_groups = 50000;
+static	int	Num_clients = 10;
+static	int	Max_wait_secs = 60;
+
+static	mailbox	Client_mbox[MAX_BENCH_CLIENTS];
+
+static	double	Now_ms( void )
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0 );
+}
+
+static	void	Usage( char *exe )
+{
+	fprintf( stderr, "Usage: %s -s <loaded daemon> -j <joining daemon>\n"
+		"\t[-n <groups>]       : groups to join at the loaded daemon (default %d)\n"
+		"\t[-c <clients>]      : clients the groups are spread over (default %d)\n"
+		"\t[-t <secs>]         : give up waiting for the joining daemon after this long (default %d)\n",
+		exe, Num_groups, Num_clients, Max_wait_secs );
+	exit( 1 );
+}
+
+static	void	Group_name( int i, char group[MAX_GROUP_NAME] )
+{
+	sprintf( group, "state_bench_%d", i );
+}
+
+/* receives one message; returns its service type, and the member count for memberships */
+static	service	Receive( mailbox mbox, int *num_members )
+{
+	static	char	groups[MAX_BENCH_GROUPS][MAX_GROUP_NAME];
+	static	char	mess[MAX_BENCH_MESS];
+	char		sender[MAX_GROUP_NAME];
+	service		service_type;
+	int16		mess_type;
+	int		endian_mismatch;
+	int		ret;
+
+	service_type = 0;
+	ret = SP_receive( mbox, &service_type, sender, MAX_BENCH_GROUPS, num_members, groups,
+			  &mess_type, &endian_mismatch, sizeof(mess), mess );
+	if( ret < 0 && ret != GROUPS_TOO_SHORT )
+	{
+		fprintf( stderr, "state_bench: " );
+		SP_error( ret );
+		exit( 1 );
+	}
+	return( service_type );
+}
+
+/* joins the groups a window at a time, taking the membership of each join */
+static	void	Load( void )
+{
+	char	group[MAX_GROUP_NAME];
+	int	first, last, i, num_members, ret;
+
+	for( first=0; first < Num_groups; first = last )
+	{
+		last = first + JOIN_WINDOW;
+		if( last > Num_groups ) last = Num_groups;
+		for( i=first; i < last; i++ )
+		{
+			Group_name( i, group );
+			ret = SP_join( Client_mbox[i % Num_clients], group );
+			if( ret < 0 )
+			{
+				SP_error( ret );
+				exit( 1 );
+			}
+		}
+		for( i=first; i < last; i++ )
+			while( !Is_reg_memb_mess( Receive( Client_mbox[i % Num_clients], &num_members ) ) );
+	}
+}
+
+int	main( int argc, char *argv[] )
+{
+	char	private_group[MAX_GROUP_NAME];
+	char	group[MAX_GROUP_NAME];
+	mailbox	joining_mbox;
+	double	start, loaded, accepted;
+	int	i, num_members, ret;
+
+	for( i=1; i < argc; i++ )
+	{
+		if( i+1 >= argc ) Usage( argv[0] );
+		if(      !strcmp( argv[i], "-s" ) ) Loaded_name = argv[++i];
+		else if( !strcmp( argv[i], "-j" ) ) Joining_name = argv[++i];
+		else if( !strcmp( argv[i], "-n" ) ) Num_groups = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-c" ) ) Num_clients = atoi( argv[++i] );
+		else if( !strcmp( argv[i], "-t" ) ) Max_wait_secs = atoi( argv[++i] );
+		else Usage( argv[0] );
+	}
+	if( Loaded_name == NULL || Joining_name == NULL || Num_groups <= 0 ||
+	    Num_clients <= 0 || Num_clients > MAX_BENCH_CLIENTS ) Usage( argv[0] );
+
+	for( i=0; i < Num_clients; i++ )
+	{
+		ret = SP_connect( Loaded_name, NULL, 0, 1, &Client_mbox[i], private_group );
+		if( ret != ACCEPT_SESSION )
+		{
+			fprintf( stderr, "state_bench: connecting to %s: ", Loaded_name );
+			SP_error( ret );
+			exit( 1 );
+		}
+	}
+	start = Now_ms();
+	Load();
+	loaded = Now_ms();
+	printf( "joined %d groups at %s in %.1f ms; waiting for %s\n",
+		Num_groups, Loaded_name, loaded - start, Joining_name );
+	fflush( stdout );
+
+	for( i=0; ; i++ )
+	{
+		ret = SP_connect( Joining_name, NULL, 0, 1, &joining_mbox, private_group );
+		if( ret == ACCEPT_SESSION ) break;
+		if( i >= Max_wait_secs * 100 )
+		{
+			fprintf( stderr, "state_bench: %s did not come up\n", Joining_name );
+			exit( 1 );
+		}
+		usleep( 10000 );
+	}
+	accepted = Now_ms();
+	Group_name( 0, group );
+	ret = SP_join( joining_mbox, group );
+	if( ret < 0 )
+	{
+		SP_error( ret );
+		exit( 1 );
+	}
+	do {
+		while( !Is_reg_memb_mess( Receive( joining_mbox, &num_members ) ) );
+	} while( num_members < 2 );
+	printf( "%-24s %10.1f ms after it accepted a client\n", "groups known at joiner", Now_ms() - accepted );
+
+	SP_disconnect( joining_mbox );
+	for( i=0; i < Num_clients; i++ )
+		SP_disconnect( Client_mbox[i] );
+	return( 0 );
+}
@@ -0,0 +1,199 @@
+/*
+ * The Spread Toolkit.
+ *     
+ * The contents of this file are subject to the Spread Open-Source
+ * License, Version 1.0 (the ``License''); you may not use
+ * this file except in compliance with the License.  You may obtain a
+ * copy of the License at:
+ *
+ * http://www.spread.org/license/
+ *
+ * or in the file ``license.txt'' found in this distribution.
+ *
+ * Software distributed under the License is distributed on an AS IS basis, 
+ * WITHOUT WARRANTY OF ANY KIND, either express or implied. See the License 
+ * for the specific language governing rights and limitations under the 
+ * License.
+ *
+ * The Creators of Spread are:
+ *  Yair Amir, Michal Miskin-Amir, Jonathan Stanton, John Schultz.
+ *
+ *  Copyright (C) 1993-2014 Spread Concepts LLC <info@spreadconcepts.com>
+ *
+ *  All Rights Reserved.
+ *
+ * Major Contributor(s):
+ * ---------------
+ *    Amy Babay            babay@cs.jhu.edu - accelerated ring protocol.
+ *    Ryan Caudy           rcaudy@gmail.com - contributions to process groups.
+ *    Claudiu Danilov      claudiu@acm.org - scalable wide area support.
+ *    Cristina Nita-Rotaru crisn@cs.purdue.edu - group communication security.
+ *    Theo Schlossnagle    jesus@omniti.com - Perl, autoconf, old skiplist.
+ *    Dan Schoenblum       dansch@cnds.jhu.edu - Java interface.
+ *
+ */
+
+/*
+ * timer_bench: compares the cost of requeueing and dequeueing time events
+ * in the events library against the sorted linked list it used to keep.
+ * Every operation targets one of Num_timers pending events, the way the
+ * protocol rearms its token loss and hurry timers on every packet.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "spu_events.h"
+#include "spu_alarm.h"
+
+typedef	struct dummy_list_event {
+	sp_time		t;
+	void		(* func)( int code, void *data );
+        int             code;
+        void            *data;
+	struct dummy_list_event	*next;
+} list_event;
+
+static	list_event	*List_queue;
+
+static	int	Num_timers = 10000;
+static	int	Num_ops    = 200000;
+
+static	void	Usage( int argc, char *argv[] );
+
+static	void	Dummy_event( int code, void *data )
+{
+}
+
+static	double	Now_usec(void)
+{
+	struct timeval	tv;
+
+	gettimeofday( &tv, NULL );
+	return( tv.tv_sec * 1000000.0 + tv.tv_usec );
+}
+
+/* The former E_queue: a sorted list walked on every call */
+static	void	List_queue_event( void (* func)( int code, void *data ), int code, void *data, sp_time delta_time )
+{
+	list_event	**pp, *t_e, *found;
+
+	found = NULL;
+	for( pp = &List_queue; *pp != NULL; pp = &(*pp)->next )
+	{
+		if( (*pp)->func == func && (*pp)->code == code && (*pp)->data == data )
+		{
+			found = *pp;
+			*pp = found->next;
+			break;
+		}
+	}
+	t_e = found;
+	if( t_e == NULL ) t_e = malloc( sizeof(list_event) );
+	t_e->t    = E_add_time( E_get_time(), delta_time );
+	t_e->func = func;
+	t_e->code = code;
+	t_e->data = data;
+
+	for( pp = &List_queue; *pp != NULL && E_compare_time( (*pp)->t, t_e->t ) <= 0; pp = &(*pp)->next )
+		;
+	t_e->next = *pp;
+	*pp = t_e;
+}
+
+static	void	List_dequeue_event( void (* func)( int code, void *data ), int code, void *data )
+{
+	list_event	**pp, *t_e;
+
+	for( pp = &List_queue; *pp != NULL; pp = &(*pp)->next )
+	{
+		if( (*pp)->func == func && (*pp)->code == code && (*pp)->data == data )
+		{
+			t_e = *pp;
+			*pp = t_e->next;
+			free( t_e );
+			return;
+		}
+	}
+}
+
+static	sp_time	Random_delay(void)
+{
+	sp_time	t;
+
+	t.sec  = 1 + rand() % 10;
+	t.usec = rand() % 1000000;
+	return( t );
+}
+
+int main( int argc, char *argv[] )
+{
+	double	start, list_queue, list_dequeue, heap_queue, heap_dequeue;
+	int	i, code;
+
+	Usage( argc, argv );
+
+	Alarm_set_types( 0 );
+	E_init();
+
+	srand( 1 );
+	for( i=0; i < Num_timers; i++ )
+		List_queue_event( Dummy_event, i, NULL, Random_delay() );
+	start = Now_usec();
+	for( i=0; i < Num_ops; i++ )
+		List_queue_event( Dummy_event, rand() % Num_timers, NULL, Random_delay() );
+	list_queue = ( Now_usec() - start ) / Num_ops;
+	start = Now_usec();
+	for( i=0; i < Num_ops; i++ )
+	{
+		code = rand() % Num_timers;
+		List_dequeue_event( Dummy_event, code, NULL );
+		List_queue_event( Dummy_event, code, NULL, Random_delay() );
+	}
+	list_dequeue = ( Now_usec() - start ) / Num_ops;
+
+	srand( 1 );
+	for( i=0; i < Num_timers; i++ )
+		E_queue( Dummy_event, i, NULL, Random_delay() );
+	start = Now_usec();
+	for( i=0; i < Num_ops; i++ )
+		E_queue( Dummy_event, rand() % Num_timers, NULL, Random_delay() );
+	heap_queue = ( Now_usec() - start ) / Num_ops;
+	start = Now_usec();
+	for( i=0; i < Num_ops; i++ )
+	{
+		code = rand() % Num_timers;
+		E_dequeue( Dummy_event, code, NULL );
+		E_queue( Dummy_event, code, NULL, Random_delay() );
+	}
+	heap_dequeue = ( Now_usec() - start ) / Num_ops;
+
+	printf("timer_bench: %d pending timers, %d operations\n", Num_timers, Num_ops );
+	printf("%-24s %12s %12s\n", "", "list (us)", "E_queue (us)" );
+	printf("%-24s %12.3f %12.3f\n", "requeue", list_queue, heap_queue );
+	printf("%-24s %12.3f %12.3f\n", "dequeue + queue", list_dequeue, heap_dequeue );
+
+	return( 0 );
+}
+
+static	void	Usage( int argc, char *argv[] )
+{
+	for( --argc, ++argv; argc > 0; --argc, ++argv )
+	{
+		if( !strncmp( *argv, "-t", 2 ) && argc > 1 ){
+			Num_timers = atoi( argv[1] );
+			--argc; ++argv;
+		}else if( !strncmp( *argv, "-o", 2 ) && argc > 1 ){
+			Num_ops = atoi( argv[1] );
+			--argc; ++argv;
+		}else{
+			printf( "Usage: timer_bench\n%s\n%s\n",
+				"\t[-t <num>]   : number of pending timers, default 10000",
+				"\t[-o <num>]   : number of operations to time, default 200000" );
+			exit( 0 );
+		}
+	}
+	if( Num_timers <= 0 ) Num_timers = 1;
+}
@@ -165,6 +165,23 @@ typedef struct dummy_membership_info {
         vs_set_info  my_vs_set;
 } membership_info;
 
+/* A message returned by SP_receive_many; the pointers are into the
+ * library's receive buffer for the mailbox */
+typedef struct dummy_sp_message {
+        service         service_type;
+        char            *sender;        /* MAX_GROUP_NAME bytes */
+        int             num_groups;
+        char            (*groups)[MAX_GROUP_NAME];
+        int16           mess_type;
+        int             endian_mismatch;
+        int             data_len;
+        char            *data;
+} sp_message;
+
+/* A buffer of SP_receive_buffer holding one message; it is the library's
+ * until SP_buffer_release drops the last reference to it */
+typedef struct dummy_sp_buffer sp_buffer;
+
 #include "sp_events.h"
 #include "sp_func.h"
 #ifdef __cplusplus
@@ -82,6 +82,14 @@ int	SP_multigroup_scat_multicast( mailbox mbox, service service_type,
 				      int16 mess_type,
 				      const scatter *scat_mess );
 
+int	SP_batch_begin( mailbox mbox );
+
+int	SP_batch_flush( mailbox mbox );
+
+int	SP_set_nonblocking( mailbox mbox, int nonblocking );
+
+int	SP_send_pending( mailbox mbox );
+
 int	SP_receive( mailbox mbox, service *service_type,
 		    char sender[MAX_GROUP_NAME], int max_groups,
 		    int *num_groups, char groups[][MAX_GROUP_NAME],
@@ -94,6 +102,14 @@ int	SP_scat_receive( mailbox mbox, service *service_type,
 			 int16 *mess_type, int *endian_mismatch,
 			 scatter *scat_mess );
 
+int	SP_receive_many( mailbox mbox, int max_messages, sp_message messages[] );
+
+int	SP_receive_buffer( mailbox mbox, sp_message *mess, sp_buffer **buffer );
+
+void	SP_buffer_hold( sp_buffer *buffer );
+
+void	SP_buffer_release( sp_buffer *buffer );
+
 /* get membership info from a message */
 int     SP_get_memb_info( const char *memb_mess, 
                           const service service_type,
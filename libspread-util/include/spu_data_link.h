@@ -41,6 +41,14 @@
 
 #define		MAX_PACKET_SIZE		1472    /*1472 = 1536-64 (of udp)*/
 
+/* Most packets DL_recv_batch returns, and DL_send_batch passes to the kernel, per call */
+#define		DL_MAX_RECV_BATCH	64
+#define		DL_MAX_SEND_BATCH	64
+
+/* Limits of one UDP_SEGMENT send or UDP_GRO receive */
+#define		DL_MAX_GSO_SEGMENTS	64
+#define		DL_MAX_GSO_BYTES	65507
+
 #define		SEND_CHANNEL	0x00000001
 #define		RECV_CHANNEL    0x00000002
 #define         NO_LOOP         0x00000004
@@ -53,7 +61,13 @@
 channel	DL_init_channel( int32 channel_type, int16 port, int32 mcast_address, int32 interface_address );
 void    DL_close_channel(channel chan);
 int	DL_send( channel chan, int32 address, int16 port, sys_scatter *scat );
+int	DL_send_batch( channel chan, int32 address, int16 port, sys_scatter *scats[], int num_scats );
+int	DL_enable_gso( channel chan );
+int	DL_send_gso( channel chan, int32 address, int16 port, sys_scatter *scats[], int num_scats );
 int	DL_recv( channel chan, sys_scatter *scat );
 int	DL_recvfrom( channel chan, sys_scatter *scat, int *src_address, unsigned short *src_port );
+int	DL_recv_batch( channel chan, sys_scatter *scats[], int num_scats, int *lens );
+int	DL_enable_gro( channel chan );
+int	DL_recv_gro( channel chan, sys_scatter *scats[], int num_scats, int *lens );
 
 #endif  /* INC_DATA_LINK */
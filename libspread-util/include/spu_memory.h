@@ -128,6 +128,20 @@ int             dec_ref_cnt(void *object);
 int             get_ref_cnt(void *object);            
 
 
+/* Input: a valid pointer to an object created by new or new_ref_cnt
+ * Output: the resulting number of holders
+ * Effects: Adds a holder to an object, so a plain object can be shared
+ */
+int             share_ref_cnt(void *object);
+
+
+/* Input: a valid pointer to an object created by new or passed to share_ref_cnt
+ * Output: the number of holders left besides the caller
+ * Effects: Drops a holder. 0 means the caller was the last and disposes it.
+ */
+int             unshare_ref_cnt(void *object);
+
+
 /***************************************************************************
  * These two functions are ONLY needed for dynamically sized allocations
  * like traditional malloc/free --NOT for object based allocations
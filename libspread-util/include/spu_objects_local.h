@@ -107,6 +107,7 @@
 #define GROUPS_BUF_LINK         52
 #define GROUPS_MESSAGE_LINK     53
 #define DAEMON_MEMBERS          54
+#define MESSAGE_SLICE           55
 
 
 /* Highest valid object number is defined in objects.h as UNKNOWN_OBJ */
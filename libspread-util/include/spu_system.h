@@ -0,0 +1,59 @@
+/* Automatically generated by gen_system_include.sh from config.h; do not edit. */
+
+/* This system header contains those constants that change upon compilation and are
+ * required for the Spread Util Library API. These should not conflict with any
+ * other definitions in other software and should be safe to include in other software.
+ */
+
+#ifndef SYSTEM_H
+#define SYSTEM_H
+
+/* int64_t type */
+#define SPU_HAVE_INT64_T 1
+
+/* Define to 1 if you have the <inttypes.h> header file. */
+#define SPU_HAVE_INTTYPES_H 1
+
+/* various intxx_t types */
+#define SPU_HAVE_INTXX_T 1
+
+/* Define to 1 if you have the <limits.h> header file. */
+#define SPU_HAVE_LIMITS_H 1
+
+/* Define to 1 if you have the <stdlib.h> header file. */
+#define SPU_HAVE_STDLIB_H 1
+
+/* unsigned int type u_int */
+#define SPU_HAVE_U_INT 1
+
+/* unsigned int64_t */
+#define SPU_HAVE_U_INT64_T 1
+
+/* unsigned int64_t */
+#define SPU_HAVE_U_INT64_T 1
+
+/* various unsigned intxx_t types */
+#define SPU_HAVE_U_INTXX_T 1
+
+/* various unsigned intxx_t types */
+#define SPU_HAVE_U_INTXX_T 1
+
+/* The size of `char', as computed by sizeof. */
+#define SPU_SIZEOF_CHAR 1
+
+/* The size of `int', as computed by sizeof. */
+#define SPU_SIZEOF_INT 4
+
+/* The size of `long int', as computed by sizeof. */
+#define SPU_SIZEOF_LONG_INT 8
+
+/* The size of `long long int', as computed by sizeof. */
+#define SPU_SIZEOF_LONG_LONG_INT 8
+
+/* The size of `short int', as computed by sizeof. */
+#define SPU_SIZEOF_SHORT_INT 2
+
+
+#include "spu_system_defs.h"
+
+#endif /* SYSTEM_H */
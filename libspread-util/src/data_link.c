@@ -33,6 +33,9 @@
  */
 
 
+/* Must come before any system headers as otherwise it is ignored */
+#define _GNU_SOURCE
+
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
@@ -52,6 +55,16 @@
 #  include <winsock.h>
 #endif
 
+#ifdef HAVE_NETINET_UDP_H
+#  include <netinet/udp.h>
+#endif
+
+/* UDP segmentation offload: one sendmsg carries a run of equal-size packets,
+ * and one recvmsg can return several packets coalesced by the kernel. */
+#if defined(UDP_SEGMENT) && defined(UDP_GRO) && defined(SOL_UDP) && !defined(ARCH_SCATTER_NONE)
+#  define DL_UDP_OFFLOAD
+#endif
+
 #include "spu_data_link.h"
 #include "spu_alarm.h"
 #include "spu_events.h" /* for sp_time */
@@ -293,6 +306,75 @@ int     DL_send( channel chan, int32 address, int16 port, sys_scatter *scat )
         return( ret );
 }
 
+/* Sends every packet in scats to the same address, using one sendmmsg call
+ * per DL_MAX_SEND_BATCH packets where the platform has it. Packets the kernel
+ * does not take go through DL_send and its retry; one that fails even then
+ * is dropped and the rest are still sent. Returns the number of packets sent.
+ */
+int     DL_send_batch( channel chan, int32 address, int16 port, sys_scatter *scats[], int num_scats )
+{
+#if defined(HAVE_SENDMMSG) && !defined(ARCH_SCATTER_NONE)
+static  struct  mmsghdr msgs[DL_MAX_SEND_BATCH];
+        struct  sockaddr_in soc_addr;
+        int             num_done, num_sent, num_batch;
+        int             ret;
+        int             i;
+
+        memset( &soc_addr, 0, sizeof( soc_addr ) );
+        soc_addr.sin_family      = AF_INET;
+        soc_addr.sin_addr.s_addr = htonl( address );
+        soc_addr.sin_port        = htons( port );
+
+#ifdef HAVE_SIN_LEN_IN_STRUCT_SOCKADDR_IN
+        soc_addr.sin_len = sizeof( soc_addr );
+#endif
+
+        for( num_done = 0, num_sent = 0; num_done < num_scats; )
+        {
+                num_batch = num_scats - num_done;
+                if( num_batch > DL_MAX_SEND_BATCH ) num_batch = DL_MAX_SEND_BATCH;
+
+                for( i=0; i < num_batch; i++ )
+                {
+                        if( scats[num_done+i]->num_elements > ARCH_SCATTER_SIZE ) {
+                          Alarmp( SPLOG_FATAL, DATA_LINK, "DL_send_batch: illegal scat->num_elements (%d) > ARCH_SCATTER_SIZE (%d)\n", 
+                                  (int) scats[num_done+i]->num_elements, (int) ARCH_SCATTER_SIZE );
+                        }
+                        memset( &msgs[i], 0, sizeof( msgs[i] ) );
+                        msgs[i].msg_hdr.msg_name    = (caddr_t) &soc_addr;
+                        msgs[i].msg_hdr.msg_namelen = sizeof( soc_addr );
+                        msgs[i].msg_hdr.msg_iov     = (struct iovec *) scats[num_done+i]->elements;
+                        msgs[i].msg_hdr.msg_iovlen  = scats[num_done+i]->num_elements;
+                }
+
+                ret = sendmmsg( chan, msgs, num_batch, 0 );
+                if( ret > 0 )
+                {
+                        num_done += ret;
+                        num_sent += ret;
+                        continue;
+                }
+                /* let DL_send retry and report the first one, then go on with the rest */
+                if( DL_send( chan, address, port, scats[num_done] ) >= 0 ) num_sent++;
+                num_done++;
+        }
+
+        Alarmp( SPLOG_INFO, DATA_LINK, "DL_send_batch: sent %d of %d packets to (" IPF ":%d) on channel %d\n", 
+                num_sent, num_scats, IP(address), port, chan );
+
+        return( num_sent );
+#else
+        int             num_sent;
+        int             i;
+
+        for( num_sent = 0, i = 0; i < num_scats; i++ )
+        {
+                if( DL_send( chan, address, port, scats[i] ) >= 0 ) num_sent++;
+        }
+        return( num_sent );
+#endif
+}
+
 int DL_recv( channel chan, sys_scatter *scat )
 {
     return( DL_recvfrom( chan, scat, NULL, NULL ) );
@@ -415,3 +497,344 @@ static  char            pseudo_scat[MAX_PACKET_SIZE];
 
         return(ret);
 }
+
+/* Receives up to num_scats packets with one system call where the platform
+ * has recvmmsg. Blocks only until the first packet is available. On return
+ * lens[i] holds the size of the packet placed in scats[i]. Returns the number
+ * of packets received, or -1 on error.
+ */
+int     DL_recv_batch( channel chan, sys_scatter *scats[], int num_scats, int *lens )
+{
+#if defined(HAVE_RECVMMSG) && !defined(ARCH_SCATTER_NONE)
+static  struct  mmsghdr msgs[DL_MAX_RECV_BATCH];
+        int             ret;
+        int             i;
+
+        if( num_scats > DL_MAX_RECV_BATCH ) num_scats = DL_MAX_RECV_BATCH;
+
+        for( i=0; i < num_scats; i++ )
+        {
+                if( scats[i]->num_elements > ARCH_SCATTER_SIZE ) {
+                  Alarmp( SPLOG_FATAL, DATA_LINK, "DL_recv_batch: illegal scat->num_elements (%d) > ARCH_SCATTER_SIZE (%d)\n", 
+                          (int) scats[i]->num_elements, (int) ARCH_SCATTER_SIZE );
+                }
+                memset( &msgs[i], 0, sizeof( msgs[i] ) );
+                msgs[i].msg_hdr.msg_iov    = (struct iovec *) scats[i]->elements;
+                msgs[i].msg_hdr.msg_iovlen = scats[i]->num_elements;
+        }
+
+        ret = recvmmsg( chan, msgs, num_scats, MSG_WAITFORONE, NULL );
+        if( ret < 0 && errno == ENOSYS )
+        {
+                /* kernel without recvmmsg: fall back to one packet per call */
+                lens[0] = DL_recv( chan, scats[0] );
+                return( lens[0] < 0 ? -1 : 1 );
+        }
+        if( ret < 0 )
+        {
+                Alarm( DATA_LINK, "DL_recv_batch: error %d receiving on channel %d\n", ret, chan );
+                return( -1 );
+        }
+        for( i=0; i < ret; i++ )
+                lens[i] = msgs[i].msg_len;
+
+        Alarm( DATA_LINK, "DL_recv_batch: received %d packets on channel %d\n", ret, chan );
+
+        return( ret );
+#else
+        if( num_scats < 1 ) return( 0 );
+
+        lens[0] = DL_recv( chan, scats[0] );
+        if( lens[0] < 0 ) return( -1 );
+
+        return( 1 );
+#endif
+}
+
+#ifdef DL_UDP_OFFLOAD
+static  int     DL_scat_len( sys_scatter *scat )
+{
+        int     len = 0;
+        int     i;
+
+        for( i=0; i < scat->num_elements; i++ )
+                len += scat->elements[i].len;
+
+        return( len );
+}
+#endif
+
+/* Prepares a send channel for DL_send_gso. Returns 1 if the kernel supports
+ * UDP_SEGMENT on it, 0 otherwise (DL_send_gso then behaves as DL_send_batch).
+ */
+int     DL_enable_gso( channel chan )
+{
+#ifdef DL_UDP_OFFLOAD
+        int     gso_size = 0;
+
+        /* a zero socket default leaves segmentation to the per-call control message */
+        if( setsockopt( chan, SOL_UDP, UDP_SEGMENT, (void *)&gso_size, sizeof(gso_size) ) < 0 )
+        {
+                Alarmp( SPLOG_WARNING, DATA_LINK, "DL_enable_gso: UDP_SEGMENT not supported on channel %d: %s\n", chan, strerror(errno) );
+                return( 0 );
+        }
+        Alarmp( SPLOG_INFO, DATA_LINK, "DL_enable_gso: enabled on channel %d\n", chan );
+        return( 1 );
+#else
+        return( 0 );
+#endif
+}
+
+/* Asks the kernel to coalesce packets received on chan. Once this returns 1,
+ * the channel must be read with DL_recv_gro.
+ */
+int     DL_enable_gro( channel chan )
+{
+#ifdef DL_UDP_OFFLOAD
+        int     on = 1;
+
+        if( setsockopt( chan, SOL_UDP, UDP_GRO, (void *)&on, sizeof(on) ) < 0 )
+        {
+                Alarmp( SPLOG_WARNING, DATA_LINK, "DL_enable_gro: UDP_GRO not supported on channel %d: %s\n", chan, strerror(errno) );
+                return( 0 );
+        }
+        Alarmp( SPLOG_INFO, DATA_LINK, "DL_enable_gro: enabled on channel %d\n", chan );
+        return( 1 );
+#else
+        return( 0 );
+#endif
+}
+
+/* Like DL_send_batch, but each run of equal-size packets (optionally ended
+ * by one shorter packet) is passed to the kernel as a single UDP_SEGMENT
+ * send, which the kernel or NIC splits back into the original packets.
+ * A packet that fails is dropped as in DL_send_batch. Returns the number
+ * of packets sent.
+ */
+int     DL_send_gso( channel chan, int32 address, int16 port, sys_scatter *scats[], int num_scats )
+{
+#ifdef DL_UDP_OFFLOAD
+static  struct  iovec   iov[ARCH_SCATTER_SIZE];
+        struct  msghdr  msg;
+        struct  sockaddr_in soc_addr;
+        struct  cmsghdr *cmsg;
+        char            control[CMSG_SPACE(sizeof(int16u))];
+        int             num_done, num_sent, num_run;
+        int             seg_len, len, run_bytes, num_iov;
+        int             ret;
+        int             i, j;
+
+        memset( &soc_addr, 0, sizeof( soc_addr ) );
+        soc_addr.sin_family      = AF_INET;
+        soc_addr.sin_addr.s_addr = htonl( address );
+        soc_addr.sin_port        = htons( port );
+
+#ifdef HAVE_SIN_LEN_IN_STRUCT_SOCKADDR_IN
+        soc_addr.sin_len = sizeof( soc_addr );
+#endif
+
+        for( num_done = 0, num_sent = 0; num_done < num_scats; num_done += num_run )
+        {
+                seg_len   = DL_scat_len( scats[num_done] );
+                run_bytes = seg_len;
+                num_iov   = scats[num_done]->num_elements;
+                for( num_run = 1; num_done + num_run < num_scats && num_run < DL_MAX_GSO_SEGMENTS; num_run++ )
+                {
+                        len = DL_scat_len( scats[num_done+num_run] );
+                        if( len > seg_len || run_bytes + len > DL_MAX_GSO_BYTES ||
+                            num_iov + scats[num_done+num_run]->num_elements > ARCH_SCATTER_SIZE ) break;
+                        run_bytes += len;
+                        num_iov   += scats[num_done+num_run]->num_elements;
+                        /* only the last segment of a send may be short */
+                        if( len < seg_len ) { num_run++; break; }
+                }
+
+                if( num_run == 1 )
+                {
+                        if( DL_send( chan, address, port, scats[num_done] ) >= 0 ) num_sent++;
+                        continue;
+                }
+
+                for( i=0, num_iov=0; i < num_run; i++ )
+                        for( j=0; j < scats[num_done+i]->num_elements; j++, num_iov++ )
+                        {
+                                iov[num_iov].iov_base = scats[num_done+i]->elements[j].buf;
+                                iov[num_iov].iov_len  = scats[num_done+i]->elements[j].len;
+                        }
+
+                memset( &msg, 0, sizeof( msg ) );
+                msg.msg_name       = (caddr_t) &soc_addr;
+                msg.msg_namelen    = sizeof( soc_addr );
+                msg.msg_iov        = iov;
+                msg.msg_iovlen     = num_iov;
+                msg.msg_control    = control;
+                msg.msg_controllen = sizeof( control );
+
+                cmsg = CMSG_FIRSTHDR( &msg );
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type  = UDP_SEGMENT;
+                cmsg->cmsg_len   = CMSG_LEN( sizeof(int16u) );
+                *(int16u *) CMSG_DATA( cmsg ) = (int16u) seg_len;
+
+                ret = sendmsg( chan, &msg, 0 );
+                if( ret == run_bytes )
+                {
+                        num_sent += num_run;
+                        continue;
+                }
+                /* let DL_send retry and report each packet of the run */
+                Alarmp( SPLOG_INFO, DATA_LINK, "DL_send_gso: segmented send of %d packets failed (%d, errno %d), resending singly\n", 
+                        num_run, ret, errno );
+                for( i=0; i < num_run; i++ )
+                        if( DL_send( chan, address, port, scats[num_done+i] ) >= 0 ) num_sent++;
+        }
+
+        Alarmp( SPLOG_INFO, DATA_LINK, "DL_send_gso: sent %d of %d packets to (" IPF ":%d) on channel %d\n", 
+                num_sent, num_scats, IP(address), port, chan );
+
+        return( num_sent );
+#else
+        return( DL_send_batch( chan, address, port, scats, num_scats ) );
+#endif
+}
+
+#ifdef DL_UDP_OFFLOAD
+/* Scats each recvmmsg message of DL_recv_gro spans: enough full-size
+ * packets for the largest datagram the kernel coalesces */
+#define DL_GRO_SCATS    ( ( DL_MAX_GSO_BYTES + MAX_PACKET_SIZE - 1 ) / MAX_PACKET_SIZE )
+
+/* Copies len bytes between buf and the scats, starting offset bytes into
+ * them taken as one buffer */
+static  void    DL_scat_copy( sys_scatter *scats[], int num_scats, int offset, char *buf, int len, int to_scats )
+{
+        int     i, j, chunk;
+
+        for( i=0; i < num_scats && len > 0; i++ )
+                for( j=0; j < scats[i]->num_elements && len > 0; j++ )
+                {
+                        if( offset >= (int) scats[i]->elements[j].len ) {
+                                offset -= scats[i]->elements[j].len;
+                                continue;
+                        }
+                        chunk = scats[i]->elements[j].len - offset;
+                        if( chunk > len ) chunk = len;
+                        if( to_scats ) memcpy( &scats[i]->elements[j].buf[offset], buf, chunk );
+                        else           memcpy( buf, &scats[i]->elements[j].buf[offset], chunk );
+                        buf    += chunk;
+                        len    -= chunk;
+                        offset  = 0;
+                }
+}
+#endif
+
+/* Receives from a DL_enable_gro channel straight into scats. Each recvmmsg
+ * message spans DL_GRO_SCATS scats, so a datagram the kernel coalesced
+ * lands in consecutive scats; when its packets are full size each is
+ * already in its own scat, and shorter ones are moved up to the start of
+ * theirs. lens gets the packet length of every scat up to the returned
+ * count, 0 for those left unused. Returns -1 on error.
+ */
+int     DL_recv_gro( channel chan, sys_scatter *scats[], int num_scats, int *lens )
+{
+#ifdef DL_UDP_OFFLOAD
+static  struct  mmsghdr msgs[DL_MAX_RECV_BATCH];
+static  struct  iovec   iov[ARCH_SCATTER_SIZE];
+static  char            control[DL_MAX_RECV_BATCH][CMSG_SPACE(sizeof(int))];
+        char            seg_buf[MAX_PACKET_SIZE];
+        int             first[DL_MAX_RECV_BATCH], count[DL_MAX_RECV_BATCH];
+        struct  cmsghdr *cmsg;
+        int             num_msgs, num_iov, num_elements;
+        int             len, seg_len, num_segs, src, dst, to_move;
+        int             ret;
+        int             m, i, j, k;
+
+        if( num_scats > DL_MAX_RECV_BATCH ) num_scats = DL_MAX_RECV_BATCH;
+        if( num_scats < 1 ) return( 0 );
+
+        num_elements = 0;
+        for( num_msgs = 0, num_iov = 0, i = 0; i < num_scats; i += count[num_msgs++] )
+        {
+                count[num_msgs] = num_scats - i;
+                if( count[num_msgs] > DL_GRO_SCATS ) count[num_msgs] = DL_GRO_SCATS;
+                for( num_elements = 0, j = i; j < i + count[num_msgs]; j++ )
+                        num_elements += scats[j]->num_elements;
+                if( num_iov + num_elements > ARCH_SCATTER_SIZE ) break;
+
+                first[num_msgs] = i;
+                memset( &msgs[num_msgs], 0, sizeof( msgs[num_msgs] ) );
+                msgs[num_msgs].msg_hdr.msg_iov        = &iov[num_iov];
+                msgs[num_msgs].msg_hdr.msg_iovlen     = num_elements;
+                msgs[num_msgs].msg_hdr.msg_control    = control[num_msgs];
+                msgs[num_msgs].msg_hdr.msg_controllen = sizeof( control[num_msgs] );
+                for( j = i; j < i + count[num_msgs]; j++ )
+                        for( k=0; k < scats[j]->num_elements; k++, num_iov++ )
+                        {
+                                iov[num_iov].iov_base = scats[j]->elements[k].buf;
+                                iov[num_iov].iov_len  = scats[j]->elements[k].len;
+                        }
+        }
+        if( num_msgs == 0 )
+                Alarmp( SPLOG_FATAL, DATA_LINK, "DL_recv_gro: scats of %d elements do not fit %d iovecs\n", num_elements, ARCH_SCATTER_SIZE );
+
+#ifdef HAVE_RECVMMSG
+        ret = recvmmsg( chan, msgs, num_msgs, MSG_WAITFORONE, NULL );
+        if( ret < 0 && errno == ENOSYS )
+#endif
+        {
+                /* one coalesced datagram per call */
+                ret = recvmsg( chan, &msgs[0].msg_hdr, 0 );
+                if( ret >= 0 ) {
+                        msgs[0].msg_len = ret;
+                        ret = 1;
+                }
+        }
+        if( ret < 0 )
+        {
+                Alarm( DATA_LINK, "DL_recv_gro: error %d receiving on channel %d\n", ret, chan );
+                return( -1 );
+        }
+
+        for( m=0; m < ret; m++ )
+        {
+                len     = msgs[m].msg_len;
+                seg_len = len;
+                for( cmsg = CMSG_FIRSTHDR( &msgs[m].msg_hdr ); cmsg != NULL; cmsg = CMSG_NXTHDR( &msgs[m].msg_hdr, cmsg ) )
+                {
+                        if( cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO )
+                                memcpy( &seg_len, CMSG_DATA( cmsg ), sizeof(int) );
+                }
+                if( seg_len <= 0 || seg_len > len ) seg_len = len;
+                if( msgs[m].msg_hdr.msg_flags & MSG_TRUNC )
+                        Alarmp( SPLOG_WARNING, DATA_LINK, "DL_recv_gro: coalesced datagram truncated to %d bytes on channel %d\n", len, chan );
+
+                num_segs = ( len > 0 ? ( len + seg_len - 1 ) / seg_len : 0 );
+                if( num_segs > count[m] ) num_segs = count[m];
+
+                /* the last packets move furthest; going down keeps the earlier ones in place until their turn */
+                for( j = num_segs - 1; j >= 0; j-- )
+                {
+                        to_move = len - j * seg_len;
+                        if( to_move > seg_len ) to_move = seg_len;
+                        src = j * seg_len;
+                        for( dst = 0, k = 0; k < j; k++ )
+                                dst += DL_scat_len( scats[first[m]+k] );
+                        if( to_move > DL_scat_len( scats[first[m]+j] ) ) to_move = DL_scat_len( scats[first[m]+j] );
+                        if( dst != src )
+                        {
+                                if( to_move > (int) sizeof(seg_buf) ) to_move = sizeof(seg_buf);
+                                DL_scat_copy( &scats[first[m]], count[m], src, seg_buf, to_move, 0 );
+                                DL_scat_copy( &scats[first[m]], count[m], dst, seg_buf, to_move, 1 );
+                        }
+                        lens[first[m]+j] = to_move;
+                }
+                for( j = num_segs; j < count[m]; j++ )
+                        lens[first[m]+j] = 0;
+
+                Alarm( DATA_LINK, "DL_recv_gro: received %d bytes as %d packets on channel %d\n", len, num_segs, chan );
+        }
+
+        return( first[ret-1] + count[ret-1] );
+#else
+        return( DL_recv_batch( chan, scats, num_scats, lens ) );
+#endif
+}
@@ -64,6 +64,7 @@
 #endif	/* ARCH_PC_WIN95 */
 
 #include <string.h>
+#include <stdlib.h>
 #include "spu_events.h"
 #include "spu_objects.h"    /* For memory */
 #include "spu_memory.h"     /* for memory */
@@ -72,12 +73,23 @@
 #define SPU_EVENTS_EXIT_NORMAL     1
 #define SPU_EVENTS_EXIT_ASYNC_SAFE 2
 
+/* The readiness backend is epoll where available, select otherwise.
+ * Define DISABLE_EPOLL to force the select backend.
+ */
+#if defined(HAVE_SYS_EPOLL_H) && !defined(DISABLE_EPOLL)
+#define EVENTS_USE_EPOLL
+#include <sys/epoll.h>
+#include <fcntl.h>
+#endif
+
 typedef	struct dummy_t_event {
 	sp_time		t;
 	void		(* func)( int code, void *data );
         int             code;
         void            *data;
-	struct dummy_t_event	*next;
+        int32u          seq;            /* order of queueing, breaks ties on t */
+        int             heap_index;     /* position in Time_heap */
+	struct dummy_t_event	*next;  /* hash chain in Time_hash */
 } time_event;
 
 typedef struct dummy_fd_event {
@@ -97,7 +109,12 @@ typedef struct dummy_fd_queue {
 
 static sp_time E_get_time_monotonic(void);
 
-static	time_event	*Time_queue;
+static	time_event	**Time_heap;
+static	int		Time_heap_num;
+static	int		Time_heap_size;
+static	time_event	**Time_hash;
+static	int		Time_hash_size;
+static	int32u		Time_seq;
 static	sp_time		Now;
 
 static	fd_queue	Fd_queue[NUM_PRIORITY];
@@ -105,6 +122,27 @@ static	fd_set		Fd_mask[NUM_FDTYPES];
 static	int		Active_priority;
 static	int		Exit_events;
 
+#ifdef  EVENTS_USE_EPOLL
+/* Each priority has its own epoll set holding the active fds of that
+ * priority. The sets of priorities at or above Active_priority are
+ * themselves registered in Epoll_top, so changing the threshold costs
+ * at most NUM_PRIORITY epoll_ctl calls no matter how many fds are attached.
+ */
+typedef struct dummy_epoll_prio {
+        int             epfd;
+        int             in_top;         /* true if epfd is registered in Epoll_top */
+        int             size;           /* number of fds covered by interest and slot */
+        unsigned char   *interest;      /* per fd: fd_type bits registered with epfd */
+        int             *slot;          /* per fd and fd_type: 1 + index in Fd_queue, 0 if none */
+        int             num_ready;
+        struct epoll_event ready[MAX_FD_EVENTS];
+} epoll_prio;
+
+static  int             Use_epoll;
+static  int             Epoll_top = -1;
+static  epoll_prio      Epoll_prio[NUM_PRIORITY];
+#endif
+
 enum ev_type {
     NULL_EVENT_t = 0,
     TIME_EVENT_t,
@@ -125,11 +163,216 @@ int     Slow_events_max = 5;
 int     Slow_events_active = 0;
 static  struct event_record    Slow_events[5];
 
+#ifdef  EVENTS_USE_EPOLL
+/* epoll fds are not passed on to programs the process execs */
+static  int     E_epoll_create( int size )
+{
+#ifdef  EPOLL_CLOEXEC
+	return( epoll_create1( EPOLL_CLOEXEC ) );
+#else
+	int	epfd;
+
+	epfd = epoll_create( size );
+	if( epfd >= 0 ) fcntl( epfd, F_SETFD, FD_CLOEXEC );
+	return( epfd );
+#endif
+}
+
+static  void    E_epoll_init(void)
+{
+	int	i;
+
+	if( Epoll_top >= 0 )
+	{
+		for( i=0; i < NUM_PRIORITY; i++ )
+		{
+			close( Epoll_prio[i].epfd );
+			free( Epoll_prio[i].interest );
+			free( Epoll_prio[i].slot );
+		}
+		close( Epoll_top );
+	}
+	memset( Epoll_prio, 0, sizeof(Epoll_prio) );
+	Use_epoll = 0;
+
+	Epoll_top = E_epoll_create( NUM_PRIORITY );
+	if( Epoll_top < 0 )
+	{
+		Alarm( PRINT, "E_epoll_init: epoll_create failed (%s), using select\n", strerror(errno) );
+		return;
+	}
+	for( i=0; i < NUM_PRIORITY; i++ )
+	{
+		Epoll_prio[i].epfd = E_epoll_create( 64 );
+		if( Epoll_prio[i].epfd < 0 )
+			Alarm( EXIT, "E_epoll_init: epoll_create failed for priority %d: %s\n", i, strerror(errno) );
+	}
+	Use_epoll = 1;
+}
+
+static  int     E_epoll_grow( int priority, int fd )
+{
+	epoll_prio	*ep = &Epoll_prio[priority];
+	unsigned char	*interest;
+	int		*slot;
+	int		size;
+
+	if( fd < ep->size ) return( 0 );
+
+	size = 2 * ep->size;
+	if( size < 64 ) size = 64;
+	while( size <= fd ) size *= 2;
+
+	interest = realloc( ep->interest, size * sizeof(unsigned char) );
+	if( interest == NULL ) return( -1 );
+	ep->interest = interest;
+	slot = realloc( ep->slot, size * NUM_FDTYPES * sizeof(int) );
+	if( slot == NULL ) return( -1 );
+	ep->slot = slot;
+
+	memset( &ep->interest[ep->size], 0, (size - ep->size) * sizeof(unsigned char) );
+	memset( &ep->slot[ep->size * NUM_FDTYPES], 0, (size - ep->size) * NUM_FDTYPES * sizeof(int) );
+	ep->size = size;
+
+	return( 0 );
+}
+
+static  int     E_epoll_slot( int priority, int fd, int fd_type )
+{
+	if( fd < 0 || fd >= Epoll_prio[priority].size ) return( -1 );
+
+	return( Epoll_prio[priority].slot[fd * NUM_FDTYPES + fd_type] - 1 );
+}
+
+/* Recomputes which fd_types of fd are active at priority and brings the
+ * registration in that priority's epoll set up to date.
+ */
+static  void    E_epoll_update( int priority, int fd )
+{
+	epoll_prio		*ep = &Epoll_prio[priority];
+	struct epoll_event	ev;
+	int			fd_type, j;
+	int			want, op, ret;
+
+	if( fd >= ep->size ) return;
+
+	want = 0;
+	for( fd_type=0; fd_type < NUM_FDTYPES; fd_type++ )
+	{
+		j = E_epoll_slot( priority, fd, fd_type );
+		if( j >= 0 && Fd_queue[priority].events[j].active )
+			want |= ( 1 << fd_type );
+	}
+	if( want == ep->interest[fd] ) return;
+
+	memset( &ev, 0, sizeof(ev) );
+	if( want & ( 1 << READ_FD ) )	ev.events |= EPOLLIN;
+	if( want & ( 1 << WRITE_FD ) )	ev.events |= EPOLLOUT;
+	if( want & ( 1 << EXCEPT_FD ) )	ev.events |= EPOLLPRI;
+	ev.data.fd = fd;
+
+	if( want == 0 )			op = EPOLL_CTL_DEL;
+	else if( ep->interest[fd] == 0 )	op = EPOLL_CTL_ADD;
+	else				op = EPOLL_CTL_MOD;
+
+	ret = epoll_ctl( ep->epfd, op, fd, &ev );
+	if( ret < 0 )
+	{
+		/* A closed fd is dropped by the kernel, and its number may have been reused since */
+		if( op == EPOLL_CTL_MOD && errno == ENOENT )
+			ret = epoll_ctl( ep->epfd, EPOLL_CTL_ADD, fd, &ev );
+		else if( op == EPOLL_CTL_ADD && errno == EEXIST )
+			ret = epoll_ctl( ep->epfd, EPOLL_CTL_MOD, fd, &ev );
+		else if( op == EPOLL_CTL_DEL && ( errno == ENOENT || errno == EBADF ) )
+			ret = 0;
+	}
+	if( ret < 0 )
+		Alarm( PRINT, "E_epoll_update: epoll_ctl(%d) failed for fd %d priority %d: %s\n",
+			op, fd, priority, strerror(errno) );
+
+	ep->interest[fd] = want;
+}
+
+static  void    E_epoll_threshold(void)
+{
+	struct epoll_event	ev;
+	int			i, want;
+
+	for( i=0; i < NUM_PRIORITY; i++ )
+	{
+		want = ( i >= Active_priority );
+		if( want == Epoll_prio[i].in_top ) continue;
+
+		memset( &ev, 0, sizeof(ev) );
+		ev.events = EPOLLIN;
+		ev.data.u32 = i;
+		if( epoll_ctl( Epoll_top, want ? EPOLL_CTL_ADD : EPOLL_CTL_DEL, Epoll_prio[i].epfd, &ev ) < 0 )
+			Alarm( EXIT, "E_epoll_threshold: epoll_ctl failed for priority %d: %s\n", i, strerror(errno) );
+		Epoll_prio[i].in_top = want;
+	}
+}
+
+/* Waits on the priorities at or above the threshold. On return the ready
+ * array of each priority holds its ready fds, with events rewritten as
+ * fd_type bits. Returns the number of ready (fd, fd_type) pairs like select.
+ */
+static  int     E_epoll_wait( sp_time timeout )
+{
+	struct epoll_event	top[NUM_PRIORITY];
+	epoll_prio		*ep;
+	unsigned int		revents, bits;
+	int			num_top, num_set;
+	int			msec;
+	int			i, k;
+
+	for( i=0; i < NUM_PRIORITY; i++ )
+		Epoll_prio[i].num_ready = 0;
+
+	msec = timeout.sec * 1000 + ( timeout.usec + 999 ) / 1000;
+	num_top = epoll_wait( Epoll_top, top, NUM_PRIORITY, msec );
+	if( num_top <= 0 ) return( num_top );
+
+	num_set = 0;
+	for( i=0; i < num_top; i++ )
+	{
+		ep = &Epoll_prio[top[i].data.u32];
+		ep->num_ready = epoll_wait( ep->epfd, ep->ready, MAX_FD_EVENTS, 0 );
+		if( ep->num_ready < 0 )
+		{
+			ep->num_ready = 0;
+			continue;
+		}
+		for( k=0; k < ep->num_ready; k++ )
+		{
+			revents = ep->ready[k].events;
+			bits = 0;
+			/* select reports errors and hangups as readable and writable */
+			if( revents & ( EPOLLIN | EPOLLERR | EPOLLHUP ) )	bits |= ( 1 << READ_FD );
+			if( revents & ( EPOLLOUT | EPOLLERR | EPOLLHUP ) )	bits |= ( 1 << WRITE_FD );
+			if( revents & EPOLLPRI )				bits |= ( 1 << EXCEPT_FD );
+			bits &= ep->interest[ep->ready[k].data.fd];
+			ep->ready[k].events = bits;
+			for( ; bits; bits &= bits - 1 )
+				num_set++;
+		}
+	}
+	return( num_set );
+}
+#endif  /* EVENTS_USE_EPOLL */
+
 int 	E_init(void)
 {
 	int	i,ret;
 	
-	Time_queue = NULL;
+	while( Time_heap_num > 0 )
+		dispose( Time_heap[--Time_heap_num] );
+	free( Time_heap );
+	free( Time_hash );
+	Time_heap      = NULL;
+	Time_heap_size = 0;
+	Time_hash      = NULL;
+	Time_hash_size = 0;
+	Time_seq       = 0;
 
         ret = Mem_init_object(TIME_EVENT, "time_event", sizeof(time_event), 100,0);
         if (ret < 0)
@@ -148,6 +391,11 @@ int 	E_init(void)
         }
 	Active_priority = LOW_PRIORITY;
 
+#ifdef  EVENTS_USE_EPOLL
+	E_epoll_init();
+	if( Use_epoll ) E_epoll_threshold();
+#endif
+
 	E_get_time_monotonic();
 
 	Alarm( EVENTS, "E_init: went ok\n");
@@ -251,175 +499,218 @@ int	E_compare_time( sp_time t1, sp_time t2 )
 	else			      return (  0 );
 }
 
-int 	E_queue( void (* func)( int code, void *data ), int code, void *data,
-		 sp_time delta_time )
+/* Pending time events are kept in a binary min-heap ordered by (t, seq)
+ * and indexed by a hash on (func, code, data), so queueing, requeueing and
+ * dequeueing are O(log n) and requeueing an event already in the queue
+ * updates it in place.
+ */
+static	int	E_time_before( time_event *a, time_event *b )
 {
-	time_event *t_pre;
-	time_event *t_post;
-	time_event *t_e;
-	int	   inserted;
-	int	   deleted;
-	int	   compare;
+	int	compare;
 
-	t_e       = new( TIME_EVENT );
+	compare = E_compare_time( a->t, b->t );
+	if( compare != 0 ) return( compare < 0 );
+	/* same time: the one queued first runs first */
+	return( (int32) ( a->seq - b->seq ) < 0 );
+}
 
-	t_e->t    = E_add_time( E_get_time_monotonic(), delta_time );
-	t_e->func = func;
-        t_e->code = code;
-        t_e->data = data;
-	deleted   = 0;
-	inserted  = 0;
+static	void	E_heap_place( time_event *t_e, int index )
+{
+	Time_heap[index] = t_e;
+	t_e->heap_index  = index;
+}
+
+static	void	E_heap_up( int index )
+{
+	time_event	*t_e = Time_heap[index];
+	int		parent;
 
-	if( Time_queue != NULL )
+	while( index > 0 )
 	{
-		if( Time_queue->func == t_e->func && 
-                    Time_queue->data == t_e->data &&
-                    Time_queue->code == t_e->code )
-		{
-			t_pre = Time_queue;
-			Time_queue = Time_queue->next;
-			dispose( t_pre );
-			deleted = 1;
-			Alarm( EVENTS, "E_queue: dequeued a (first) simillar event\n" );
-		}
+		parent = ( index - 1 ) / 2;
+		if( !E_time_before( t_e, Time_heap[parent] ) ) break;
+		E_heap_place( Time_heap[parent], index );
+		index = parent;
 	}
-	if( Time_queue == NULL )
+	E_heap_place( t_e, index );
+}
+
+static	void	E_heap_down( int index )
+{
+	time_event	*t_e = Time_heap[index];
+	int		child;
+
+	while( ( child = 2 * index + 1 ) < Time_heap_num )
 	{
-		t_e->next  = NULL;
-		Time_queue = t_e;
-		Alarm( EVENTS, "E_queue: (only) event queued func 0x%x code %d data 0x%x in future (%u:%u)\n",t_e->func,t_e->code, t_e->data, delta_time.sec, delta_time.usec );
-		return( 0 );
-	}else{
-		compare = E_compare_time ( t_e->t, Time_queue->t );
-		if( compare < 0 )
-		{
-			t_e->next   = Time_queue;
-			Time_queue  = t_e;
-			inserted    = 1;
-			Alarm( EVENTS, "E_queue: (first) event queued func 0x%x code %d data 0x%x in future (%u:%u)\n",t_e->func,t_e->code, t_e->data, delta_time.sec,delta_time.usec );
-		}
+		if( child + 1 < Time_heap_num && E_time_before( Time_heap[child+1], Time_heap[child] ) )
+			child++;
+		if( !E_time_before( Time_heap[child], t_e ) ) break;
+		E_heap_place( Time_heap[child], index );
+		index = child;
 	}
-	t_pre    = Time_queue ; 
-	t_post   = Time_queue->next;
-	while ( t_post != NULL && ( !inserted || !deleted ) )
+	E_heap_place( t_e, index );
+}
+
+static	void	E_heap_remove( time_event *t_e )
+{
+	int		index = t_e->heap_index;
+	time_event	*last;
+
+	Time_heap_num--;
+	if( index == Time_heap_num ) return;
+
+	last = Time_heap[Time_heap_num];
+	E_heap_place( last, index );
+	if( index > 0 && E_time_before( last, Time_heap[( index - 1 ) / 2] ) )
+		E_heap_up( index );
+	else	E_heap_down( index );
+}
+
+static	int32u	E_time_hash( void (* func)( int code, void *data ), int code, void *data )
+{
+	unsigned long	h;
+
+	h  = (unsigned long) func ^ ( (unsigned long) data >> 3 ) ^ ( (unsigned long) code * 40503UL );
+	h ^= h >> 16;
+	h *= 0x45d9f3bUL;
+	h ^= h >> 16;
+
+	return( (int32u) h & ( Time_hash_size - 1 ) );
+}
+
+static	time_event	*E_time_lookup( void (* func)( int code, void *data ), int code, void *data )
+{
+	time_event	*t_e;
+
+	if( Time_hash_size == 0 ) return( NULL );
+
+	for( t_e = Time_hash[E_time_hash( func, code, data )]; t_e != NULL; t_e = t_e->next )
 	{
-		if( t_post->func == t_e->func && 
-                    t_post->data == t_e->data &&
-                    t_post->code == t_e->code )
-		{
-			t_pre->next = t_post->next;
-			dispose( t_post );
-			t_post = t_pre->next;
-			deleted = 1;
-			Alarm( EVENTS, "E_queue: dequeued a simillar event\n" );
-			continue;
-		}
+		if( t_e->func == func && t_e->data == data && t_e->code == code )
+			return( t_e );
+	}
+	return( NULL );
+}
+
+static	void	E_time_unhash( time_event *t_e )
+{
+	time_event	**t_pp;
+
+	for( t_pp = &Time_hash[E_time_hash( t_e->func, t_e->code, t_e->data )]; *t_pp != t_e; t_pp = &(*t_pp)->next )
+		;
+	*t_pp = t_e->next;
+}
 
-		if ( !inserted )
+/* Grows the heap and the hash table so one more event fits. The hash
+ * table keeps at least as many buckets as the heap has slots.
+ */
+static	void	E_time_grow(void)
+{
+	time_event	**heap, **hash;
+	time_event	*t_e, *t_next;
+	int		size, i;
+	int32u		bucket;
+
+	if( Time_heap_num < Time_heap_size ) return;
+
+	size = 2 * Time_heap_size;
+	if( size < 64 ) size = 64;
+
+	heap = realloc( Time_heap, size * sizeof(time_event *) );
+	hash = calloc( size, sizeof(time_event *) );
+	if( heap == NULL || hash == NULL )
+		Alarm( EXIT, "E_time_grow: Failure to allocate time queue for %d events\n", size );
+	Time_heap = heap;
+
+	/* Time_hash_size is used by E_time_hash so it changes before rehashing */
+	i = Time_hash_size;
+	Time_hash_size = size;
+	for( i--; i >= 0; i-- )
+	{
+		for( t_e = Time_hash[i]; t_e != NULL; t_e = t_next )
 		{
-			compare = E_compare_time ( t_e->t, t_post->t );
-			if( compare < 0 )
-			{
-				t_pre->next = t_e;
-				t_e->next   = t_post;
-				inserted    = 1;
-				Alarm( EVENTS, "E_queue: event queued for func 0x%x code %d data 0x%x in future (%u:%u)\n",t_e->func,t_e->code, t_e->data, delta_time.sec, delta_time.usec );
-			}
+			t_next = t_e->next;
+			bucket = E_time_hash( t_e->func, t_e->code, t_e->data );
+			t_e->next = hash[bucket];
+			hash[bucket] = t_e;
 		}
-
-		t_pre  = t_post;
-		t_post = t_post->next;
 	}
+	free( Time_hash );
+	Time_hash = hash;
+	Time_heap_size = size;
+}
+
+int 	E_queue( void (* func)( int code, void *data ), int code, void *data,
+		 sp_time delta_time )
+{
+	time_event *t_e;
+	int32u	   bucket;
 
-	if( !inserted )
+	t_e = E_time_lookup( func, code, data );
+	if( t_e != NULL )
 	{
-		t_pre->next = t_e;
-		t_e->next   = NULL;
-		Alarm( EVENTS, "E_queue: (last) event queued func 0x%x code %d data 0x%x in future (%u:%u)\n",t_e->func,t_e->code, t_e->data, delta_time.sec,delta_time.usec );
+		/* Reschedule in place */
+		t_e->t   = E_add_time( E_get_time_monotonic(), delta_time );
+		t_e->seq = Time_seq++;
+		E_heap_down( t_e->heap_index );
+		E_heap_up( t_e->heap_index );
+		Alarm( EVENTS, "E_queue: requeued event func 0x%x code %d data 0x%x in future (%u:%u)\n",t_e->func,t_e->code, t_e->data, delta_time.sec, delta_time.usec );
+		return( 0 );
 	}
 
+	E_time_grow();
+
+	t_e       = new( TIME_EVENT );
+
+	t_e->t    = E_add_time( E_get_time_monotonic(), delta_time );
+	t_e->func = func;
+        t_e->code = code;
+        t_e->data = data;
+	t_e->seq  = Time_seq++;
+
+	bucket = E_time_hash( func, code, data );
+	t_e->next = Time_hash[bucket];
+	Time_hash[bucket] = t_e;
+
+	E_heap_place( t_e, Time_heap_num++ );
+	E_heap_up( t_e->heap_index );
+
+	Alarm( EVENTS, "E_queue: event queued func 0x%x code %d data 0x%x in future (%u:%u)\n",t_e->func,t_e->code, t_e->data, delta_time.sec, delta_time.usec );
+
 	return( 0 );
 }
 
 int 	E_dequeue( void (* func)( int code, void *data ), int code,
 		   void *data )
 {
-	time_event *t_pre;
-	time_event *t_ptr;
+	time_event *t_e;
 
-	if( Time_queue == NULL )
+	t_e = E_time_lookup( func, code, data );
+	if( t_e == NULL )
 	{
 		Alarm( EVENTS, "E_dequeue: no such event\n" );
 		return( -1 );
 	}
 
-	if( Time_queue->func == func && 
-            Time_queue->data == data &&
-            Time_queue->code == code )
-	{
-		t_ptr = Time_queue;
-		Time_queue = Time_queue->next;
-		dispose( t_ptr );
-		Alarm( EVENTS, "E_dequeue: first event dequeued func 0x%x code %d data 0x%x\n",func,code, data);
-		return( 0 );
-	}
-
-	t_pre = Time_queue;
-	while ( t_pre->next != NULL )
-	{
-		t_ptr = t_pre->next;
-		if( t_ptr->func == func && 
-                    t_ptr->data == data &&
-                    t_ptr->code == code )   
-		{
-			t_pre->next = t_ptr->next;
-			dispose( t_ptr );
-			Alarm( EVENTS, "E_dequeue: event dequeued func 0x%x code %d data 0x%x\n",func,code, data);
-			return( 0 );
-		}
-		t_pre = t_ptr;
-	}
+	E_time_unhash( t_e );
+	E_heap_remove( t_e );
+	dispose( t_e );
+	Alarm( EVENTS, "E_dequeue: event dequeued func 0x%x code %d data 0x%x\n",func,code, data);
 
-	Alarm( EVENTS, "E_dequeue: no such event\n" );
-	return( -1 );
+	return( 0 );
 }
 
 int 	E_in_queue( void (* func)( int code, void *data ), int code,
 		   void *data )
 {
-	time_event *t_pre;
-	time_event *t_ptr;
-
-	if( Time_queue == NULL )
+	if( E_time_lookup( func, code, data ) == NULL )
 	{
-	    Alarm( EVENTS, "E_in_queue: no such event\n" );
+		Alarm( EVENTS, "E_in_queue: no such event\n" );
 		return( 0 );
 	}
 
-	if( Time_queue->func == func && 
-            Time_queue->data == data &&
-            Time_queue->code == code )
-	{
-		Alarm( EVENTS, "E_in_queue: found event in queue func 0x%x code %d data 0x%x\n",func,code, data);
-		return( 1 );
-	}
-
-	t_pre = Time_queue;
-	while ( t_pre->next != NULL )
-	{
-		t_ptr = t_pre->next;
-		if( t_ptr->func == func && 
-                    t_ptr->data == data &&
-                    t_ptr->code == code )   
-		{
-		    Alarm( EVENTS, "E_in_queue: found event in queue func 0x%x code %d data 0x%x\n",func,code, data);
-			return(1);
-		}
-		t_pre = t_ptr;
-	}
-
-	Alarm( EVENTS, "E_in_queue: no such event\n" );
-	return( 0 );
+	Alarm( EVENTS, "E_in_queue: found event in queue func 0x%x code %d data 0x%x\n",func,code, data);
+	return( 1 );
 }
 
 
@@ -571,6 +862,18 @@ int	E_attach_fd( int fd, int fd_type,
 		Alarm( PRINT, "E_attach_fd: invalid fd_type %d for fd %d with priority %d\n", fd_type, fd, priority );
 		return( -1 );
 	}
+#ifdef  EVENTS_USE_EPOLL
+	if( Use_epoll )
+	{
+		/* epoll has no FD_SETSIZE limit */
+		if( fd < 0 || E_epoll_grow( priority, fd ) < 0 )
+		{
+			Alarm( PRINT, "E_attach_fd: invalid fd %d with fd_type %d with priority %d\n", fd, fd_type, priority );
+			return( -1 );
+		}
+	} else
+#endif
+	{
 #ifndef	ARCH_PC_WIN95
 	/* Windows bug: Reports FD_SETSIZE of 64 but select works on all
 	 * fd's even ones with numbers greater then 64.
@@ -581,6 +884,7 @@ int	E_attach_fd( int fd, int fd_type,
                 return( -1 );
         }
 #endif
+	}
 	for( j=0; j < Fd_queue[priority].num_fds; j++ )
 	{
 		if( ( Fd_queue[priority].events[j].fd == fd ) && ( Fd_queue[priority].events[j].fd_type == fd_type ) )
@@ -591,6 +895,9 @@ int	E_attach_fd( int fd, int fd_type,
                         if ( !(Fd_queue[priority].events[j].active) )
                                 Fd_queue[priority].num_active_fds++;
                         Fd_queue[priority].events[j].active = TRUE;
+#ifdef  EVENTS_USE_EPOLL
+			if( Use_epoll ) E_epoll_update( priority, fd );
+#endif
 			Alarm( EVENTS, 
 				"E_attach_fd: fd %d with type %d exists & replaced & activated\n", fd, fd_type );
 			return( 1 );
@@ -610,6 +917,13 @@ int	E_attach_fd( int fd, int fd_type,
         Fd_queue[priority].events[num_fds].active  = TRUE;
 	Fd_queue[priority].num_fds++;
         Fd_queue[priority].num_active_fds++;
+#ifdef  EVENTS_USE_EPOLL
+	if( Use_epoll )
+	{
+		Epoll_prio[priority].slot[fd * NUM_FDTYPES + fd_type] = num_fds + 1;
+		E_epoll_update( priority, fd );
+	} else
+#endif
 	if( Active_priority <= priority ) FD_SET( fd, &Fd_mask[fd_type] );
 
 	Alarm( EVENTS, "E_attach_fd: fd %d, fd_type %d, code %d, data 0x%x, priority %d Active_priority %d\n",
@@ -664,6 +978,16 @@ int 	E_detach_fd_priority( int fd, int fd_type, int priority )
 	            Fd_queue[priority].num_fds--;
 		    Fd_queue[priority].events[i] = Fd_queue[priority].events[Fd_queue[priority].num_fds];
 
+#ifdef  EVENTS_USE_EPOLL
+		    if( Use_epoll )
+		    {
+			    if( i != Fd_queue[priority].num_fds )
+				    Epoll_prio[priority].slot[Fd_queue[priority].events[i].fd * NUM_FDTYPES +
+							      Fd_queue[priority].events[i].fd_type] = i + 1;
+			    Epoll_prio[priority].slot[fd * NUM_FDTYPES + fd_type] = 0;
+			    E_epoll_update( priority, fd );
+		    } else
+#endif
 		    FD_CLR( fd, &Fd_mask[fd_type] );
 		    found = 1;
 
@@ -697,6 +1021,10 @@ int     E_deactivate_fd( int fd, int fd_type )
                         if (Fd_queue[i].events[j].active)
                                 Fd_queue[i].num_active_fds--;
                         Fd_queue[i].events[j].active = FALSE;
+#ifdef  EVENTS_USE_EPOLL
+			if( Use_epoll ) E_epoll_update( i, fd );
+			else
+#endif
 			FD_CLR( fd, &Fd_mask[fd_type] );
 			found = 1;
 
@@ -729,6 +1057,10 @@ int     E_activate_fd( int fd, int fd_type )
                         if ( !(Fd_queue[i].events[j].active) )
                                 Fd_queue[i].num_active_fds++;
                         Fd_queue[i].events[j].active = TRUE;
+#ifdef  EVENTS_USE_EPOLL
+			if( Use_epoll ) E_epoll_update( i, fd );
+			else
+#endif
 			if( i >= Active_priority ) FD_SET( fd, &Fd_mask[ fd_type ] );
 			found = 1;
 
@@ -754,6 +1086,14 @@ int 	E_set_active_threshold( int priority )
 	if( priority == Active_priority ) return( priority );
 
 	Active_priority = priority;
+#ifdef  EVENTS_USE_EPOLL
+	if( Use_epoll )
+	{
+		E_epoll_threshold();
+		Alarm( EVENTS, "E_set_active_threshold: changed to %d\n",Active_priority);
+		return( priority );
+	}
+#endif
 	for ( i=0; i < NUM_FDTYPES; i++ )
         {
 		FD_ZERO( &Fd_mask[i] );
@@ -782,15 +1122,41 @@ int	E_num_active( int priority )
 	return( Fd_queue[priority].num_active_fds );
 }
 
+#ifdef  BADCLOCK
+static	const sp_time		mili_sec 	= {     0, 1000};
+static	int			Clock_sync;
+#endif
+
+/* Runs the handler of Fd_queue[priority].events[j] and records its duration */
+static	void	E_exec_fd_event( int priority, int j )
+{
+	sp_time		ev_start;
+
+#ifdef BADCLOCK
+	Now = E_add_time( Now, mili_sec );
+	Clock_sync++;
+#else
+	E_get_time_monotonic();
+#endif
+	ev_start = Now;
+	Fd_queue[priority].events[j].func( 
+			Fd_queue[priority].events[j].fd,
+			Fd_queue[priority].events[j].code,
+			Fd_queue[priority].events[j].data );
+#ifdef BADCLOCK
+	Now = E_add_time( Now, mili_sec );
+	Clock_sync++;
+#else
+	E_get_time_monotonic();
+#endif
+	E_time_events( ev_start, Now, &(Fd_queue[priority].events[j]), NULL );
+}
+
 void 	E_handle_events(void)
 {
 static	int			Round_robin	= 0;
 static	const sp_time		long_timeout 	= { 10000,    0};
 static  const sp_time           zero_sec        = {     0,    0};
-#ifdef  BADCLOCK
-static	const sp_time		mili_sec 	= {     0, 1000};
-	int			clock_sync;
-#endif
 	int			num_set;
 	int			treated;
 	int			fd;
@@ -802,11 +1168,16 @@ static	const sp_time		mili_sec 	= {     0, 1000};
 	time_event		*temp_ptr;
         int                     first=1;
         sp_time                 ev_start;
+#ifdef  EVENTS_USE_EPOLL
+	epoll_prio		*ep;
+	unsigned int		bits;
+	int			k, best, dist, best_dist;
+#endif
 #ifdef TESTTIME
         sp_time         	tmp_late,start,stop,req_time;       /* DEBUGGING */
 #endif
 #ifdef BADCLOCK
-    clock_sync = 0;
+    Clock_sync = 0;
 #endif
     for( Exit_events = 0 ; !Exit_events ; )
     {
@@ -817,42 +1188,43 @@ static	const sp_time		mili_sec 	= {     0, 1000};
 #ifdef TESTTIME
         start = E_get_time_monotonic();
 #endif
-	while( Time_queue != NULL )
+	while( Time_heap_num > 0 )
 	{
 #ifdef BADCLOCK
-		if ( clock_sync >= 0 )
+		if ( Clock_sync >= 0 )
 		{
 		    E_get_time_monotonic();
-		    clock_sync = -20;
+		    Clock_sync = -20;
 		}
 #else
                 E_get_time_monotonic();
 #endif
-		if ( !first && E_compare_time( Now, Time_queue->t ) >= 0 )
+		if ( !first && E_compare_time( Now, Time_heap[0]->t ) >= 0 )
 		{
 #ifdef TESTTIME
-                        tmp_late = E_sub_time( Now, Time_queue->t );
+                        tmp_late = E_sub_time( Now, Time_heap[0]->t );
 #endif
-			temp_ptr = Time_queue;
-			Time_queue = Time_queue->next;
+			temp_ptr = Time_heap[0];
+			E_time_unhash( temp_ptr );
+			E_heap_remove( temp_ptr );
 			Alarm( EVENTS, "E_handle_events: exec time event \n");
 #ifdef TESTTIME 
                         Alarm( DEBUG, "Events: TimeEv is %d %d late\n",tmp_late.sec, tmp_late.usec); 
 #endif
                         ev_start = Now;
 			temp_ptr->func( temp_ptr->code, temp_ptr->data );
-			dispose( temp_ptr );
 #ifdef BADCLOCK
 			Now = E_add_time( Now, mili_sec );
-			clock_sync++;
+			Clock_sync++;
 #else
                         E_get_time_monotonic();
 #endif
                         E_time_events( ev_start, Now, NULL, temp_ptr );
+			dispose( temp_ptr );
 
                         if (Exit_events) goto end_handler;
 		}else{
-			timeout = E_sub_time( Time_queue->t, Now );
+			timeout = E_sub_time( Time_heap[0]->t, Now );
 			break;
 		}
 	}
@@ -864,14 +1236,34 @@ static	const sp_time		mili_sec 	= {     0, 1000};
         Alarm(DEBUG, "Events: TimeEv's took %d %d to handle\n", tmp_late.sec, tmp_late.usec); 
 #endif
 	/* Handle fd events   */
+#ifdef TESTTIME
+        req_time = zero_sec;
+#endif
+#ifdef  EVENTS_USE_EPOLL
+	if( Use_epoll )
+	{
+		Alarm( EVENTS, "E_handle_events: poll epoll\n");
+		num_set = E_epoll_wait( zero_sec );
+		if (num_set == 0 && !Exit_events)
+		{
+#ifdef BADCLOCK
+			Clock_sync = 0;
+#endif
+			Alarm( EVENTS, "E_handle_events: epoll with timeout (%d, %d)\n",
+				timeout.sec,timeout.usec );
+#ifdef TESTTIME
+	                req_time = E_add_time(req_time, timeout);
+#endif
+			num_set = E_epoll_wait( timeout );
+		}
+	} else
+#endif
+	{
 	for( i=0; i < NUM_FDTYPES; i++ )
 	{
 		current_mask[i] = Fd_mask[i];
 	}
 	Alarm( EVENTS, "E_handle_events: poll select\n");
-#ifdef TESTTIME
-        req_time = zero_sec;
-#endif
         wait_timeout.tv_sec = zero_sec.sec;
         wait_timeout.tv_usec = zero_sec.usec;
 	num_set = select( FD_SETSIZE, &current_mask[READ_FD], &current_mask[WRITE_FD], &current_mask[EXCEPT_FD], 
@@ -879,7 +1271,7 @@ static	const sp_time		mili_sec 	= {     0, 1000};
 	if (num_set == 0 && !Exit_events)
 	{
 #ifdef BADCLOCK
-		clock_sync = 0;
+		Clock_sync = 0;
 #endif
 		for( i=0; i < NUM_FDTYPES; i++ )
 		{
@@ -895,6 +1287,7 @@ static	const sp_time		mili_sec 	= {     0, 1000};
 		num_set = select( FD_SETSIZE, &current_mask[READ_FD], &current_mask[WRITE_FD], 
 				  &current_mask[EXCEPT_FD], &sel_timeout );
 	}
+	}
 #ifdef TESTTIME
         start = E_get_time_monotonic();
         tmp_late = E_sub_time(start, stop);
@@ -905,6 +1298,33 @@ static	const sp_time		mili_sec 	= {     0, 1000};
 	     i > LOW_PRIORITY && num_set > 0 && !treated;
 	     i-- )
 	{
+#ifdef  EVENTS_USE_EPOLL
+	    if( Use_epoll )
+	    {
+		/* Only the ready fds are visited, so cost does not grow with idle fds */
+		ep = &Epoll_prio[i];
+		for( k=0; k < ep->num_ready && num_set > 0; k++ )
+		{
+		    fd = ep->ready[k].data.fd;
+		    for( fd_type=0; fd_type < NUM_FDTYPES && num_set > 0; fd_type++ )
+		    {
+			if( !( ep->ready[k].events & ( 1 << fd_type ) ) ) continue;
+			/* an earlier handler may have detached it */
+			j = E_epoll_slot( i, fd, fd_type );
+			if( j < 0 ) continue;
+
+			Alarm( EVENTS, "E_handle_events: exec handler for fd %d, fd_type %d, priority %d\n", 
+					fd, fd_type, i );
+			E_exec_fd_event( i, j );
+			treated = 1;
+			num_set--;
+
+			if (Exit_events) goto end_handler;
+		    }
+		}
+		continue;
+	    }
+#endif
 	    for( j=0; j < Fd_queue[i].num_fds && num_set > 0; j++ )
 	    {
 		fd      = Fd_queue[i].events[j].fd;
@@ -913,26 +1333,9 @@ static	const sp_time		mili_sec 	= {     0, 1000};
 		{
 		    Alarm( EVENTS, "E_handle_events: exec handler for fd %d, fd_type %d, priority %d\n", 
 					fd, fd_type, i );
-#ifdef BADCLOCK
-		    Now = E_add_time( Now, mili_sec );
-		    clock_sync++;
-#else
-                    E_get_time_monotonic();
-#endif
-                    ev_start = Now;
-		    Fd_queue[i].events[j].func( 
-				Fd_queue[i].events[j].fd,
-				Fd_queue[i].events[j].code,
-				Fd_queue[i].events[j].data );
+		    E_exec_fd_event( i, j );
 		    treated = 1;
 		    num_set--;
-#ifdef BADCLOCK
-		    Now = E_add_time( Now, mili_sec );
-		    clock_sync++;
-#else
-                    E_get_time_monotonic();
-#endif
-                    E_time_events(ev_start, Now, &(Fd_queue[i].events[j]), NULL);
 
                     if (Exit_events) goto end_handler;
 		}
@@ -956,6 +1359,43 @@ static	const sp_time		mili_sec 	= {     0, 1000};
            However, verify that Active_priority still allows LOW_PRIORITY events. 
            Active_priority can change because of calls to E_set_threshold() during the current select loop.
         */
+#ifdef  EVENTS_USE_EPOLL
+	if( Use_epoll )
+	{
+	    /* Pick the ready fd that comes first in round robin order */
+	    ep   = &Epoll_prio[LOW_PRIORITY];
+	    best = -1;
+	    best_dist = 0;
+	    for( k=0; k < ep->num_ready 
+                      && num_set > 0 
+                      && Active_priority == LOW_PRIORITY; 
+                 k++ )
+	    {
+		for( bits = ep->ready[k].events, fd_type=0; fd_type < NUM_FDTYPES; fd_type++ )
+		{
+		    if( !( bits & ( 1 << fd_type ) ) ) continue;
+		    j = E_epoll_slot( LOW_PRIORITY, ep->ready[k].data.fd, fd_type );
+		    if( j < 0 ) continue;
+		    dist = ( j - Round_robin + Fd_queue[LOW_PRIORITY].num_fds ) % Fd_queue[LOW_PRIORITY].num_fds;
+		    if( best < 0 || dist < best_dist )
+		    {
+			best = j;
+			best_dist = dist;
+		    }
+		}
+	    }
+	    if( best >= 0 )
+	    {
+		Round_robin = ( best + 1 ) % Fd_queue[LOW_PRIORITY].num_fds;
+
+		Alarm( EVENTS , "E_handle_events: exec ext fd event \n");
+		E_exec_fd_event( LOW_PRIORITY, best );
+		num_set--;
+
+                if (Exit_events) goto end_handler;
+	    }
+	} else
+#endif
 	for( i=0; i < Fd_queue[LOW_PRIORITY].num_fds 
                      && num_set > 0
                      && Active_priority == LOW_PRIORITY; 
@@ -969,26 +1409,8 @@ static	const sp_time		mili_sec 	= {     0, 1000};
 		Round_robin = ( j + 1 ) % Fd_queue[LOW_PRIORITY].num_fds;
 
 		Alarm( EVENTS , "E_handle_events: exec ext fd event \n");
-#ifdef BADCLOCK
-                Now = E_add_time( Now, mili_sec );
-                clock_sync++;
-#else
-                E_get_time_monotonic();
-#endif
-                ev_start = Now;
-	 	Fd_queue[LOW_PRIORITY].events[j].func( 
-				Fd_queue[LOW_PRIORITY].events[j].fd,
-				Fd_queue[LOW_PRIORITY].events[j].code,
-				Fd_queue[LOW_PRIORITY].events[j].data );
+		E_exec_fd_event( LOW_PRIORITY, j );
 		num_set--;
-#ifdef BADCLOCK
-		Now = E_add_time( Now, mili_sec );
-		clock_sync++;
-#else
-                E_get_time_monotonic();
-#endif
-
-                E_time_events(ev_start, Now, &(Fd_queue[LOW_PRIORITY].events[j]), NULL);
 
                 if (Exit_events) goto end_handler;
 		break;
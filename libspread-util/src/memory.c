@@ -723,6 +723,41 @@ int             get_ref_cnt(void *object)
     return(mem_header_ptr(object)->ref_cnt);
 }            
 
+/* Input: a valid pointer to an object created by new or new_ref_cnt
+ * Output: the resulting number of holders
+ * Effects: Adds a holder to an object. An object created by new starts
+ * counting here, with 2 for the holder it had and the new one.
+ */
+int             share_ref_cnt(void *object)
+{
+    assert(object != NULL);
+    if(mem_header_ptr(object)->ref_cnt == NO_REF_CNT) {
+	mem_header_ptr(object)->ref_cnt = 1;
+    }
+    return(++mem_header_ptr(object)->ref_cnt);
+}
+
+/* Input: a valid pointer to an object created by new or passed to share_ref_cnt
+ * Output: the number of holders left besides the caller
+ * Effects: Drops a holder without disposing the object. When one holder is
+ * left the object goes back to being a plain object, so 0 means the caller
+ * was the last holder and must dispose it.
+ */
+int             unshare_ref_cnt(void *object)
+{
+    int ret;
+
+    assert(object != NULL);
+    if(mem_header_ptr(object)->ref_cnt == NO_REF_CNT) { return 0; }
+
+    assert(mem_header_ptr(object)->ref_cnt > 1);
+    ret = --mem_header_ptr(object)->ref_cnt;
+    if(ret == 1) {
+	mem_header_ptr(object)->ref_cnt = NO_REF_CNT;
+    }
+    return(ret);
+}
+
 
 char    *Objnum_to_String(int32u oid)
 {
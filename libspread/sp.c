@@ -38,6 +38,9 @@
 #include "arch.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <limits.h>
 
 #ifndef	ARCH_PC_WIN95
 
@@ -84,6 +87,26 @@ typedef struct dummy_membership_info {
         vs_set_info  my_vs_set;
 } membership_info;
 
+typedef struct dummy_sp_message {
+        service         service_type;
+        char            *sender;
+        int             num_groups;
+        char            (*groups)[MAX_GROUP_NAME];
+        int16           mess_type;
+        int             endian_mismatch;
+        int             data_len;
+        char            *data;
+} sp_message;
+
+typedef struct dummy_sp_buffer {
+        struct dummy_sp_buffer *next;   /* in the pool of its slot */
+        int     ses;                    /* slot whose pool takes it back */
+        int     size_class;             /* -1 for a buffer too big for the pool */
+        int     ref_cnt;
+} sp_buffer;
+
+#define SP_BUFFER_DATA( buf )   ( (char *) ( (buf) + 1 ) )     /* the message follows the sp_buffer */
+
 #include "sp_func.h"
 
 enum sp_sess_state {
@@ -92,16 +115,38 @@ enum sp_sess_state {
     SESS_ERROR,
 };
 
+#define SP_POOL_CLASSES         11              /* buffer sizes of SP_POOL_MIN_SIZE << 0..10 */
+#define SP_POOL_MIN_SIZE        256
+#define SP_POOL_MAX_BYTES       ( 1024 * 1024 ) /* pooled per slot; more is freed */
+
 typedef	struct	dummy_sp_session {
         mutex_type recv_mutex;
         mutex_type send_mutex;
-	mailbox	mbox;
-        enum sp_sess_state state;
+	volatile mailbox	mbox;
+        volatile enum sp_sess_state state;
+        volatile int    generation;     /* bumped whenever the slot is taken or given back */
 	char	private_group_name[MAX_GROUP_NAME];
         message_header  recv_saved_head;
         int     recv_message_saved;
+        char    *recv_buf;      /* bytes SP_receive_many read ahead; kept for the next session in the slot */
+        int     recv_buf_size;
+        int     recv_head;      /* first byte not handed out yet */
+        int     recv_tail;      /* end of the bytes read */
+        char    *send_buf;      /* messages batched or queued but not sent yet; kept like recv_buf */
+        int     send_buf_size;
+        int     send_head;      /* first byte not sent yet */
+        int     send_len;       /* end of the bytes in send_buf */
+        int     batching;       /* between SP_batch_begin and SP_batch_flush */
+        int     nonblocking;    /* set by SP_set_nonblocking */
+        mutex_type pool_mutex;  /* pool and the ref_cnt of the buffers handed out from it */
+        sp_buffer *pool[SP_POOL_CLASSES];  /* released buffers of SP_receive_buffer; kept like recv_buf */
+        int     pool_bytes;
 } sp_session;
 
+#define SP_RECV_BUF_SIZE        ( 64 * 1024 )   /* first size of recv_buf, doubled when a message needs it */
+#define SP_SEND_BUF_SIZE        ( 64 * 1024 )   /* a batch is sent when the next message would not fit;
+                                                 * a non-blocking session's queue grows past it */
+
 struct auth_method_info {
         char    name[MAX_AUTH_NAME];
         int     (*authenticate) (int, void *);
@@ -135,10 +180,36 @@ static	mutex_type	Struct_mutex;
 static	int		Num_sessions = 0;
 static	sp_session	Sessions[MAX_LIB_SESSIONS];
 
+/* Struct_mutex only serializes taking and giving back session slots. The
+ * send and receive paths find their session without it (sp_lookup_session)
+ * and check the slot's generation again once they hold its send_mutex or
+ * recv_mutex (sp_same_session); these barriers order the slot's fields
+ * against its mbox and generation for them. */
+#ifndef	_REENTRANT
+#define	SP_barrier()
+#elif	defined(ARCH_PC_WIN95)
+#define	SP_barrier()		MemoryBarrier()
+#else
+#define	SP_barrier()		__sync_synchronize()
+#endif
+
 static  sp_time         Zero_timeout = { 0, 0 };
 
 static	void    Flip_mess( message_header *head_ptr );
 static	int	SP_get_session( mailbox mbox );
+static	int	sp_lookup_session( mailbox mbox, int *generation );
+static	int	sp_same_session( int ses, mailbox mbox, int generation );
+static  int     sp_recv( int ses, mailbox mbox, char *buf, int len );
+static  int     sp_recv_room( int ses, int len );
+static  int     sp_recv_whole( int ses, int max_messages, int *missing );
+static  void    sp_recv_wait( mailbox mbox );
+static  int     sp_mess_len( const char *head_buf );
+static  void    sp_parse_mess( char *buf, const char *private_group, sp_message *mess );
+static  int     sp_recv_ready( int ses, mailbox mbox, int max_messages );
+static  sp_buffer *sp_buffer_get( int ses, int len );
+static  void    sp_flip_memb_body( char *body, int len );
+static  int     sp_send_room( int ses, int len );
+static  int     sp_send_batch( int ses, mailbox mbox, int wait );
 static	int	SP_internal_multicast( mailbox mbox, service service_type, 
 				       int num_groups,
 				       const char groups[][MAX_GROUP_NAME],
@@ -223,6 +294,7 @@ static  void    sp_atfork_child(void)
         {
             Mutex_unlock( &Sessions[ses].recv_mutex );
 	    Mutex_unlock( &Sessions[ses].send_mutex );
+	    Mutex_unlock( &Sessions[ses].pool_mutex );
         }
 }
 
@@ -243,6 +315,7 @@ static  void    sp_initialize(void)
 	{
 	        Mutex_init( &Sessions[ses].recv_mutex );
 		Mutex_init( &Sessions[ses].send_mutex );
+		Mutex_init( &Sessions[ses].pool_mutex );
 		Sessions[ses].mbox  = -1;
 		Sessions[ses].state = SESS_UNUSED;
 	}
@@ -908,10 +981,18 @@ int	SP_connect_timeout( const char *spread_name, const char *private_name,
 		}
 	}
 
-	Sessions[ses].mbox = s;
-        Sessions[ses].state = SESS_ACTIVE;
 	strcpy( Sessions[ses].private_group_name, private_group );
         Sessions[ses].recv_message_saved = 0;
+        Sessions[ses].recv_head = Sessions[ses].recv_tail = 0;
+        Sessions[ses].send_head = Sessions[ses].send_len = 0;
+        Sessions[ses].batching = 0;
+        Sessions[ses].nonblocking = 0;
+        Sessions[ses].generation++;
+
+        /* lookups without the Struct_mutex see the fields above once they see mbox */
+        SP_barrier();
+        Sessions[ses].state = SESS_ACTIVE;
+	Sessions[ses].mbox = s;
 
 	Mutex_unlock( &Struct_mutex );
 
@@ -1059,6 +1140,144 @@ int	SP_multigroup_scat_multicast( mailbox mbox, service service_type,
 	return( ret );
 }
 
+/* Messages multicast on mbox from here on are collected and sent together
+ * by SP_batch_flush, or sooner when the batch fills up */
+int	SP_batch_begin( mailbox mbox )
+{
+	int		ses;
+	int		generation;
+
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
+
+	Mutex_lock( &Sessions[ses].send_mutex );
+	if( !sp_same_session( ses, mbox, generation ) )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( ILLEGAL_SESSION );
+	}
+        if( Sessions[ses].state != SESS_ACTIVE )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( NET_ERROR_ON_SESSION );
+	}
+	if( sp_send_room( ses, 0 ) < 0 )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( BUFFER_TOO_SHORT );
+	}
+	Sessions[ses].batching = 1;
+	Mutex_unlock( &Sessions[ses].send_mutex );
+
+	return( 0 );
+}
+
+/* Sends the messages batched on mbox and ends the batch */
+int	SP_batch_flush( mailbox mbox )
+{
+	int		ses;
+	int		generation;
+	int		ret;
+
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
+
+	Mutex_lock( &Sessions[ses].send_mutex );
+	if( !sp_same_session( ses, mbox, generation ) )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( ILLEGAL_SESSION );
+	}
+        if( Sessions[ses].state != SESS_ACTIVE )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( NET_ERROR_ON_SESSION );
+	}
+	ret = sp_send_batch( ses, mbox, !Sessions[ses].nonblocking );
+	Sessions[ses].batching = 0;
+	Mutex_unlock( &Sessions[ses].send_mutex );
+
+	return( ret );
+}
+
+/* In non-blocking mode SP_receive_many returns 0 instead of waiting for a
+ * message, and multicasts the socket will not take are queued for
+ * SP_send_pending. Leaving it sends what is queued first. */
+int	SP_set_nonblocking( mailbox mbox, int nonblocking )
+{
+	int		ses;
+	int		generation;
+	int		on;
+	int		ret;
+
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
+
+	Mutex_lock( &Sessions[ses].send_mutex );
+	if( !sp_same_session( ses, mbox, generation ) )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( ILLEGAL_SESSION );
+	}
+        if( Sessions[ses].state != SESS_ACTIVE )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( NET_ERROR_ON_SESSION );
+	}
+	on = ( nonblocking != 0 );
+	if( !on && Sessions[ses].nonblocking && !Sessions[ses].batching )
+	{
+		ret = sp_send_batch( ses, mbox, 1 );
+		if( ret < 0 )
+		{
+			Mutex_unlock( &Sessions[ses].send_mutex );
+			return( ret );
+		}
+	}
+	ret = ioctl( mbox, FIONBIO, &on );
+	if( ret < 0 )
+	{
+		Alarm( SESSION, "SP_set_nonblocking: failed setting mailbox %d to %d: %s\n", mbox, on, sock_strerror(sock_errno) );
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( ILLEGAL_SESSION );
+	}
+	Sessions[ses].nonblocking = on;
+	Mutex_unlock( &Sessions[ses].send_mutex );
+
+	return( 0 );
+}
+
+/* Sends what a non-blocking mbox has queued, as far as the socket takes it.
+ * Returns the bytes still queued: while there are any, wait for mbox to be
+ * writable and call again. */
+int	SP_send_pending( mailbox mbox )
+{
+	int		ses;
+	int		generation;
+	int		ret;
+
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
+
+	Mutex_lock( &Sessions[ses].send_mutex );
+	if( !sp_same_session( ses, mbox, generation ) )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( ILLEGAL_SESSION );
+	}
+        if( Sessions[ses].state != SESS_ACTIVE )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( NET_ERROR_ON_SESSION );
+	}
+	ret = 0;
+	if( !Sessions[ses].batching ) ret = sp_send_batch( ses, mbox, 0 );
+	if( ret == 0 ) ret = Sessions[ses].send_len - Sessions[ses].send_head;
+	Mutex_unlock( &Sessions[ses].send_mutex );
+
+	return( ret );
+}
+
 static	int	SP_internal_multicast( mailbox mbox, service service_type, 
 				       int num_groups,
 				       const char groups[][MAX_GROUP_NAME],
@@ -1069,8 +1288,11 @@ static	int	SP_internal_multicast( mailbox mbox, service service_type,
 	char		head_buf[10000]; 
 	message_header	*head_ptr;
 	char		*group_ptr;
-	int		mess_len, len;
+	char		*batch_ptr;
+	int		mess_len, head_len, len;
+	int		num_elements;
 	int		ses;
+	int		generation;
 	int		i;
         int             buf_len;
 	int		ret;
@@ -1078,26 +1300,16 @@ static	int	SP_internal_multicast( mailbox mbox, service service_type,
         /* zero head_buf to avoid information leakage */
         memset( head_buf, 0, sizeof(message_header) + MAX_GROUP_NAME*num_groups );
 
-	Mutex_lock( &Struct_mutex );
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
 
-	ses = SP_get_session( mbox );
-	if( ses < 0 ){
-		Mutex_unlock( &Struct_mutex );
-		return( ILLEGAL_SESSION );
-	}
-
-        if( Sessions[ses].state != SESS_ACTIVE ) {
-		Mutex_unlock( &Struct_mutex );
-		return( NET_ERROR_ON_SESSION );
-	}
+        if( Sessions[ses].state != SESS_ACTIVE ) return( NET_ERROR_ON_SESSION );
 
 	head_ptr = (message_header *)head_buf;
 	group_ptr = &head_buf[ sizeof(message_header) ];
 
-	/* enter the private_group_name of this mbox */
-	strcpy( head_ptr->private_group_name, Sessions[ses].private_group_name );
-
-	Mutex_unlock( &Struct_mutex );
+	/* enter the private_group_name of this mbox; the slot is checked again under the send_mutex */
+	memcpy( head_ptr->private_group_name, Sessions[ses].private_group_name, MAX_GROUP_NAME );
 
 	for( i=0, mess_len=0; i < (int) scat_mess->num_elements; i++ )
 	{
@@ -1120,10 +1332,84 @@ static	int	SP_internal_multicast( mailbox mbox, service service_type,
 	head_ptr->data_len = mess_len;
 	memcpy( group_ptr, groups, MAX_GROUP_NAME * num_groups );
 
+        head_len = sizeof(message_header)+MAX_GROUP_NAME*num_groups;
+        num_elements = scat_mess->num_elements;
+
 	Mutex_lock( &Sessions[ses].send_mutex );
-        for ( buf_len = 0; buf_len < (int) sizeof(message_header)+MAX_GROUP_NAME*num_groups; buf_len += ret) 
+	if( !sp_same_session( ses, mbox, generation ) )
+	{
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		return( ILLEGAL_SESSION );
+	}
+        if( Sessions[ses].nonblocking )
+        {
+                /* queued whole, then sent as far as the socket takes it */
+                if( sp_send_room( ses, head_len + mess_len ) < 0 )
+                {
+                        Alarm( SESSION, "SP_internal_multicast: no memory to queue %d bytes on mailbox %d\n", head_len + mess_len, mbox );
+                        Mutex_unlock( &Sessions[ses].send_mutex );
+                        return( BUFFER_TOO_SHORT );
+                }
+                batch_ptr = &Sessions[ses].send_buf[Sessions[ses].send_len];
+                memcpy( batch_ptr, head_buf, head_len );
+                for( len=head_len, i=0; i < num_elements; len+=scat_mess->elements[i].len, i++ )
+                        memcpy( &batch_ptr[len], scat_mess->elements[i].buf, scat_mess->elements[i].len );
+                Sessions[ses].send_len += len;
+
+                /* a disconnect has to get out before the mailbox is closed */
+                ret = 0;
+                if( Is_kill_mess( service_type ) )
+                {
+                        ret = sp_send_batch( ses, mbox, 1 );
+                        Sessions[ses].batching = 0;
+                }else if( !Sessions[ses].batching ){
+                        ret = sp_send_batch( ses, mbox, 0 );
+                }
+                Mutex_unlock( &Sessions[ses].send_mutex );
+                if( ret < 0 ) return( ret );
+                return( mess_len );
+        }
+
+        if( Sessions[ses].batching )
         {
-            while(((ret=send( mbox, &head_buf[buf_len], sizeof(message_header)+MAX_GROUP_NAME*num_groups - buf_len, 0 )) == -1) 
+                if( Sessions[ses].send_len + head_len + mess_len > SP_SEND_BUF_SIZE )
+                {
+                        ret = sp_send_batch( ses, mbox, 1 );
+                        if( ret < 0 )
+                        {
+                                Mutex_unlock( &Sessions[ses].send_mutex );
+                                return( ret );
+                        }
+                }
+                if( head_len + mess_len <= SP_SEND_BUF_SIZE )
+                {
+                        batch_ptr = &Sessions[ses].send_buf[Sessions[ses].send_len];
+                        memcpy( batch_ptr, head_buf, head_len );
+                        for( len=head_len, i=0; i < num_elements; len+=scat_mess->elements[i].len, i++ )
+                                memcpy( &batch_ptr[len], scat_mess->elements[i].buf, scat_mess->elements[i].len );
+                        Sessions[ses].send_len += len;
+
+                        /* a disconnect ends the batch */
+                        ret = 0;
+                        if( Is_kill_mess( service_type ) )
+                        {
+                                ret = sp_send_batch( ses, mbox, 1 );
+                                Sessions[ses].batching = 0;
+                        }
+                        Mutex_unlock( &Sessions[ses].send_mutex );
+                        if( ret < 0 ) return( ret );
+                        return( mess_len );
+                }
+                /* too big to batch, it follows the batch out on its own */
+        }else if( head_len + mess_len <= (int) sizeof(head_buf) ){
+                /* small messages go out with their header in one send() */
+                for( i=0; i < num_elements; head_len+=scat_mess->elements[i].len, i++ )
+                        memcpy( &head_buf[head_len], scat_mess->elements[i].buf, scat_mess->elements[i].len );
+                num_elements = 0;
+        }
+        for ( buf_len = 0; buf_len < head_len; buf_len += ret) 
+        {
+            while(((ret=send( mbox, &head_buf[buf_len], head_len - buf_len, 0 )) == -1) 
                   && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
                 ;
             if( ret <=0 )
@@ -1144,7 +1430,7 @@ static	int	SP_internal_multicast( mailbox mbox, service service_type,
 		return( CONNECTION_CLOSED );
             }
         }
-	for( len=0, i=0; i < (int) scat_mess->num_elements; len+=buf_len, i++ )
+	for( len=0, i=0; i < num_elements; len+=buf_len, i++ )
 	{
             for ( buf_len = 0; buf_len < (int) scat_mess->elements[i].len; buf_len += ret) 
             {
@@ -1171,7 +1457,7 @@ static	int	SP_internal_multicast( mailbox mbox, service service_type,
             }
 	}
 	Mutex_unlock( &Sessions[ses].send_mutex );
-	return( len );
+	return( mess_len );
 }
 
 int	SP_receive( mailbox mbox, service *service_type, char sender[MAX_GROUP_NAME],
@@ -1211,65 +1497,37 @@ static	char		dummy_buf[10240];
 	int		to_read;
 	int		scat_index, byte_index;
 	int		ses;
+	int		generation;
 	char		This_session_private_group[MAX_GROUP_NAME];
 	int		i;
         int32           old_type;
 
 	/* lookup and validate the session */
 
-	Mutex_lock( &Struct_mutex );
-
-	ses = SP_get_session( mbox );
-
-	if( ses < 0 ) {
-	  Mutex_unlock( &Struct_mutex );
-	  return( ILLEGAL_SESSION );
-	}
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
 
-	if( Sessions[ses].state != SESS_ACTIVE ) {
-	  Mutex_unlock( &Struct_mutex );
-	  return( NET_ERROR_ON_SESSION );
-	}
+	if( Sessions[ses].state != SESS_ACTIVE ) return( NET_ERROR_ON_SESSION );
 
-	Mutex_unlock( &Struct_mutex );
-
-        /* I must acquire the recv lock for this mbox before the
-         * Struct_mutex lock because I must be sure ONLY one thread is
-         * truly in recv for this mbox. Otherwise, one thread enters
-         * this and gets the state and sees no saved message then
-         * grabs the recv lock and discovers buffer too short and
-         * so regrabs the Struct_mutex and adds the saved header, but
-         * during this time another thread has entered recv for the
-         * same mbox and already grabbed the Struct_mutex and also
-         * seen that no saved mesage exists and is now waiting for the
-         * recv mutex.  When the first thread returns and releases the
-         * recv mutex, the second thread will grab it and enter--but
-         * it will think there is NO saved messaage when in reality
-         * there IS one. This will cause MANY PROBLEMS :-)
-         *
-         * NOTE: locking and unlocking the Struct_mutex multiple times
-         * during this is OK BECAUSE Struct_mutex only locks
-         * non-blocking operations that are guaranteed to complete
-         * quickly and never take additional locks.
-         */
+        /* Only one thread may truly be in recv for this mbox: the saved
+         * header of a message found too big for the caller's buffers is
+         * read here and set further down, and a second thread looking in
+         * between would miss it. The recv lock covers both, and the slot
+         * is checked again once it is held. */
 
 	Mutex_lock( &Sessions[ses].recv_mutex );
 
-	Mutex_lock( &Struct_mutex );
-
-	if( ses != SP_get_session( mbox ) ){
-		Mutex_unlock( &Struct_mutex );
+	if( !sp_same_session( ses, mbox, generation ) ){
                 Mutex_unlock( &Sessions[ses].recv_mutex );
 		return( ILLEGAL_SESSION );
 	}
 
         if( Sessions[ses].state != SESS_ACTIVE ) {
-		Mutex_unlock( &Struct_mutex );
                 Mutex_unlock( &Sessions[ses].recv_mutex );
 		return( NET_ERROR_ON_SESSION );
 	}
 
-	strcpy( This_session_private_group, Sessions[ses].private_group_name );
+	memcpy( This_session_private_group, Sessions[ses].private_group_name, MAX_GROUP_NAME );
 
         if (Sessions[ses].recv_message_saved) {
                 memcpy(&mess_head, &(Sessions[ses].recv_saved_head), sizeof(message_header) );
@@ -1277,8 +1535,6 @@ static	char		dummy_buf[10240];
         } else {
                 This_session_message_saved = 0;
         }
-
-	Mutex_unlock( &Struct_mutex );
         
 	head_ptr = (message_header *)&mess_head;
 	buf_ptr = (char *)&mess_head;
@@ -1289,9 +1545,9 @@ static	char		dummy_buf[10240];
                 /* read up to size of message_header */
                 for( len=0, remain = sizeof(message_header); remain > 0;  len += ret, remain -= ret )
                 {
-                        while(((ret = recv( mbox, &buf_ptr[len], remain, 0 )) == -1 )
+                        while(((ret = sp_recv( ses, mbox, &buf_ptr[len], remain )) == -1 )
                               && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
-                                ;
+                                sp_recv_wait( mbox );
                         if( ret <=0 )
                         {
                                 Alarm( SESSION, "SP_scat_receive: failed receiving header on session %d (ret: %d len: %d): %s\n", mbox, ret, len, sock_strerror(sock_errno) );
@@ -1342,15 +1598,8 @@ static	char		dummy_buf[10240];
         if (!drop_semantics) {
                 if ( (head_ptr->num_groups > max_groups) || (head_ptr->data_len > max_mess_len) ) {
                         if (!This_session_message_saved) {
-                                Mutex_lock( &Struct_mutex );
-                                if( ses != SP_get_session( mbox ) ){
-                                        Mutex_unlock( &Struct_mutex );
-					Mutex_unlock( &Sessions[ses].recv_mutex );
-                                        return( ILLEGAL_SESSION );
-                                }
                                 memcpy(&(Sessions[ses].recv_saved_head), &mess_head, sizeof(message_header) );
                                 Sessions[ses].recv_message_saved = 1;
-                                Mutex_unlock( &Struct_mutex );
                         }
                         /* When *_TOO_SHORT error will be returned, provide caller with all available information:
                          * service_type
@@ -1423,8 +1672,8 @@ static	char		dummy_buf[10240];
                 buf_ptr = (char *)&old_type;
                 for( len=0; remain > 0; len += ret, remain -= ret )
                 {
-                        while(((ret = recv( mbox, &buf_ptr[len], remain, 0 )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
-                                ;
+                        while(((ret = sp_recv( ses, mbox, &buf_ptr[len], remain )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
+                                sp_recv_wait( mbox );
                         if( ret <=0 )
                         {
                                 Alarm( SESSION, "SP_scat_receive: failed receiving old_type for reject on session %d, ret is %d: %s\n", mbox, ret, sock_strerror(sock_errno));
@@ -1463,8 +1712,8 @@ static	char		dummy_buf[10240];
 
 	for( len=0; remain > 0; len += ret, remain -= ret )
 	{
-		while(((ret = recv( mbox, &buf_ptr[len], remain, 0 )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
-                        ;
+		while(((ret = sp_recv( ses, mbox, &buf_ptr[len], remain )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
+                        sp_recv_wait( mbox );
 		if( ret <=0 )
 		{
 			Alarm( SESSION, "SP_scat_receive: failed receiving groups on session %d, ret is %d: %s\n", mbox, ret, sock_strerror(sock_errno));
@@ -1492,8 +1741,8 @@ static	char		dummy_buf[10240];
 		{
 			to_read = remain;
 			if( to_read > sizeof( dummy_buf ) ) to_read = sizeof( dummy_buf );
-			while(((ret = recv( mbox, dummy_buf, to_read, 0 )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
-                                ;
+			while(((ret = sp_recv( ses, mbox, dummy_buf, to_read )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
+                                sp_recv_wait( mbox );
 			if( ret <=0 )
 			{
 				Alarm( SESSION, "SP_scat_receive: failed receiving groups overflow on session %d, ret is %d: %s\n", 
@@ -1555,9 +1804,9 @@ static	char		dummy_buf[10240];
 	{
 		to_read = scat_mess->elements[scat_index].len - byte_index;
 		if( to_read > remain ) to_read = remain;
-		while(((ret = recv( mbox, &scat_mess->elements[scat_index].buf[byte_index], to_read, 0 )) == -1 )
+		while(((ret = sp_recv( ses, mbox, &scat_mess->elements[scat_index].buf[byte_index], to_read )) == -1 )
                       && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
-                        ;
+                        sp_recv_wait( mbox );
 		if( ret <=0 )
 		{
 			Alarm( SESSION, "SP_scat_receive: failed receiving message on session %d, ret is %d: %s\n", 
@@ -1729,8 +1978,8 @@ static	char		dummy_buf[10240];
 		{
 			to_read = remain;
 			if( to_read > sizeof( dummy_buf ) ) to_read = sizeof( dummy_buf );
-			while(((ret = recv( mbox, dummy_buf, to_read, 0 )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
-                                ;
+			while(((ret = sp_recv( ses, mbox, dummy_buf, to_read )) == -1 ) && ((sock_errno == EINTR) || (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK)) )
+                                sp_recv_wait( mbox );
 			if( ret <=0 )
 			{
 				Alarm( SESSION, "SP_scat_receive: failed receiving overflow on session %d, ret is %d: %s\n", 
@@ -1756,39 +2005,182 @@ static	char		dummy_buf[10240];
 	}
         /* Successful receive so clear saved_message info if any */
         if (This_session_message_saved) {
-                Mutex_lock( &Struct_mutex );
-                if( ses != SP_get_session( mbox ) ){
-                        Mutex_unlock( &Struct_mutex );
-			Mutex_unlock( &Sessions[ses].recv_mutex );
-                        return( ILLEGAL_SESSION );
-                }
                 memset(&(Sessions[ses].recv_saved_head), 0, sizeof(message_header) );
                 Sessions[ses].recv_message_saved = 0;
-                Mutex_unlock( &Struct_mutex );
         }
 
 	Mutex_unlock( &Sessions[ses].recv_mutex );
 	return( head_ptr->data_len );
 }
 
+/* Reads as much as the mailbox has into the session's buffer and returns
+ * the whole messages in it, up to max_messages, each described as
+ * SP_scat_receive would return it, with pointers into the buffer. They stay
+ * valid until the next receive on mbox. Blocks until there is at least one,
+ * unless mbox is non-blocking: then it returns 0 when no whole message has
+ * come in yet, keeping the part that has for the next call.
+ */
+int	SP_receive_many( mailbox mbox, int max_messages, sp_message messages[] )
+{
+	char		This_session_private_group[MAX_GROUP_NAME];
+	sp_session	*sp;
+	int		num;
+	int		ses;
+	int		generation;
+	int		i;
+
+	if( max_messages <= 0 ) return( BUFFER_TOO_SHORT );
+
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
+
+	if( Sessions[ses].state != SESS_ACTIVE ) return( NET_ERROR_ON_SESSION );
+
+	/* one receiver at a time, for the reasons given in SP_scat_receive */
+	Mutex_lock( &Sessions[ses].recv_mutex );
+
+	if( !sp_same_session( ses, mbox, generation ) ){
+		Mutex_unlock( &Sessions[ses].recv_mutex );
+		return( ILLEGAL_SESSION );
+	}
+
+	if( Sessions[ses].state != SESS_ACTIVE ) {
+		Mutex_unlock( &Sessions[ses].recv_mutex );
+		return( NET_ERROR_ON_SESSION );
+	}
+
+	memcpy( This_session_private_group, Sessions[ses].private_group_name, MAX_GROUP_NAME );
+
+	num = sp_recv_ready( ses, mbox, max_messages );
+	if( num < 0 )
+	{
+		Mutex_unlock( &Sessions[ses].recv_mutex );
+		return( num );
+	}
+
+	sp = &Sessions[ses];
+	for( i = 0; i < num; i++ )
+	{
+		sp_parse_mess( &sp->recv_buf[sp->recv_head], This_session_private_group, &messages[i] );
+		sp->recv_head += sp_mess_len( &sp->recv_buf[sp->recv_head] );
+	}
+	if( sp->recv_head == sp->recv_tail ) sp->recv_head = sp->recv_tail = 0;
+
+	Mutex_unlock( &Sessions[ses].recv_mutex );
+	return( num );
+}
+
+/* Receives the next message into a buffer of the library sized to it and
+ * returns it in *buffer, described in *mess with pointers into the
+ * buffer. The buffer stays valid until SP_buffer_release, whatever is
+ * received meanwhile. Returns the data length of the message; *buffer is
+ * left NULL when a non-blocking mbox has none. */
+int	SP_receive_buffer( mailbox mbox, sp_message *mess, sp_buffer **buffer )
+{
+	char		This_session_private_group[MAX_GROUP_NAME];
+	sp_session	*sp;
+	sp_buffer	*buf;
+	int		len;
+	int		ses;
+	int		generation;
+	int		ret;
+
+	*buffer = NULL;
+
+	ses = sp_lookup_session( mbox, &generation );
+	if( ses < 0 ) return( ILLEGAL_SESSION );
+
+	if( Sessions[ses].state != SESS_ACTIVE ) return( NET_ERROR_ON_SESSION );
+
+	Mutex_lock( &Sessions[ses].recv_mutex );
+
+	if( !sp_same_session( ses, mbox, generation ) ){
+		Mutex_unlock( &Sessions[ses].recv_mutex );
+		return( ILLEGAL_SESSION );
+	}
+
+	if( Sessions[ses].state != SESS_ACTIVE ) {
+		Mutex_unlock( &Sessions[ses].recv_mutex );
+		return( NET_ERROR_ON_SESSION );
+	}
+
+	memcpy( This_session_private_group, Sessions[ses].private_group_name, MAX_GROUP_NAME );
+
+	ret = sp_recv_ready( ses, mbox, 1 );
+	if( ret <= 0 )
+	{
+		Mutex_unlock( &Sessions[ses].recv_mutex );
+		return( ret );
+	}
+
+	sp  = &Sessions[ses];
+	len = sp_mess_len( &sp->recv_buf[sp->recv_head] );
+	buf = sp_buffer_get( ses, len );
+	if( buf == NULL )
+	{
+		Alarm( SESSION, "SP_receive_buffer: no memory for a %d byte message on session %d\n", len, mbox );
+		Mutex_unlock( &Sessions[ses].recv_mutex );
+		return( BUFFER_TOO_SHORT );
+	}
+	memcpy( SP_BUFFER_DATA( buf ), &sp->recv_buf[sp->recv_head], len );
+	sp->recv_head += len;
+	if( sp->recv_head == sp->recv_tail ) sp->recv_head = sp->recv_tail = 0;
+
+	Mutex_unlock( &Sessions[ses].recv_mutex );
+
+	sp_parse_mess( SP_BUFFER_DATA( buf ), This_session_private_group, mess );
+	*buffer = buf;
+	return( mess->data_len );
+}
+
+/* Takes another reference to a buffer of SP_receive_buffer */
+void	SP_buffer_hold( sp_buffer *buffer )
+{
+	Mutex_lock( &Sessions[buffer->ses].pool_mutex );
+	buffer->ref_cnt++;
+	Mutex_unlock( &Sessions[buffer->ses].pool_mutex );
+}
+
+/* Drops a reference to a buffer of SP_receive_buffer; the last one gives
+ * it back to the pool of the mailbox it came from */
+void	SP_buffer_release( sp_buffer *buffer )
+{
+	sp_session	*sp = &Sessions[buffer->ses];
+	int		c = buffer->size_class;
+
+	Mutex_lock( &sp->pool_mutex );
+	if( --buffer->ref_cnt > 0 )
+	{
+		Mutex_unlock( &sp->pool_mutex );
+		return;
+	}
+	if( c >= 0 && sp->pool_bytes + ( SP_POOL_MIN_SIZE << c ) <= SP_POOL_MAX_BYTES )
+	{
+		buffer->next = sp->pool[c];
+		sp->pool[c] = buffer;
+		sp->pool_bytes += SP_POOL_MIN_SIZE << c;
+		buffer = NULL;
+	}
+	Mutex_unlock( &sp->pool_mutex );
+
+	if( buffer != NULL ) free( buffer );
+}
+
 int	SP_poll( mailbox mbox )
 {
 	int		num_bytes;
 	int		ses;
+	int		generation;
 	int		ret;
 
-	Mutex_lock( &Struct_mutex );
-
 	/* verify mbox */
-	ses = SP_get_session( mbox );
-
-	Mutex_unlock( &Struct_mutex );
+	ses = sp_lookup_session( mbox, &generation );
 
 	if( ses < 0 ) return( ILLEGAL_SESSION );
 
 	ret = ioctl( mbox, FIONREAD, &num_bytes);
 	if( ret < 0 ) return( ILLEGAL_SESSION );
-	return( num_bytes );
+	return( num_bytes + Sessions[ses].recv_tail - Sessions[ses].recv_head );
 
 }
 
@@ -2037,29 +2429,401 @@ int	SP_query_members( mailbox mbox, char *group, int max_members, char *members[
 	return( -1 );
 }
 
+/* Waits for the threads sending or receiving on the session to leave it,
+ * so the socket is not torn down under them. */
 void	SP_kill( mailbox mbox )
 {
 	int	ses;
+	int	generation;
+
+	ses = sp_lookup_session( mbox, &generation );
 
+	if( ses < 0 ){ 
+		Alarm( SESSION, "SP_kill: killing a non existent session for mailbox %d (likely race condition)!!!\n", mbox );
+		return;
+	}
+
+	Mutex_lock( &Sessions[ses].recv_mutex );
+	Mutex_lock( &Sessions[ses].send_mutex );
 	Mutex_lock( &Struct_mutex );
 
 	/* get mbox out of the data structures */
 
-	ses = SP_get_session( mbox );
-
-	if( ses < 0 ){ 
+	if( !sp_same_session( ses, mbox, generation ) ){ 
 		Alarm( SESSION, "SP_kill: killing a non existent session for mailbox %d (likely race condition)!!!\n", mbox );
 		Mutex_unlock( &Struct_mutex );
+		Mutex_unlock( &Sessions[ses].send_mutex );
+		Mutex_unlock( &Sessions[ses].recv_mutex );
 		return;
 	}
 
 	Sessions[ses].mbox  = -1;
 	Sessions[ses].state = SESS_UNUSED;
+        SP_barrier();
+        Sessions[ses].generation++;
 	close(mbox);
 
 	Num_sessions--;
 
 	Mutex_unlock( &Struct_mutex );
+	Mutex_unlock( &Sessions[ses].send_mutex );
+	Mutex_unlock( &Sessions[ses].recv_mutex );
+}
+
+/* Reads what SP_receive_many read ahead first, then the mailbox */
+static  int     sp_recv( int ses, mailbox mbox, char *buf, int len )
+{
+        int             ret;
+
+        ret = Sessions[ses].recv_tail - Sessions[ses].recv_head;
+        if( ret == 0 ) return( recv( mbox, buf, len, 0 ) );
+
+        if( ret > len ) ret = len;
+        memcpy( buf, &Sessions[ses].recv_buf[Sessions[ses].recv_head], ret );
+        Sessions[ses].recv_head += ret;
+        return( ret );
+}
+
+/* SP_scat_receive returns only whole messages, so when a non-blocking
+ * mailbox has nothing yet it sleeps until the mailbox is readable instead
+ * of spinning on recv() */
+static  void    sp_recv_wait( mailbox mbox )
+{
+        fd_set          rset;
+
+        if( sock_errno != EAGAIN && sock_errno != EWOULDBLOCK ) return;
+
+        FD_ZERO( &rset );
+        FD_SET( mbox, &rset );
+        while( select( mbox+1, &rset, NULL, NULL, NULL ) == -1 && sock_errno == EINTR )
+        {
+                FD_ZERO( &rset );
+                FD_SET( mbox, &rset );
+        }
+}
+
+/* Reads as much as the mailbox has into recv_buf until whole messages
+ * are there and returns how many, up to max_messages; the first is at
+ * recv_head. A non-blocking session returns 0 rather than wait. Called
+ * with the recv_mutex held. */
+static  int     sp_recv_ready( int ses, mailbox mbox, int max_messages )
+{
+	message_header	saved_head;
+	int		saved;
+	sp_session	*sp = &Sessions[ses];
+	int		num, missing, room;
+	int		ret;
+
+	/* a header SP_scat_receive found too big for its buffers goes back
+	 * in front of the rest of its message, as it was sent */
+	saved = sp->recv_message_saved;
+	if( saved ) {
+		memcpy( &saved_head, &sp->recv_saved_head, sizeof(message_header) );
+		memset( &sp->recv_saved_head, 0, sizeof(message_header) );
+		sp->recv_message_saved = 0;
+
+		if( !Same_endian( saved_head.type ) ) Flip_mess( &saved_head );
+		if( sp_recv_room( ses, sizeof(message_header) ) < 0 ) goto NO_MEMORY;
+		memmove( &sp->recv_buf[sp->recv_head + sizeof(message_header)], &sp->recv_buf[sp->recv_head], sp->recv_tail - sp->recv_head );
+		memcpy( &sp->recv_buf[sp->recv_head], &saved_head, sizeof(message_header) );
+		sp->recv_tail += sizeof(message_header);
+	}
+
+	for( ;; )
+	{
+		num = sp_recv_whole( ses, max_messages, &missing );
+		if( num < 0 ) return( ILLEGAL_MESSAGE );
+		if( num > 0 ) break;
+
+		room = sp_recv_room( ses, missing );
+		if( room < 0 ) goto NO_MEMORY;
+		while( ( ret = recv( mbox, &sp->recv_buf[sp->recv_tail], room, 0 ) ) == -1
+		       && ( (sock_errno == EINTR) || (!sp->nonblocking && ( (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK) ) ) ) )
+			;
+		if( ret == -1 && sp->nonblocking && ( (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK) ) ) break;
+		if( ret <= 0 ) goto CLOSED;
+		sp->recv_tail += ret;
+	}
+	return( num );
+
+NO_MEMORY:
+	Alarm( SESSION, "sp_recv_ready: no memory for a receive buffer on session %d\n", mbox );
+	return( BUFFER_TOO_SHORT );
+
+CLOSED:
+	Alarm( SESSION, "sp_recv_ready: failed receiving on session %d, ret is %d: %s\n", mbox, ret, sock_strerror(sock_errno) );
+
+	Mutex_lock( &Struct_mutex );
+	if( ses == SP_get_session( mbox ) ) sp->state = SESS_ERROR;
+	Mutex_unlock( &Struct_mutex );
+	return( CONNECTION_CLOSED );
+}
+
+/* A buffer for a len byte message, from the pool of slot ses when one of
+ * its size class is there. Messages too big for the pool get a buffer of
+ * their own size. Returns NULL when out of memory. */
+static  sp_buffer *sp_buffer_get( int ses, int len )
+{
+        sp_session      *sp = &Sessions[ses];
+        sp_buffer       *buf;
+        int             c;
+
+        for( c = 0; c < SP_POOL_CLASSES && ( SP_POOL_MIN_SIZE << c ) < len; c++ )
+                ;
+        if( c == SP_POOL_CLASSES )
+        {
+                buf = malloc( sizeof(sp_buffer) + len );
+                c = -1;
+        }else{
+                Mutex_lock( &sp->pool_mutex );
+                buf = sp->pool[c];
+                if( buf != NULL )
+                {
+                        sp->pool[c] = buf->next;
+                        sp->pool_bytes -= SP_POOL_MIN_SIZE << c;
+                }
+                Mutex_unlock( &sp->pool_mutex );
+                if( buf == NULL ) buf = malloc( sizeof(sp_buffer) + ( SP_POOL_MIN_SIZE << c ) );
+        }
+        if( buf == NULL ) return( NULL );
+
+        buf->next       = NULL;
+        buf->ses        = ses;
+        buf->size_class = c;
+        buf->ref_cnt    = 1;
+        return( buf );
+}
+
+/* Makes room in recv_buf for len more bytes, moving the bytes not handed
+ * out yet to the front and growing it as needed. Returns the room there
+ * is, or -1 when out of memory. */
+static  int     sp_recv_room( int ses, int len )
+{
+        sp_session      *sp = &Sessions[ses];
+        char            *buf;
+        int             unread, size;
+
+        unread = sp->recv_tail - sp->recv_head;
+        if( sp->recv_head > 0 && ( sp->recv_buf_size - sp->recv_tail < len || sp->recv_head > sp->recv_buf_size / 2 ) )
+        {
+                memmove( sp->recv_buf, &sp->recv_buf[sp->recv_head], unread );
+                sp->recv_head = 0;
+                sp->recv_tail = unread;
+        }
+        if( sp->recv_buf_size - sp->recv_tail < len )
+        {
+                size = ( sp->recv_buf_size > 0 ? sp->recv_buf_size : SP_RECV_BUF_SIZE );
+                while( size - unread < len ) size *= 2;
+                buf = realloc( sp->recv_buf, size );
+                if( buf == NULL ) return( -1 );
+                sp->recv_buf      = buf;
+                sp->recv_buf_size = size;
+        }
+        return( sp->recv_buf_size - sp->recv_tail );
+}
+
+/* Counts the whole messages read ahead, up to max_messages, and sets
+ * *missing to the bytes still to come of the next one. Returns -1 if the
+ * first of them has an impossible header. */
+static  int     sp_recv_whole( int ses, int max_messages, int *missing )
+{
+        sp_session      *sp = &Sessions[ses];
+        int             offset, unread, len;
+        int             num;
+
+        *missing = 0;
+        for( num = 0, offset = sp->recv_head; num < max_messages; num++, offset += len )
+        {
+                unread = sp->recv_tail - offset;
+                if( unread < (int) sizeof(message_header) )
+                {
+                        *missing = sizeof(message_header) - unread;
+                        break;
+                }
+                len = sp_mess_len( &sp->recv_buf[offset] );
+                if( len < 0 ) return( num > 0 ? num : -1 );
+                if( unread < len )
+                {
+                        *missing = len - unread;
+                        break;
+                }
+        }
+        return( num );
+}
+
+/* Length of the message starting with the header in head_buf, in the
+ * byte order it was sent in, or -1 if the header is impossible */
+static  int     sp_mess_len( const char *head_buf )
+{
+        message_header  head;
+        int             len;
+
+        memcpy( &head, head_buf, sizeof(message_header) );
+        if( !Same_endian( head.type ) ) Flip_mess( &head );
+
+        if( head.num_groups < 0 || head.num_groups > ( INT_MAX / 4 ) / MAX_GROUP_NAME ) return( -1 );
+        if( head.data_len < 0 || head.data_len > INT_MAX / 4 ) return( -1 );
+
+        len = sizeof(message_header) + head.num_groups * MAX_GROUP_NAME + head.data_len;
+        if( Is_reject_mess( head.type ) ) len += sizeof(int32);
+        return( len );
+}
+
+/* Fills mess in from the whole message at buf, fixing its byte order in
+ * place, as SP_scat_receive would return it */
+static  void    sp_parse_mess( char *buf, const char *private_group, sp_message *mess )
+{
+        message_header  head;
+        int32           old_type;
+        char            *groups;
+        int             i;
+
+        memcpy( &head, buf, sizeof(message_header) );
+        if( !Same_endian( head.type ) ) Flip_mess( &head );
+
+        groups = &buf[sizeof(message_header)];
+        if( Is_reject_mess( head.type ) )
+        {
+                memcpy( &old_type, groups, sizeof(int32) );
+                if( !Same_endian( head.type ) ) old_type = Flip_int32( old_type );
+                groups += sizeof(int32);
+        }
+
+        if( Is_regular_mess( head.type ) || Is_reject_mess( head.type ) )
+        {
+                if( !Same_endian( head.hint ) )
+                {
+                        head.hint = Flip_int32( head.hint );
+                        mess->endian_mismatch = 1;
+                }else{
+                        mess->endian_mismatch = 0;
+                }
+                mess->mess_type = ( Clear_endian( head.hint ) >> 8 ) & 0x0000ffff;
+        }else{
+                mess->mess_type = -1; /* marks the index (0..n-1) of the member in the group */
+                mess->endian_mismatch = 0;
+        }
+
+        mess->sender     = &buf[offsetof( message_header, private_group_name )];
+        mess->num_groups = head.num_groups;
+        mess->groups     = (char (*)[MAX_GROUP_NAME]) groups;
+        mess->data_len   = head.data_len;
+        mess->data       = &groups[head.num_groups * MAX_GROUP_NAME];
+
+        if( Is_reg_memb_mess( head.type ) )
+        {
+                for( i = 0; i < head.num_groups; i++ )
+                {
+                        if( !strncmp( mess->groups[i], private_group, MAX_GROUP_NAME ) )
+                        {
+                                mess->mess_type = i;
+                                break;
+                        }
+                }
+                if( !Same_endian( head.type ) ) sp_flip_memb_body( mess->data, mess->data_len );
+        }
+
+        if( Is_reject_mess( head.type ) ) head.type = old_type | REJECT_MESS;
+        mess->service_type = Clear_endian( head.type );
+}
+
+/* Flips the group_id, the vs set count and offset, and the member count of
+ * each vs set in a membership message body from the other byte order */
+static  void    sp_flip_memb_body( char *body, int len )
+{
+        int32u          word;
+        int             num_vs_sets, num_members;
+        int             offset, i;
+
+        if( len < (int) ( sizeof(group_id) + 2 * sizeof(int32u) ) ) return;
+
+        for( offset = 0; offset < (int) ( sizeof(group_id) + 2 * sizeof(int32u) ); offset += sizeof(int32u) )
+        {
+                memcpy( &word, &body[offset], sizeof(int32u) );
+                word = Flip_int32( word );
+                memcpy( &body[offset], &word, sizeof(int32u) );
+        }
+        memcpy( &num_vs_sets, &body[sizeof(group_id)], sizeof(int32u) );
+
+        for( i = 0; i < num_vs_sets && offset + (int) sizeof(int32u) <= len; i++ )
+        {
+                memcpy( &word, &body[offset], sizeof(int32u) );
+                word = Flip_int32( word );
+                memcpy( &body[offset], &word, sizeof(int32u) );
+                num_members = word;
+                if( num_members < 0 || num_members > ( len - offset ) / MAX_GROUP_NAME ) break;
+                offset += sizeof(int32u) + num_members * MAX_GROUP_NAME;
+        }
+}
+
+/* Makes room in send_buf for len more bytes, moving the bytes not sent
+ * yet to the front and growing it as needed. Returns 0, or -1 when out
+ * of memory. */
+static  int     sp_send_room( int ses, int len )
+{
+        sp_session      *sp = &Sessions[ses];
+        char            *buf;
+        int             size;
+
+        if( sp->send_buf != NULL && sp->send_len + len <= sp->send_buf_size ) return( 0 );
+
+        if( sp->send_head > 0 )
+        {
+                memmove( sp->send_buf, &sp->send_buf[sp->send_head], sp->send_len - sp->send_head );
+                sp->send_len -= sp->send_head;
+                sp->send_head = 0;
+        }
+        size = ( sp->send_buf_size > 0 ? sp->send_buf_size : SP_SEND_BUF_SIZE );
+        while( size < sp->send_len + len ) size *= 2;
+        if( sp->send_buf == NULL || size != sp->send_buf_size )
+        {
+                buf = realloc( sp->send_buf, size );
+                if( buf == NULL ) return( -1 );
+                sp->send_buf      = buf;
+                sp->send_buf_size = size;
+        }
+        return( 0 );
+}
+
+/* Sends the batched or queued messages with as few send() calls as the
+ * socket takes. Unless wait is set, stops when the socket is full and
+ * leaves the rest queued. Called with the send_mutex held. Returns 0 or CONNECTION_CLOSED. */
+static  int     sp_send_batch( int ses, mailbox mbox, int wait )
+{
+        sp_session      *sp = &Sessions[ses];
+        fd_set          wset;
+        int             ret;
+
+        while( sp->send_head < sp->send_len )
+        {
+                ret = send( mbox, &sp->send_buf[sp->send_head], sp->send_len - sp->send_head, 0 );
+                if( ret == -1 && ( (sock_errno == EAGAIN) || (sock_errno == EWOULDBLOCK) ) )
+                {
+                        if( !wait ) return( 0 );
+
+                        FD_ZERO( &wset );
+                        FD_SET( mbox, &wset );
+                        select( mbox+1, NULL, &wset, NULL, NULL );
+                        continue;
+                }
+                if( ret == -1 && sock_errno == EINTR ) continue;
+                if( ret <= 0 )
+                {
+                        Alarm( SESSION, "sp_send_batch: error %d sending %d batched bytes on mailbox %d: %s\n",
+                               ret, sp->send_len - sp->send_head, mbox, sock_strerror(sock_errno) );
+                        goto CLOSED;
+                }
+                sp->send_head += ret;
+        }
+        sp->send_head = sp->send_len = 0;
+        return( 0 );
+
+CLOSED:
+        sp->send_head = sp->send_len = 0;
+        Mutex_lock( &Struct_mutex );
+        if( ses == SP_get_session( mbox ) ) sp->state = SESS_ERROR;
+        Mutex_unlock( &Struct_mutex );
+        return( CONNECTION_CLOSED );
 }
 
 static	int	SP_get_session( mailbox mbox )
@@ -2082,6 +2846,32 @@ static	int	SP_get_session( mailbox mbox )
 	return ses;
 }
 
+/* SP_get_session for the paths that do not hold the Struct_mutex. Also
+ * returns the slot's generation, for sp_same_session once the caller
+ * holds the session's send_mutex or recv_mutex. */
+static	int	sp_lookup_session( mailbox mbox, int *generation )
+{
+        int ses;
+
+        ses = SP_get_session( mbox );
+        if( ses < 0 ) return( -1 );
+
+        *generation = Sessions[ses].generation;
+        SP_barrier();
+
+        /* given back (and maybe taken again) meanwhile */
+        if( Sessions[ses].mbox != mbox ) return( -1 );
+
+        return( ses );
+}
+
+/* Is slot ses still the session of mbox that sp_lookup_session found? */
+static	int	sp_same_session( int ses, mailbox mbox, int generation )
+{
+        SP_barrier();
+        return( Sessions[ses].generation == generation && Sessions[ses].mbox == mbox );
+}
+
 void	SP_error( int error )
 {
 	switch( error )